@@ -0,0 +1,255 @@
+// ab_compare.cpp
+// セッション群の統計的比較の実装
+
+#include "ab_compare.h"
+#include "statistics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+
+namespace ABCompare {
+
+    // ブートストラップ1チャンクあたりの復元抽出回数（結果がスレッド数に依存しないよう固定）
+    static const size_t BOOTSTRAP_CHUNK = 256;
+
+    const char* metricName(size_t index) {
+        switch (index) {
+            case 0: return "wpm";
+            case 1: return "accuracy";
+            case 2: return "inter_key_interval";
+            default: return "";
+        }
+    }
+
+    double metricValue(const SessionMetrics& metrics, size_t index) {
+        switch (index) {
+            case 0: return metrics.wpm;
+            case 1: return metrics.accuracy;
+            case 2: return metrics.interKeyInterval;
+            default: return 0.0;
+        }
+    }
+
+    SessionMetrics measureSession(InputRecorder::EventView events) {
+        SessionMetrics metrics{0.0, 0.0, 0.0, 0};
+        if (events.empty()) return metrics;
+
+        // 判定に渡されたキーの正誤（チャタリング・ゴースト押下・文字のないキーは判定されていない）
+        size_t correct = 0;
+        size_t incorrect = 0;
+        uint64_t first = events[0].timestamp_us;
+        uint64_t last = first;
+        for (const auto& event : events) {
+            first = std::min(first, event.timestamp_us);
+            last = std::max(last, event.timestamp_us);
+            if (!InputRecorder::isJudgedKeyDown(event)) continue;
+            if (event.is_correct) correct++; else incorrect++;
+        }
+
+        Statistics::FleetCalculator calc;
+        calc.startSession(first);
+        calc.endSession(last);
+        Statistics::StatisticsData data = calc.calculate(events, correct, incorrect);
+
+        size_t judged = data.correctKeyCount + data.incorrectKeyCount;
+        metrics.wpm = data.wpmCorrect;
+        metrics.accuracy = judged > 0 ? static_cast<double>(data.correctKeyCount) / judged * 100.0 : 0.0;
+        metrics.interKeyInterval = data.avgInterKeyInterval;
+        metrics.keyCount = data.totalKeyCount;
+        return metrics;
+    }
+
+    // ---- 検定・効果量 ----
+
+    MannWhitneyResult mannWhitneyU(const std::vector<double>& a, const std::vector<double>& b) {
+        MannWhitneyResult result{0.0, 0.0, 1.0};
+        size_t n1 = a.size();
+        size_t n2 = b.size();
+        if (n1 == 0 || n2 == 0) return result;
+
+        // 両群をまとめて順位付け（同順位は平均順位）
+        struct Item { double value; bool fromB; };
+        std::vector<Item> items;
+        items.reserve(n1 + n2);
+        for (double v : a) items.push_back({v, false});
+        for (double v : b) items.push_back({v, true});
+        std::sort(items.begin(), items.end(),
+                  [](const Item& x, const Item& y) { return x.value < y.value; });
+
+        size_t n = items.size();
+        double rankSumB = 0.0;
+        double tieTerm = 0.0;   // Σ(t^3 - t)
+        size_t i = 0;
+        while (i < n) {
+            size_t j = i + 1;
+            while (j < n && items[j].value == items[i].value) j++;
+            double avgRank = (static_cast<double>(i + 1) + static_cast<double>(j)) / 2.0;
+            double t = static_cast<double>(j - i);
+            tieTerm += t * t * t - t;
+            for (size_t k = i; k < j; ++k) {
+                if (items[k].fromB) rankSumB += avgRank;
+            }
+            i = j;
+        }
+
+        double dn1 = static_cast<double>(n1);
+        double dn2 = static_cast<double>(n2);
+        double dn = static_cast<double>(n);
+        result.u = rankSumB - dn2 * (dn2 + 1.0) / 2.0;
+
+        double mean = dn1 * dn2 / 2.0;
+        double variance = dn1 * dn2 / 12.0 * ((dn + 1.0) - tieTerm / (dn * (dn - 1.0)));
+        if (n < 2 || variance <= 0.0) return result;  // 全て同じ値
+
+        double diff = result.u - mean;
+        double corrected = std::max(std::fabs(diff) - 0.5, 0.0);  // 連続性補正
+        result.z = (diff < 0 ? -corrected : corrected) / std::sqrt(variance);
+        result.pValue = std::erfc(std::fabs(result.z) / std::sqrt(2.0));
+        return result;
+    }
+
+    double cliffsDelta(const MannWhitneyResult& result, size_t sizeA, size_t sizeB) {
+        if (sizeA == 0 || sizeB == 0) return 0.0;
+        double pairs = static_cast<double>(sizeA) * static_cast<double>(sizeB);
+        return (2.0 * result.u - pairs) / pairs;
+    }
+
+    static double mean(const std::vector<double>& v) {
+        if (v.empty()) return 0.0;
+        return std::accumulate(v.begin(), v.end(), 0.0) / static_cast<double>(v.size());
+    }
+
+    static double median(std::vector<double> v) {
+        if (v.empty()) return 0.0;
+        size_t mid = v.size() / 2;
+        std::nth_element(v.begin(), v.begin() + mid, v.end());
+        double upper = v[mid];
+        if (v.size() % 2 == 1) return upper;
+        double lower = *std::max_element(v.begin(), v.begin() + mid);
+        return (lower + upper) / 2.0;
+    }
+
+    double cohensD(const std::vector<double>& a, const std::vector<double>& b) {
+        if (a.size() < 2 || b.size() < 2) return 0.0;
+
+        double ma = mean(a);
+        double mb = mean(b);
+        double ssa = 0.0;
+        double ssb = 0.0;
+        for (double v : a) ssa += (v - ma) * (v - ma);
+        for (double v : b) ssb += (v - mb) * (v - mb);
+
+        double pooled = std::sqrt((ssa + ssb) / static_cast<double>(a.size() + b.size() - 2));
+        if (pooled == 0.0) return 0.0;
+        return (mb - ma) / pooled;
+    }
+
+    // ---- ブートストラップ ----
+
+    // シードとチャンク番号からチャンクごとの乱数シードを作る（SplitMix64）
+    static uint64_t chunkSeed(uint64_t seed, uint64_t chunk) {
+        uint64_t z = seed + (chunk + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // 復元抽出1回分の平均
+    static double resampleMean(const std::vector<double>& v, std::mt19937_64& rng) {
+        // 剰余による偏りは 要素数/2^64 程度で無視できる
+        double sum = 0.0;
+        size_t n = v.size();
+        for (size_t i = 0; i < n; ++i) {
+            sum += v[rng() % n];
+        }
+        return sum / static_cast<double>(n);
+    }
+
+    ConfidenceInterval bootstrapMeanDiff(const std::vector<double>& a, const std::vector<double>& b,
+                                         const BootstrapOptions& options) {
+        ConfidenceInterval ci{0.0, 0.0};
+        if (a.empty() || b.empty() || options.resamples == 0) return ci;
+
+        std::vector<double> diffs(options.resamples);
+        size_t chunkCount = (options.resamples + BOOTSTRAP_CHUNK - 1) / BOOTSTRAP_CHUNK;
+        std::atomic<size_t> nextChunk(0);
+
+        auto worker = [&]() {
+            for (;;) {
+                size_t chunk = nextChunk.fetch_add(1);
+                if (chunk >= chunkCount) break;
+
+                std::mt19937_64 rng(chunkSeed(options.seed, chunk));
+                size_t begin = chunk * BOOTSTRAP_CHUNK;
+                size_t end = std::min(begin + BOOTSTRAP_CHUNK, options.resamples);
+                for (size_t r = begin; r < end; ++r) {
+                    diffs[r] = resampleMean(b, rng) - resampleMean(a, rng);
+                }
+            }
+        };
+
+        size_t threadCount = options.threads;
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min(threadCount, chunkCount);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 1; t < threadCount; ++t) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // パーセンタイル法
+        double alpha = 1.0 - options.confidence;
+        size_t last = diffs.size() - 1;
+        size_t lowIndex = static_cast<size_t>(std::floor(alpha / 2.0 * last));
+        size_t highIndex = static_cast<size_t>(std::ceil((1.0 - alpha / 2.0) * last));
+        std::nth_element(diffs.begin(), diffs.begin() + lowIndex, diffs.end());
+        ci.low = diffs[lowIndex];
+        std::nth_element(diffs.begin(), diffs.begin() + highIndex, diffs.end());
+        ci.high = diffs[highIndex];
+        return ci;
+    }
+
+    std::vector<MetricComparison> compare(const std::vector<SessionMetrics>& a,
+                                          const std::vector<SessionMetrics>& b,
+                                          const BootstrapOptions& options) {
+        std::vector<MetricComparison> results;
+
+        for (size_t m = 0; m < METRIC_COUNT; ++m) {
+            // キーのないセッションは除外
+            std::vector<double> va;
+            std::vector<double> vb;
+            for (const auto& s : a) if (s.keyCount > 0) va.push_back(metricValue(s, m));
+            for (const auto& s : b) if (s.keyCount > 0) vb.push_back(metricValue(s, m));
+
+            MetricComparison c;
+            c.name = metricName(m);
+            c.countA = va.size();
+            c.countB = vb.size();
+            c.meanA = mean(va);
+            c.meanB = mean(vb);
+            c.medianA = median(va);
+            c.medianB = median(vb);
+            c.meanDiff = c.meanB - c.meanA;
+
+            // 指標ごとに別の乱数系列を使う
+            BootstrapOptions metricOptions = options;
+            metricOptions.seed = chunkSeed(options.seed, 0x100000000ULL + m);
+            c.ci = bootstrapMeanDiff(va, vb, metricOptions);
+
+            c.test = mannWhitneyU(va, vb);
+            c.cliffsDelta = cliffsDelta(c.test, va.size(), vb.size());
+            c.cohensD = cohensD(va, vb);
+            results.push_back(c);
+        }
+
+        return results;
+    }
+
+} // namespace ABCompare
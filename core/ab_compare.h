@@ -0,0 +1,101 @@
+#pragma once
+
+// ab_compare.h
+// 2つのセッション群（キーボードA/B）の統計的比較
+//
+// 用語解説:
+// - マン・ホイットニーのU検定(Mann-Whitney U): 2群の分布の位置に差があるかを
+//   順位で調べるノンパラメトリック検定（正規分布を仮定しない）
+// - ブートストラップ(Bootstrap): 標本から復元抽出を繰り返して推定値のばらつきを求める方法
+// - 信頼区間(Confidence Interval): 真の差が入ると考えられる範囲
+// - 効果量(Effect Size): 差の大きさ。Cliffのδ（-1〜1）とCohenのd（標準偏差単位）
+//
+// ブートストラップは固定サイズのチャンクに分けて複数スレッドで実行する。
+// 各チャンクの乱数はシードとチャンク番号から決まるため、スレッド数によらず結果は同じ。
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "input_event.h"
+
+namespace ABCompare {
+
+    // 1セッションの指標
+    struct SessionMetrics {
+        double wpm;                 // 正答ベースWPM
+        double accuracy;            // 正答率（%）
+        double interKeyInterval;    // 平均キー間隔（ミリ秒）
+        size_t keyCount;            // 集計対象のキー数
+    };
+
+    // 比較する指標の数と名前
+    constexpr size_t METRIC_COUNT = 3;
+    const char* metricName(size_t index);
+    double metricValue(const SessionMetrics& metrics, size_t index);
+
+    // イベント列からセッションの指標を計算
+    // 正誤はKEY_DOWNのis_correctから数え、セッション時間は最初と最後のイベントの間とする
+    SessionMetrics measureSession(InputRecorder::EventView events);
+
+    // マン・ホイットニーのU検定の結果
+    struct MannWhitneyResult {
+        double u;           // BのU統計量（Bの値がAより大きい組の数、同順位は0.5）
+        double z;           // 正規近似のz値（同順位補正・連続性補正あり）
+        double pValue;      // 両側p値
+    };
+
+    MannWhitneyResult mannWhitneyU(const std::vector<double>& a, const std::vector<double>& b);
+
+    // Cliffのδ（BがAより大きい確率 - 小さい確率）
+    double cliffsDelta(const MannWhitneyResult& result, size_t sizeA, size_t sizeB);
+
+    // Cohenのd（(平均B - 平均A) / プールした標準偏差）
+    double cohensD(const std::vector<double>& a, const std::vector<double>& b);
+
+    // ブートストラップの設定
+    struct BootstrapOptions {
+        size_t resamples;       // 復元抽出の回数
+        uint64_t seed;          // 乱数シード（同じシードなら同じ結果）
+        size_t threads;         // スレッド数（0でハードウェアの並列数）
+        double confidence;      // 信頼水準（例: 0.95）
+
+        BootstrapOptions()
+            : resamples(10000)
+            , seed(1)
+            , threads(0)
+            , confidence(0.95)
+        {}
+    };
+
+    // 平均の差（B - A）のブートストラップ信頼区間（パーセンタイル法）
+    struct ConfidenceInterval {
+        double low;
+        double high;
+    };
+
+    ConfidenceInterval bootstrapMeanDiff(const std::vector<double>& a, const std::vector<double>& b,
+                                         const BootstrapOptions& options);
+
+    // 1指標の比較結果
+    struct MetricComparison {
+        std::string name;
+        size_t countA;
+        size_t countB;
+        double meanA;
+        double meanB;
+        double medianA;
+        double medianB;
+        double meanDiff;            // 平均B - 平均A
+        ConfidenceInterval ci;      // meanDiffの信頼区間
+        MannWhitneyResult test;
+        double cliffsDelta;
+        double cohensD;
+    };
+
+    // 全指標を比較
+    std::vector<MetricComparison> compare(const std::vector<SessionMetrics>& a,
+                                          const std::vector<SessionMetrics>& b,
+                                          const BootstrapOptions& options = BootstrapOptions());
+
+} // namespace ABCompare
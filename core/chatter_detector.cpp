@@ -0,0 +1,73 @@
+// chatter_detector.cpp
+// チャタリング・ゴースト押下検出の実装
+
+#include "chatter_detector.h"
+
+namespace InputRecorder {
+
+    ChatterDetector::ChatterDetector(const ChatterConfig& config)
+        : config_(config)
+    {
+        reset();
+    }
+
+    Suspect ChatterDetector::onKeyDown(int vk, uint64_t timestamp_us) {
+        if (vk < 0 || vk >= static_cast<int>(CHATTER_KEY_COUNT)) return Suspect::NONE;
+        KeyState& key = keys_[vk];
+
+        Suspect result = Suspect::NONE;
+
+        // 直前のKEY_UPから間を置かずに同じキーが押された
+        if (key.hasReleased && !key.held &&
+            timestamp_us - key.lastUpUs < config_.chatterWindowUs) {
+            result = Suspect::CHATTER;
+            bounceCount_[vk]++;
+            totalBounceCount_++;
+        }
+
+        key.lastDownUs = timestamp_us;
+        key.held = true;
+        key.current = result;
+        return result;
+    }
+
+    Suspect ChatterDetector::onKeyUp(int vk, uint64_t timestamp_us) {
+        if (vk < 0 || vk >= static_cast<int>(CHATTER_KEY_COUNT)) return Suspect::NONE;
+        KeyState& key = keys_[vk];
+
+        Suspect result = Suspect::NONE;
+
+        if (key.held) {
+            if (key.current != Suspect::NONE) {
+                // チャタリングだった押下の解放
+                result = key.current;
+            } else if (config_.ghostMaxDwellUs > 0 &&
+                       timestamp_us - key.lastDownUs < config_.ghostMaxDwellUs) {
+                // 押下時間が短すぎる
+                result = Suspect::GHOST;
+                bounceCount_[vk]++;
+                totalBounceCount_++;
+            }
+        }
+
+        key.lastUpUs = timestamp_us;
+        key.held = false;
+        key.hasReleased = true;
+        key.current = Suspect::NONE;
+        return result;
+    }
+
+    uint32_t ChatterDetector::getBounceCount(int vk) const {
+        if (vk < 0 || vk >= static_cast<int>(CHATTER_KEY_COUNT)) return 0;
+        return bounceCount_[vk];
+    }
+
+    void ChatterDetector::reset() {
+        for (size_t i = 0; i < CHATTER_KEY_COUNT; ++i) {
+            keys_[i] = KeyState{0, 0, false, false, Suspect::NONE};
+            bounceCount_[i] = 0;
+        }
+        totalBounceCount_ = 0;
+    }
+
+} // namespace InputRecorder
@@ -0,0 +1,72 @@
+#pragma once
+// chatter_detector.h
+// スイッチのチャタリング（バウンス）・ゴースト押下の検出
+//
+// 用語解説:
+// - チャタリング(Chatter/Bounce): 接点不良などで1回の打鍵が
+//   KEY_DOWN→KEY_UP→KEY_DOWN のように数ミリ秒以内に再入力される現象
+// - ゴースト押下(Ghost Press): 実際には押していないのに極端に短い押下が記録される現象
+//
+// 記録と同時にストリーミングで判定する。状態はキー（VK）ごとに固定長で持つ。
+
+#include <cstdint>
+#include <cstddef>
+#include "input_event.h"
+
+namespace InputRecorder {
+
+    // 検出対象とするVKの範囲
+    constexpr size_t CHATTER_KEY_COUNT = 256;
+
+    // 判定の閾値
+    struct ChatterConfig {
+        uint64_t chatterWindowUs;   // KEY_UPから同じキーのKEY_DOWNまでがこの時間未満ならチャタリング
+        uint64_t ghostMaxDwellUs;   // 押下時間がこの時間未満ならゴースト押下（0で無効）
+
+        ChatterConfig()
+            : chatterWindowUs(8000)    // 8ms
+            , ghostMaxDwellUs(3000)    // 3ms
+        {}
+    };
+
+    // チャタリング検出器
+    class ChatterDetector {
+    private:
+        struct KeyState {
+            uint64_t lastDownUs;    // 最後のKEY_DOWN時刻
+            uint64_t lastUpUs;      // 最後のKEY_UP時刻
+            bool held;              // 押下中か
+            bool hasReleased;       // 一度でもKEY_UPがあったか
+            Suspect current;        // 現在の押下に付いた判定
+        };
+
+        ChatterConfig config_;
+        KeyState keys_[CHATTER_KEY_COUNT];
+        uint32_t bounceCount_[CHATTER_KEY_COUNT];   // キー別の検出回数
+        size_t totalBounceCount_;
+
+    public:
+        explicit ChatterDetector(const ChatterConfig& config = ChatterConfig());
+
+        // KEY_DOWNを判定（CHATTERまたはNONE）
+        Suspect onKeyDown(int vk, uint64_t timestamp_us);
+
+        // KEY_UPを判定
+        // 押下時間が短すぎればGHOST、押下がチャタリングだった場合はCHATTERを返す
+        Suspect onKeyUp(int vk, uint64_t timestamp_us);
+
+        // 閾値の設定・取得
+        void setConfig(const ChatterConfig& config) { config_ = config; }
+        const ChatterConfig& getConfig() const { return config_; }
+
+        // キー別の検出回数
+        uint32_t getBounceCount(int vk) const;
+
+        // 検出回数の合計
+        size_t getTotalBounceCount() const { return totalBounceCount_; }
+
+        // 状態のリセット（閾値は保持）
+        void reset();
+    };
+
+} // namespace InputRecorder
@@ -1,29 +1,64 @@
 #include "csv_logger.h"
+#include "csv_writer.h"
+#include "session_directory.h"
+#include "csv_reader.h"
+#include "event_columns.h"
+#include "../helper/block_file.h"
 #include <fstream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <filesystem>
+#include <algorithm>
 #include <ctime>
+#include <mutex>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace fs = std::filesystem;
 
 namespace CSVLogger {
 
-    // 現在時刻からファイル名を生成
-    std::string generateFilename(const std::string& prefix) {
-        // 現在時刻を取得
+    // 実行中のプロセスID（別プロセスで同時に出力してもIDが重ならないようにする）
+    static unsigned long currentProcessId() {
+#ifdef _WIN32
+        return static_cast<unsigned long>(_getpid());
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+
+    // 新しいセッションIDを発行
+    std::string generateSessionId() {
+        static std::mutex mutex;
+        static long long lastMs = 0;
+        static unsigned long long sequence = 0;
+
+        // 現在時刻（ミリ秒）を取得
         auto now = std::chrono::system_clock::now();
-        auto now_t = std::chrono::system_clock::to_time_t(now);
-        
+        long long ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count();
+
+        unsigned long long seq;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            // 時刻が戻っても前回より小さいIDにならないようにする
+            if (ms < lastMs) ms = lastMs;
+            lastMs = ms;
+            seq = ++sequence;
+        }
+
         // ローカル時刻に変換
+        std::time_t now_t = static_cast<std::time_t>(ms / 1000);
         std::tm tm;
         //localtime_s(&tm, &now_t);
         localtime_r(&now_t, &tm); // POSIX互換
-        // YYYYMMDD_HHMMSS形式でフォーマット
+        // YYYYMMDD_HHMMSS_mmm_<プロセスID>_<連番>形式でフォーマット
         std::ostringstream oss;
-        oss << prefix << "_"
-            << std::setfill('0')
+        oss << std::setfill('0')
             << std::setw(4) << (tm.tm_year + 1900)
             << std::setw(2) << (tm.tm_mon + 1)
             << std::setw(2) << tm.tm_mday
@@ -31,13 +66,35 @@ namespace CSVLogger {
             << std::setw(2) << tm.tm_hour
             << std::setw(2) << tm.tm_min
             << std::setw(2) << tm.tm_sec
-            << ".csv";
-        
+            << "_"
+            << std::setw(3) << (ms % 1000)
+            << "_" << currentProcessId()
+            << "_" << std::setw(4) << seq;
+
         return oss.str();
     }
 
-    // イベントタイプを文字列に変換
-    std::string eventTypeToString(InputRecorder::EventType type) {
+    // セッションIDからファイル名を生成
+    std::string generateFilename(const std::string& prefix, const std::string& sessionId) {
+        return prefix + "_" + sessionId + ".csv";
+    }
+
+    // 新しいセッションIDでファイル名を生成
+    std::string generateFilename(const std::string& prefix) {
+        return generateFilename(prefix, generateSessionId());
+    }
+
+    // 省略されたセッションIDを補う
+    static std::string resolveSessionId(const std::string& sessionId) {
+        return sessionId.empty() ? generateSessionId() : sessionId;
+    }
+
+    // イベントCSVの列
+    static const char* EVENT_CSV_COLUMNS =
+        "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note";
+
+    // イベントタイプを文字列に変換（文字列リテラルを返すのでコピーは発生しない）
+    static const char* eventTypeToString(InputRecorder::EventType type) {
         switch (type) {
             case InputRecorder::EventType::KEY_DOWN: return "KEY_DOWN";
             case InputRecorder::EventType::KEY_UP: return "KEY_UP";
@@ -47,20 +104,59 @@ namespace CSVLogger {
         }
     }
 
+    // エスケープが必要な文字のCSV表現（不要ならnullptr）
+    static const char* escapeChar(char ch) {
+        switch (ch) {
+            case '\0': return "";
+            case '\n': return "\\n";
+            case '\r': return "\\r";
+            case '\t': return "\\t";
+            case ',': return "\\,";
+            case '"': return "\\\"";
+            default: return nullptr;
+        }
+    }
+
     // 文字をCSVセーフな文字列に変換
     std::string charToString(char ch) {
-        if (ch == '\0') return "";
-        if (ch == '\n') return "\\n";
-        if (ch == '\r') return "\\r";
-        if (ch == '\t') return "\\t";
-        if (ch == ',') return "\\,";
-        if (ch == '"') return "\\\"";
-        return std::string(1, ch);
+        const char* escaped = escapeChar(ch);
+        return escaped != nullptr ? std::string(escaped) : std::string(1, ch);
+    }
+
+    // イベントCSVの1行を書き込む（ヘッダーはEVENT_CSV_COLUMNS）
+    static void writeEventRow(CSVWriter::BufferedWriter& file, const InputRecorder::InputEvent& event) {
+        file.writeUnsigned(event.timestamp_us);
+        file.put(',');
+        file.write(eventTypeToString(event.type));
+        file.put(',');
+        file.writeSigned(event.vk_code);
+        file.put(',');
+        file.writeSigned(event.scan_code);
+        file.put(',');
+        const char* escaped = escapeChar(event.character);
+        if (escaped != nullptr) {
+            file.write(escaped);
+        } else {
+            file.put(event.character);
+        }
+        file.write(event.is_correct ? ",1," : ",0,");
+        file.writeUnsigned(event.inter_key_time_us);
+        file.put(',');
+        file.write(event.note);
+        file.put('\n');
     }
 
     // イベントCSV出力
     std::string writeEventCSV(const InputRecorder::Recorder& recorder,
                               const std::string& outputDir) {
+        return writeEventCSV(InputRecorder::EventView(recorder.getEvents()), outputDir);
+    }
+
+    // イベントCSV出力（イベント列から）
+    std::string writeEventCSV(InputRecorder::EventView events,
+                              const std::string& outputDir,
+                              const std::string& sessionId,
+                              bool compress) {
         // 出力ディレクトリを作成
         try {
             fs::create_directories(outputDir);
@@ -69,38 +165,226 @@ namespace CSVLogger {
         }
         
         // ファイル名を生成
-        std::string filename = generateFilename("typing_events");
+        std::string filename = generateFilename("typing_events", resolveSessionId(sessionId));
         std::string filepath = outputDir + "/" + filename;
+        if (compress) {
+            filepath += BlockFile::FILE_SUFFIX;
+        }
         
         // CSVファイルを開く
-        std::ofstream file(filepath);
-        if (!file.is_open()) {
+        // 数値はバッファに直接変換し、一杯になったらまとめて書き出す（圧縮時はバックグラウンドで圧縮）
+        CSVWriter::BufferedWriter file;
+        if (!(compress ? file.openCompressed(filepath) : file.open(filepath))) {
             return "";  // ファイルオープン失敗
         }
         
         // ヘッダー行を書き込み
-        file << "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note\n";
+        file.write(EVENT_CSV_COLUMNS);
+        file.put('\n');
         
         // イベントデータを書き込み
-        const auto& events = recorder.getEvents();
         for (const auto& event : events) {
-            file << event.timestamp_us << ","
-                 << eventTypeToString(event.type) << ","
-                 << event.vk_code << ","
-                 << event.scan_code << ","
-                 << charToString(event.character) << ","
-                 << (event.is_correct ? "1" : "0") << ","
-                 << event.inter_key_time_us << ","
-                 << event.note << "\n";
+            writeEventRow(file, event);
         }
         
-        file.close();
+        if (!file.close()) {
+            return "";  // 書き込み失敗
+        }
+        return filepath;
+    }
+
+    // イベントの列指向バイナリ出力
+    std::string writeEventColumns(InputRecorder::EventView events,
+                                  const std::string& outputDir,
+                                  const std::string& sessionId) {
+        std::error_code ec;
+        fs::create_directories(outputDir, ec);
+        if (ec) {
+            return "";  // ディレクトリ作成失敗
+        }
+
+        std::string filepath = outputDir + "/typing_events_" + resolveSessionId(sessionId) + ".evcol";
+        if (!EventColumns::writeFile(events, filepath)) {
+            return "";
+        }
         return filepath;
     }
 
+    // 今日の日付（YYYYMMDD）
+    static std::string currentDate() {
+        std::time_t now_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::tm tm;
+        localtime_r(&now_t, &tm); // POSIX互換
+        std::ostringstream oss;
+        oss << std::setfill('0')
+            << std::setw(4) << (tm.tm_year + 1900)
+            << std::setw(2) << (tm.tm_mon + 1)
+            << std::setw(2) << tm.tm_mday;
+        return oss.str();
+    }
+
+    // イベントログのパス（directory/typing_eventlog_YYYYMMDD_NNN.csv）
+    static std::string eventLogPath(const std::string& directory, const std::string& date, unsigned part) {
+        std::ostringstream oss;
+        oss << directory << "/typing_eventlog_" << date << "_"
+            << std::setfill('0') << std::setw(3) << part << ".csv";
+        return oss.str();
+    }
+
+    // イベントログ・セッションログへの追記は1つずつ行う（セッションの行・索引が混ざらないように）
+    static std::mutex appendMutex;
+
+    // イベントログに1セッション分を追記
+    std::string appendEventLog(InputRecorder::EventView events, const std::string& sessionId,
+                               const EventLogConfig& config) {
+        std::lock_guard<std::mutex> lock(appendMutex);
+
+        std::error_code ec;
+        fs::create_directories(config.directory, ec);
+        if (ec) {
+            return "";  // ディレクトリ作成失敗
+        }
+
+        // 今日の最後のファイルを探し、上限に達していれば次のファイルにする
+        std::string date = currentDate();
+        unsigned part = 1;
+        while (fs::exists(eventLogPath(config.directory, date, part + 1), ec)) {
+            part++;
+        }
+        std::string filepath = eventLogPath(config.directory, date, part);
+        uintmax_t size = fs::exists(filepath, ec) ? fs::file_size(filepath, ec) : 0;
+        if (ec) {
+            return "";
+        }
+        if (config.maxBytes > 0 && size >= config.maxBytes) {
+            filepath = eventLogPath(config.directory, date, ++part);
+            size = 0;
+        }
+
+        CSVWriter::BufferedWriter file;
+
+        // 新しいファイルにはヘッダー行を書き込む
+        if (size == 0) {
+            if (!file.open(filepath)) {
+                return "";  // ファイルオープン失敗
+            }
+            file.write("session_id,");
+            file.write(EVENT_CSV_COLUMNS);
+            file.put('\n');
+            if (!file.close()) {
+                return "";
+            }
+        }
+
+        // 追記前の大きさがこのセッションの開始位置になる
+        uintmax_t offset = fs::file_size(filepath, ec);
+        if (ec || !file.open(filepath, true)) {
+            return "";
+        }
+        for (const auto& event : events) {
+            file.write(sessionId);
+            file.put(',');
+            writeEventRow(file, event);
+        }
+        if (!file.close()) {
+            return "";  // 書き込み失敗（途中までの行は索引に載らないので読まれない）
+        }
+        uintmax_t end = fs::file_size(filepath, ec);
+        if (ec) {
+            return "";
+        }
+
+        // 索引に1行追加（ログを書き終えてから追加するので、索引の範囲は常に書き込み済み）
+        std::string indexPath = filepath + CSVReader::EVENT_LOG_INDEX_SUFFIX;
+        bool newIndex = !fs::exists(indexPath, ec);
+        std::ofstream index(indexPath, std::ios::app);
+        if (!index.is_open()) {
+            return "";
+        }
+        if (newIndex) {
+            index << "session_id,offset,bytes,events\n";
+        }
+        index << sessionId << "," << offset << "," << (end - offset) << "," << events.size() << "\n";
+        index.close();
+        if (!index) {
+            return "";
+        }
+        return filepath;
+    }
+
+    // セッションログに1セッション分のCSVを追記
+    std::string appendSessionLog(const std::string& csvPath, const std::string& sessionId,
+                                 const std::string& directory) {
+        // typing_<種類>_<sessionId>.csv → typing_<種類>log_YYYYMMDD.csv
+        std::string name = fs::path(csvPath).filename().string();
+        std::string tail = "_" + sessionId + ".csv";
+        if (name.size() <= tail.size() || name.compare(name.size() - tail.size(), tail.size(), tail) != 0) {
+            return "";
+        }
+        std::string logPath = directory + "/" + name.substr(0, name.size() - tail.size()) +
+                              "log_" + currentDate() + ".csv";
+
+        std::ifstream source(csvPath);
+        std::string header;
+        if (!source.is_open() || !std::getline(source, header)) {
+            return "";
+        }
+        if (!header.empty() && header.back() == '\r') header.pop_back();
+        header = "session_id," + header;
+
+        // 行をまとめてから1回で追記する
+        std::string rows;
+        std::string line;
+        while (std::getline(source, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            rows += sessionId;
+            rows += ',';
+            rows += line;
+            rows += '\n';
+        }
+
+        std::lock_guard<std::mutex> lock(appendMutex);
+
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        if (ec) {
+            return "";  // ディレクトリ作成失敗
+        }
+
+        // 既存のログは同じ列でなければ追記しない
+        uintmax_t size = fs::exists(logPath, ec) ? fs::file_size(logPath, ec) : 0;
+        if (ec) {
+            return "";
+        }
+        if (size > 0) {
+            std::ifstream existing(logPath);
+            std::string existingHeader;
+            std::getline(existing, existingHeader);
+            if (!existingHeader.empty() && existingHeader.back() == '\r') existingHeader.pop_back();
+            if (existingHeader != header) {
+                return "";
+            }
+        }
+
+        std::ofstream file(logPath, std::ios::app);
+        if (!file.is_open()) {
+            return "";  // ファイルオープン失敗
+        }
+        if (size == 0) {
+            file << header << "\n";
+        }
+        file << rows;
+        file.close();
+        if (!file) {
+            return "";
+        }
+        return logPath;
+    }
+
     // サマリCSV出力
     std::string writeSummaryCSV(const Statistics::StatisticsData& stats,
-                                const std::string& outputDir) {
+                                const std::string& outputDir,
+                                const std::string& sessionId) {
         // 出力ディレクトリを作成
         try {
             fs::create_directories(outputDir);
@@ -108,8 +392,9 @@ namespace CSVLogger {
             return "";  // ディレクトリ作成失敗
         }
         
-        // ファイル名を生成
-        std::string filename = generateFilename("typing_summary");
+        // ファイル名を生成（かな別CSVも同じセッションIDにする）
+        std::string id = resolveSessionId(sessionId);
+        std::string filename = generateFilename("typing_summary", id);
         std::string filepath = outputDir + "/" + filename;
         
         // CSVファイルを開く
@@ -124,41 +409,60 @@ namespace CSVLogger {
         // 基本情報
         file << "total_duration," << stats.totalDuration << ",microseconds\n";
         file << "total_duration_sec," << (stats.totalDuration / 1000000.0) << ",seconds\n";
+        
+        // これ以降の小数は固定小数点2桁
+        file << std::fixed << std::setprecision(2);
         file << "total_key_count," << stats.totalKeyCount << ",keys\n";
         file << "correct_key_count," << stats.correctKeyCount << ",keys\n";
         file << "incorrect_key_count," << stats.incorrectKeyCount << ",keys\n";
         file << "backspace_count," << stats.backspaceCount << ",keys\n";
+        file << "bounce_count," << stats.bounceCount << ",events\n";
         
         // 正答率
         double accuracy = (stats.totalKeyCount > 0) 
             ? (static_cast<double>(stats.correctKeyCount) / stats.totalKeyCount * 100.0)
             : 0.0;
-        file << "accuracy," << std::fixed << std::setprecision(2) << accuracy << ",percent\n";
+        file << "accuracy," << accuracy << ",percent\n";
         
         // WPM/CPM
-        file << "wpm_total," << std::fixed << std::setprecision(2) << stats.wpmTotal << ",words_per_minute\n";
-        file << "wpm_correct," << std::fixed << std::setprecision(2) << stats.wpmCorrect << ",words_per_minute\n";
-        file << "cpm_total," << std::fixed << std::setprecision(2) << stats.cpmTotal << ",chars_per_minute\n";
-        file << "cpm_correct," << std::fixed << std::setprecision(2) << stats.cpmCorrect << ",chars_per_minute\n";
+        file << "wpm_total," << stats.wpmTotal << ",words_per_minute\n";
+        file << "wpm_correct," << stats.wpmCorrect << ",words_per_minute\n";
+        file << "cpm_total," << stats.cpmTotal << ",chars_per_minute\n";
+        file << "cpm_correct," << stats.cpmCorrect << ",chars_per_minute\n";
         
         // キー間隔
-        file << "avg_inter_key_interval," << std::fixed << std::setprecision(2) << stats.avgInterKeyInterval << ",milliseconds\n";
-        file << "min_inter_key_interval," << std::fixed << std::setprecision(2) << stats.minInterKeyInterval << ",milliseconds\n";
-        file << "max_inter_key_interval," << std::fixed << std::setprecision(2) << stats.maxInterKeyInterval << ",milliseconds\n";
+        file << "avg_inter_key_interval," << stats.avgInterKeyInterval << ",milliseconds\n";
+        file << "min_inter_key_interval," << stats.minInterKeyInterval << ",milliseconds\n";
+        file << "max_inter_key_interval," << stats.maxInterKeyInterval << ",milliseconds\n";
+        file << "stddev_inter_key_interval," << stats.stdDevInterKeyInterval << ",milliseconds\n";
+        
+        // キーロールオーバー・同時押し
+        file << "max_simultaneous_keys," << stats.maxSimultaneousKeys << ",keys\n";
+        file << "overlap_time," << (stats.overlapTime() / 1000.0) << ",milliseconds\n";
+        for (size_t n = 1; n < Statistics::HELD_LEVEL_COUNT; ++n) {
+            file << "held_time_" << n << (n == Statistics::HELD_LEVEL_COUNT - 1 ? "plus" : "") << "_keys,"
+                 << (stats.heldTimeByCount[n] / 1000.0) << ",milliseconds\n";
+        }
+        file << "rollover_limit_hits," << stats.rolloverLimitEvents.size() << ",events\n";
+        
+        // キー別チャタリング検出数（検出されたキーのみ）
+        for (const auto& pair : stats.bounceCountByKey) {
+            file << "bounce_count_vk_" << pair.first << "," << pair.second << ",events\n";
+        }
         
         file.close();
         
         // かな別入力時間を別ファイルに出力
         if (!stats.kanaInputTime.empty()) {
-            std::string kanaFilename = generateFilename("typing_kana");
+            std::string kanaFilename = generateFilename("typing_kana", id);
             std::string kanaFilepath = outputDir + "/" + kanaFilename;
             
             std::ofstream kanaFile(kanaFilepath);
             if (kanaFile.is_open()) {
                 kanaFile << "kana,avg_input_time_ms\n";
+                kanaFile << std::fixed << std::setprecision(2);
                 for (const auto& pair : stats.kanaInputTime) {
-                    kanaFile << pair.first << "," 
-                            << std::fixed << std::setprecision(2) << pair.second << "\n";
+                    kanaFile << pair.first << "," << pair.second << "\n";
                 }
                 kanaFile.close();
             }
@@ -167,4 +471,252 @@ namespace CSVLogger {
         return filepath;
     }
 
+    // 遷移時間ヒストグラムの列名を出力（以降の小数は固定小数点2桁）
+    static void writeTransitionHeader(std::ofstream& file) {
+        file << "count,mean_ms";
+        for (size_t bin = 0; bin < Statistics::DIGRAPH_HISTOGRAM_BINS - 1; ++bin) {
+            file << ",lt_" << Statistics::DIGRAPH_HISTOGRAM_UPPER_US[bin] / 1000 << "ms";
+        }
+        file << ",ge_" << Statistics::DIGRAPH_HISTOGRAM_UPPER_US[Statistics::DIGRAPH_HISTOGRAM_BINS - 2] / 1000 << "ms\n";
+        file << std::fixed << std::setprecision(2);
+    }
+
+    // 遷移時間の集計1件を出力
+    static void writeTransitionStats(std::ofstream& file, const Statistics::TransitionStats& stats) {
+        file << stats.count << "," << stats.meanMs();
+        for (size_t bin = 0; bin < Statistics::DIGRAPH_HISTOGRAM_BINS; ++bin) {
+            file << "," << stats.histogram[bin];
+        }
+        file << "\n";
+    }
+
+    // キーペア遷移時間CSV出力
+    std::string writeDigraphCSV(const Statistics::DigraphMatrix& digraphs,
+                                const std::string& outputDir,
+                                const std::string& sessionId) {
+        // 出力ディレクトリを作成
+        try {
+            fs::create_directories(outputDir);
+        } catch (const std::exception& e) {
+            return "";  // ディレクトリ作成失敗
+        }
+        
+        std::string filepath = outputDir + "/" + generateFilename("typing_digraph", resolveSessionId(sessionId));
+        
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return "";  // ファイルオープン失敗
+        }
+        
+        // 行列のうち遷移のあったセルのみを出力
+        file << "from,to,";
+        writeTransitionHeader(file);
+        for (size_t from = 0; from < Statistics::DIGRAPH_KEY_COUNT; ++from) {
+            for (size_t to = 0; to < Statistics::DIGRAPH_KEY_COUNT; ++to) {
+                const auto& stats = digraphs.at(static_cast<char>(from), static_cast<char>(to));
+                if (stats.count == 0) continue;
+                
+                file << charToString(static_cast<char>(from)) << ","
+                     << charToString(static_cast<char>(to)) << ",";
+                writeTransitionStats(file, stats);
+            }
+        }
+        
+        file.close();
+        return filepath;
+    }
+
+    // トライグラム遷移時間CSV出力
+    std::string writeTrigramCSV(const Statistics::TrigramTable& trigrams,
+                                const std::string& outputDir,
+                                const std::string& sessionId) {
+        if (trigrams.size() == 0) {
+            return "";
+        }
+        
+        try {
+            fs::create_directories(outputDir);
+        } catch (const std::exception& e) {
+            return "";  // ディレクトリ作成失敗
+        }
+        
+        std::string filepath = outputDir + "/" + generateFilename("typing_trigram", resolveSessionId(sessionId));
+        
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return "";  // ファイルオープン失敗
+        }
+        
+        file << "first,second,third,";
+        writeTransitionHeader(file);
+        trigrams.forEach([&](char a, char b, char c, const Statistics::TransitionStats& stats) {
+            file << charToString(a) << "," << charToString(b) << "," << charToString(c) << ",";
+            writeTransitionStats(file, stats);
+        });
+        
+        file.close();
+        return filepath;
+    }
+
+    // 値の範囲を mean,min,max の3列で出力（対象サンプルがなければ空欄）
+    static void writeSeriesRange(std::ofstream& file, const Statistics::SeriesRange& range) {
+        if (range.count == 0) {
+            file << ",,";
+            return;
+        }
+        file << range.mean() << "," << range.min << "," << range.max;
+    }
+
+    // 移動窓時系列CSV出力
+    std::string writeTimeSeriesCSV(const Statistics::TimeSeries& series,
+                                   const std::string& outputDir,
+                                   const std::string& sessionId) {
+        try {
+            fs::create_directories(outputDir);
+        } catch (const std::exception& e) {
+            return "";  // ディレクトリ作成失敗
+        }
+        
+        std::string filepath = outputDir + "/" + generateFilename("typing_timeseries", resolveSessionId(sessionId));
+        
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return "";  // ファイルオープン失敗
+        }
+        
+        file << "elapsed_s,span_s,samples,"
+             << "wpm_mean,wpm_min,wpm_max,"
+             << "cpm_mean,cpm_min,cpm_max,"
+             << "accuracy_mean,accuracy_min,accuracy_max,"
+             << "median_interval_ms_mean,median_interval_ms_min,median_interval_ms_max\n";
+        
+        file << std::fixed << std::setprecision(2);
+        uint64_t origin = series.getOrigin();
+        for (const auto& bucket : series.getBuckets()) {
+            double elapsed = static_cast<double>(bucket.startTime - origin) / 1000000.0;
+            double span = static_cast<double>(bucket.endTime - bucket.startTime) / 1000000.0;
+            file << elapsed << "," << span << "," << bucket.samples << ",";
+            writeSeriesRange(file, bucket.wpm);
+            file << ",";
+            writeSeriesRange(file, bucket.cpm);
+            file << ",";
+            writeSeriesRange(file, bucket.accuracy);
+            file << ",";
+            writeSeriesRange(file, bucket.medianInterval);
+            file << "\n";
+        }
+        
+        file.close();
+        return filepath;
+    }
+
+    // 分位点スケッチを1行で出力: 名前,件数,最小,最大,平均:重み;平均:重み;...
+    // スケッチCSVは小さいので書き込みバッファも小さくてよい
+    static const size_t SKETCH_BUFFER_SIZE = 1 << 16;
+
+    static void writeSketchLine(CSVWriter::BufferedWriter& writer, const std::string& name,
+                                const Statistics::TDigest& digest) {
+        // 共有中のスケッチは書き換えない（未圧縮なら写しを圧縮する）
+        if (!digest.compressed()) {
+            Statistics::TDigest copy = digest;
+            copy.compress();
+            writeSketchLine(writer, name, copy);
+            return;
+        }
+        
+        // 値は元の値に戻せる最短の桁数で書く（読み戻して合算しても丸め誤差が積もらない）
+        writer.write(name);
+        writer.put(',');
+        writer.writeUnsigned(static_cast<uint64_t>(digest.count()));
+        writer.put(',');
+        writer.writeShortest(digest.min());
+        writer.put(',');
+        writer.writeShortest(digest.max());
+        writer.put(',');
+        const auto& centroids = digest.centroids();
+        for (size_t i = 0; i < centroids.size(); ++i) {
+            if (i > 0) writer.put(';');
+            writer.writeShortest(centroids[i].mean);
+            writer.put(':');
+            writer.writeShortest(centroids[i].weight);
+        }
+        writer.put('\n');
+    }
+
+    // 名前付きスケッチの出力
+    bool writeSketchFile(const std::map<std::string, Statistics::TDigest>& sketches,
+                         const std::string& filepath) {
+        CSVWriter::BufferedWriter writer(SKETCH_BUFFER_SIZE);
+        if (!writer.open(filepath)) {
+            return false;
+        }
+        
+        writer.write("sketch,count,min,max,centroids\n");
+        for (const auto& pair : sketches) {
+            if (pair.second.empty()) continue;
+            writeSketchLine(writer, pair.first, pair.second);
+        }
+        
+        return writer.close();
+    }
+
+    // 分位点スケッチCSV出力
+    std::string writeSketchCSV(const Statistics::SessionSketches& sketches,
+                               const std::string& outputDir,
+                               const std::string& sessionId) {
+        try {
+            fs::create_directories(outputDir);
+        } catch (const std::exception& e) {
+            return "";  // ディレクトリ作成失敗
+        }
+        
+        std::string filepath = outputDir + "/" + generateFilename("typing_sketch", resolveSessionId(sessionId));
+        
+        // 名前: interval_ms, dwell_ms, kana_ms:<かな>（単位はミリ秒）
+        std::map<std::string, Statistics::TDigest> named;
+        named.emplace("interval_ms", sketches.interval);
+        named.emplace("dwell_ms", sketches.dwell);
+        for (const auto& pair : sketches.kana) {
+            named.emplace("kana_ms:" + pair.first, pair.second);
+        }
+        
+        if (!writeSketchFile(named, filepath)) {
+            return "";  // ファイルオープン失敗
+        }
+        return filepath;
+    }
+
+    // セッション出力の目録CSV出力
+    std::string writeManifestCSV(const std::string& directory, const std::string& sessionId) {
+        std::vector<std::pair<std::string, uintmax_t>> files;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+            std::string name = entry.path().filename().string();
+            if (name == SessionDirectory::MANIFEST_FILENAME) continue;
+            files.emplace_back(name, entry.file_size(ec));
+        }
+        if (ec) {
+            return "";  // ディレクトリ読み込み失敗
+        }
+        std::sort(files.begin(), files.end());
+
+        std::string filepath = directory + "/" + SessionDirectory::MANIFEST_FILENAME;
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return "";  // ファイルオープン失敗
+        }
+
+        file << "session_id,file,bytes\n";
+        for (const auto& pair : files) {
+            file << sessionId << "," << pair.first << "," << pair.second << "\n";
+        }
+
+        file.close();
+        if (!file) {
+            return "";  // 書き込み失敗
+        }
+        return filepath;
+    }
+
 } // namespace CSVLogger
@@ -7,9 +7,17 @@
 // - CSV (Comma-Separated Values): カンマ区切りのテキストファイル形式
 // - イベントCSV: キー入力イベントの詳細を記録
 // - サマリCSV: セッション全体の統計情報を記録
+// - セッションID: 1回の計測を識別する文字列。同じセッションのファイルは同じIDで終わる
+// - イベントログ: 複数セッションのイベントを1つのファイルに追記していくCSV
+// - セッションログ: 複数セッションのサマリなどを日ごとに1つのファイルに追記していくCSV
+//
+// 各出力関数のsessionIdを省略すると、呼び出しごとに新しいセッションIDを発行する。
+// 1セッション分のファイルをまとめて出力するときは、同じIDを渡すこと。
 
 #include <string>
 #include <vector>
+#include <map>
+#include <cstdint>
 #include "input_recorder.h"
 #include "statistics.h"
 
@@ -22,16 +30,107 @@ namespace CSVLogger {
     std::string writeEventCSV(const InputRecorder::Recorder& recorder, 
                               const std::string& outputDir = "output");
 
+    // イベントCSV出力（記録済みのイベント列から）
+    // events: Recorder::takeEvents()で取り出したイベントなど
+    // compress: trueならブロック単位で圧縮する（typing_events_<sessionId>.csv.lzb、BlockFile形式）
+    //           CSVReader::readEventCSVはどちらの形式も読み込める
+    std::string writeEventCSV(InputRecorder::EventView events,
+                              const std::string& outputDir = "output",
+                              const std::string& sessionId = "",
+                              bool compress = false);
+
+    // イベントの列指向バイナリ出力（EventColumns形式、分析で一部の列だけを読む用）
+    // ファイル名: typing_events_<sessionId>.evcol
+    // 戻り値: 出力ファイルパス（失敗時は空文字列）
+    std::string writeEventColumns(InputRecorder::EventView events,
+                                  const std::string& outputDir = "output",
+                                  const std::string& sessionId = "");
+
+    // 複数セッションのイベントログの設定
+    struct EventLogConfig {
+        std::string directory = "output";
+        uint64_t maxBytes = 256ULL << 20;   // 1ファイルの上限（超えたら次のファイル。0なら日ごとのみ）
+    };
+
+    // 複数セッションのイベントログ（追記専用）に1セッション分を追記
+    // ログ: directory/typing_eventlog_YYYYMMDD_NNN.csv（日ごと・上限ごとに新しいファイル）
+    //       イベントCSVの列の前にsession_id列を付ける。1セッションは1つのファイルに収める
+    // 索引: ログのパス + CSVReader::EVENT_LOG_INDEX_SUFFIX（session_id,offset,bytes,events）
+    //       セッションの行の開始位置とバイト数。CSVReader::readEventLogSessionで直接読み込める
+    // 同じプロセス内の追記は順番に行う（複数のプロセスから同じディレクトリへの追記は非対応）
+    // 戻り値: 追記したログファイルのパス（失敗時は空文字列）
+    std::string appendEventLog(InputRecorder::EventView events, const std::string& sessionId,
+                               const EventLogConfig& config = EventLogConfig());
+
+    // 1セッション分の小さなCSV（サマリ・かな別・スケッチなど）を日ごとのセッションログに追記
+    // csvPath: 書き終えたtyping_<種類>_<sessionId>.csv
+    // ログ: directory/typing_<種類>log_YYYYMMDD.csv（例: typing_summarylog_20251113.csv）
+    //       元のCSVの列の前にsession_id列を付ける。ヘッダー行は新しいファイルにだけ書く
+    // イベントログと同じく同じプロセス内の追記は順番に行う
+    // 戻り値: 追記したログファイルのパス（失敗時・ログのヘッダーが異なる場合は空文字列）
+    std::string appendSessionLog(const std::string& csvPath, const std::string& sessionId,
+                                 const std::string& directory = "output");
+
     // サマリCSV出力（Phase 4-2で実装）
     // stats: StatisticsDataインスタンス
     // outputDir: 出力ディレクトリ（デフォルト: "output"）
+    // sessionId: ファイル名に付けるセッションID（かな別CSVも同じIDで出力）
     // 戻り値: 出力ファイルパス（失敗時は空文字列）
     std::string writeSummaryCSV(const Statistics::StatisticsData& stats,
-                                const std::string& outputDir = "output");
+                                const std::string& outputDir = "output",
+                                const std::string& sessionId = "");
+
+    // キーペア遷移時間CSV出力
+    // digraphs: Calculator::getDigraphMatrix()の結果
+    // outputDir: 出力ディレクトリ（デフォルト: "output"）
+    // 戻り値: 出力ファイルパス（失敗時は空文字列）
+    std::string writeDigraphCSV(const Statistics::DigraphMatrix& digraphs,
+                                const std::string& outputDir = "output",
+                                const std::string& sessionId = "");
+
+    // トライグラム遷移時間CSV出力（登録がなければ出力しない）
+    // 戻り値: 出力ファイルパス（失敗時・出力なしは空文字列）
+    std::string writeTrigramCSV(const Statistics::TrigramTable& trigrams,
+                                const std::string& outputDir = "output",
+                                const std::string& sessionId = "");
+
+    // 移動窓時系列CSV出力（WPM/CPM・正確率・キー間隔中央値）
+    // series: Calculator::getTimeSeries()の結果
+    // 戻り値: 出力ファイルパス（失敗時は空文字列）
+    std::string writeTimeSeriesCSV(const Statistics::TimeSeries& series,
+                                   const std::string& outputDir = "output",
+                                   const std::string& sessionId = "");
+
+    // 分位点スケッチCSV出力（キー間隔・押下時間・かな別入力時間）
+    // sketches: Calculator::getSketches()の結果
+    // 戻り値: 出力ファイルパス（失敗時は空文字列）
+    std::string writeSketchCSV(const Statistics::SessionSketches& sketches,
+                               const std::string& outputDir = "output",
+                               const std::string& sessionId = "");
+
+    // 名前付きスケッチを指定したパスに出力（マージ結果の保存用）
+    // 戻り値: 成功時true
+    bool writeSketchFile(const std::map<std::string, Statistics::TDigest>& sketches,
+                         const std::string& filepath);
+
+    // セッション出力の目録CSV（session_id,file,bytes）を出力
+    // directory内の通常ファイル（目録自身を除く）をファイル名順に記録する
+    // ファイル名はSessionDirectory::MANIFEST_FILENAME
+    // 戻り値: 出力ファイルパス（失敗時は空文字列）
+    std::string writeManifestCSV(const std::string& directory, const std::string& sessionId);
+
+    // 新しいセッションIDを発行
+    // 戻り値: "YYYYMMDD_HHMMSS_mmm_<プロセスID>_<連番>"
+    // 同じプロセス内では必ず異なり、発行順に大きくなる（時刻が戻っても前回の時刻を使う）
+    std::string generateSessionId();
+
+    // セッションIDからファイル名を生成
+    // 戻り値: "prefix_<sessionId>.csv"
+    std::string generateFilename(const std::string& prefix, const std::string& sessionId);
 
-    // 現在時刻からファイル名を生成
+    // 新しいセッションIDでファイル名を生成
     // prefix: ファイル名のプレフィックス（例: "typing_events"）
-    // 戻り値: "prefix_YYYYMMDD_HHMMSS.csv"
+    // 戻り値: "prefix_YYYYMMDD_HHMMSS_mmm_<プロセスID>_<連番>.csv"
     std::string generateFilename(const std::string& prefix);
 
 } // namespace CSVLogger
@@ -0,0 +1,558 @@
+// csv_reader.cpp
+// CSV入力の実装
+
+#include "csv_reader.h"
+#include "session_directory.h"
+#include "../helper/block_file.h"
+#include "../helper/mapped_file.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+// SSE2はx86-64では常に使えるため、実行時の判定はしない
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define CSV_READER_HAS_SSE2 1
+#include <emmintrin.h>
+#else
+#define CSV_READER_HAS_SSE2 0
+#endif
+
+namespace fs = std::filesystem;
+
+namespace CSVReader {
+
+    // イベントCSVのヘッダー（CSVLogger::writeEventCSVと同じ）
+    static const char* EVENT_CSV_HEADER =
+        "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note";
+
+    // 区切り文字までを切り出す（posは次の列の先頭に進む）
+    static bool nextField(const std::string& line, size_t& pos, std::string& field) {
+        if (pos > line.size()) return false;
+        size_t comma = line.find(',', pos);
+        if (comma == std::string::npos) {
+            field.assign(line, pos, std::string::npos);
+            pos = line.size() + 1;
+        } else {
+            field.assign(line, pos, comma - pos);
+            pos = comma + 1;
+        }
+        return true;
+    }
+
+    static bool parseUnsigned(const std::string& text, uint64_t& value) {
+        if (text.empty()) return false;
+        char* end = nullptr;
+        value = std::strtoull(text.c_str(), &end, 10);
+        return end == text.c_str() + text.size();
+    }
+
+    // ---- イベントCSV ----
+    // 行・列はマップしたファイル上のポインタ範囲のまま解析し、列ごとの文字列は作らない
+
+    // [p, end)から改行を探す（なければend）
+    // SSE2で16バイトずつ比較する。改行の間隔は平均40バイト程度なので、memchrの呼び出しより速い
+    static const char* findNewline(const char* p, const char* end) {
+#if CSV_READER_HAS_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+            if (mask != 0) {
+                return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && *p != '\n') ++p;
+        return p;
+    }
+
+    // [p, end)の改行の数（行数の見積もり用）
+    static size_t countNewlines(const char* p, const char* end) {
+        size_t count = 0;
+#if CSV_READER_HAS_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            count += __builtin_popcount(static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline))));
+            p += 16;
+        }
+#endif
+        for (; p < end; ++p) {
+            if (*p == '\n') ++count;
+        }
+        return count;
+    }
+
+    // 区切り文字までを切り出す（pは次の列の先頭に進む。最後の列ならendの1つ先を指す）
+    static bool takeField(const char*& p, const char* end, std::string_view& field) {
+        if (p > end) return false;
+        const char* comma = static_cast<const char*>(std::memchr(p, ',', static_cast<size_t>(end - p)));
+        if (comma == nullptr) {
+            field = std::string_view(p, static_cast<size_t>(end - p));
+            p = end + 1;
+        } else {
+            field = std::string_view(p, static_cast<size_t>(comma - p));
+            p = comma + 1;
+        }
+        return true;
+    }
+
+    template <typename T>
+    static bool parseNumber(std::string_view text, T& value) {
+        if (text.empty()) return false;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    static bool parseEventType(std::string_view text, InputRecorder::EventType& type) {
+        if (text == "KEY_DOWN") type = InputRecorder::EventType::KEY_DOWN;
+        else if (text == "KEY_UP") type = InputRecorder::EventType::KEY_UP;
+        else if (text == "BACKSPACE") type = InputRecorder::EventType::BACKSPACE;
+        else if (text == "CORRECTION") type = InputRecorder::EventType::CORRECTION;
+        else return false;
+        return true;
+    }
+
+    // 文字の列（CSVLogger::charToStringの逆変換）
+    // "\," はカンマのエスケープとバックスラッシュ文字の直後の区切りの両方があり得るため、
+    // 続く列（is_correct）が空でないことを使って区別する
+    static bool parseCharacter(const char*& p, const char* end, char& ch) {
+        if (p >= end) return false;
+        size_t rest = static_cast<size_t>(end - p);
+
+        if (p[0] == ',') {
+            ch = '\0';
+            p += 1;
+            return true;
+        }
+
+        if (p[0] == '\\' && rest > 2 && p[2] == ',') {
+            switch (p[1]) {
+                case 'n': ch = '\n'; p += 3; return true;
+                case 'r': ch = '\r'; p += 3; return true;
+                case 't': ch = '\t'; p += 3; return true;
+                case '"': ch = '"'; p += 3; return true;
+                case ',': ch = ','; p += 3; return true;
+                default: break;
+            }
+        }
+
+        if (rest > 1 && p[1] == ',') {
+            ch = p[0];
+            p += 2;
+            return true;
+        }
+        return false;
+    }
+
+    // イベントCSVの1行（[begin, end)、改行を含まない）を解析
+    static bool parseEventRecord(const char* begin, const char* end, InputRecorder::InputEvent& event) {
+        const char* p = begin;
+        std::string_view field;
+
+        uint64_t timestamp = 0;
+        if (!takeField(p, end, field) || !parseNumber(field, timestamp)) return false;
+
+        InputRecorder::EventType type;
+        if (!takeField(p, end, field) || !parseEventType(field, type)) return false;
+
+        int vk = 0;
+        int scan = 0;
+        if (!takeField(p, end, field) || !parseNumber(field, vk)) return false;
+        if (!takeField(p, end, field) || !parseNumber(field, scan)) return false;
+
+        char ch = '\0';
+        if (!parseCharacter(p, end, ch)) return false;
+
+        if (!takeField(p, end, field) || (field != "0" && field != "1")) return false;
+        bool isCorrect = (field == "1");
+
+        uint64_t interKey = 0;
+        if (!takeField(p, end, field) || !parseNumber(field, interKey)) return false;
+
+        // 備考は行末まで（CRLFのCRは除く）
+        std::string_view note = p <= end ? std::string_view(p, static_cast<size_t>(end - p)) : std::string_view();
+        if (!note.empty() && note.back() == '\r') note.remove_suffix(1);
+
+        event.type = type;
+        event.timestamp_us = timestamp;
+        event.vk_code = vk;
+        event.scan_code = scan;
+        event.character = ch;
+        event.is_correct = isCorrect;
+        event.inter_key_time_us = interKey;
+        if (note == "chatter") {
+            event.suspect = InputRecorder::Suspect::CHATTER;
+        } else if (note == "ghost") {
+            event.suspect = InputRecorder::Suspect::GHOST;
+        } else {
+            event.suspect = InputRecorder::Suspect::NONE;
+        }
+        event.note.assign(note.data(), note.size());
+        return true;
+    }
+
+    bool parseEventLine(const std::string& line, InputRecorder::InputEvent& event) {
+        return parseEventRecord(line.data(), line.data() + line.size(), event);
+    }
+
+    // [p, end)の各行を解析して追加（行頭がprefixでない行があればfalse。prefixは取り除いて解析）
+    static bool parseEventLines(const char* p, const char* end, std::string_view prefix,
+                                std::vector<InputRecorder::InputEvent>& events) {
+        events.reserve(events.size() + countNewlines(p, end) + 1);
+
+        while (p < end) {
+            const char* lineEnd = findNewline(p, end);
+            const char* lineBegin = p;
+            p = lineEnd + 1;
+
+            if (lineEnd > lineBegin && lineEnd[-1] == '\r') --lineEnd;
+            if (lineEnd == lineBegin) continue;
+            if (!prefix.empty()) {
+                if (static_cast<size_t>(lineEnd - lineBegin) < prefix.size() ||
+                    std::string_view(lineBegin, prefix.size()) != prefix) {
+                    return false;
+                }
+                lineBegin += prefix.size();
+            }
+            // 末尾に直接解析し、解析できなければ取り除く（イベントの移動を省く）
+            events.emplace_back();
+            if (!parseEventRecord(lineBegin, lineEnd, events.back())) {
+                events.pop_back();
+            }
+        }
+        return true;
+    }
+
+    // イベントCSVの内容（ヘッダー行から）を解析
+    static bool parseEventCSV(const char* p, const char* end, std::vector<InputRecorder::InputEvent>& events) {
+        if (p == end) {
+            return false;
+        }
+
+        // ヘッダー行
+        const char* headerEnd = findNewline(p, end);
+        std::string_view header(p, static_cast<size_t>(headerEnd - p));
+        if (!header.empty() && header.back() == '\r') header.remove_suffix(1);
+        if (header != EVENT_CSV_HEADER) {
+            return false;  // イベントCSVではない
+        }
+
+        parseEventLines(headerEnd + (headerEnd < end ? 1 : 0), end, std::string_view(), events);
+        return true;
+    }
+
+    bool readEventCSV(const std::string& filepath, std::vector<InputRecorder::InputEvent>& events) {
+        // 圧縮したファイルは全ブロックを復号してから解析する
+        if (BlockFile::isCompressedPath(filepath)) {
+            BlockFile::Reader reader;
+            std::vector<char> text;
+            if (!reader.open(filepath) || !reader.readAll(text)) {
+                return false;
+            }
+            return parseEventCSV(text.data(), text.data() + text.size(), events);
+        }
+
+        FileMapping::MappedFile file;
+        if (!file.open(filepath)) {
+            return false;
+        }
+        return parseEventCSV(file.data(), file.data() + file.size(), events);
+    }
+
+    // ---- イベントログ ----
+
+    static const char* EVENT_LOG_INDEX_HEADER = "session_id,offset,bytes,events";
+
+    bool readEventLogIndex(const std::string& indexPath, std::vector<EventLogEntry>& entries) {
+        std::ifstream file(indexPath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != EVENT_LOG_INDEX_HEADER) {
+            return false;
+        }
+
+        std::string field;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            EventLogEntry entry;
+            size_t pos = 0;
+            if (!nextField(line, pos, entry.sessionId) || entry.sessionId.empty()) continue;
+            if (!nextField(line, pos, field) || !parseUnsigned(field, entry.offset)) continue;
+            if (!nextField(line, pos, field) || !parseUnsigned(field, entry.bytes)) continue;
+            if (!nextField(line, pos, field) || !parseUnsigned(field, entry.eventCount)) continue;
+            entries.push_back(std::move(entry));
+        }
+        return true;
+    }
+
+    bool readEventLogSession(const std::string& logPath, const EventLogEntry& entry,
+                             std::vector<InputRecorder::InputEvent>& events) {
+        // 索引の範囲だけを解析する
+        FileMapping::MappedFile file;
+        if (!file.open(logPath)) {
+            return false;
+        }
+        if (entry.offset > file.size() || entry.bytes > file.size() - entry.offset) {
+            return false;  // ログより後ろを指している
+        }
+        const char* begin = file.data() + entry.offset;
+
+        // 索引が別のセッションを指していれば読まない
+        const std::string prefix = entry.sessionId + ",";
+        return parseEventLines(begin, begin + entry.bytes, prefix, events);
+    }
+
+    // CSV（圧縮した.csv.lzbを含む）のファイル名か
+    static bool isCSVName(const std::string& name) {
+        fs::path path(name);
+        if (BlockFile::isCompressedPath(name)) {
+            path = path.stem();
+        }
+        return path.extension() == ".csv";
+    }
+
+    // ディレクトリ直下のファイルを接頭辞で探して追加
+    static void appendCSV(const fs::path& directory, const std::string& prefix,
+                          std::vector<std::string>& paths) {
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+            std::string name = entry.path().filename().string();
+            if (name.rfind(prefix, 0) == 0 && isCSVName(name)) {
+                paths.push_back(entry.path().string());
+            }
+        }
+    }
+
+    std::vector<std::string> listCSV(const std::string& directory, const std::string& prefix) {
+        std::vector<std::string> paths;
+
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec)) {
+            return paths;
+        }
+
+        appendCSV(directory, prefix, paths);
+
+        // セッションディレクトリの中も探す（書き込み中の作業ディレクトリは名前が異なるので含まれない）
+        const std::string sessionPrefix = SessionDirectory::DIRECTORY_PREFIX;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (!entry.is_directory(ec)) continue;
+            if (entry.path().filename().string().rfind(sessionPrefix, 0) != 0) continue;
+            appendCSV(entry.path(), prefix, paths);
+        }
+
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::vector<std::string> listEventCSV(const std::string& directory) {
+        return listCSV(directory, "typing_events_");
+    }
+
+    static bool parseDouble(const char* begin, const char* end, double& value) {
+        if (begin == end) return false;
+        std::string text(begin, end);
+        char* stop = nullptr;
+        value = std::strtod(text.c_str(), &stop);
+        return stop == text.c_str() + text.size();
+    }
+
+    // ---- サマリ・かな別 ----
+
+    static const char* SUMMARY_CSV_HEADER = "metric,value,unit";
+    static const char* KANA_CSV_HEADER = "kana,avg_input_time_ms";
+
+    // 「名前,数値[,...]」形式のCSVを読み込む（1列目 → 2列目の数値）
+    static bool readNamedValues(const std::string& filepath, const char* header,
+                                std::map<std::string, double>& values) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != header) {
+            return false;
+        }
+
+        std::string name;
+        std::string field;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t pos = 0;
+            double value = 0.0;
+            if (!nextField(line, pos, name) || name.empty()) continue;
+            if (!nextField(line, pos, field)) continue;
+            if (!parseDouble(field.data(), field.data() + field.size(), value)) continue;
+            values[name] = value;
+        }
+        return true;
+    }
+
+    bool readSummaryCSV(const std::string& filepath, std::map<std::string, double>& metrics) {
+        return readNamedValues(filepath, SUMMARY_CSV_HEADER, metrics);
+    }
+
+    bool readKanaCSV(const std::string& filepath, std::map<std::string, double>& kanaTimes) {
+        return readNamedValues(filepath, KANA_CSV_HEADER, kanaTimes);
+    }
+
+    // セッションログの「session_id,名前,数値[,...]」形式を読み込む
+    static bool readNamedValuesLog(const std::string& filepath, const char* header,
+                                   std::map<std::string, std::map<std::string, double>>& bySession) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != std::string("session_id,") + header) {
+            return false;
+        }
+
+        std::string sessionId;
+        std::string name;
+        std::string field;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t pos = 0;
+            double value = 0.0;
+            if (!nextField(line, pos, sessionId) || sessionId.empty()) continue;
+            if (!nextField(line, pos, name) || name.empty()) continue;
+            if (!nextField(line, pos, field)) continue;
+            if (!parseDouble(field.data(), field.data() + field.size(), value)) continue;
+            bySession[sessionId][name] = value;
+        }
+        return true;
+    }
+
+    bool readSummaryLog(const std::string& filepath,
+                        std::map<std::string, std::map<std::string, double>>& bySession) {
+        return readNamedValuesLog(filepath, SUMMARY_CSV_HEADER, bySession);
+    }
+
+    bool readKanaLog(const std::string& filepath,
+                     std::map<std::string, std::map<std::string, double>>& bySession) {
+        return readNamedValuesLog(filepath, KANA_CSV_HEADER, bySession);
+    }
+
+    // ---- 目録 ----
+
+    static const char* MANIFEST_CSV_HEADER = "session_id,file,bytes";
+
+    bool readManifestCSV(const std::string& filepath, std::vector<ManifestEntry>& entries) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != MANIFEST_CSV_HEADER) {
+            return false;
+        }
+
+        std::string field;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            ManifestEntry entry;
+            size_t pos = 0;
+            if (!nextField(line, pos, entry.sessionId)) continue;
+            if (!nextField(line, pos, entry.file) || entry.file.empty()) continue;
+            if (!nextField(line, pos, field) || !parseUnsigned(field, entry.bytes)) continue;
+            entries.push_back(std::move(entry));
+        }
+        return true;
+    }
+
+    // ---- 分位点スケッチ ----
+
+    static const char* SKETCH_CSV_HEADER = "sketch,count,min,max,centroids";
+
+    bool parseSketchLine(const std::string& line, std::string& name, Statistics::TDigest& digest) {
+        size_t pos = 0;
+        std::string field;
+
+        // 名前（かなを含む）・件数・最小・最大
+        if (!nextField(line, pos, name) || name.empty()) return false;
+        uint64_t count = 0;
+        if (!nextField(line, pos, field) || !parseUnsigned(field, count)) return false;
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        if (!nextField(line, pos, field) || !parseDouble(field.data(), field.data() + field.size(), minValue)) return false;
+        if (!nextField(line, pos, field) || !parseDouble(field.data(), field.data() + field.size(), maxValue)) return false;
+
+        // セントロイド列: 平均:重み;平均:重み;...
+        std::string list = pos <= line.size() ? line.substr(pos) : std::string();
+        if (!list.empty() && list.back() == '\r') list.pop_back();
+
+        std::vector<Statistics::TDigest::Centroid> centroids;
+        const char* p = list.data();
+        const char* end = p + list.size();
+        while (p < end) {
+            const char* itemEnd = std::find(p, end, ';');
+            const char* colon = std::find(p, itemEnd, ':');
+            if (colon == itemEnd) return false;
+
+            Statistics::TDigest::Centroid c;
+            if (!parseDouble(p, colon, c.mean) || !parseDouble(colon + 1, itemEnd, c.weight)) return false;
+            centroids.push_back(c);
+
+            p = itemEnd < end ? itemEnd + 1 : end;
+        }
+
+        digest = Statistics::TDigest::fromCentroids(centroids, minValue, maxValue);
+        return true;
+    }
+
+    bool readSketchCSV(const std::string& filepath, std::map<std::string, Statistics::TDigest>& sketches) {
+        std::ifstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != SKETCH_CSV_HEADER) {
+            return false;  // スケッチCSVではない
+        }
+
+        std::string name;
+        Statistics::TDigest digest;
+        while (std::getline(file, line)) {
+            if (parseSketchLine(line, name, digest)) {
+                sketches[name].merge(digest);
+            }
+        }
+        return true;
+    }
+
+} // namespace CSVReader
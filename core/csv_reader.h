@@ -0,0 +1,102 @@
+#pragma once
+
+// csv_reader.h
+// CSV入力（CSVLoggerで出力したファイルの読み込み）
+//
+// イベントCSVを読み込み、記録時と同じInputEventの列に戻す。
+// 文字列のエスケープ（\, \n など）はCSVLogger::charToStringの逆変換を行う。
+//
+// イベントCSVはファイルをメモリマップし、改行をSSE2で探して、各列をstd::from_charsで
+// マップ上から直接変換する（列ごとの文字列は作らない）。1コアで300MB/s程度。
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include "input_event.h"
+#include "tdigest.h"
+
+namespace CSVReader {
+
+    // イベントCSVの1行（ヘッダーを除く）を解析
+    // 戻り値: 成功時true（列不足・数値の解析失敗はfalse）
+    bool parseEventLine(const std::string& line, InputRecorder::InputEvent& event);
+
+    // イベントCSV読み込み
+    // filepath: typing_events_*.csv のパス（.csv.lzbならブロックを復号してから読む）
+    // events: 読み込んだイベントを末尾に追加
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse。解析できない行は読み飛ばす）
+    bool readEventCSV(const std::string& filepath, std::vector<InputRecorder::InputEvent>& events);
+
+    // イベントログの索引ファイルの接尾辞（ログのパスの後ろに付ける）
+    constexpr const char* EVENT_LOG_INDEX_SUFFIX = ".idx";
+
+    // イベントログの索引の1行（1セッション分の位置）
+    struct EventLogEntry {
+        std::string sessionId;
+        uint64_t offset = 0;        // ログ内の開始位置（バイト）
+        uint64_t bytes = 0;         // セッションの行の合計バイト数
+        uint64_t eventCount = 0;
+    };
+
+    // イベントログの索引読み込み（session_id,offset,bytes,events）
+    // entries: 読み込んだ行を末尾に追加（解析できない行は読み飛ばす）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readEventLogIndex(const std::string& indexPath, std::vector<EventLogEntry>& entries);
+
+    // イベントログから1セッション分を読み込み（索引の範囲だけを読む）
+    // logPath: typing_eventlog_*.csv のパス
+    // events: 読み込んだイベントを末尾に追加
+    // 戻り値: 成功時true（範囲を読めない・範囲内にentry.sessionId以外の行がある場合はfalse）
+    bool readEventLogSession(const std::string& logPath, const EventLogEntry& entry,
+                             std::vector<InputRecorder::InputEvent>& events);
+
+    // サマリCSV読み込み（metric,value,unit）
+    // metrics: 指標名 → 値（数値でない行は読み飛ばす）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readSummaryCSV(const std::string& filepath, std::map<std::string, double>& metrics);
+
+    // かな別CSV読み込み（kana,avg_input_time_ms）
+    // kanaTimes: かな → 平均入力時間（ミリ秒）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readKanaCSV(const std::string& filepath, std::map<std::string, double>& kanaTimes);
+
+    // セッションログ（CSVLogger::appendSessionLog）のサマリ・かな別の読み込み
+    // bySession: セッションID → 指標名（かな） → 値（同じセッションの行は合わせる）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readSummaryLog(const std::string& filepath,
+                        std::map<std::string, std::map<std::string, double>>& bySession);
+    bool readKanaLog(const std::string& filepath,
+                     std::map<std::string, std::map<std::string, double>>& bySession);
+
+    // 分位点スケッチCSV（CSVLogger::writeSketchCSVの出力）の1行を解析
+    // 戻り値: 成功時true
+    bool parseSketchLine(const std::string& line, std::string& name, Statistics::TDigest& digest);
+
+    // 分位点スケッチCSV読み込み
+    // sketches: 同じ名前のスケッチがあれば合算する（複数ファイルを続けて読み込める）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readSketchCSV(const std::string& filepath, std::map<std::string, Statistics::TDigest>& sketches);
+
+    // 目録CSV（session_id,file,bytes）の1行
+    struct ManifestEntry {
+        std::string sessionId;
+        std::string file;       // セッションディレクトリ内のファイル名
+        uint64_t bytes = 0;
+    };
+
+    // 目録CSV読み込み
+    // entries: 読み込んだ行を末尾に追加（解析できない行は読み飛ばす）
+    // 戻り値: 成功時true（ファイルが開けない・ヘッダーが異なる場合はfalse）
+    bool readManifestCSV(const std::string& filepath, std::vector<ManifestEntry>& entries);
+
+    // ディレクトリ内のCSV（圧縮した.csv.lzbを含む）を接頭辞で列挙（パス順）
+    // セッションディレクトリ（session_*）の中のファイルも含める
+    // prefix: 例 "typing_sketch_"
+    std::vector<std::string> listCSV(const std::string& directory, const std::string& prefix);
+
+    // ディレクトリ内のイベントCSVを列挙（パス順）
+    // 戻り値: typing_events_*.csv（圧縮した.csv.lzbを含む）のパス（ディレクトリがなければ空）
+    std::vector<std::string> listEventCSV(const std::string& directory);
+
+} // namespace CSVReader
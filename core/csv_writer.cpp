@@ -0,0 +1,138 @@
+// csv_writer.cpp
+// バッファ付きCSV書き込みの実装
+
+#include "csv_writer.h"
+#include "../helper/block_file.h"
+#include <charconv>
+#include <cstring>
+
+namespace CSVWriter {
+
+    // 数値1つの最大文字数（uint64_tは20桁、doubleの固定小数点は桁数に応じて伸びる）
+    static const size_t MAX_INTEGER_CHARS = 24;
+    static const size_t MAX_FIXED_CHARS = 352;
+    static const size_t MAX_SHORTEST_CHARS = 32;
+
+    BufferedWriter::BufferedWriter(size_t bufferSize)
+        : file_(nullptr)
+        , buffer_(bufferSize < MAX_FIXED_CHARS ? MAX_FIXED_CHARS : bufferSize)
+        , used_(0)
+        , failed_(false)
+    {
+    }
+
+    BufferedWriter::~BufferedWriter() {
+        close();
+    }
+
+    bool BufferedWriter::open(const std::string& filepath, bool append) {
+        close();
+        // テキストモード（Windowsでは従来のofstreamと同じく改行がCRLFになる）
+        file_ = std::fopen(filepath.c_str(), append ? "a" : "w");
+        if (file_ == nullptr) {
+            return false;
+        }
+        // 自前のバッファでまとめて書くので、標準ライブラリ側のバッファは使わない
+        std::setvbuf(file_, nullptr, _IONBF, 0);
+        used_ = 0;
+        failed_ = false;
+        return true;
+    }
+
+    bool BufferedWriter::openCompressed(const std::string& filepath) {
+        close();
+        auto compressed = std::make_unique<BlockFile::Writer>();
+        if (!compressed->open(filepath)) {
+            return false;
+        }
+        compressed_ = std::move(compressed);
+        used_ = 0;
+        failed_ = false;
+        return true;
+    }
+
+    // ファイル（圧縮時はBlockFile::Writer）に書き出す
+    void BufferedWriter::writeOut(const char* data, size_t size) {
+        if (compressed_ != nullptr) {
+            compressed_->write(data, size);
+        } else if (file_ == nullptr || std::fwrite(data, 1, size, file_) != size) {
+            failed_ = true;
+        }
+    }
+
+    void BufferedWriter::write(std::string_view text) {
+        if (text.size() > buffer_.size() - used_) {
+            flush();
+            // バッファより大きい文字列は直接書き出す
+            if (text.size() > buffer_.size()) {
+                writeOut(text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + used_, text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void BufferedWriter::writeUnsigned(uint64_t value) {
+        reserve(MAX_INTEGER_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), value);
+        used_ += result.ptr - begin;
+    }
+
+    void BufferedWriter::writeSigned(int64_t value) {
+        reserve(MAX_INTEGER_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), value);
+        used_ += result.ptr - begin;
+    }
+
+    void BufferedWriter::writeFixed(double value, int precision) {
+        reserve(MAX_FIXED_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), value,
+                                    std::chars_format::fixed, precision);
+        if (result.ec == std::errc()) {
+            used_ += result.ptr - begin;
+        }
+    }
+
+    void BufferedWriter::writeShortest(double value) {
+        reserve(MAX_SHORTEST_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), value);
+        if (result.ec == std::errc()) {
+            used_ += result.ptr - begin;
+        }
+    }
+
+    bool BufferedWriter::flush() {
+        if (used_ > 0) {
+            writeOut(buffer_.data(), used_);
+            used_ = 0;
+        }
+        return !failed_;
+    }
+
+    bool BufferedWriter::close() {
+        if (compressed_ != nullptr) {
+            flush();
+            if (!compressed_->close()) {
+                failed_ = true;
+            }
+            compressed_.reset();
+            return !failed_;
+        }
+        if (file_ == nullptr) {
+            used_ = 0;
+            return !failed_;
+        }
+        flush();
+        if (std::fclose(file_) != 0) {
+            failed_ = true;
+        }
+        file_ = nullptr;
+        return !failed_;
+    }
+
+} // namespace CSVWriter
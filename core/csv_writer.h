@@ -0,0 +1,92 @@
+#pragma once
+
+// csv_writer.h
+// バッファ付きCSV書き込み
+//
+// 用語解説:
+// - バッファ(Buffer): 書き込む内容を一時的にためておくメモリ領域
+// - to_chars: 数値を文字列に変換するC++17の関数。ロケールを参照せず、
+//   メモリ確保もしないため、ストリームの<<より大幅に速い
+//
+// 1行ごと・1列ごとにファイルへ書くとストリームの処理が律速になるため、
+// 大きなバッファに数値・文字列を直接書き込み、一杯になったらまとめてファイルに書き出す。
+// openCompressedで開いた場合は、書き出す内容をBlockFile::Writerに渡してブロック単位で圧縮する。
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BlockFile {
+    class Writer;
+}
+
+namespace CSVWriter {
+
+    // デフォルトのバッファサイズ（1MiB）
+    constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 20;
+
+    class BufferedWriter {
+    private:
+        std::FILE* file_;
+        std::unique_ptr<BlockFile::Writer> compressed_;  // openCompressedで開いた場合のみ
+        std::vector<char> buffer_;
+        size_t used_;
+        bool failed_;
+
+        // 残りがsize未満ならファイルに書き出す
+        void reserve(size_t size) {
+            if (buffer_.size() - used_ < size) flush();
+        }
+
+        // ファイル（圧縮時はBlockFile::Writer）に書き出す
+        void writeOut(const char* data, size_t size);
+
+    public:
+        explicit BufferedWriter(size_t bufferSize = DEFAULT_BUFFER_SIZE);
+        ~BufferedWriter();
+
+        BufferedWriter(const BufferedWriter&) = delete;
+        BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+        // ファイルを開く（appendがfalseなら既存の内容は消え、trueなら末尾に追記する）
+        // 戻り値: 成功時true
+        bool open(const std::string& filepath, bool append = false);
+
+        // ブロック単位で圧縮したファイル（BlockFile形式）として開く（既存の内容は消える）
+        // 圧縮はバックグラウンドのスレッドで行い、closeで完了を待つ
+        // 戻り値: 成功時true
+        bool openCompressed(const std::string& filepath);
+
+        bool isOpen() const { return file_ != nullptr || compressed_ != nullptr; }
+
+        // 文字列・1文字
+        void write(std::string_view text);
+        void put(char ch) {
+            reserve(1);
+            buffer_[used_++] = ch;
+        }
+
+        // 整数（10進）
+        void writeUnsigned(uint64_t value);
+        void writeSigned(int64_t value);
+
+        // 小数（固定小数点、precision桁）
+        void writeFixed(double value, int precision);
+
+        // 小数（元の値に戻せる最短の桁数。42.0は"42"）
+        void writeShortest(double value);
+
+        // バッファの内容をファイルに書き出す
+        // 戻り値: これまでの書き込みがすべて成功していればtrue
+        bool flush();
+
+        // 書き出して閉じる
+        // 戻り値: これまでの書き込みがすべて成功していればtrue
+        bool close();
+    };
+
+} // namespace CSVWriter
@@ -0,0 +1,75 @@
+// delta_blocks.cpp
+// 整数列のメモリ内圧縮の実装
+
+#include "delta_blocks.h"
+
+namespace DeltaBlocks {
+
+    void Sequence::push_back(uint64_t value) {
+        if (size_ % BLOCK_VALUES == 0) {
+            // 新しいブロック（先頭は基準値としてそのまま持つ）
+            bases_.push_back(value);
+            offsets_.push_back(static_cast<uint32_t>(bytes_.size()));
+        } else {
+            uint64_t delta = value - last_;
+            uint64_t zigzag = (delta << 1) ^ (0 - (delta >> 63));
+            while (zigzag >= 0x80) {
+                bytes_.push_back(static_cast<uint8_t>(zigzag | 0x80));
+                zigzag >>= 7;
+            }
+            bytes_.push_back(static_cast<uint8_t>(zigzag));
+        }
+        last_ = value;
+        size_++;
+    }
+
+    uint64_t Sequence::operator[](size_t index) const {
+        size_t block = index / BLOCK_VALUES;
+        uint64_t value = bases_[block];
+        const uint8_t* pos = bytes_.data() + offsets_[block];
+        for (size_t i = block * BLOCK_VALUES; i < index; ++i) {
+            value += readDelta(pos);
+        }
+        return value;
+    }
+
+    size_t Sequence::decodeBlock(size_t block, uint64_t* out) const {
+        size_t first = block * BLOCK_VALUES;
+        size_t count = size_ - first < BLOCK_VALUES ? size_ - first : BLOCK_VALUES;
+        const uint8_t* pos = bytes_.data() + offsets_[block];
+        uint64_t value = bases_[block];
+        out[0] = value;
+        for (size_t i = 1; i < count; ++i) {
+            value += readDelta(pos);
+            out[i] = value;
+        }
+        return count;
+    }
+
+    std::vector<uint64_t> Sequence::toVector() const {
+        std::vector<uint64_t> values;
+        values.reserve(size_);
+        forEach([&values](uint64_t value) { values.push_back(value); });
+        return values;
+    }
+
+    size_t Sequence::memoryBytes() const {
+        return bases_.capacity() * sizeof(uint64_t) + offsets_.capacity() * sizeof(uint32_t) +
+               bytes_.capacity();
+    }
+
+    void Sequence::shrinkToFit() {
+        bases_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+        bytes_.shrink_to_fit();
+    }
+
+    void Sequence::clear() {
+        bases_.clear();
+        offsets_.clear();
+        bytes_.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+
+} // namespace DeltaBlocks
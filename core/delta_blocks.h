@@ -0,0 +1,97 @@
+#pragma once
+
+// delta_blocks.h
+// 整数列のメモリ内圧縮（ブロックごとの差分可変長整数）
+//
+// 用語解説:
+// - 差分(Delta): 直前の値との差。タイムスタンプのように少しずつ増える値は差が小さい
+// - 可変長整数(Varint): 小さい値ほど少ないバイト数で表す整数の符号化（7bitずつ、上位bitが継続の印）
+// - ジグザグ符号化(ZigZag): 負の差も小さい正の数に対応付ける（0,-1,1,-2,… → 0,1,2,3,…）
+// - ブロック(Block): BLOCK_VALUES個ずつの区切り。先頭の値はそのまま（基準値）持つ
+//
+// マイクロ秒のタイムスタンプは8バイトだが、打鍵間隔（数万〜数十万μs）の差なら2〜3バイトで済む。
+// ブロックごとに基準値と開始位置を持つので、i番目の値はそのブロックの先頭から
+// 最大BLOCK_VALUES - 1個の差を足すだけで求まる（先頭から全部を復号する必要はない）。
+// 全体を順に読む場合はforEachを使う（ブロックの先頭位置を探し直さない）。
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DeltaBlocks {
+
+    // 1ブロックの値の数
+    constexpr size_t BLOCK_VALUES = 128;
+
+    class Sequence {
+    private:
+        std::vector<uint64_t> bases_;       // ブロックの先頭の値
+        std::vector<uint32_t> offsets_;     // ブロックの2番目以降の値の差がbytes_のどこから始まるか
+        std::vector<uint8_t> bytes_;        // ジグザグ符号化した差の可変長整数
+        uint64_t last_;
+        size_t size_;
+
+        // 差を1つ読む（posは次の差の先頭に進む）
+        static uint64_t readDelta(const uint8_t*& pos) {
+            uint64_t raw = *pos++;
+            if (raw >= 0x80) {
+                raw &= 0x7F;
+                int shift = 7;
+                uint8_t byte;
+                do {
+                    byte = *pos++;
+                    raw |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                    shift += 7;
+                } while (byte >= 0x80);
+            }
+            // ジグザグ符号化を戻した差（2の補数で足せば負の差も扱える）
+            return (raw >> 1) ^ (0 - (raw & 1));
+        }
+
+    public:
+        Sequence() : last_(0), size_(0) {}
+
+        // 末尾に追加
+        void push_back(uint64_t value);
+
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+        size_t blockCount() const { return bases_.size(); }
+
+        // i番目の値（i < size()）
+        uint64_t operator[](size_t index) const;
+
+        // 1ブロック分を復号してoutに書き込む（outはBLOCK_VALUES個以上）
+        // 戻り値: 書き込んだ値の数
+        size_t decodeBlock(size_t block, uint64_t* out) const;
+
+        // 全体を先頭から順に渡す
+        template <typename Function>
+        void forEach(Function function) const {
+            const uint8_t* pos = bytes_.data();
+            size_t remaining = size_;
+            for (size_t block = 0; block < bases_.size(); ++block) {
+                uint64_t value = bases_[block];
+                function(value);
+                size_t count = remaining < BLOCK_VALUES ? remaining : BLOCK_VALUES;
+                for (size_t i = 1; i < count; ++i) {
+                    value += readDelta(pos);
+                    function(value);
+                }
+                remaining -= count;
+            }
+        }
+
+        // 全体を配列に戻す
+        std::vector<uint64_t> toVector() const;
+
+        // 使用しているメモリ（確保済みの容量を含む）
+        size_t memoryBytes() const;
+
+        // 余分に確保している容量を解放する（追加が終わった後に呼ぶ）
+        void shrinkToFit();
+
+        void clear();
+    };
+
+} // namespace DeltaBlocks
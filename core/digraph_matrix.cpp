@@ -0,0 +1,141 @@
+// digraph_matrix.cpp
+// キーペア（ダイグラフ）遷移時間集計の実装
+
+#include "digraph_matrix.h"
+#include <algorithm>
+
+namespace Statistics {
+
+    // ヒストグラムのビン上限: 25, 50, 100, 150, 200, 300, 500ms、それ以上
+    const uint64_t DIGRAPH_HISTOGRAM_UPPER_US[DIGRAPH_HISTOGRAM_BINS - 1] = {
+        25000, 50000, 100000, 150000, 200000, 300000, 500000
+    };
+
+    size_t transitionHistogramBin(uint64_t intervalUs) {
+        size_t bin = 0;
+        while (bin < DIGRAPH_HISTOGRAM_BINS - 1 && intervalUs >= DIGRAPH_HISTOGRAM_UPPER_US[bin]) {
+            bin++;
+        }
+        return bin;
+    }
+
+    void TransitionStats::add(uint64_t intervalUs) {
+        count++;
+        sumUs += intervalUs;
+        histogram[transitionHistogramBin(intervalUs)]++;
+    }
+
+    double TransitionStats::meanMs() const {
+        if (count == 0) return 0.0;
+        return static_cast<double>(sumUs) / count / 1000.0;  // μs -> ms
+    }
+
+    // ---- DigraphMatrix ----
+
+    DigraphMatrix::DigraphMatrix()
+        : cells_(DIGRAPH_KEY_COUNT * DIGRAPH_KEY_COUNT)
+        , transitionCount_(0)
+    {
+    }
+
+    void DigraphMatrix::add(char from, char to, uint64_t intervalUs) {
+        if (!isTransitionChar(from) || !isTransitionChar(to)) return;
+
+        unsigned char f = static_cast<unsigned char>(from);
+        unsigned char t = static_cast<unsigned char>(to);
+        cells_[f * DIGRAPH_KEY_COUNT + t].add(intervalUs);
+        transitionCount_++;
+    }
+
+    const TransitionStats& DigraphMatrix::at(char from, char to) const {
+        static const TransitionStats empty;
+        unsigned char f = static_cast<unsigned char>(from);
+        unsigned char t = static_cast<unsigned char>(to);
+        if (f >= DIGRAPH_KEY_COUNT || t >= DIGRAPH_KEY_COUNT) return empty;
+
+        return cells_[f * DIGRAPH_KEY_COUNT + t];
+    }
+
+    void DigraphMatrix::clear() {
+        std::fill(cells_.begin(), cells_.end(), TransitionStats());
+        transitionCount_ = 0;
+    }
+
+    // ---- TrigramTable ----
+
+    TrigramTable::TrigramTable(size_t initialCapacity)
+        : size_(0)
+    {
+        // 容量は2のべき乗に揃える
+        size_t capacity = 16;
+        while (capacity < initialCapacity) capacity <<= 1;
+        slots_.resize(capacity);
+    }
+
+    uint32_t TrigramTable::makeKey(char a, char b, char c) {
+        // 最上位に番兵ビットを立てて0（空き）と区別する
+        return (1u << 24)
+            | (static_cast<uint32_t>(static_cast<unsigned char>(a)) << 16)
+            | (static_cast<uint32_t>(static_cast<unsigned char>(b)) << 8)
+            | static_cast<uint32_t>(static_cast<unsigned char>(c));
+    }
+
+    // キーのハッシュ（乗算ハッシュ）
+    static inline size_t trigramSlot(uint32_t key, size_t mask) {
+        return static_cast<size_t>((key * 2654435761u) >> 8) & mask;
+    }
+
+    void TrigramTable::grow() {
+        std::vector<Entry> old(slots_.size() * 2);
+        old.swap(slots_);
+        size_t mask = slots_.size() - 1;
+
+        for (const auto& slot : old) {
+            if (slot.key == 0) continue;
+            size_t i = trigramSlot(slot.key, mask);
+            while (slots_[i].key != 0) i = (i + 1) & mask;
+            slots_[i] = slot;
+        }
+    }
+
+    void TrigramTable::add(char a, char b, char c, uint64_t intervalUs) {
+        if (!isTransitionChar(a) || !isTransitionChar(b) || !isTransitionChar(c)) {
+            return;
+        }
+
+        // 負荷率70%を超えたら拡張
+        if ((size_ + 1) * 10 > slots_.size() * 7) {
+            grow();
+        }
+
+        uint32_t key = makeKey(a, b, c);
+        size_t mask = slots_.size() - 1;
+        size_t i = trigramSlot(key, mask);
+        while (slots_[i].key != 0 && slots_[i].key != key) {
+            i = (i + 1) & mask;
+        }
+
+        if (slots_[i].key == 0) {
+            slots_[i].key = key;
+            size_++;
+        }
+        slots_[i].stats.add(intervalUs);
+    }
+
+    const TransitionStats* TrigramTable::find(char a, char b, char c) const {
+        uint32_t key = makeKey(a, b, c);
+        size_t mask = slots_.size() - 1;
+        size_t i = trigramSlot(key, mask);
+        while (slots_[i].key != 0) {
+            if (slots_[i].key == key) return &slots_[i].stats;
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    void TrigramTable::clear() {
+        std::fill(slots_.begin(), slots_.end(), Entry{0, TransitionStats()});
+        size_ = 0;
+    }
+
+} // namespace Statistics
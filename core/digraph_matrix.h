@@ -0,0 +1,119 @@
+#pragma once
+
+// digraph_matrix.h
+// キーペア（ダイグラフ）遷移時間の集計
+//
+// 用語解説:
+// - ダイグラフ(Digraph): 連続する2打鍵の組（例: "k"→"a"）
+// - トライグラム(Trigram): 連続する3打鍵の組（例: "s"→"h"→"i"）
+// - 遷移時間(Transition Time): 前のキーダウンから次のキーダウンまでの時間
+//
+// 同指連打・左右交互打鍵などの評価のため、文字（ASCII 0-127）の
+// 128×128行列で遷移時間を集計する。行列は構築時に確保し、
+// 集計中の追加確保は行わない。文字を持たないキー（Shiftなど、文字が'\0'）や
+// 制御文字は集計しない。
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Statistics {
+
+    // 行列の一辺（ASCII範囲）
+    constexpr size_t DIGRAPH_KEY_COUNT = 128;
+
+    // 遷移時間ヒストグラムのビン数
+    constexpr size_t DIGRAPH_HISTOGRAM_BINS = 8;
+
+    // 各ビンの上限（マイクロ秒、未満）。最後のビンは上限なし
+    extern const uint64_t DIGRAPH_HISTOGRAM_UPPER_US[DIGRAPH_HISTOGRAM_BINS - 1];
+
+    // 1つのキー組に対する遷移時間の集計
+    struct TransitionStats {
+        uint32_t count;                                 // 遷移回数
+        uint64_t sumUs;                                 // 遷移時間の合計（マイクロ秒）
+        uint32_t histogram[DIGRAPH_HISTOGRAM_BINS];     // 遷移時間の分布
+
+        TransitionStats() : count(0), sumUs(0), histogram{} {}
+
+        void add(uint64_t intervalUs);
+
+        // 平均遷移時間（ミリ秒）
+        double meanMs() const;
+    };
+
+    // 遷移の集計対象の文字か（印字可能なASCII文字）
+    inline bool isTransitionChar(char c) {
+        return c >= 0x20 && c < 0x7F;
+    }
+
+    // 遷移時間からヒストグラムのビン番号を求める
+    size_t transitionHistogramBin(uint64_t intervalUs);
+
+    // ダイグラフ遷移行列（128×128の密行列）
+    class DigraphMatrix {
+    private:
+        std::vector<TransitionStats> cells_;   // from * DIGRAPH_KEY_COUNT + to
+        size_t transitionCount_;               // 集計した遷移の総数
+
+    public:
+        DigraphMatrix();
+
+        // 遷移を1件追加（isTransitionChar()でない文字は無視）
+        void add(char from, char to, uint64_t intervalUs);
+
+        // キー組の集計を取得
+        const TransitionStats& at(char from, char to) const;
+
+        // 集計した遷移の総数
+        size_t getTransitionCount() const { return transitionCount_; }
+
+        void clear();
+    };
+
+    // トライグラム遷移表（疎な開番地法ハッシュ表）
+    // 容量は負荷率が上限を超えたときだけ倍増する（1件ごとの確保はしない）
+    class TrigramTable {
+    public:
+        struct Entry {
+            uint32_t key;            // 0: 空き, それ以外: makeKey()の値
+            TransitionStats stats;
+        };
+
+    private:
+        std::vector<Entry> slots_;
+        size_t size_;
+
+        static uint32_t makeKey(char a, char b, char c);
+        void grow();
+
+    public:
+        explicit TrigramTable(size_t initialCapacity = 1024);
+
+        // 3打鍵の遷移を1件追加（先頭キーダウンから3打鍵目のキーダウンまでの時間）
+        // isTransitionChar()でない文字を含む組は無視
+        void add(char a, char b, char c, uint64_t intervalUs);
+
+        // 集計を検索（未登録ならnullptr）
+        const TransitionStats* find(char a, char b, char c) const;
+
+        // 登録済みの組を列挙
+        template <typename Func>
+        void forEach(Func func) const {
+            for (const auto& slot : slots_) {
+                if (slot.key != 0) {
+                    func(static_cast<char>((slot.key >> 16) & 0x7F),
+                         static_cast<char>((slot.key >> 8) & 0x7F),
+                         static_cast<char>(slot.key & 0x7F),
+                         slot.stats);
+                }
+            }
+        }
+
+        // 登録済みの組の数
+        size_t size() const { return size_; }
+
+        void clear();
+    };
+
+} // namespace Statistics
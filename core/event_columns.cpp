@@ -0,0 +1,386 @@
+// event_columns.cpp
+// イベントの列指向バイナリ形式の実装
+
+#include "event_columns.h"
+#include "../helper/byte_order.h"
+#include <cstring>
+#include <fstream>
+
+namespace EventColumns {
+
+    using ByteOrder::putU32;
+    using ByteOrder::putU64;
+    using ByteOrder::getU32;
+    using ByteOrder::getU64;
+
+    static const char HEADER_MAGIC[8] = {'T', 'P', 'E', 'V', 'C', 'O', 'L', '1'};
+    static const char TRAILER_MAGIC[8] = {'T', 'P', 'E', 'V', 'C', 'O', 'L', 'F'};
+    static const uint32_t FORMAT_VERSION = 1;
+    static const size_t HEADER_SIZE = 24;
+    static const size_t FOOTER_ENTRY_SIZE = 24;
+    static const size_t TRAILER_SIZE = 16;
+
+    // ---- 書き込み ----
+
+    static void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    static uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    static int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // 整数列（vk_code・scan_code）は範囲に応じて1・2・4バイトにする
+    template <typename Getter>
+    static Encoding putIntegers(std::vector<uint8_t>& out, InputRecorder::EventView events, Getter get) {
+        bool fits8 = true;
+        bool fits16 = true;
+        for (const auto& event : events) {
+            int value = get(event);
+            if (value < 0 || value > UINT8_MAX) fits8 = false;
+            if (value < INT16_MIN || value > INT16_MAX) {
+                fits16 = false;
+                break;
+            }
+        }
+        size_t width = fits8 ? 1 : fits16 ? 2 : 4;
+        for (const auto& event : events) {
+            uint32_t value = static_cast<uint32_t>(get(event));
+            for (size_t b = 0; b < width; ++b) {
+                out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+            }
+        }
+        return fits8 ? Encoding::UINT8 : fits16 ? Encoding::INT16 : Encoding::INT32;
+    }
+
+    std::vector<uint8_t> encode(InputRecorder::EventView events) {
+        std::vector<uint8_t> out;
+        // 1イベントあたり平均10バイト程度に収まる
+        out.reserve(HEADER_SIZE + events.size() * 12 + COLUMN_COUNT * (FOOTER_ENTRY_SIZE + 8) + TRAILER_SIZE);
+
+        out.insert(out.end(), HEADER_MAGIC, HEADER_MAGIC + 8);
+        putU32(out, FORMAT_VERSION);
+        putU32(out, static_cast<uint32_t>(COLUMN_COUNT));
+        putU64(out, events.size());
+
+        struct Entry {
+            Column column;
+            Encoding encoding;
+            uint64_t offset;
+            uint64_t size;
+        };
+        std::vector<Entry> entries;
+
+        for (size_t c = 0; c < COLUMN_COUNT; ++c) {
+            // 各列の先頭は8バイト境界にそろえる
+            while (out.size() % 8 != 0) out.push_back(0);
+            Column column = static_cast<Column>(c);
+            size_t begin = out.size();
+            Encoding encoding = Encoding::UINT8;
+
+            switch (column) {
+                case Column::TIMESTAMP: {
+                    encoding = Encoding::DELTA_VARINT;
+                    uint64_t previous = 0;
+                    for (const auto& event : events) {
+                        putVarint(out, zigzag(static_cast<int64_t>(event.timestamp_us - previous)));
+                        previous = event.timestamp_us;
+                    }
+                    break;
+                }
+                case Column::EVENT_TYPE:
+                    for (const auto& event : events) out.push_back(static_cast<uint8_t>(event.type));
+                    break;
+                case Column::VK_CODE:
+                    encoding = putIntegers(out, events, [](const InputRecorder::InputEvent& e) { return e.vk_code; });
+                    break;
+                case Column::SCAN_CODE:
+                    encoding = putIntegers(out, events, [](const InputRecorder::InputEvent& e) { return e.scan_code; });
+                    break;
+                case Column::CHARACTER:
+                    for (const auto& event : events) out.push_back(static_cast<uint8_t>(event.character));
+                    break;
+                case Column::IS_CORRECT: {
+                    encoding = Encoding::BITS;
+                    out.resize(out.size() + (events.size() + 7) / 8, 0);
+                    uint8_t* bits = out.data() + begin;
+                    for (size_t i = 0; i < events.size(); ++i) {
+                        if (events[i].is_correct) bits[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+                    }
+                    break;
+                }
+                case Column::INTER_KEY_TIME:
+                    encoding = Encoding::VARINT;
+                    for (const auto& event : events) putVarint(out, event.inter_key_time_us);
+                    break;
+                case Column::SUSPECT:
+                    for (const auto& event : events) out.push_back(static_cast<uint8_t>(event.suspect));
+                    break;
+                case Column::NOTE:
+                    encoding = Encoding::STRINGS;
+                    for (const auto& event : events) {
+                        putVarint(out, event.note.size());
+                        out.insert(out.end(), event.note.begin(), event.note.end());
+                    }
+                    break;
+            }
+
+            entries.push_back({column, encoding, begin, out.size() - begin});
+        }
+
+        uint64_t footerOffset = out.size();
+        for (const auto& entry : entries) {
+            putU32(out, static_cast<uint32_t>(entry.column));
+            putU32(out, static_cast<uint32_t>(entry.encoding));
+            putU64(out, entry.offset);
+            putU64(out, entry.size);
+        }
+        putU64(out, footerOffset);
+        out.insert(out.end(), TRAILER_MAGIC, TRAILER_MAGIC + 8);
+        return out;
+    }
+
+    bool writeFile(InputRecorder::EventView events, const std::string& filepath) {
+        std::vector<uint8_t> data = encode(events);
+        std::ofstream file(filepath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        file.close();
+        return static_cast<bool>(file);
+    }
+
+    // ---- 読み込み ----
+
+    // 立っているbitの数（GCC・Clang以外は1bitずつ数える）
+    static int popCount64(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(value);
+#else
+        int count = 0;
+        while (value != 0) {
+            value &= value - 1;
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    // 可変長整数を1つ読む（pは次の値に進む）
+    static bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            uint8_t byte = *p++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    // 可変長整数の列を復号（deltaなら差分を積算する）
+    static bool decodeVarints(const ColumnView& view, uint64_t count, bool delta, std::vector<uint64_t>& values) {
+        const uint8_t* p = view.data;
+        const uint8_t* end = view.data + view.size;
+        if (count > view.size) return false;   // 1つ1バイト以上
+        values.resize(count);
+        uint64_t current = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+            uint64_t raw;
+            if (!getVarint(p, end, raw)) return false;
+            if (delta) {
+                current += static_cast<uint64_t>(unzigzag(raw));
+                values[i] = current;
+            } else {
+                values[i] = raw;
+            }
+        }
+        return true;
+    }
+
+    // 1バイト（符号なし）・2バイト・4バイト（符号付き）の整数列を復号
+    static bool decodeIntegers(const ColumnView& view, uint64_t count, std::vector<int>& values) {
+        size_t width = view.encoding == Encoding::UINT8 ? 1
+                     : view.encoding == Encoding::INT16 ? 2
+                     : view.encoding == Encoding::INT32 ? 4 : 0;
+        if (width == 0 || view.size != count * width) return false;
+        values.resize(count);
+        const uint8_t* p = view.data;
+        for (uint64_t i = 0; i < count; ++i, p += width) {
+            if (width == 1) {
+                values[i] = p[0];
+            } else if (width == 2) {
+                values[i] = static_cast<int16_t>(static_cast<uint16_t>(p[0] | (p[1] << 8)));
+            } else {
+                values[i] = static_cast<int32_t>(getU32(p));
+            }
+        }
+        return true;
+    }
+
+    Reader::Reader()
+        : eventCount_(0)
+    {
+        present_.fill(false);
+    }
+
+    bool Reader::open(const std::string& filepath) {
+        eventCount_ = 0;
+        columns_.fill(ColumnView());
+        present_.fill(false);
+        if (!file_.open(filepath)) {
+            return false;
+        }
+
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(file_.data());
+        size_t size = file_.size();
+        if (size < HEADER_SIZE + TRAILER_SIZE) return false;
+        if (std::memcmp(base, HEADER_MAGIC, 8) != 0) return false;
+        if (std::memcmp(base + size - 8, TRAILER_MAGIC, 8) != 0) return false;
+        if (getU32(base + 8) != FORMAT_VERSION) return false;
+
+        uint32_t columnCount = getU32(base + 12);
+        uint64_t footerOffset = getU64(base + size - TRAILER_SIZE);
+        if (footerOffset > size - TRAILER_SIZE ||
+            (size - TRAILER_SIZE - footerOffset) != static_cast<uint64_t>(columnCount) * FOOTER_ENTRY_SIZE) {
+            return false;
+        }
+
+        for (uint32_t c = 0; c < columnCount; ++c) {
+            const uint8_t* entry = base + footerOffset + c * FOOTER_ENTRY_SIZE;
+            uint32_t id = getU32(entry);
+            uint64_t offset = getU64(entry + 8);
+            uint64_t bytes = getU64(entry + 16);
+            if (offset > footerOffset || bytes > footerOffset - offset) return false;
+            // 知らない列（新しい版で追加された列）は読み飛ばす
+            if (id >= COLUMN_COUNT) continue;
+
+            ColumnView& view = columns_[id];
+            view.data = base + offset;
+            view.size = static_cast<size_t>(bytes);
+            view.encoding = static_cast<Encoding>(getU32(entry + 4));
+            present_[id] = true;
+        }
+
+        eventCount_ = getU64(base + 16);
+        return true;
+    }
+
+    bool Reader::readTimestamps(std::vector<uint64_t>& values) const {
+        ColumnView view = column(Column::TIMESTAMP);
+        return hasColumn(Column::TIMESTAMP) && view.encoding == Encoding::DELTA_VARINT &&
+               decodeVarints(view, eventCount_, true, values);
+    }
+
+    bool Reader::readInterKeyTimes(std::vector<uint64_t>& values) const {
+        ColumnView view = column(Column::INTER_KEY_TIME);
+        return hasColumn(Column::INTER_KEY_TIME) && view.encoding == Encoding::VARINT &&
+               decodeVarints(view, eventCount_, false, values);
+    }
+
+    bool Reader::readEventTypes(std::vector<InputRecorder::EventType>& values) const {
+        ColumnView view = column(Column::EVENT_TYPE);
+        if (!hasColumn(Column::EVENT_TYPE) || view.encoding != Encoding::UINT8 || view.size != eventCount_) {
+            return false;
+        }
+        values.resize(eventCount_);
+        for (size_t i = 0; i < view.size; ++i) {
+            if (view.data[i] > static_cast<uint8_t>(InputRecorder::EventType::CORRECTION)) {
+                return false;   // 定義にない種類（壊れたファイル）
+            }
+            values[i] = static_cast<InputRecorder::EventType>(view.data[i]);
+        }
+        return true;
+    }
+
+    bool Reader::readVkCodes(std::vector<int>& values) const {
+        return hasColumn(Column::VK_CODE) && decodeIntegers(column(Column::VK_CODE), eventCount_, values);
+    }
+
+    bool Reader::readScanCodes(std::vector<int>& values) const {
+        return hasColumn(Column::SCAN_CODE) && decodeIntegers(column(Column::SCAN_CODE), eventCount_, values);
+    }
+
+    bool Reader::readCorrect(std::vector<uint8_t>& values) const {
+        ColumnView view = column(Column::IS_CORRECT);
+        if (!hasColumn(Column::IS_CORRECT) || view.encoding != Encoding::BITS || view.size != (eventCount_ + 7) / 8) {
+            return false;
+        }
+        values.resize(eventCount_);
+        for (uint64_t i = 0; i < eventCount_; ++i) {
+            values[i] = (view.data[i / 8] >> (i % 8)) & 1;
+        }
+        return true;
+    }
+
+    uint64_t Reader::countCorrect() const {
+        ColumnView view = column(Column::IS_CORRECT);
+        if (!hasColumn(Column::IS_CORRECT) || view.encoding != Encoding::BITS) {
+            return 0;
+        }
+        // 書き込み時に余りのbitは0にしているので、8バイトずつまとめて数えればよい
+        uint64_t count = 0;
+        size_t i = 0;
+        for (; i + 8 <= view.size; i += 8) {
+            count += static_cast<uint64_t>(popCount64(getU64(view.data + i)));
+        }
+        for (; i < view.size; ++i) {
+            count += static_cast<uint64_t>(popCount64(view.data[i]));
+        }
+        return count;
+    }
+
+    bool Reader::readEvents(std::vector<InputRecorder::InputEvent>& events) const {
+        std::vector<uint64_t> timestamps;
+        std::vector<uint64_t> interKeyTimes;
+        std::vector<InputRecorder::EventType> types;
+        std::vector<int> vkCodes;
+        std::vector<int> scanCodes;
+        std::vector<uint8_t> correct;
+        if (!readTimestamps(timestamps) || !readInterKeyTimes(interKeyTimes) || !readEventTypes(types) ||
+            !readVkCodes(vkCodes) || !readScanCodes(scanCodes) || !readCorrect(correct)) {
+            return false;
+        }
+
+        ColumnView characters = column(Column::CHARACTER);
+        ColumnView suspects = column(Column::SUSPECT);
+        ColumnView notes = column(Column::NOTE);
+        if (characters.size != eventCount_ || suspects.size != eventCount_ || !hasColumn(Column::NOTE)) {
+            return false;
+        }
+        for (uint64_t i = 0; i < eventCount_; ++i) {
+            if (suspects.data[i] > static_cast<uint8_t>(InputRecorder::Suspect::GHOST)) {
+                return false;   // 定義にない種類（壊れたファイル）
+            }
+        }
+        const uint8_t* note = notes.data;
+        const uint8_t* notesEnd = notes.data + notes.size;
+
+        events.reserve(events.size() + eventCount_);
+        for (uint64_t i = 0; i < eventCount_; ++i) {
+            uint64_t length;
+            if (!getVarint(note, notesEnd, length) || length > static_cast<uint64_t>(notesEnd - note)) {
+                return false;
+            }
+
+            events.emplace_back(types[i], timestamps[i], vkCodes[i], scanCodes[i],
+                                static_cast<char>(characters.data[i]));
+            InputRecorder::InputEvent& event = events.back();
+            event.is_correct = correct[i] != 0;
+            event.inter_key_time_us = interKeyTimes[i];
+            event.suspect = static_cast<InputRecorder::Suspect>(suspects.data[i]);
+            event.note.assign(reinterpret_cast<const char*>(note), static_cast<size_t>(length));
+            note += length;
+        }
+        return true;
+    }
+
+} // namespace EventColumns
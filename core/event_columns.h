@@ -0,0 +1,107 @@
+#pragma once
+
+// event_columns.h
+// イベントの列指向バイナリ形式（書き込み・読み込み）
+//
+// 用語解説:
+// - 列指向(Columnar): 1イベントずつではなく、列（タイムスタンプ、仮想キーコードなど）ごとに
+//   全イベントの値を連続して並べる形式。必要な列だけを読めばよい
+// - 可変長整数(Varint): 小さい値ほど少ないバイト数で表す整数の符号化（7bitずつ、上位bitが継続の印）
+// - 差分符号化(Delta): 直前の値との差を記録する。単調に増えるタイムスタンプは差が小さくなる
+// - ジグザグ符号化(ZigZag): 負の差も小さい正の数に対応付ける（0,-1,1,-2,… → 0,1,2,3,…）
+// - フッター(Footer): ファイル末尾に置く、各列の位置と符号化方法の一覧
+//
+// ファイル構成（数値はすべてリトルエンディアン）:
+//   ヘッダー  : "TPEVCOL1"(8) / バージョン(u32) / 列数(u32) / イベント数(u64)
+//   列データ  : 列ごとの連続領域（先頭は8バイト境界）
+//   フッター  : 列ごとに 列番号(u32) / 符号化(u32) / 開始位置(u64) / バイト数(u64)
+//   末尾      : フッターの開始位置(u64) / "TPEVCOLF"(8)
+// 読み込み時はファイルをメモリマップし、フッターから目的の列の範囲だけを参照する。
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "input_event.h"
+#include "../helper/mapped_file.h"
+
+namespace EventColumns {
+
+    // 列の種類（番号はファイルに記録されるので変更しない）
+    enum class Column : uint32_t {
+        TIMESTAMP = 0,          // timestamp_us
+        EVENT_TYPE = 1,         // type
+        VK_CODE = 2,            // vk_code
+        SCAN_CODE = 3,          // scan_code
+        CHARACTER = 4,          // character
+        IS_CORRECT = 5,         // is_correct
+        INTER_KEY_TIME = 6,     // inter_key_time_us
+        SUSPECT = 7,            // suspect
+        NOTE = 8,               // note
+    };
+    constexpr size_t COLUMN_COUNT = 9;
+
+    // 列の符号化（番号はファイルに記録されるので変更しない）
+    enum class Encoding : uint32_t {
+        UINT8 = 0,              // 1バイト/イベント（符号なし）
+        INT16 = 1,              // 2バイト/イベント（符号付き）
+        INT32 = 2,              // 4バイト/イベント（符号付き）
+        BITS = 3,               // 1bit/イベント（下位bitから詰める）
+        VARINT = 4,             // 可変長整数
+        DELTA_VARINT = 5,       // 直前との差をジグザグ符号化した可変長整数（最初は0との差）
+        STRINGS = 6,            // 長さ（可変長整数）＋バイト列
+    };
+
+    // 列の範囲（マップしたファイル上を指す）
+    struct ColumnView {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        Encoding encoding = Encoding::UINT8;
+    };
+
+    // イベント列を列指向バイナリにする
+    std::vector<uint8_t> encode(InputRecorder::EventView events);
+
+    // 列指向バイナリをファイルに出力
+    // 戻り値: 成功時true
+    bool writeFile(InputRecorder::EventView events, const std::string& filepath);
+
+    // 列指向バイナリの読み込み（ファイルはメモリマップしたまま保持する）
+    class Reader {
+    private:
+        FileMapping::MappedFile file_;
+        uint64_t eventCount_;
+        std::array<ColumnView, COLUMN_COUNT> columns_;
+        std::array<bool, COLUMN_COUNT> present_;
+
+    public:
+        Reader();
+
+        // ファイルを開き、ヘッダー・フッターを検証する
+        // 戻り値: 成功時true（形式が異なる・列の範囲がファイルをはみ出す場合はfalse）
+        bool open(const std::string& filepath);
+
+        uint64_t eventCount() const { return eventCount_; }
+        bool hasColumn(Column column) const { return present_[static_cast<size_t>(column)]; }
+
+        // 列の範囲（なければ空）
+        ColumnView column(Column column) const { return columns_[static_cast<size_t>(column)]; }
+
+        // 1列だけを復号する（他の列のデータには触れない）
+        // 戻り値: 成功時true（列がない・データが壊れている場合はfalse）
+        bool readTimestamps(std::vector<uint64_t>& values) const;
+        bool readInterKeyTimes(std::vector<uint64_t>& values) const;
+        bool readEventTypes(std::vector<InputRecorder::EventType>& values) const;
+        bool readVkCodes(std::vector<int>& values) const;
+        bool readScanCodes(std::vector<int>& values) const;
+        bool readCorrect(std::vector<uint8_t>& values) const;   // 0か1
+
+        // 正解のイベント数（ビット列を数えるだけで復号しない）
+        uint64_t countCorrect() const;
+
+        // 全列を復号してイベント列に戻す
+        bool readEvents(std::vector<InputRecorder::InputEvent>& events) const;
+    };
+
+} // namespace EventColumns
@@ -0,0 +1,94 @@
+#pragma once
+// input_event.h
+// 入力イベントの共通型
+//
+// InputRecorder（記録）とStatistics（統計計算）が同じイベント型を共有し、
+// 記録したイベント列をコピーせずにそのまま統計計算へ渡せるようにする。
+// Windows APIに依存しないヘッダーのみの定義。
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace InputRecorder {
+
+    // イベントの種類
+    enum class EventType {
+        KEY_DOWN,       // キーを押した瞬間
+        KEY_UP,         // キーを離した瞬間
+        BACKSPACE,      // Backspaceキーの押下
+        CORRECTION      // 修正操作（Backspaceで文字を削除した確定イベント）
+    };
+
+    // 疑わしいイベントの種類（チャタリング検出）
+    enum class Suspect : uint8_t {
+        NONE,       // 正常
+        CHATTER,    // チャタリングによる再入力
+        GHOST       // ゴースト押下
+    };
+
+    // 1つの入力イベントの詳細情報
+    struct InputEvent {
+        EventType type;              // イベントの種類
+        uint64_t timestamp_us;       // イベント発生時刻（マイクロ秒）
+        int vk_code;                 // 仮想キーコード（どのキーが押されたか）
+        int scan_code;               // スキャンコード（物理的なキーの位置）
+        char character;              // 入力された文字（該当する場合）
+        bool is_correct;             // 正しい入力かどうか（判定ロジックで設定）
+        uint64_t inter_key_time_us;  // 直前のキーアップからこのキーダウンまでの時間
+        Suspect suspect;             // チャタリング・ゴースト押下の疑い（統計から除外される）
+        std::string note;            // 追加情報（デバッグやログ用）
+
+        // コンストラクタ（初期化用）
+        InputEvent()
+            : type(EventType::KEY_DOWN)
+            , timestamp_us(0)
+            , vk_code(0)
+            , scan_code(0)
+            , character('\0')
+            , is_correct(false)
+            , inter_key_time_us(0)
+            , suspect(Suspect::NONE)
+        {}
+
+        InputEvent(EventType t, uint64_t ts, int vk, int scan, char ch = '\0')
+            : type(t)
+            , timestamp_us(ts)
+            , vk_code(vk)
+            , scan_code(scan)
+            , character(ch)
+            , is_correct(false)
+            , inter_key_time_us(0)
+            , suspect(Suspect::NONE)
+        {}
+    };
+
+    // 判定（TypingJudge）に渡されたキーダウンか
+    // チャタリング・ゴースト押下は入力時に判定に渡さず、統計計算でも除外する（Calculatorと同じ規則）。
+    // 文字を持たないキーも判定しない
+    inline bool isJudgedKeyDown(const InputEvent& event) {
+        return event.type == EventType::KEY_DOWN && event.suspect == Suspect::NONE && event.character != '\0';
+    }
+
+    // イベント列の読み取り専用ビュー（C++17のためstd::spanの代わり）
+    // 参照先の寿命は呼び出し側が保証する
+    class EventView {
+    private:
+        const InputEvent* data_;
+        size_t size_;
+
+    public:
+        EventView() : data_(nullptr), size_(0) {}
+        EventView(const InputEvent* data, size_t size) : data_(data), size_(size) {}
+        EventView(const std::vector<InputEvent>& events)
+            : data_(events.data()), size_(events.size()) {}
+
+        const InputEvent* begin() const { return data_; }
+        const InputEvent* end() const { return data_ + size_; }
+        const InputEvent& operator[](size_t i) const { return data_[i]; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+    };
+
+} // namespace InputRecorder
@@ -4,29 +4,6 @@
 
 namespace InputRecorder {
 
-    // InputEvent のコンストラクタ（初期化）
-    InputEvent::InputEvent() 
-        : type(EventType::KEY_DOWN)
-        , timestamp_us(0)
-        , vk_code(0)
-        , scan_code(0)
-        , character('\0')
-        , is_correct(false)
-        , inter_key_time_us(0)
-        , note("")
-    {}
-
-    InputEvent::InputEvent(EventType t, uint64_t ts, int vk, int scan, char ch)
-        : type(t)
-        , timestamp_us(ts)
-        , vk_code(vk)
-        , scan_code(scan)
-        , character(ch)
-        , is_correct(false)
-        , inter_key_time_us(0)
-        , note("")
-    {}
-
     // Recorder のコンストラクタ
     Recorder::Recorder()
         : session_start_us_(0)
@@ -34,6 +11,7 @@ namespace InputRecorder {
         , recording_(false)
     {
         WinTimer::init();  // タイマーを初期化
+        clear();
     }
 
     void Recorder::startSession() {
@@ -47,8 +25,8 @@ namespace InputRecorder {
         recording_ = false;
     }
 
-    void Recorder::recordKeyDown(int vk, int scan, char ch) {
-        if (!recording_) return;  // 記録中でなければ何もしない
+    size_t Recorder::recordKeyDown(int vk, int scan, char ch) {
+        if (!recording_) return NO_EVENT;  // 記録中でなければ何もしない
 
         uint64_t now = WinTimer::now_us();
         InputEvent evt(EventType::KEY_DOWN, now, vk, scan, ch);
@@ -58,7 +36,17 @@ namespace InputRecorder {
             evt.inter_key_time_us = now - last_keyup_time_us_;
         }
 
+        // チャタリング判定（同じキーがKEY_UP直後に再度押された）
+        evt.suspect = chatterDetector_.onKeyDown(vk, now);
+        if (evt.suspect == Suspect::CHATTER) {
+            evt.note = "chatter";
+        }
+
+        if (vk >= 0 && vk < static_cast<int>(CHATTER_KEY_COUNT)) {
+            lastKeyDownIndex_[vk] = events_.size();
+        }
         events_.push_back(evt);
+        return events_.size() - 1;
     }
 
     void Recorder::recordKeyUp(int vk, int scan) {
@@ -66,6 +54,19 @@ namespace InputRecorder {
 
         uint64_t now = WinTimer::now_us();
         InputEvent evt(EventType::KEY_UP, now, vk, scan);
+
+        // ゴースト押下判定（押下時間が短すぎる場合は対応するKEY_DOWNにも印を付ける）
+        evt.suspect = chatterDetector_.onKeyUp(vk, now);
+        if (evt.suspect == Suspect::GHOST) {
+            evt.note = "ghost";
+            size_t downIndex = lastKeyDownIndex_[vk];
+            if (downIndex < events_.size()) {
+                events_[downIndex].suspect = Suspect::GHOST;
+                events_[downIndex].note = "ghost";
+            }
+        } else if (evt.suspect == Suspect::CHATTER) {
+            evt.note = "chatter";
+        }
         events_.push_back(evt);
 
         // 最後のキーアップ時刻を更新
@@ -96,6 +97,35 @@ namespace InputRecorder {
         }
     }
 
+    void Recorder::setEventCorrectness(size_t index, bool is_correct) {
+        if (index < events_.size()) {
+            events_[index].is_correct = is_correct;
+        }
+    }
+
+    bool Recorder::isLastEventSuspect() const {
+        return !events_.empty() && events_.back().suspect != Suspect::NONE;
+    }
+
+    PressStatus Recorder::getPressStatus(size_t index) const {
+        if (index >= events_.size()) return PressStatus::REJECTED;
+        const InputEvent& evt = events_[index];
+        if (evt.suspect != Suspect::NONE) return PressStatus::REJECTED;
+
+        // KEY_UPの記録はこれより後の時刻になるので、ここで確定すればゴーストにはならない
+        uint64_t dwell = WinTimer::now_us() - evt.timestamp_us;
+        if (dwell >= chatterDetector_.getConfig().ghostMaxDwellUs) return PressStatus::ACCEPTED;
+        return PressStatus::PENDING;
+    }
+
+    void Recorder::setChatterConfig(const ChatterConfig& config) {
+        chatterDetector_.setConfig(config);
+    }
+
+    const ChatterDetector& Recorder::getChatterDetector() const {
+        return chatterDetector_;
+    }
+
     bool Recorder::isRecording() const {
         return recording_;
     }
@@ -108,6 +138,13 @@ namespace InputRecorder {
         return events_;
     }
 
+    PackedEvents Recorder::takeEvents() {
+        PackedEvents taken{EventView(events_)};
+        clear();
+        events_.shrink_to_fit();    // 詰めた形に移したので、配列の容量も手放す
+        return taken;
+    }
+
     uint64_t Recorder::getSessionDuration() const {
         if (session_start_us_ == 0) return 0;
         return WinTimer::now_us() - session_start_us_;
@@ -118,6 +155,10 @@ namespace InputRecorder {
         session_start_us_ = 0;
         last_keyup_time_us_ = 0;
         recording_ = false;
+        chatterDetector_.reset();
+        for (size_t i = 0; i < CHATTER_KEY_COUNT; ++i) {
+            lastKeyDownIndex_[i] = SIZE_MAX;
+        }
     }
 
 } // namespace InputRecorder
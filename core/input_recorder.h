@@ -10,31 +10,20 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include "input_event.h"
+#include "packed_events.h"
+#include "chatter_detector.h"
 
 namespace InputRecorder {
 
-    // イベントの種類
-    enum class EventType {
-        KEY_DOWN,       // キーを押した瞬間
-        KEY_UP,         // キーを離した瞬間
-        BACKSPACE,      // Backspaceキーの押下
-        CORRECTION      // 修正操作（Backspaceで文字を削除した確定イベント）
-    };
+    // recordKeyDown()が記録しなかった場合の位置
+    constexpr size_t NO_EVENT = static_cast<size_t>(-1);
 
-    // 1つの入力イベントの詳細情報
-    struct InputEvent {
-        EventType type;              // イベントの種類
-        uint64_t timestamp_us;       // イベント発生時刻（マイクロ秒）
-        int vk_code;                 // 仮想キーコード（どのキーが押されたか）
-        int scan_code;               // スキャンコード（物理的なキーの位置）
-        char character;              // 入力された文字（該当する場合）
-        bool is_correct;             // 正しい入力かどうか（判定ロジックで設定）
-        uint64_t inter_key_time_us;  // 直前のキーアップからこのキーダウンまでの時間
-        std::string note;            // 追加情報（デバッグやログ用）
-
-        // コンストラクタ（初期化用）
-        InputEvent();
-        InputEvent(EventType t, uint64_t ts, int vk, int scan, char ch = '\0');
+    // 押下の判定状態（ゴースト押下は押下時間が分かるまで判定できない）
+    enum class PressStatus : uint8_t {
+        PENDING,    // まだ分からない（押下からghostMaxDwellUs未満）
+        ACCEPTED,   // 有効な押下（判定に渡してよい）
+        REJECTED    // チャタリング・ゴースト押下（判定に渡さない）
     };
 
     // 入力イベント記録クラス
@@ -45,6 +34,10 @@ namespace InputRecorder {
         uint64_t last_keyup_time_us_;        // 最後にキーが離された時刻
         bool recording_;                     // 記録中かどうかのフラグ
 
+        // チャタリング検出（キーごとに直近のKEY_DOWNの位置を保持）
+        ChatterDetector chatterDetector_;
+        size_t lastKeyDownIndex_[CHATTER_KEY_COUNT];
+
     public:
         Recorder();
 
@@ -56,7 +49,8 @@ namespace InputRecorder {
 
         // キーダウンイベントを記録
         // vk: 仮想キーコード, scan: スキャンコード, ch: 文字
-        void recordKeyDown(int vk, int scan, char ch = '\0');
+        // 戻り値: 記録したイベントの位置（記録中でなければNO_EVENT）
+        size_t recordKeyDown(int vk, int scan, char ch = '\0');
 
         // キーアップイベントを記録
         void recordKeyUp(int vk, int scan);
@@ -71,6 +65,23 @@ namespace InputRecorder {
         // 最後に記録したイベントに正誤フラグを設定
         void setLastEventCorrectness(bool is_correct);
 
+        // 指定位置のイベントに正誤フラグを設定（判定を押下の確定まで遅らせた場合）
+        void setEventCorrectness(size_t index, bool is_correct);
+
+        // 最後に記録したイベントがチャタリング等の疑いありか
+        bool isLastEventSuspect() const;
+
+        // recordKeyDown()で記録した押下の判定状態
+        // チャタリングはKEY_DOWNの時点で、ゴースト押下はKEY_UPの時点で分かる。
+        // 押したままghostMaxDwellUsを過ぎた押下はゴーストにならないので、その時点で確定する
+        PressStatus getPressStatus(size_t index) const;
+
+        // チャタリング判定の閾値を設定
+        void setChatterConfig(const ChatterConfig& config);
+
+        // チャタリング検出器の取得（キー別の検出回数など）
+        const ChatterDetector& getChatterDetector() const;
+
         // 記録中かどうか
         bool isRecording() const;
 
@@ -80,6 +91,10 @@ namespace InputRecorder {
         // 全イベントの取得（読み取り専用）
         const std::vector<InputEvent>& getEvents() const;
 
+        // 全イベントを詰めた形（PackedEvents）で取り出す（記録はクリアされる）
+        // セッション終了後にイベントをバックグラウンドの処理へ渡すときに使う
+        PackedEvents takeEvents();
+
         // セッションの経過時間（マイクロ秒）
         uint64_t getSessionDuration() const;
 
@@ -0,0 +1,273 @@
+// interval_kernels.cpp
+// タイムスタンプ集計カーネルの実装
+//
+// AVX2版はGCCのtarget属性で関数単位に有効化するため、
+// ビルドフラグ（-mavx2）は不要。AVX2非対応CPUではスカラー版が使われる。
+
+#include "interval_kernels.h"
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define INTERVAL_KERNELS_HAS_AVX2 1
+#include <immintrin.h>
+#else
+#define INTERVAL_KERNELS_HAS_AVX2 0
+#endif
+
+namespace IntervalKernels {
+
+    // ==================== スカラー版 ====================
+
+    namespace {
+
+        void deltaScalar(uint64_t* values, size_t count) {
+            // 後ろから処理すれば元の値を上書きする前に読み終わる
+            for (size_t i = count; i-- > 1; ) {
+                values[i] -= values[i - 1];
+            }
+        }
+
+        Summary summarizeScalar(const uint64_t* values, size_t count) {
+            Summary s{count, 0, 0, 0};
+            if (count == 0) return s;
+
+            s.min = values[0];
+            s.max = values[0];
+            for (size_t i = 0; i < count; ++i) {
+                uint64_t v = values[i];
+                s.sum += v;
+                if (v < s.min) s.min = v;
+                if (v > s.max) s.max = v;
+            }
+            return s;
+        }
+
+        double varianceScalar(const uint64_t* values, size_t count, double mean) {
+            if (count == 0) return 0.0;
+
+            double acc = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                double d = static_cast<double>(values[i]) - mean;
+                acc += d * d;
+            }
+            return acc / count;
+        }
+
+        // 値が入るビン番号（upperEdges[k] 以上であるエッジの数）
+        inline size_t binOf(uint64_t v, const uint64_t* upperEdges, size_t edgeCount) {
+            size_t bin = 0;
+            while (bin < edgeCount && v >= upperEdges[bin]) bin++;
+            return bin;
+        }
+
+        void histogramScalar(const uint64_t* values, size_t count,
+                             const uint64_t* upperEdges, size_t edgeCount, uint32_t* bins) {
+            for (size_t i = 0; i < count; ++i) {
+                bins[binOf(values[i], upperEdges, edgeCount)]++;
+            }
+        }
+
+    } // namespace
+
+    // ==================== AVX2版 ====================
+
+#if INTERVAL_KERNELS_HAS_AVX2
+    namespace {
+
+        // AVX2には符号なし64bit比較がないため、符号ビットを反転して符号付き比較に変換する
+        __attribute__((target("avx2")))
+        inline __m256i flipSign(__m256i v) {
+            return _mm256_xor_si256(v, _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL)));
+        }
+
+        // 2^52未満の整数を倍精度に変換（AVX2には64bit整数→倍精度の変換命令がない）
+        __attribute__((target("avx2")))
+        inline __m256d toDouble(__m256i v) {
+            const __m256i magicBits = _mm256_set1_epi64x(0x4330000000000000LL);   // 2^52
+            const __m256d magic = _mm256_castsi256_pd(magicBits);
+            return _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(v, magicBits)), magic);
+        }
+
+        __attribute__((target("avx2")))
+        void deltaAvx2(uint64_t* values, size_t count) {
+            if (count < 2) return;
+
+            // 末尾から4要素ずつ: values[i-3..i] -= values[i-4..i-1]
+            // 書き込み先より前の要素しか読まないので、後ろから進めればその場で変換できる
+            size_t i = count;
+            while (i >= 5) {
+                __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i - 4));
+                __m256i prev = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i - 5));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i - 4),
+                                    _mm256_sub_epi64(cur, prev));
+                i -= 4;
+            }
+            deltaScalar(values, i);
+        }
+
+        __attribute__((target("avx2")))
+        Summary summarizeAvx2(const uint64_t* values, size_t count) {
+            if (count < 8) return summarizeScalar(values, count);
+
+            __m256i vsum = _mm256_setzero_si256();
+            __m256i vmin = flipSign(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values)));
+            __m256i vmax = vmin;
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+                vsum = _mm256_add_epi64(vsum, v);
+
+                __m256i f = flipSign(v);
+                vmin = _mm256_blendv_epi8(vmin, f, _mm256_cmpgt_epi64(vmin, f));
+                vmax = _mm256_blendv_epi8(vmax, f, _mm256_cmpgt_epi64(f, vmax));
+            }
+
+            alignas(32) uint64_t lanesSum[4], lanesMin[4], lanesMax[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanesSum), vsum);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMin), flipSign(vmin));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanesMax), flipSign(vmax));
+
+            Summary s{count, 0, lanesMin[0], lanesMax[0]};
+            for (int k = 0; k < 4; ++k) {
+                s.sum += lanesSum[k];
+                if (lanesMin[k] < s.min) s.min = lanesMin[k];
+                if (lanesMax[k] > s.max) s.max = lanesMax[k];
+            }
+            for (; i < count; ++i) {
+                uint64_t v = values[i];
+                s.sum += v;
+                if (v < s.min) s.min = v;
+                if (v > s.max) s.max = v;
+            }
+            return s;
+        }
+
+        __attribute__((target("avx2")))
+        double varianceAvx2(const uint64_t* values, size_t count, double mean) {
+            if (count == 0) return 0.0;
+
+            __m256d vmean = _mm256_set1_pd(mean);
+            __m256d acc = _mm256_setzero_pd();
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+                __m256d d = _mm256_sub_pd(toDouble(v), vmean);
+                acc = _mm256_add_pd(acc, _mm256_mul_pd(d, d));
+            }
+
+            alignas(32) double lanes[4];
+            _mm256_store_pd(lanes, acc);
+            double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+            for (; i < count; ++i) {
+                double d = static_cast<double>(values[i]) - mean;
+                total += d * d;
+            }
+            return total / count;
+        }
+
+        __attribute__((target("avx2")))
+        void histogramAvx2(const uint64_t* values, size_t count,
+                           const uint64_t* upperEdges, size_t edgeCount, uint32_t* bins) {
+            // 4値ずつ、各エッジとの比較結果（真で-1）を引いてビン番号を求める
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256i f = flipSign(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+                __m256i binIndex = _mm256_setzero_si256();
+                for (size_t e = 0; e < edgeCount; ++e) {
+                    __m256i edge = flipSign(_mm256_set1_epi64x(static_cast<long long>(upperEdges[e])));
+                    // v >= edge  ⇔  !(edge > v)
+                    __m256i below = _mm256_cmpgt_epi64(edge, f);
+                    binIndex = _mm256_sub_epi64(binIndex, _mm256_xor_si256(below, _mm256_set1_epi64x(-1)));
+                }
+
+                alignas(32) uint64_t lanes[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), binIndex);
+                bins[lanes[0]]++;
+                bins[lanes[1]]++;
+                bins[lanes[2]]++;
+                bins[lanes[3]]++;
+            }
+            histogramScalar(values + i, count - i, upperEdges, edgeCount, bins);
+        }
+
+        bool cpuHasAvx2() {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }
+
+    } // namespace
+#else
+    namespace {
+        bool cpuHasAvx2() { return false; }
+    } // namespace
+#endif
+
+    // ==================== 実行時選択 ====================
+
+    namespace {
+
+        // 選択した命令セット（集計は後処理・集計ツールのスレッドから呼ばれるためatomicで持つ）
+        // 初回の判定はstaticローカルの初期化で1回だけ行う（C++11以降はスレッド安全）
+        std::atomic<Isa>& dispatch() {
+            static std::atomic<Isa> isa(cpuHasAvx2() ? Isa::AVX2 : Isa::SCALAR);
+            return isa;
+        }
+
+        inline bool useAvx2() {
+            return INTERVAL_KERNELS_HAS_AVX2 && dispatch().load(std::memory_order_relaxed) == Isa::AVX2;
+        }
+
+    } // namespace
+
+    Isa activeIsa() {
+        return dispatch().load(std::memory_order_relaxed);
+    }
+
+    void overrideIsa(Isa isa) {
+        dispatch().store((isa == Isa::AVX2 && !cpuHasAvx2()) ? Isa::SCALAR : isa, std::memory_order_relaxed);
+    }
+
+    void deltaInPlace(uint64_t* values, size_t count) {
+#if INTERVAL_KERNELS_HAS_AVX2
+        if (useAvx2()) { deltaAvx2(values, count); return; }
+#endif
+        deltaScalar(values, count);
+    }
+
+    Summary summarize(const uint64_t* values, size_t count) {
+#if INTERVAL_KERNELS_HAS_AVX2
+        if (useAvx2()) return summarizeAvx2(values, count);
+#endif
+        return summarizeScalar(values, count);
+    }
+
+    uint64_t sum(const uint64_t* values, size_t count) {
+        return summarize(values, count).sum;
+    }
+
+    uint64_t min(const uint64_t* values, size_t count) {
+        return summarize(values, count).min;
+    }
+
+    uint64_t max(const uint64_t* values, size_t count) {
+        return summarize(values, count).max;
+    }
+
+    double variance(const uint64_t* values, size_t count, double mean) {
+#if INTERVAL_KERNELS_HAS_AVX2
+        if (useAvx2()) return varianceAvx2(values, count, mean);
+#endif
+        return varianceScalar(values, count, mean);
+    }
+
+    void histogram(const uint64_t* values, size_t count,
+                   const uint64_t* upperEdges, size_t edgeCount, uint32_t* bins) {
+#if INTERVAL_KERNELS_HAS_AVX2
+        if (useAvx2()) { histogramAvx2(values, count, upperEdges, edgeCount, bins); return; }
+#endif
+        histogramScalar(values, count, upperEdges, edgeCount, bins);
+    }
+
+} // namespace IntervalKernels
@@ -0,0 +1,67 @@
+#pragma once
+
+// interval_kernels.h
+// タイムスタンプ配列に対する集計カーネル（SIMD対応）
+//
+// 用語解説:
+// - カーネル(Kernel): 配列全体に同じ処理を繰り返す小さな計算関数
+// - SIMD: 1命令で複数の値をまとめて処理するCPU命令（ここではAVX2で4×64bit）
+// - 実行時選択(Runtime Dispatch): 起動したCPUがAVX2に対応していればAVX2版、
+//   そうでなければスカラー版を使う
+//
+// いずれの関数も一時配列を確保せず、渡された配列の上で処理する。
+// タイムスタンプ・間隔は2^52未満（約142年分のマイクロ秒）を前提とする。
+
+#include <cstdint>
+#include <cstddef>
+
+namespace IntervalKernels {
+
+    // 使用する命令セット
+    enum class Isa {
+        SCALAR,
+        AVX2
+    };
+
+    // 現在使われている命令セット（初回呼び出し時にCPUを判定）
+    Isa activeIsa();
+
+    // 命令セットの強制（テスト・比較用）。CPUが対応していない場合はSCALARになる
+    // 集計中の別スレッドから呼んでもよい（切り替えはその後に始まる呼び出しから効く）
+    void overrideIsa(Isa isa);
+
+    // 間隔配列の要約
+    struct Summary {
+        size_t count;       // 要素数
+        uint64_t sum;       // 合計
+        uint64_t min;       // 最小値（count == 0 のとき0）
+        uint64_t max;       // 最大値（count == 0 のとき0）
+
+        double mean() const { return count > 0 ? static_cast<double>(sum) / count : 0.0; }
+    };
+
+    // タイムスタンプ配列をその場で差分に変換
+    // 実行後: values[0]は元の値のまま、values[i] = 元のvalues[i] - 元のvalues[i-1]（i >= 1）
+    // values は単調非減少であること
+    void deltaInPlace(uint64_t* values, size_t count);
+
+    // 合計・最小・最大を1パスで計算
+    Summary summarize(const uint64_t* values, size_t count);
+
+    // 合計のみ
+    uint64_t sum(const uint64_t* values, size_t count);
+
+    // 最小値・最大値（count == 0 のとき0）
+    uint64_t min(const uint64_t* values, size_t count);
+    uint64_t max(const uint64_t* values, size_t count);
+
+    // 母分散（mean は summarize() 等で求めた平均）
+    double variance(const uint64_t* values, size_t count, double mean);
+
+    // ヒストグラム
+    // upperEdges: 昇順のビン上限（未満）edgeCount個。ビン数は edgeCount + 1
+    // bins: edgeCount + 1 要素の配列に加算する（呼び出し側で初期化）
+    void histogram(const uint64_t* values, size_t count,
+                   const uint64_t* upperEdges, size_t edgeCount, uint32_t* bins);
+
+} // namespace IntervalKernels
@@ -0,0 +1,68 @@
+// packed_events.cpp
+// 記録済みイベント列のメモリ内圧縮の実装
+
+#include "packed_events.h"
+
+namespace InputRecorder {
+
+    PackedEvents::PackedEvents(EventView events) {
+        flags_.reserve(events.size());
+        vkCodes_.reserve(events.size());
+        scanCodes_.reserve(events.size());
+        characters_.reserve(events.size());
+        for (const auto& event : events) {
+            push_back(event);
+        }
+        shrinkToFit();
+    }
+
+    void PackedEvents::push_back(const InputEvent& event) {
+        if (!event.note.empty()) {
+            notes_.emplace_back(static_cast<uint32_t>(flags_.size()), event.note);
+        }
+        timestamps_.push_back(event.timestamp_us);
+        interKeyTimes_.push_back(event.inter_key_time_us);
+        flags_.push_back(packFlags(event));
+        vkCodes_.push_back(event.vk_code);
+        scanCodes_.push_back(event.scan_code);
+        characters_.push_back(event.character);
+    }
+
+    std::vector<InputEvent> PackedEvents::unpack() const {
+        std::vector<InputEvent> events;
+        events.reserve(size());
+        forEach([&events](const InputEvent& event) { events.push_back(event); });
+        return events;
+    }
+
+    size_t PackedEvents::memoryBytes() const {
+        size_t bytes = timestamps_.memoryBytes() + interKeyTimes_.memoryBytes() + flags_.capacity() +
+                       vkCodes_.capacity() * sizeof(int32_t) + scanCodes_.capacity() * sizeof(int32_t) +
+                       characters_.capacity() + notes_.capacity() * sizeof(notes_[0]);
+        for (const auto& note : notes_) {
+            bytes += note.second.capacity();
+        }
+        return bytes;
+    }
+
+    void PackedEvents::shrinkToFit() {
+        timestamps_.shrinkToFit();
+        interKeyTimes_.shrinkToFit();
+        flags_.shrink_to_fit();
+        vkCodes_.shrink_to_fit();
+        scanCodes_.shrink_to_fit();
+        characters_.shrink_to_fit();
+        notes_.shrink_to_fit();
+    }
+
+    void PackedEvents::clear() {
+        timestamps_.clear();
+        interKeyTimes_.clear();
+        flags_.clear();
+        vkCodes_.clear();
+        scanCodes_.clear();
+        characters_.clear();
+        notes_.clear();
+    }
+
+} // namespace InputRecorder
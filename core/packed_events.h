@@ -0,0 +1,103 @@
+#pragma once
+
+// packed_events.h
+// 記録済みイベント列のメモリ内圧縮
+//
+// 用語解説:
+// - パック(Pack): InputEventの配列を列ごとの詰めた形に変換すること。アンパック(Unpack)はその逆
+// - 差分ブロック: DeltaBlocks::Sequence。BLOCK_VALUES個ごとに基準値を持ち、残りを差分の可変長整数で持つ
+//
+// InputEventは1件あたり80バイト（2つのuint64_tとstd::stringを含む）だが、
+// タイムスタンプ・打鍵間隔を差分ブロックに、種類・疑い・正誤を1バイトにまとめ、
+// noteは空でないものだけを持つと、打鍵の記録では1件あたり16バイト前後になる。
+// Recorder::takeEvents()はこの形でイベントを後処理に渡す（キューで待っている間も小さいまま）。
+// 統計計算はforEachでブロックごとに復号しながら読み、InputEventの配列を作り直さない。
+// CSV出力などEventViewで読む処理には、unpack()で配列に戻して渡す。
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "input_event.h"
+#include "delta_blocks.h"
+
+namespace InputRecorder {
+
+    class PackedEvents {
+    private:
+        DeltaBlocks::Sequence timestamps_;
+        DeltaBlocks::Sequence interKeyTimes_;
+        std::vector<uint8_t> flags_;        // 種類(下位2bit)・疑い(2bit)・正誤(1bit)
+        std::vector<int32_t> vkCodes_;
+        std::vector<int32_t> scanCodes_;
+        std::vector<char> characters_;
+        std::vector<std::pair<uint32_t, std::string>> notes_;  // 空でないnote（イベントの位置の順）
+
+        static uint8_t packFlags(const InputEvent& event) {
+            return static_cast<uint8_t>(static_cast<uint8_t>(event.type) |
+                                        (static_cast<uint8_t>(event.suspect) << 2) |
+                                        (event.is_correct ? 0x10 : 0));
+        }
+
+        // index番目の固定長の列をeventに戻す（タイムスタンプ・打鍵間隔・noteは呼び出し側で設定する）
+        void unpackFixed(size_t index, InputEvent& event) const {
+            uint8_t flags = flags_[index];
+            event.type = static_cast<EventType>(flags & 0x03);
+            event.suspect = static_cast<Suspect>((flags >> 2) & 0x03);
+            event.is_correct = (flags & 0x10) != 0;
+            event.vk_code = vkCodes_[index];
+            event.scan_code = scanCodes_[index];
+            event.character = characters_[index];
+        }
+
+    public:
+        PackedEvents() = default;
+        explicit PackedEvents(EventView events);
+
+        // 末尾に追加
+        void push_back(const InputEvent& event);
+
+        size_t size() const { return flags_.size(); }
+        bool empty() const { return flags_.empty(); }
+
+        // 全体を先頭から順に渡す（function(const InputEvent&)）
+        // ブロックごとに復号し、1つのInputEventを書き換えながら渡すので、参照を保持してはいけない
+        template <typename Function>
+        void forEach(Function function) const {
+            uint64_t timestamps[DeltaBlocks::BLOCK_VALUES];
+            uint64_t interKeyTimes[DeltaBlocks::BLOCK_VALUES];
+            InputEvent event;
+            size_t note = 0;
+            for (size_t block = 0; block < timestamps_.blockCount(); ++block) {
+                size_t count = timestamps_.decodeBlock(block, timestamps);
+                interKeyTimes_.decodeBlock(block, interKeyTimes);
+                size_t first = block * DeltaBlocks::BLOCK_VALUES;
+                for (size_t i = 0; i < count; ++i) {
+                    size_t index = first + i;
+                    unpackFixed(index, event);
+                    event.timestamp_us = timestamps[i];
+                    event.inter_key_time_us = interKeyTimes[i];
+                    if (note < notes_.size() && notes_[note].first == index) {
+                        event.note = notes_[note++].second;
+                    } else if (!event.note.empty()) {
+                        event.note.clear();
+                    }
+                    function(static_cast<const InputEvent&>(event));
+                }
+            }
+        }
+
+        // InputEventの配列に戻す
+        std::vector<InputEvent> unpack() const;
+
+        // 使用しているメモリ（確保済みの容量を含む）
+        size_t memoryBytes() const;
+
+        // 余分に確保している容量を解放する（追加が終わった後に呼ぶ）
+        void shrinkToFit();
+
+        void clear();
+    };
+
+} // namespace InputRecorder
@@ -206,10 +206,10 @@ namespace RomajiConverter {
     }
 
     // 部分一致チェック（入力途中かどうか判定）
-    bool Converter::hasPartialMatch(const std::string& romaji) const {
+    bool Converter::hasPartialMatch(std::string_view romaji) const {
         for (const auto& pair : conversionTable_) {
             // テーブルのキーがromajiで始まるかチェック
-            if (pair.first.find(romaji) == 0 && pair.first.length() > romaji.length()) {
+            if (pair.first.length() > romaji.length() && pair.first.compare(0, romaji.length(), romaji) == 0) {
                 return true;
             }
         }
@@ -217,7 +217,7 @@ namespace RomajiConverter {
     }
 
     // ローマ字をかなに変換（最長一致優先）
-    ConvertResult Converter::convert(const std::string& input) {
+    ConvertResult Converter::convert(std::string_view input) {
         if (input.empty()) {
             return ConvertResult(ConvertStatus::NO_MATCH);
         }
@@ -228,16 +228,15 @@ namespace RomajiConverter {
             input[1] != 'i' && input[1] != 'u' && input[1] != 'e' && 
             input[1] != 'o' && input[1] != 'y' && input[1] != 'n') {
             // n + (子音) → ん
-            std::string remaining = input.substr(1);
-            return ConvertResult(ConvertStatus::MATCHED, "ん", "n", remaining);
+            return ConvertResult(ConvertStatus::MATCHED, "ん", "n", std::string(input.substr(1)));
         }
 
         // 最長一致を探す
-        std::string longestMatch = "";
+        std::string_view longestMatch;
         std::string matchedKana = "";
 
         for (size_t len = input.length(); len > 0; --len) {
-            std::string prefix = input.substr(0, len);
+            std::string_view prefix = input.substr(0, len);
             auto it = conversionTable_.find(prefix);
             if (it != conversionTable_.end()) {
                 longestMatch = prefix;
@@ -248,20 +247,20 @@ namespace RomajiConverter {
 
         if (!longestMatch.empty()) {
             // 完全一致
-            std::string remaining = input.substr(longestMatch.length());
-            return ConvertResult(ConvertStatus::MATCHED, matchedKana, longestMatch, remaining);
+            return ConvertResult(ConvertStatus::MATCHED, matchedKana, std::string(longestMatch),
+                                 std::string(input.substr(longestMatch.length())));
         }
 
         // 部分一致チェック
         if (hasPartialMatch(input)) {
-            return ConvertResult(ConvertStatus::PARTIAL, "", "", input);
+            return ConvertResult(ConvertStatus::PARTIAL, "", "", std::string(input));
         }
 
         // 促音の特殊処理: 子音の重複 → っ
         if (input.length() >= 2 && input[0] == input[1] && 
-            std::string("kgsztdhbpmyrwn").find(input[0]) != std::string::npos) {
-            std::string remaining = input.substr(1);
-            return ConvertResult(ConvertStatus::MATCHED, "っ", std::string(1, input[0]), remaining);
+            std::string_view("kgsztdhbpmyrwn").find(input[0]) != std::string_view::npos) {
+            return ConvertResult(ConvertStatus::MATCHED, "っ", std::string(1, input[0]),
+                                 std::string(input.substr(1)));
         }
 
         // 一致なし
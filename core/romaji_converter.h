@@ -9,6 +9,7 @@
 // - 複数表記(Multi-variant): 1つのかなに複数のローマ字表記がある（例: し=shi/si）
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
 
@@ -38,21 +39,22 @@ namespace RomajiConverter {
     private:
         // 変換テーブル: ローマ字 → かな
         // 複数のローマ字表記を持つかなに対応
-        std::map<std::string, std::string> conversionTable_;
+        // 比較はstd::less<>（部分文字列をstring_viewのまま探す）
+        std::map<std::string, std::string, std::less<>> conversionTable_;
         
         // 初期化用ヘルパー
         void initializeTable();
         
         // 部分一致チェック（入力途中かどうか）
-        bool hasPartialMatch(const std::string& romaji) const;
+        bool hasPartialMatch(std::string_view romaji) const;
 
     public:
         Converter();
 
         // ローマ字をかなに変換
-        // input: 変換対象のローマ字文字列
+        // input: 変換対象のローマ字文字列（文字列の一部をコピーせずに渡せる）
         // 戻り値: 変換結果（status, kana, consumed, remaining）
-        ConvertResult convert(const std::string& input);
+        ConvertResult convert(std::string_view input);
 
         // 最長一致変換（貪欲マッチ）
         // input: 変換対象のローマ字文字列
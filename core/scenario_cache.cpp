@@ -0,0 +1,386 @@
+// scenario_cache.cpp
+// シナリオのバイナリキャッシュの実装
+
+#include "scenario_cache.h"
+#include "scenario_stream.h"
+#include "romaji_converter.h"
+#include "../helper/text_width.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace ScenarioCache {
+
+    static const char MAGIC[8] = {'T', 'P', 'S', 'C', 'A', 'C', 'H', 'E'};
+
+    // ローマ字1つの最長（変換テーブルのキーはこれより短い）
+    static const size_t ROMAJI_WINDOW = 8;
+
+    // マップした領域をそのまま構造として読むので、詰め物の位置まで固定しておく
+    static_assert(sizeof(StringRef) == 8, "StringRef layout");
+    static_assert(sizeof(FileHeader) == 88, "FileHeader layout");
+    static_assert(sizeof(EntryRecord) == 48, "EntryRecord layout");
+    static_assert(std::is_trivially_copyable<FileHeader>::value && std::is_trivially_copyable<EntryRecord>::value,
+                  "cache records must be trivially copyable");
+
+    // 実行中のプロセスID（同時に作り直す別プロセスと一時ファイルが重ならないようにする）
+    static unsigned long currentProcessId() {
+#ifdef _WIN32
+        return static_cast<unsigned long>(_getpid());
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+
+    // 元のシナリオの更新時刻とサイズ
+    static bool sourceStamp(const std::string& sourcePath, int64_t& mtime, uint64_t& size) {
+        std::error_code ec;
+        auto time = fs::last_write_time(sourcePath, ec);
+        if (ec) return false;
+        uintmax_t bytes = fs::file_size(sourcePath, ec);
+        if (ec) return false;
+        mtime = static_cast<int64_t>(time.time_since_epoch().count());
+        size = static_cast<uint64_t>(bytes);
+        return true;
+    }
+
+    // ---- Image ----
+
+    Image::Image()
+        : header_(nullptr)
+        , entries_(nullptr)
+        , kana_(nullptr)
+        , kanaIds_(nullptr)
+        , strings_(nullptr)
+    {
+    }
+
+    bool Image::open(const std::string& cachePath) {
+        close();
+        if (!file_.open(cachePath)) return false;
+
+        if (file_.size() < sizeof(FileHeader)) {
+            close();
+            return false;
+        }
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(file_.data());
+        if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != FORMAT_VERSION) {
+            close();
+            return false;
+        }
+
+        // 各領域の大きさの合計がファイルのサイズと一致すること（書きかけ・切り詰めを弾く）
+        uint64_t entriesBytes = static_cast<uint64_t>(header->entryCount) * sizeof(EntryRecord);
+        uint64_t kanaBytes = static_cast<uint64_t>(header->kanaCount) * sizeof(StringRef);
+        uint64_t idsBytes = static_cast<uint64_t>(header->kanaIdCount) * sizeof(uint16_t);
+        if (sizeof(FileHeader) + entriesBytes + kanaBytes + idsBytes + header->stringsSize != file_.size()) {
+            close();
+            return false;
+        }
+
+        const char* base = file_.data() + sizeof(FileHeader);
+        header_ = header;
+        entries_ = reinterpret_cast<const EntryRecord*>(base);
+        kana_ = reinterpret_cast<const StringRef*>(base + entriesBytes);
+        kanaIds_ = reinterpret_cast<const uint16_t*>(base + entriesBytes + kanaBytes);
+        strings_ = base + entriesBytes + kanaBytes + idsBytes;
+        return true;
+    }
+
+    void Image::close() {
+        file_.close();
+        header_ = nullptr;
+        entries_ = nullptr;
+        kana_ = nullptr;
+        kanaIds_ = nullptr;
+        strings_ = nullptr;
+    }
+
+    Entry Image::entry(size_t index) const {
+        const EntryRecord& record = entries_[index];
+        Entry entry;
+        entry.key = string(record.key);
+        entry.text = string(record.text);
+        entry.rubi = string(record.rubi);
+        entry.level = string(record.level);
+        if (static_cast<uint64_t>(record.kanaFirst) + record.kanaCount <= header_->kanaIdCount) {
+            entry.kanaIds = kanaIds_ + record.kanaFirst;
+            entry.kanaCount = record.kanaCount;
+        } else {
+            entry.kanaIds = nullptr;
+            entry.kanaCount = 0;
+        }
+        entry.textWidth = static_cast<int>(record.textWidth);
+        entry.rubiWidth = static_cast<int>(record.rubiWidth);
+        return entry;
+    }
+
+    bool Image::find(std::string_view key, Entry& entry) const {
+        for (size_t i = 0; i < header_->entryCount; ++i) {
+            if (string(entries_[i].key) == key) {
+                entry = this->entry(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ---- 作成 ----
+
+    std::string cachePathFor(const std::string& sourcePath) {
+        return sourcePath + CACHE_SUFFIX;
+    }
+
+    uint64_t hashBytes(const char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    namespace {
+
+        // キャッシュの内容を組み立てる
+        class Builder {
+        private:
+            std::string strings_;
+            std::vector<EntryRecord> entries_;
+            std::vector<StringRef> kana_;
+            std::vector<uint16_t> kanaIds_;
+            std::unordered_map<std::string, uint16_t> kanaIndex_;
+            RomajiConverter::Converter converter_;
+            std::string rubi_;
+            bool overflow_;
+
+            StringRef addString(std::string_view text) {
+                if (strings_.size() + text.size() > UINT32_MAX) {
+                    overflow_ = true;
+                    return StringRef{0, 0};
+                }
+                StringRef ref{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(text.size())};
+                strings_.append(text.data(), text.size());
+                return ref;
+            }
+
+            uint16_t internKana(const std::string& kana) {
+                auto it = kanaIndex_.find(kana);
+                if (it != kanaIndex_.end()) return it->second;
+                if (kana_.size() > UINT16_MAX) {
+                    overflow_ = true;
+                    return 0;
+                }
+                uint16_t id = static_cast<uint16_t>(kana_.size());
+                kana_.push_back(addString(kana));
+                kanaIndex_.emplace(kana, id);
+                return id;
+            }
+
+            // ルビをかなに区切ってIDを追加する（判定と同じく小文字にしてから変換する）
+            // 戻り値: 区切ったかなの数
+            uint32_t addKana(const std::string& rubi) {
+                rubi_ = rubi;
+                std::transform(rubi_.begin(), rubi_.end(), rubi_.begin(),
+                               [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+                uint32_t count = 0;
+                size_t pos = 0;
+                while (pos < rubi_.size()) {
+                    // 変換テーブルのキーより長い部分は結果に影響しないので、先頭の数文字だけを渡す
+                    // （コピーせずにstring_viewで渡す）
+                    RomajiConverter::ConvertResult result =
+                        converter_.convert(std::string_view(rubi_).substr(pos, ROMAJI_WINDOW));
+                    if (result.status != RomajiConverter::ConvertStatus::MATCHED || result.consumed.empty()) break;
+                    kanaIds_.push_back(internKana(result.kana));
+                    pos += result.consumed.size();
+                    count++;
+                }
+                return count;
+            }
+
+        public:
+            Builder() : overflow_(false) {}
+
+            void addEntry(const ScenarioStream::Entry& entry) {
+                EntryRecord record;
+                record.key = addString(entry.key);
+                record.text = addString(entry.text);
+                record.rubi = addString(entry.rubi);
+                record.level = addString(entry.level);
+                record.kanaFirst = static_cast<uint32_t>(kanaIds_.size());
+                record.kanaCount = addKana(entry.rubi);
+                record.textWidth = static_cast<uint32_t>(TextWidth::displayWidth(entry.text));
+                record.rubiWidth = static_cast<uint32_t>(TextWidth::displayWidth(entry.rubi));
+                if (entries_.size() >= UINT32_MAX || kanaIds_.size() > UINT32_MAX) overflow_ = true;
+                entries_.push_back(record);
+            }
+
+            bool overflow() const { return overflow_; }
+
+            // ファイルに書き出す
+            bool write(std::ofstream& out, FileHeader header, const std::string& sourcePath,
+                       const ScenarioStream::Meta& meta) {
+                header.sourcePath = addString(sourcePath);
+                header.name = addString(meta.name);
+                header.uniqueId = addString(meta.uniqueId);
+                header.requiredVersion = addString(meta.requiredVersion);
+                if (overflow_) return false;
+
+                std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+                header.version = FORMAT_VERSION;
+                header.entryCount = static_cast<uint32_t>(entries_.size());
+                header.kanaCount = static_cast<uint32_t>(kana_.size());
+                header.kanaIdCount = static_cast<uint32_t>(kanaIds_.size());
+                header.stringsSize = strings_.size();
+
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char*>(entries_.data()), entries_.size() * sizeof(EntryRecord));
+                out.write(reinterpret_cast<const char*>(kana_.data()), kana_.size() * sizeof(StringRef));
+                out.write(reinterpret_cast<const char*>(kanaIds_.data()), kanaIds_.size() * sizeof(uint16_t));
+                out.write(strings_.data(), strings_.size());
+                return out.good();
+            }
+        };
+
+    } // namespace
+
+    // 書き終えた一時ファイルでキャッシュを置き換える（失敗したら一時ファイルを消す）
+    static bool replaceCache(const std::string& tempPath, const std::string& cachePath) {
+        std::error_code ec;
+        fs::rename(tempPath, cachePath, ec);
+        if (ec) {
+            // 別のプロセスがマップしている間は置き換えられないことがある（Windows）
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool build(const std::string& sourcePath, const std::string& cachePath, std::string& error) {
+        // 読む前に時刻を取る（作成中に元が変わっても、次のload()で古いと判定される）
+        FileHeader header = {};
+        if (!sourceStamp(sourcePath, header.sourceMtime, header.sourceSize)) {
+            error = "cannot open " + sourcePath;
+            return false;
+        }
+        {
+            FileMapping::MappedFile source;
+            if (!source.open(sourcePath)) {
+                error = "cannot open " + sourcePath;
+                return false;
+            }
+            header.sourceHash = hashBytes(source.data(), source.size());
+        }
+
+        ScenarioStream::EntryReader reader;
+        if (!reader.open(sourcePath)) {
+            error = reader.error();
+            return false;
+        }
+        Builder builder;
+        ScenarioStream::Entry entry;
+        while (reader.next(entry)) {
+            builder.addEntry(entry);
+        }
+        if (!reader.error().empty()) {
+            error = reader.error();
+            return false;
+        }
+
+        // 一時ファイルに書いてから置き換える
+        std::string tempPath = cachePath + ".tmp" + std::to_string(currentProcessId());
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                error = "cannot write " + tempPath;
+                return false;
+            }
+            if (!builder.write(out, header, sourcePath, reader.meta())) {
+                out.close();
+                std::error_code ec;
+                fs::remove(tempPath, ec);
+                error = builder.overflow() ? "scenario too large for cache" : "cannot write " + tempPath;
+                return false;
+            }
+        }
+        if (!replaceCache(tempPath, cachePath)) {
+            error = "cannot replace " + cachePath;
+            return false;
+        }
+        return true;
+    }
+
+    // 記録した更新時刻だけを書き換える
+    // マップ中の別のプロセスの像を変えないよう、build()と同じく一時ファイルに写してから置き換える
+    static bool restamp(const std::string& cachePath, int64_t mtime) {
+        std::string tempPath = cachePath + ".tmp" + std::to_string(currentProcessId());
+        {
+            FileMapping::MappedFile cache;
+            if (!cache.open(cachePath) || cache.size() < sizeof(FileHeader)) return false;
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) return false;
+            const size_t stampEnd = offsetof(FileHeader, sourceMtime) + sizeof(mtime);
+            out.write(cache.data(), offsetof(FileHeader, sourceMtime));
+            out.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+            out.write(cache.data() + stampEnd, static_cast<std::streamsize>(cache.size() - stampEnd));
+            out.close();
+            if (!out) {
+                std::error_code ec;
+                fs::remove(tempPath, ec);
+                return false;
+            }
+        }
+        return replaceCache(tempPath, cachePath);
+    }
+
+    LoadStatus load(const std::string& sourcePath, Image& image, std::string& error) {
+        std::string cachePath = cachePathFor(sourcePath);
+        int64_t mtime;
+        uint64_t size;
+        if (!sourceStamp(sourcePath, mtime, size)) {
+            image.close();
+            error = "cannot open " + sourcePath;
+            return LoadStatus::FAILED;
+        }
+
+        if (image.open(cachePath)) {
+            const FileHeader& header = image.header();
+            bool samePath = image.sourcePath() == sourcePath;
+            if (samePath && header.sourceMtime == mtime && header.sourceSize == size) {
+                return LoadStatus::HIT;
+            }
+
+            // 時刻だけが変わった（内容を書き戻した・コピーした）場合は内容のハッシュで判定する
+            bool sameContent = false;
+            if (samePath && header.sourceSize == size) {
+                FileMapping::MappedFile source;
+                sameContent = source.open(sourcePath) && hashBytes(source.data(), source.size()) == header.sourceHash;
+            }
+            image.close();
+            if (sameContent && restamp(cachePath, mtime) && image.open(cachePath)) {
+                return LoadStatus::RESTAMPED;
+            }
+        }
+
+        if (!build(sourcePath, cachePath, error) || !image.open(cachePath)) {
+            image.close();
+            if (error.empty()) error = "cannot open " + cachePath;
+            return LoadStatus::FAILED;
+        }
+        return LoadStatus::REBUILT;
+    }
+
+} // namespace ScenarioCache
@@ -0,0 +1,155 @@
+#pragma once
+
+// scenario_cache.h
+// シナリオのバイナリキャッシュ（メモリマップしてそのまま使える形式）
+//
+// 用語解説:
+// - キャッシュ(Cache): 元のシナリオ（JSON）から作った、すぐ使える形のファイル。元と並べて置く（例: beginner.json.tpsc）
+// - イメージ(Image): ファイルの内容をメモリ上の構造としてそのまま使える配置。読み込み時の解析や確保がない
+// - かなID: キャッシュ内のかな表の番号。エントリのルビをかなに区切った列をIDの列で持つ
+// - 古い(Stale): 元のシナリオが変わっていて、キャッシュを作り直す必要がある状態
+//
+// 起動のたびにJSONを解析し、ルビのかな分割や表示幅の計算をやり直すのを避ける。
+// load()は元のシナリオの更新時刻・サイズがキャッシュに記録したものと同じなら、キャッシュをマップするだけで返す。
+// 違う場合は内容のハッシュを比べ、同じなら記録した更新時刻だけを書き換え、違えば作り直す。
+// キャッシュは作り直し・時刻の書き換えとも一時ファイルに書いてから名前を変えるので、
+// 同時に起動した別のプロセスが書きかけを読むことはない。
+//
+// ファイル形式（リトルエンディアン、すべて固定長）:
+//   ヘッダ(FileHeader)
+//   エントリ(EntryRecord) × entryCount
+//   かな表(StringRef) × kanaCount
+//   かなID(uint16_t) × kanaIdCount
+//   文字列領域（UTF-8、StringRefが位置と長さで指す）
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../helper/mapped_file.h"
+
+namespace ScenarioCache {
+
+    // キャッシュのファイル名の接尾辞（元のファイル名に付ける）
+    constexpr const char* CACHE_SUFFIX = ".tpsc";
+
+    constexpr uint32_t FORMAT_VERSION = 1;
+
+    // 文字列領域の位置と長さ
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct FileHeader {
+        char magic[8];              // "TPSCACHE"
+        uint32_t version;
+        uint32_t entryCount;
+        int64_t sourceMtime;        // 元のシナリオの更新時刻（ファイルシステムの時刻の刻み）
+        uint64_t sourceSize;        // 元のシナリオのバイト数
+        uint64_t sourceHash;        // 元のシナリオの内容のハッシュ（FNV-1a 64bit）
+        uint32_t kanaCount;
+        uint32_t kanaIdCount;
+        uint64_t stringsSize;
+        StringRef sourcePath;
+        StringRef name;
+        StringRef uniqueId;
+        StringRef requiredVersion;
+    };
+
+    struct EntryRecord {
+        StringRef key;
+        StringRef text;
+        StringRef rubi;
+        StringRef level;
+        uint32_t kanaFirst;         // かなIDの列の先頭（かなID全体の中の位置）
+        uint32_t kanaCount;         // ルビをかなに区切った数（かなに変換できない部分があればそこまで）
+        uint32_t textWidth;         // textの表示幅
+        uint32_t rubiWidth;         // rubiの表示幅
+    };
+
+    // エントリ（文字列はマップしたキャッシュを指す）
+    // かなID・表示幅は後から使う処理（かな単位の判定・画面の配置）のために作成時に計算しておく。
+    // 今のタイピング画面はtext・rubiだけを使う
+    struct Entry {
+        std::string_view key;
+        std::string_view text;
+        std::string_view rubi;
+        std::string_view level;
+        const uint16_t* kanaIds;
+        size_t kanaCount;
+        int textWidth;
+        int rubiWidth;
+    };
+
+    // load()の結果
+    enum class LoadStatus {
+        HIT,            // キャッシュをそのまま使った
+        RESTAMPED,      // 更新時刻だけが違った（内容は同じなので記録を書き換えた）
+        REBUILT,        // 作り直した（キャッシュがない・古い・壊れている）
+        FAILED          // 元のシナリオを読めない・キャッシュを書けない
+    };
+
+    // マップしたキャッシュ
+    class Image {
+    private:
+        FileMapping::MappedFile file_;
+        const FileHeader* header_;
+        const EntryRecord* entries_;
+        const StringRef* kana_;
+        const uint16_t* kanaIds_;
+        const char* strings_;
+
+        // 文字列領域の範囲外を指す場合は空
+        std::string_view string(const StringRef& ref) const {
+            if (static_cast<uint64_t>(ref.offset) + ref.length > header_->stringsSize) return std::string_view();
+            return std::string_view(strings_ + ref.offset, ref.length);
+        }
+
+    public:
+        Image();
+
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+
+        // キャッシュをマップして形式を検査する（ヘッダと全体のサイズだけを見る。元のシナリオとの比較はしない）
+        // 戻り値: 成功時true
+        bool open(const std::string& cachePath);
+
+        void close();
+
+        bool isOpen() const { return header_ != nullptr; }
+
+        const FileHeader& header() const { return *header_; }
+
+        size_t entryCount() const { return header_->entryCount; }
+        Entry entry(size_t index) const;
+
+        // キーでエントリを探す（先頭から順に比べる）
+        // 戻り値: 見つかればtrue
+        bool find(std::string_view key, Entry& entry) const;
+
+        size_t kanaCount() const { return header_->kanaCount; }
+        std::string_view kana(uint16_t id) const { return id < header_->kanaCount ? string(kana_[id]) : std::string_view(); }
+
+        std::string_view sourcePath() const { return string(header_->sourcePath); }
+        std::string_view name() const { return string(header_->name); }
+        std::string_view uniqueId() const { return string(header_->uniqueId); }
+        std::string_view requiredVersion() const { return string(header_->requiredVersion); }
+    };
+
+    // 元のシナリオに対応するキャッシュのパス
+    std::string cachePathFor(const std::string& sourcePath);
+
+    // 内容のハッシュ（FNV-1a 64bit）
+    uint64_t hashBytes(const char* data, size_t size);
+
+    // 元のシナリオからキャッシュを作る
+    // 戻り値: 成功時true（失敗時はerrorに理由）
+    bool build(const std::string& sourcePath, const std::string& cachePath, std::string& error);
+
+    // 元のシナリオのキャッシュをマップする（古い・ない場合は作り直す）
+    // 戻り値: 結果（FAILED以外ならimageを使える。FAILEDの場合はerrorに理由）
+    LoadStatus load(const std::string& sourcePath, Image& image, std::string& error);
+
+} // namespace ScenarioCache
@@ -0,0 +1,355 @@
+// scenario_catalog.cpp
+// シナリオディレクトリの目録の実装
+
+#include "scenario_catalog.h"
+#include "scenario_stream.h"
+#include "../helper/work_stealing_pool.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace ScenarioCatalog {
+
+    static const char* CATALOG_HEADER = "record,path_or_key,mtime_or_level,bytes_or_length,ok,name,uniqueid,requiredver";
+
+    // 実行中のプロセスID（同時に保存する別プロセスと一時ファイルが重ならないようにする）
+    static unsigned long currentProcessId() {
+#ifdef _WIN32
+        return static_cast<unsigned long>(_getpid());
+#else
+        return static_cast<unsigned long>(getpid());
+#endif
+    }
+
+    // UTF-8の文字数
+    static uint32_t countChars(const std::string& text) {
+        uint32_t count = 0;
+        for (char c : text) {
+            if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) count++;
+        }
+        return count;
+    }
+
+    // ---- CSVの文字列 ----
+
+    // 文字列の列を書く（, " を含めば "" で囲む。改行は行区切りと区別できないので空白にする）
+    static void writeText(std::ofstream& file, const std::string& text) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) {
+            file << text;
+            return;
+        }
+        file << '"';
+        for (char c : text) {
+            if (c == '"') {
+                file << "\"\"";
+            } else if (c == '\r' || c == '\n') {
+                file << ' ';
+            } else {
+                file << c;
+            }
+        }
+        file << '"';
+    }
+
+    // 次の列を読む（"" で囲んだ列にも対応）
+    // 戻り値: 列があればtrue
+    static bool nextField(const std::string& line, size_t& pos, std::string& field) {
+        if (pos > line.size()) return false;
+        field.clear();
+        if (pos < line.size() && line[pos] == '"') {
+            size_t i = pos + 1;
+            while (i < line.size()) {
+                if (line[i] == '"') {
+                    if (i + 1 < line.size() && line[i + 1] == '"') {
+                        field += '"';
+                        i += 2;
+                        continue;
+                    }
+                    break;
+                }
+                field += line[i++];
+            }
+            if (i >= line.size()) return false;  // 閉じる " がない
+            i++;
+            if (i < line.size() && line[i] != ',') return false;
+            pos = i + 1;
+            return true;
+        }
+        size_t comma = line.find(',', pos);
+        if (comma == std::string::npos) comma = line.size();
+        field.assign(line, pos, comma - pos);
+        pos = comma + 1;
+        return true;
+    }
+
+    template <typename T>
+    static bool parseInteger(const std::string& field, T& value) {
+        if (field.empty()) return false;
+        size_t i = 0;
+        bool negative = field[0] == '-';
+        if (negative) i = 1;
+        if (i >= field.size()) return false;
+        T result = 0;
+        for (; i < field.size(); ++i) {
+            if (field[i] < '0' || field[i] > '9') return false;
+            result = static_cast<T>(result * 10 + (field[i] - '0'));
+        }
+        value = negative ? static_cast<T>(0 - result) : result;
+        return true;
+    }
+
+    // ---- 1シナリオの読み込み ----
+
+    bool readScenario(const std::string& filePath, ScenarioInfo& info, std::vector<std::string>& levels) {
+        info.ok = false;
+        info.name.clear();
+        info.uniqueId.clear();
+        info.requiredVersion.clear();
+        info.entries.clear();
+        levels.clear();
+
+        ScenarioStream::EntryReader reader;
+        if (!reader.open(filePath)) return false;
+
+        ScenarioStream::Entry entry;
+        while (reader.next(entry)) {
+            uint32_t level = 0;
+            while (level < levels.size() && levels[level] != entry.level) level++;
+            if (level == levels.size()) levels.push_back(entry.level);
+            info.entries.push_back(EntryInfo{entry.key, level, countChars(entry.rubi)});
+        }
+        if (!reader.error().empty()) {
+            info.entries.clear();
+            return false;
+        }
+
+        // metaはエントリより後ろにあっても最後まで読めば揃う
+        info.name = reader.meta().name;
+        info.uniqueId = reader.meta().uniqueId;
+        info.requiredVersion = reader.meta().requiredVersion;
+        info.ok = true;
+        return true;
+    }
+
+    // ---- Catalog ----
+
+    uint32_t Catalog::internLevel(const std::string& level) {
+        auto it = levelIds_.find(level);
+        if (it != levelIds_.end()) return it->second;
+        uint32_t id = static_cast<uint32_t>(levels_.size());
+        levels_.push_back(level);
+        levelIds_.emplace(level, id);
+        return id;
+    }
+
+    bool Catalog::findLevel(std::string_view level, uint32_t& id) const {
+        auto it = levelIds_.find(std::string(level));
+        if (it == levelIds_.end()) return false;
+        id = it->second;
+        return true;
+    }
+
+    void Catalog::clear() {
+        scenarios_.clear();
+        levels_.clear();
+        levelIds_.clear();
+    }
+
+    bool Catalog::load(const std::string& catalogPath) {
+        clear();
+        std::ifstream file(catalogPath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line != CATALOG_HEADER) {
+            return false;
+        }
+
+        // 壊れた行があれば、そのシナリオはカタログにないものとして扱う（refreshで読み直す）
+        std::string field;
+        bool currentValid = false;
+        while (std::getline(file, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t pos = 0;
+            if (!nextField(line, pos, field)) continue;
+
+            if (field == "S") {
+                ScenarioInfo info;
+                uint32_t ok = 0;
+                currentValid = nextField(line, pos, info.path) && !info.path.empty() &&
+                               nextField(line, pos, field) && parseInteger(field, info.mtime) &&
+                               nextField(line, pos, field) && parseInteger(field, info.bytes) &&
+                               nextField(line, pos, field) && parseInteger(field, ok) &&
+                               nextField(line, pos, info.name) &&
+                               nextField(line, pos, info.uniqueId) &&
+                               nextField(line, pos, info.requiredVersion);
+                if (currentValid) {
+                    info.ok = ok != 0;
+                    scenarios_.push_back(std::move(info));
+                }
+            } else if (field == "E" && currentValid) {
+                EntryInfo entry;
+                std::string level;
+                if (!nextField(line, pos, entry.key) || !nextField(line, pos, level) ||
+                    !nextField(line, pos, field) || !parseInteger(field, entry.length)) {
+                    scenarios_.pop_back();
+                    currentValid = false;
+                    continue;
+                }
+                entry.level = internLevel(level);
+                scenarios_.back().entries.push_back(std::move(entry));
+            }
+        }
+
+        std::sort(scenarios_.begin(), scenarios_.end(),
+                  [](const ScenarioInfo& a, const ScenarioInfo& b) { return a.path < b.path; });
+        return true;
+    }
+
+    bool Catalog::save(const std::string& catalogPath) const {
+        // 一時ファイルに書いてから置き換える（同時に起動した別プロセスが書きかけを読まないように）
+        std::string tempPath = catalogPath + ".tmp" + std::to_string(currentProcessId());
+        std::ofstream file(tempPath, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << CATALOG_HEADER << '\n';
+        for (const ScenarioInfo& info : scenarios_) {
+            file << "S,";
+            writeText(file, info.path);
+            file << ',' << info.mtime << ',' << info.bytes << (info.ok ? ",1," : ",0,");
+            writeText(file, info.name);
+            file << ',';
+            writeText(file, info.uniqueId);
+            file << ',';
+            writeText(file, info.requiredVersion);
+            file << '\n';
+            for (const EntryInfo& entry : info.entries) {
+                file << "E,";
+                writeText(file, entry.key);
+                file << ',';
+                writeText(file, levels_[entry.level]);
+                file << ',' << entry.length << '\n';
+            }
+        }
+
+        std::error_code ec;
+        file.close();
+        if (!file) {
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        fs::rename(tempPath, catalogPath, ec);
+        if (ec) {
+            fs::remove(tempPath, ec);
+            return false;
+        }
+        return true;
+    }
+
+    RefreshStats Catalog::refresh(const std::string& directory, size_t threadCount) {
+        RefreshStats stats;
+
+        // ディレクトリ以下のシナリオ（*.json）
+        struct FileStamp {
+            std::string path;
+            int64_t mtime;
+            uint64_t bytes;
+        };
+        std::vector<FileStamp> files;
+        std::error_code ec;
+        fs::path root(directory);
+        for (fs::recursive_directory_iterator it(root, ec), end; !ec && it != end; it.increment(ec)) {
+            std::error_code entryError;
+            if (!it->is_regular_file(entryError) || it->path().extension() != ".json") continue;
+            auto time = it->last_write_time(entryError);
+            uintmax_t bytes = it->file_size(entryError);
+            if (entryError) continue;
+            files.push_back(FileStamp{it->path().lexically_relative(root).generic_string(),
+                                      static_cast<int64_t>(time.time_since_epoch().count()),
+                                      static_cast<uint64_t>(bytes)});
+        }
+        std::sort(files.begin(), files.end(),
+                  [](const FileStamp& a, const FileStamp& b) { return a.path < b.path; });
+
+        // カタログと突き合わせる（どちらもpathの順）
+        std::vector<ScenarioInfo> next(files.size());
+        std::vector<size_t> toLoad;
+        size_t old = 0;
+        for (size_t i = 0; i < files.size(); ++i) {
+            while (old < scenarios_.size() && scenarios_[old].path < files[i].path) {
+                old++;
+                stats.removed++;
+            }
+            bool known = old < scenarios_.size() && scenarios_[old].path == files[i].path;
+            if (known && scenarios_[old].mtime == files[i].mtime && scenarios_[old].bytes == files[i].bytes) {
+                next[i] = std::move(scenarios_[old]);
+                stats.reused++;
+            } else {
+                next[i].path = files[i].path;
+                next[i].mtime = files[i].mtime;
+                next[i].bytes = files[i].bytes;
+                toLoad.push_back(i);
+            }
+            if (known) old++;
+        }
+        stats.removed += scenarios_.size() - old;
+
+        // 変わったファイルを並列に読み込む（レベル名はファイルごとに集め、後でカタログの番号に直す）
+        std::vector<std::vector<std::string>> fileLevels(toLoad.size());
+        Parallel::forEach(toLoad.size(), threadCount, [&](size_t index, size_t /*worker*/) {
+            ScenarioInfo& info = next[toLoad[index]];
+            readScenario((root / fs::u8path(info.path)).string(), info, fileLevels[index]);
+        });
+        for (size_t i = 0; i < toLoad.size(); ++i) {
+            ScenarioInfo& info = next[toLoad[i]];
+            std::vector<uint32_t> ids;
+            ids.reserve(fileLevels[i].size());
+            for (const std::string& level : fileLevels[i]) ids.push_back(internLevel(level));
+            for (EntryInfo& entry : info.entries) entry.level = ids[entry.level];
+            stats.loaded++;
+            if (!info.ok) stats.failed++;
+        }
+
+        scenarios_ = std::move(next);
+        return stats;
+    }
+
+    std::vector<Match> Catalog::select(std::string_view level, uint32_t minLength, uint32_t maxLength) const {
+        std::vector<Match> matches;
+        uint32_t levelId = 0;
+        if (!level.empty() && !findLevel(level, levelId)) return matches;
+        for (size_t s = 0; s < scenarios_.size(); ++s) {
+            const std::vector<EntryInfo>& entries = scenarios_[s].entries;
+            for (size_t e = 0; e < entries.size(); ++e) {
+                if (!level.empty() && entries[e].level != levelId) continue;
+                if (entries[e].length < minLength || entries[e].length > maxLength) continue;
+                matches.push_back(Match{s, e});
+            }
+        }
+        return matches;
+    }
+
+    std::vector<size_t> Catalog::selectScenarios(std::string_view level, uint32_t minLength, uint32_t maxLength) const {
+        std::vector<size_t> result;
+        for (const Match& match : select(level, minLength, maxLength)) {
+            if (result.empty() || result.back() != match.scenario) result.push_back(match.scenario);
+        }
+        return result;
+    }
+
+} // namespace ScenarioCatalog
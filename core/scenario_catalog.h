@@ -0,0 +1,107 @@
+#pragma once
+
+// scenario_catalog.h
+// シナリオディレクトリの目録（カタログ）
+//
+// 用語解説:
+// - カタログ(Catalog): ディレクトリ内の全シナリオのmeta（name・uniqueid・requiredver）と、
+//   エントリごとのレベル・長さの一覧。ファイルを読み直さずにレベルや長さでシナリオを選べる
+// - 長さ(Length): エントリのルビの文字数（入力する打鍵数）
+// - レベルID: カタログ内のレベル名の表の番号（"basic"などの文字列をエントリごとに持たない）
+//
+// refresh()はディレクトリ以下の*.jsonを列挙し、更新時刻・サイズがカタログと同じファイルはそのまま使い、
+// 変わったファイル・新しいファイルだけをワークスティーリングで並列に読み込む（消えたファイルは除く）。
+// カタログはCSV（CATALOG_FILENAME）としてディレクトリに保存し、次の起動ではload()してからrefresh()する。
+//
+// 保存形式（1行目は見出し。文字列に , や " を含む場合は "" で囲み、" は "" と書く）:
+//   S,path,mtime,bytes,ok,name,uniqueid,requiredver   シナリオ（pathはディレクトリからの相対パス）
+//   E,key,level,length                                直前のシナリオのエントリ
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ScenarioCatalog {
+
+    // カタログのファイル名（シナリオディレクトリ内）
+    constexpr const char* CATALOG_FILENAME = "scenario_catalog.csv";
+
+    struct EntryInfo {
+        std::string key;
+        uint32_t level;     // レベルID（Catalog::levelName）
+        uint32_t length;    // ルビの文字数
+    };
+
+    struct ScenarioInfo {
+        std::string path;               // ディレクトリからの相対パス（区切りは /）
+        int64_t mtime = 0;              // 更新時刻（ファイルシステムの時刻の刻み）
+        uint64_t bytes = 0;
+        bool ok = false;                // 読み込めたか（壊れたファイルも載せ、変わるまで読み直さない）
+        std::string name;
+        std::string uniqueId;
+        std::string requiredVersion;
+        std::vector<EntryInfo> entries;
+    };
+
+    // refresh()の結果
+    struct RefreshStats {
+        size_t reused = 0;      // カタログのまま使ったファイル
+        size_t loaded = 0;      // 読み込んだファイル
+        size_t failed = 0;      // 読み込めなかったファイル（loadedに含む）
+        size_t removed = 0;     // なくなったファイル
+    };
+
+    // 条件に合うエントリの位置
+    struct Match {
+        size_t scenario;
+        size_t entry;
+    };
+
+    class Catalog {
+    private:
+        std::vector<ScenarioInfo> scenarios_;   // pathの順
+        std::vector<std::string> levels_;
+        std::unordered_map<std::string, uint32_t> levelIds_;
+
+        uint32_t internLevel(const std::string& level);
+
+    public:
+        // 保存したカタログを読み込む（今の内容は置き換える）
+        // 戻り値: 成功時true（ない・形式が違う場合はfalseで、空のカタログになる）
+        bool load(const std::string& catalogPath);
+
+        // カタログを保存する
+        // 戻り値: 成功時true
+        bool save(const std::string& catalogPath) const;
+
+        // ディレクトリ以下のシナリオと突き合わせ、変わったファイルだけを並列に読み込む
+        // threadCount: 0ならCPU数
+        RefreshStats refresh(const std::string& directory, size_t threadCount = 0);
+
+        const std::vector<ScenarioInfo>& scenarios() const { return scenarios_; }
+
+        // レベルIDからレベル名
+        const std::string& levelName(uint32_t id) const { return levels_[id]; }
+        size_t levelCount() const { return levels_.size(); }
+
+        // レベル名からレベルID
+        // 戻り値: カタログにあればtrue
+        bool findLevel(std::string_view level, uint32_t& id) const;
+
+        // レベル（空ならすべて）と長さの範囲に合うエントリ
+        std::vector<Match> select(std::string_view level, uint32_t minLength, uint32_t maxLength) const;
+
+        // 条件に合うエントリが1件以上あるシナリオ（scenarios()の番号）
+        std::vector<size_t> selectScenarios(std::string_view level, uint32_t minLength, uint32_t maxLength) const;
+
+        void clear();
+    };
+
+    // 1つのシナリオを読み込む（levelsにファイル内のレベル名、entriesのlevelはlevelsの番号）
+    // 戻り値: 成功時true
+    bool readScenario(const std::string& filePath, ScenarioInfo& info, std::vector<std::string>& levels);
+
+} // namespace ScenarioCatalog
@@ -0,0 +1,142 @@
+// scenario_stream.cpp
+// シナリオファイルのエントリを1件ずつ読む実装
+
+#include "scenario_stream.h"
+
+namespace ScenarioStream {
+
+    using JsonReader::Token;
+
+    EntryReader::EntryReader()
+        : inEntries_(false)
+        , finished_(true)
+    {
+    }
+
+    bool EntryReader::fail(const std::string& message) {
+        error_ = message.empty() ? "invalid scenario" : message;
+        finished_ = true;
+        inEntries_ = false;
+        return false;
+    }
+
+    bool EntryReader::open(const std::string& filePath) {
+        meta_ = Meta();
+        error_.clear();
+        inEntries_ = false;
+        finished_ = true;
+
+        if (!file_.open(filePath)) {
+            return fail("cannot open " + filePath);
+        }
+        std::string_view json(file_.data(), file_.size());
+        if (json.substr(0, 3) == "\xEF\xBB\xBF") {
+            json.remove_prefix(3);
+        }
+        reader_.reset(json);
+
+        Token token = reader_.next();
+        if (token == Token::ERROR) return fail(reader_.error());
+        if (token != Token::START_OBJECT) return fail("scenario root is not an object");
+        finished_ = false;
+        return true;
+    }
+
+    bool EntryReader::seekEntries() {
+        while (true) {
+            Token token = reader_.next();
+            if (token == Token::END_OBJECT) {
+                // ルートの終わり（後ろに余計なデータがないことも確認する）
+                if (reader_.next() != Token::END) return fail(reader_.error());
+                finished_ = true;
+                return false;
+            }
+            if (token != Token::KEY) return fail(reader_.error());
+
+            std::string_view key = reader_.string();
+            if (key == "meta") {
+                if (!readMeta()) return false;
+                continue;
+            }
+            bool entries = key == "entries";
+            token = reader_.next();
+            if (entries && token == Token::START_OBJECT) {
+                inEntries_ = true;
+                return true;
+            }
+            if (token == Token::ERROR || !reader_.skipValue()) return fail(reader_.error());
+        }
+    }
+
+    bool EntryReader::readMeta() {
+        Token token = reader_.next();
+        if (token != Token::START_OBJECT) {
+            if (token == Token::ERROR || !reader_.skipValue()) return fail(reader_.error());
+            return true;
+        }
+        while ((token = reader_.next()) == Token::KEY) {
+            std::string_view key = reader_.string();
+            std::string* target = key == "name" ? &meta_.name
+                                : key == "uniqueid" ? &meta_.uniqueId
+                                : key == "requiredver" ? &meta_.requiredVersion
+                                : nullptr;
+            token = reader_.next();
+            if (target != nullptr && token == Token::STRING) {
+                target->assign(reader_.string());
+            } else if (token == Token::ERROR || !reader_.skipValue()) {
+                return fail(reader_.error());
+            }
+        }
+        if (token != Token::END_OBJECT) return fail(reader_.error());
+        return true;
+    }
+
+    bool EntryReader::readEntry(Entry& entry) {
+        entry.text.clear();
+        entry.rubi.clear();
+        entry.level.clear();
+
+        Token token;
+        while ((token = reader_.next()) == Token::KEY) {
+            std::string_view key = reader_.string();
+            std::string* target = key == "text" ? &entry.text
+                                : key == "rubi" ? &entry.rubi
+                                : key == "level" ? &entry.level
+                                : nullptr;
+            token = reader_.next();
+            if (target != nullptr && token == Token::STRING) {
+                target->assign(reader_.string());
+            } else if (token == Token::ERROR || !reader_.skipValue()) {
+                return fail(reader_.error());
+            }
+        }
+        if (token != Token::END_OBJECT) return fail(reader_.error());
+        return true;
+    }
+
+    bool EntryReader::next(Entry& entry) {
+        while (!finished_) {
+            if (!inEntries_) {
+                if (!seekEntries()) return false;
+            }
+
+            Token token = reader_.next();
+            if (token == Token::END_OBJECT) {
+                // "entries"を読み終えた（残りのキーにmetaがあるかもしれないので続けて読む）
+                inEntries_ = false;
+                continue;
+            }
+            if (token != Token::KEY) return fail(reader_.error());
+            entry.key.assign(reader_.string());
+
+            token = reader_.next();
+            if (token == Token::START_OBJECT) {
+                return readEntry(entry);
+            }
+            // オブジェクトでないエントリは読み飛ばす
+            if (token == Token::ERROR || !reader_.skipValue()) return fail(reader_.error());
+        }
+        return false;
+    }
+
+} // namespace ScenarioStream
@@ -0,0 +1,83 @@
+#pragma once
+
+// scenario_stream.h
+// シナリオファイルのエントリを1件ずつ読む
+//
+// 用語解説:
+// - エントリ(Entry): シナリオの"entries"の1件（text・rubi・level）
+// - ストリーム読み込み: ファイル全体の木を作らず、先頭から読みながら1件ずつ取り出す読み方
+//
+// JsonHelper::loadJsonFromFileはファイル全体を文字列に読み込んでから木を作るので、
+// 数百MBのシナリオではファイルの数倍のメモリを使い、最初のエントリを使えるのも全体を読んだ後になる。
+// ここではファイルをメモリマップしてJsonReaderで先頭から読み、エントリを読んだところで返す。
+// 保持するのは今のエントリだけなので、使うメモリはシナリオの大きさによらず一定になる
+// （マップしたページはOSのファイルキャッシュで、順に読む指定をしているので読み終えた分は解放できる）。
+//
+// 形式:
+// { "meta": {"name": ..., "uniqueid": ..., "requiredver": ...},
+//   "entries": { "1": {"text": ..., "rubi": ..., "level": ...}, ... } }
+// 知らないキーは読み飛ばす。"meta"が"entries"より後ろにある場合、meta()は最後まで読むと揃う。
+
+#include <string>
+#include "../helper/json_reader.h"
+#include "../helper/mapped_file.h"
+
+namespace ScenarioStream {
+
+    // シナリオの情報
+    struct Meta {
+        std::string name;
+        std::string uniqueId;
+        std::string requiredVersion;
+    };
+
+    // エントリ（文字列は呼び出し側で使い回せば確保し直さない）
+    struct Entry {
+        std::string key;        // "entries"のキー（"1", "2", ...）
+        std::string text;
+        std::string rubi;
+        std::string level;
+    };
+
+    class EntryReader {
+    private:
+        FileMapping::MappedFile file_;
+        JsonReader::Reader reader_;
+        Meta meta_;
+        std::string error_;
+        bool inEntries_;
+        bool finished_;
+
+        bool fail(const std::string& message);
+        bool readMeta();
+        bool readEntry(Entry& entry);
+
+        // "entries"の中に入るまで（またはルートの終わりまで）読み進める
+        // 戻り値: "entries"の中に入ればtrue
+        bool seekEntries();
+
+    public:
+        EntryReader();
+
+        EntryReader(const EntryReader&) = delete;
+        EntryReader& operator=(const EntryReader&) = delete;
+
+        // シナリオファイルを開く（先頭のUTF-8 BOMは読み飛ばす）
+        // 戻り値: 成功時true
+        bool open(const std::string& filePath);
+
+        // 次のエントリ
+        // 戻り値: 読めた場合true（最後まで読んだ、または書式の誤りがあればfalse。誤りはerror()に理由）
+        bool next(Entry& entry);
+
+        // シナリオの情報（"entries"より前にあれば最初のnext()から、後ろにあれば最後まで読むと揃う）
+        const Meta& meta() const { return meta_; }
+
+        // 失敗の理由（正常に最後まで読んだ場合は空）
+        const std::string& error() const { return error_; }
+
+        // 読み終えた位置（BOMを除いたJSONの先頭からのバイト数）
+        size_t offset() const { return reader_.offset(); }
+    };
+
+} // namespace ScenarioStream
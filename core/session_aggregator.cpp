@@ -0,0 +1,367 @@
+// session_aggregator.cpp
+// 出力ディレクトリ内の全セッションの集計の実装
+
+#include "session_aggregator.h"
+#include "csv_reader.h"
+#include "session_directory.h"
+#include "../helper/block_file.h"
+#include "../helper/work_stealing_pool.h"
+#include <algorithm>
+#include <bitset>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+namespace fs = std::filesystem;
+
+namespace Aggregator {
+
+    static const char* SESSION_METRIC_NAMES[SESSION_METRIC_COUNT] = {
+        "wpm_correct",
+        "cpm_correct",
+        "accuracy",
+        "avg_inter_key_interval",
+        "total_duration_sec",
+        "backspace_count",
+    };
+
+    const char* sessionMetricName(size_t index) {
+        return index < SESSION_METRIC_COUNT ? SESSION_METRIC_NAMES[index] : "";
+    }
+
+    // ファイル名の接頭辞と、セッション内での種類
+    enum class FileKind { EVENTS, SUMMARY, KANA };
+    struct FilePrefix {
+        const char* prefix;
+        FileKind kind;
+    };
+    static const char* EVENT_LOG_PREFIX = "typing_eventlog_";
+    static const char* SUMMARY_LOG_PREFIX = "typing_summarylog_";
+    static const char* KANA_LOG_PREFIX = "typing_kanalog_";
+    static const FilePrefix FILE_PREFIXES[] = {
+        {"typing_events_", FileKind::EVENTS},
+        {"typing_summary_", FileKind::SUMMARY},
+        {"typing_kana_", FileKind::KANA},
+    };
+
+    // ファイル名がセッションファイルならidと種類を設定してtrue
+    // イベントCSVは圧縮した形式（.csv.lzb）も対象にする
+    static bool classifyFile(const fs::path& path, std::string& id, FileKind& kind) {
+        fs::path csvPath = path;
+        bool compressed = BlockFile::isCompressedPath(path.string());
+        if (compressed) csvPath = path.stem();
+        if (csvPath.extension() != ".csv") return false;
+        std::string name = csvPath.stem().string();
+        for (const auto& fp : FILE_PREFIXES) {
+            std::string prefix = fp.prefix;
+            if (name.compare(0, prefix.size(), prefix) != 0) continue;
+            if (compressed && fp.kind != FileKind::EVENTS) return false;
+            id = name.substr(prefix.size());
+            kind = fp.kind;
+            return true;
+        }
+        return false;
+    }
+
+    static void addFile(std::map<std::string, SessionFiles>& byId, const std::string& id,
+                        FileKind kind, const std::string& path) {
+        SessionFiles& files = byId[id];
+        files.id = id;
+        switch (kind) {
+            case FileKind::EVENTS:  files.eventsPath = path; break;
+            case FileKind::SUMMARY: files.summaryPath = path; break;
+            case FileKind::KANA:    files.kanaPath = path; break;
+        }
+    }
+
+    // セッションディレクトリの目録に載っているファイルを追加
+    // バイト数が目録と異なるファイルは使わない
+    static void addSessionDirectory(std::map<std::string, SessionFiles>& byId, const fs::path& directory) {
+        std::vector<CSVReader::ManifestEntry> entries;
+        if (!CSVReader::readManifestCSV((directory / SessionDirectory::MANIFEST_FILENAME).string(), entries)) {
+            return;
+        }
+
+        std::error_code ec;
+        for (const auto& entry : entries) {
+            fs::path path = directory / entry.file;
+            std::string id;
+            FileKind kind;
+            if (!classifyFile(path, id, kind)) continue;
+            uintmax_t bytes = fs::file_size(path, ec);
+            if (ec || bytes != entry.bytes) continue;
+            addFile(byId, id, kind, path.string());
+        }
+    }
+
+    std::vector<SessionFiles> findSessions(const std::string& directory) {
+        std::map<std::string, SessionFiles> byId;
+
+        std::error_code ec;
+        if (!fs::is_directory(directory, ec)) {
+            return {};
+        }
+
+        const std::string sessionPrefix = SessionDirectory::DIRECTORY_PREFIX;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            // セッションディレクトリ（書き込み中の作業ディレクトリは対象外）
+            if (entry.is_directory(ec)) {
+                if (entry.path().filename().string().rfind(sessionPrefix, 0) == 0) {
+                    addSessionDirectory(byId, entry.path());
+                }
+                continue;
+            }
+
+            // ディレクトリ直下に出力された以前の形式のファイル
+            if (!entry.is_regular_file(ec)) continue;
+            std::string id;
+            FileKind kind;
+            if (classifyFile(entry.path(), id, kind)) {
+                addFile(byId, id, kind, entry.path().string());
+            }
+        }
+
+        // イベントログの索引（イベントCSVがあるセッションはそちらを使う）とセッションログ
+        std::map<std::string, std::map<std::string, double>> loggedSummaries;
+        std::map<std::string, std::map<std::string, double>> loggedKana;
+        for (const auto& entry : fs::directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+            std::string name = entry.path().filename().string();
+            if (name.rfind(SUMMARY_LOG_PREFIX, 0) == 0) {
+                CSVReader::readSummaryLog(entry.path().string(), loggedSummaries);
+                continue;
+            }
+            if (name.rfind(KANA_LOG_PREFIX, 0) == 0) {
+                CSVReader::readKanaLog(entry.path().string(), loggedKana);
+                continue;
+            }
+            const std::string suffix = std::string(".csv") + CSVReader::EVENT_LOG_INDEX_SUFFIX;
+            if (name.rfind(EVENT_LOG_PREFIX, 0) != 0) continue;
+            if (name.size() < suffix.size() ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) continue;
+
+            std::vector<CSVReader::EventLogEntry> entries;
+            if (!CSVReader::readEventLogIndex(entry.path().string(), entries)) continue;
+            std::string logPath = entry.path().string();
+            logPath.erase(logPath.size() - std::string(CSVReader::EVENT_LOG_INDEX_SUFFIX).size());
+            for (const auto& logEntry : entries) {
+                SessionFiles& files = byId[logEntry.sessionId];
+                files.id = logEntry.sessionId;
+                files.eventLogPath = logPath;
+                files.eventLog = logEntry;
+            }
+        }
+
+        // セッションログの行はイベントログの索引に載ったセッションだけ使う
+        // （索引はイベントを最後に追記し終えてから書くので、出力が途中で失敗したセッションは載らない）
+        for (auto& pair : byId) {
+            SessionFiles& files = pair.second;
+            if (files.eventLogPath.empty()) continue;
+            if (files.summaryPath.empty()) {
+                auto it = loggedSummaries.find(files.id);
+                if (it != loggedSummaries.end()) files.loggedSummary = std::move(it->second);
+            }
+            if (files.kanaPath.empty()) {
+                auto it = loggedKana.find(files.id);
+                if (it != loggedKana.end()) files.loggedKana = std::move(it->second);
+            }
+        }
+
+        std::vector<SessionFiles> sessions;
+        sessions.reserve(byId.size());
+        for (auto& pair : byId) {
+            sessions.push_back(std::move(pair.second));
+        }
+        return sessions;
+    }
+
+    void AggregateData::merge(const AggregateData& other) {
+        sessionCount += other.sessionCount;
+        failedCount += other.failedCount;
+        eventCount += other.eventCount;
+
+        for (size_t vk = 0; vk < keys.size(); ++vk) {
+            const KeyAggregate& src = other.keys[vk];
+            if (src.sessions == 0) continue;
+            KeyAggregate& dst = keys[vk];
+            dst.sessions += src.sessions;
+            dst.downCount += src.downCount;
+            dst.correctCount += src.correctCount;
+            dst.incorrectCount += src.incorrectCount;
+            dst.intervalMs.merge(src.intervalMs);
+        }
+
+        for (const auto& pair : other.kana) {
+            kana[pair.first].avgInputTimeMs.merge(pair.second.avgInputTimeMs);
+        }
+
+        for (size_t m = 0; m < SESSION_METRIC_COUNT; ++m) {
+            sessionValues[m].insert(sessionValues[m].end(),
+                                    other.sessionValues[m].begin(), other.sessionValues[m].end());
+        }
+    }
+
+    // イベントCSVからキー別の集計を加える
+    // セッションのイベントを読み込む（イベントCSVがなければイベントログから）
+    static bool readEvents(const SessionFiles& files, std::vector<InputRecorder::InputEvent>& events) {
+        if (!files.eventsPath.empty()) {
+            return CSVReader::readEventCSV(files.eventsPath, events);
+        }
+        if (!files.eventLogPath.empty()) {
+            return CSVReader::readEventLogSession(files.eventLogPath, files.eventLog, events);
+        }
+        return false;
+    }
+
+    static bool addEvents(const SessionFiles& files, AggregateData& data,
+                          std::vector<InputRecorder::InputEvent>& scratch) {
+        scratch.clear();
+        if (!readEvents(files, scratch)) return false;
+
+        std::bitset<256> seen;
+        for (const auto& event : scratch) {
+            // チャタリング等の疑わしいイベントは除く
+            if (event.type != InputRecorder::EventType::KEY_DOWN) continue;
+            if (event.suspect != InputRecorder::Suspect::NONE) continue;
+            size_t vk = static_cast<size_t>(event.vk_code) & 0xFF;
+
+            KeyAggregate& key = data.keys[vk];
+            if (!seen[vk]) {
+                seen[vk] = true;
+                key.sessions++;
+            }
+            key.downCount++;
+            if (event.is_correct) {
+                key.correctCount++;
+            } else {
+                key.incorrectCount++;
+            }
+            // 直前のキーがない（間隔0の）キーは除く
+            if (event.inter_key_time_us > 0) {
+                key.intervalMs.add(event.inter_key_time_us / 1000.0);
+            }
+        }
+        data.eventCount += scratch.size();
+        return true;
+    }
+
+    static bool loadSession(const SessionFiles& files, AggregateData& data,
+                            std::vector<InputRecorder::InputEvent>& scratch) {
+        bool loaded = false;
+
+        if (addEvents(files, data, scratch)) {
+            loaded = true;
+        }
+
+        std::map<std::string, double> metrics = files.loggedSummary;
+        if (!metrics.empty() ||
+            (!files.summaryPath.empty() && CSVReader::readSummaryCSV(files.summaryPath, metrics))) {
+            loaded = true;
+            for (size_t m = 0; m < SESSION_METRIC_COUNT; ++m) {
+                auto it = metrics.find(SESSION_METRIC_NAMES[m]);
+                if (it != metrics.end()) {
+                    data.sessionValues[m].push_back(it->second);
+                }
+            }
+        }
+
+        std::map<std::string, double> kanaTimes = files.loggedKana;
+        if (!kanaTimes.empty() ||
+            (!files.kanaPath.empty() && CSVReader::readKanaCSV(files.kanaPath, kanaTimes))) {
+            for (const auto& pair : kanaTimes) {
+                data.kana[pair.first].avgInputTimeMs.add(pair.second);
+            }
+        }
+
+        if (loaded) {
+            data.sessionCount++;
+        } else {
+            data.failedCount++;
+        }
+        return loaded;
+    }
+
+    bool addSession(const SessionFiles& files, AggregateData& data) {
+        std::vector<InputRecorder::InputEvent> scratch;
+        return loadSession(files, data, scratch);
+    }
+
+    AggregateData aggregate(const std::vector<SessionFiles>& sessions, size_t threadCount) {
+        if (threadCount == 0) threadCount = Parallel::defaultThreadCount();
+        threadCount = std::max<size_t>(1, std::min(threadCount, sessions.size()));
+
+        // スレッドごとの部分集計とイベントの作業領域
+        std::vector<AggregateData> partials(threadCount);
+        std::vector<std::vector<InputRecorder::InputEvent>> scratch(threadCount);
+
+        size_t used = Parallel::forEach(sessions.size(), threadCount, [&](size_t index, size_t worker) {
+            loadSession(sessions[index], partials[worker], scratch[worker]);
+        });
+
+        AggregateData result;
+        for (size_t w = 0; w < used; ++w) {
+            result.merge(partials[w]);
+        }
+        return result;
+    }
+
+    // 中央値（valuesは並べ替える）
+    static double median(std::vector<double>& values) {
+        if (values.empty()) return 0.0;
+        size_t mid = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + mid, values.end());
+        double upper = values[mid];
+        if (values.size() % 2 == 1) return upper;
+        double lower = *std::max_element(values.begin(), values.begin() + mid);
+        return (lower + upper) / 2.0;
+    }
+
+    bool writeReport(const AggregateData& data, const std::string& filepath) {
+        std::ofstream file(filepath);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << "section,name,sessions,count,mean,median,min,max,accuracy\n";
+        file << std::fixed << std::setprecision(2);
+
+        // 全体
+        file << "total,sessions," << data.sessionCount << "," << data.sessionCount << ",,,,,\n";
+        file << "total,events," << data.sessionCount << "," << data.eventCount << ",,,,,\n";
+
+        // セッション単位の指標（セッションごとの値の分布）
+        for (size_t m = 0; m < SESSION_METRIC_COUNT; ++m) {
+            std::vector<double> values = data.sessionValues[m];
+            if (values.empty()) continue;
+            Statistics::SeriesRange range;
+            for (double v : values) range.add(v);
+            file << "session," << SESSION_METRIC_NAMES[m] << "," << values.size() << "," << values.size() << ","
+                 << range.mean() << "," << median(values) << "," << range.min << "," << range.max << ",\n";
+        }
+
+        // キー別（押されたキーのみ）
+        for (size_t vk = 0; vk < data.keys.size(); ++vk) {
+            const KeyAggregate& key = data.keys[vk];
+            if (key.downCount == 0) continue;
+            double accuracy = static_cast<double>(key.correctCount) / key.downCount * 100.0;
+            file << "key,vk_" << vk << "," << key.sessions << "," << key.downCount << ",";
+            if (key.intervalMs.count > 0) {
+                file << key.intervalMs.mean() << ",," << key.intervalMs.min << "," << key.intervalMs.max;
+            } else {
+                file << ",,,";
+            }
+            file << "," << accuracy << "\n";
+        }
+
+        // かな別（セッションごとの平均入力時間の分布）
+        for (const auto& pair : data.kana) {
+            const Statistics::SeriesRange& range = pair.second.avgInputTimeMs;
+            file << "kana," << pair.first << "," << range.count << "," << range.count << ","
+                 << range.mean() << ",," << range.min << "," << range.max << ",\n";
+        }
+
+        file.close();
+        return true;
+    }
+
+} // namespace Aggregator
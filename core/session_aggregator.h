@@ -0,0 +1,87 @@
+#pragma once
+
+// session_aggregator.h
+// 出力ディレクトリ内の全セッションの集計
+//
+// 用語解説:
+// - セッションファイル: 1回の計測で出力されるイベント・サマリ・かな別CSVの組
+//   （ファイル名末尾のセッションIDが同じものを1セッションとする）
+//   セッションディレクトリ（session_*）は目録に載っているファイルを、
+//   ディレクトリ直下に出力された以前の形式のファイルはファイル名から集める
+//   イベントはイベントログ（typing_eventlog_*）の索引からも探す
+//   イベントログにあるセッションのサマリ・かな別はセッションログ（typing_summarylog_*・typing_kanalog_*）から読む
+// - 部分集計(Partial): スレッドごとに持つ集計途中の値。最後にまとめて1つにする
+//
+// セッションはワークスティーリングで並列に読み込み、スレッドごとの部分集計に加える。
+// 集計中はスレッド間で共有する値がないため、コア数にほぼ比例して速くなる。
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "time_series.h"
+#include "csv_reader.h"
+
+namespace Aggregator {
+
+    // 1セッション分のファイル（存在しないものは空文字列）
+    struct SessionFiles {
+        std::string id;             // セッションID（以前の形式はYYYYMMDD_HHMMSS）
+        std::string eventsPath;
+        std::string summaryPath;
+        std::string kanaPath;
+        std::string eventLogPath;           // イベントCSVがなくイベントログにある場合のログ
+        CSVReader::EventLogEntry eventLog;  // イベントログ内の位置
+        std::map<std::string, double> loggedSummary;    // セッションログのサマリ（サマリCSVがない場合）
+        std::map<std::string, double> loggedKana;       // セッションログのかな別（かな別CSVがない場合）
+    };
+
+    // ディレクトリ内のセッションを列挙（id順）
+    std::vector<SessionFiles> findSessions(const std::string& directory);
+
+    // キー別の集計（仮想キーコードごと）
+    struct KeyAggregate {
+        size_t sessions = 0;                    // キーが押されたセッション数
+        uint64_t downCount = 0;                 // キーダウン数
+        uint64_t correctCount = 0;
+        uint64_t incorrectCount = 0;
+        Statistics::SeriesRange intervalMs;     // 直前のキーアップからの時間（ミリ秒）
+    };
+
+    // かな別の集計（セッションごとの平均入力時間をまとめる）
+    struct KanaAggregate {
+        Statistics::SeriesRange avgInputTimeMs;
+    };
+
+    // セッション単位で集計するサマリの指標
+    constexpr size_t SESSION_METRIC_COUNT = 6;
+    const char* sessionMetricName(size_t index);   // サマリCSVの指標名
+
+    // 集計結果（部分集計も同じ型）
+    struct AggregateData {
+        size_t sessionCount = 0;                // 読み込めたセッション数
+        size_t failedCount = 0;                 // 読み込めなかったセッション数
+        uint64_t eventCount = 0;
+        std::array<KeyAggregate, 256> keys;
+        std::map<std::string, KanaAggregate> kana;
+        std::array<std::vector<double>, SESSION_METRIC_COUNT> sessionValues;  // セッションごとの値
+
+        void merge(const AggregateData& other);
+    };
+
+    // 1セッションを読み込んでdataに加える
+    // 戻り値: 成功時true（イベントCSVもサマリCSVも読めなければfalse）
+    bool addSession(const SessionFiles& files, AggregateData& data);
+
+    // 全セッションを並列に集計
+    // threadCount: 0ならCPU数
+    AggregateData aggregate(const std::vector<SessionFiles>& sessions, size_t threadCount = 0);
+
+    // 集計レポートCSV出力
+    // 列: section,name,sessions,count,mean,median,min,max,accuracy
+    // 戻り値: 成功時true
+    bool writeReport(const AggregateData& data, const std::string& filepath);
+
+} // namespace Aggregator
@@ -0,0 +1,72 @@
+// session_directory.cpp
+// 1セッション分の出力ディレクトリの実装
+
+#include "session_directory.h"
+#include "csv_logger.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace SessionDirectory {
+
+    std::string directoryPath(const std::string& baseDir, const std::string& sessionId) {
+        return baseDir + "/" + DIRECTORY_PREFIX + sessionId;
+    }
+
+    Staging::~Staging() {
+        discard();
+    }
+
+    bool Staging::open(const std::string& baseDir, const std::string& sessionId) {
+        discard();
+
+        std::string path = baseDir + "/" + STAGING_PREFIX + sessionId;
+        std::error_code ec;
+        fs::create_directories(baseDir, ec);
+        if (ec || !fs::create_directory(path, ec)) {
+            return false;  // 作成失敗、または同じIDで書き込み中
+        }
+
+        baseDir_ = baseDir;
+        sessionId_ = sessionId;
+        path_ = path;
+        return true;
+    }
+
+    std::string Staging::commit() {
+        if (path_.empty()) {
+            return "";
+        }
+
+        if (CSVLogger::writeManifestCSV(path_, sessionId_).empty()) {
+            discard();
+            return "";
+        }
+
+        // 既に同じ名前のディレクトリがあれば失敗する（上書きしない）
+        std::string finalPath = directoryPath(baseDir_, sessionId_);
+        std::error_code ec;
+        if (fs::exists(finalPath, ec)) {
+            discard();
+            return "";
+        }
+        fs::rename(path_, finalPath, ec);
+        if (ec) {
+            discard();
+            return "";
+        }
+
+        path_.clear();
+        return finalPath;
+    }
+
+    void Staging::discard() {
+        if (path_.empty()) {
+            return;
+        }
+        std::error_code ec;
+        fs::remove_all(path_, ec);
+        path_.clear();
+    }
+
+} // namespace SessionDirectory
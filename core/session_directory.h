@@ -0,0 +1,59 @@
+#pragma once
+
+// session_directory.h
+// 1セッション分の出力ファイルをまとめるディレクトリ
+//
+// 用語解説:
+// - セッションディレクトリ: 1回の計測の全ファイルを入れるディレクトリ（output/session_<セッションID>/）
+// - 作業ディレクトリ(Staging): 書き込み中のファイルを置く一時ディレクトリ（output/.staging_<セッションID>/）
+// - 目録(Manifest): ディレクトリ内のファイル名とバイト数の一覧（manifest.csv）
+//
+// ファイルはすべて作業ディレクトリに書き込み、最後に目録を書いてからディレクトリごと名前を変更する。
+// 名前の変更は一度に行われるので、session_で始まるディレクトリは常に全ファイルが揃っている。
+// セッションIDはプロセス内で重ならないため、複数のセッションを同時に出力しても上書きしない。
+
+#include <string>
+
+namespace SessionDirectory {
+
+    // セッションディレクトリ・作業ディレクトリの名前の接頭辞
+    constexpr const char* DIRECTORY_PREFIX = "session_";
+    constexpr const char* STAGING_PREFIX = ".staging_";
+
+    // 目録のファイル名
+    constexpr const char* MANIFEST_FILENAME = "manifest.csv";
+
+    // セッションディレクトリのパス（baseDir/session_<sessionId>）
+    std::string directoryPath(const std::string& baseDir, const std::string& sessionId);
+
+    // 書き込み中のセッションディレクトリ
+    // commitせずに破棄すると作業ディレクトリごと削除する
+    class Staging {
+    private:
+        std::string baseDir_;
+        std::string sessionId_;
+        std::string path_;      // 作業ディレクトリ（未作成なら空）
+
+    public:
+        Staging() = default;
+        ~Staging();
+
+        Staging(const Staging&) = delete;
+        Staging& operator=(const Staging&) = delete;
+
+        // 作業ディレクトリを作成
+        // 戻り値: 成功時true（baseDirが作れない・同じIDの作業中ディレクトリがある場合はfalse）
+        bool open(const std::string& baseDir, const std::string& sessionId);
+
+        // 作業ディレクトリのパス（ここにファイルを書き込む）
+        const std::string& path() const { return path_; }
+
+        // 目録を書き込み、セッションディレクトリに名前を変更
+        // 戻り値: セッションディレクトリのパス（失敗時は空文字列、作業ディレクトリは削除する）
+        std::string commit();
+
+        // 作業ディレクトリを削除
+        void discard();
+    };
+
+} // namespace SessionDirectory
@@ -0,0 +1,123 @@
+// session_finalizer.cpp
+// セッション終了後の処理のバックグラウンド実行の実装
+
+#include "session_finalizer.h"
+#include "csv_logger.h"
+#include "session_directory.h"
+#include <filesystem>
+
+namespace SessionFinalizer {
+
+    // イベントログに追記する場合の後処理の残り
+    // 作業ディレクトリのCSVを日ごとのセッションログに追記し、最後にイベントをイベントログに追記する
+    // 集計ツールはイベントログの索引に載ったセッションのサマリなどだけを読むので、
+    // 途中で失敗したセッションのセッションログの行は使われない
+    static ExportResult appendToLogs(const SessionJob& job, InputRecorder::EventView events,
+                                     ExportResult result, const std::string& dir) {
+        const std::string& id = result.sessionId;
+        std::string kanaCsvPath = dir + "/" + CSVLogger::generateFilename("typing_kana", id);
+        std::vector<std::string*> logged = {&result.summaryCsvPath, &result.sketchCsvPath, &result.digraphCsvPath,
+                                            &result.trigramCsvPath, &result.timeSeriesCsvPath, &kanaCsvPath};
+        std::error_code ec;
+        for (std::string* path : logged) {
+            if (path->empty() || !std::filesystem::exists(*path, ec)) continue;    // かな別CSVはない場合がある
+            *path = CSVLogger::appendSessionLog(*path, id, job.outputDir);
+        }
+        if (result.summaryCsvPath.empty()) {
+            return ExportResult{id};
+        }
+
+        CSVLogger::EventLogConfig config;
+        config.directory = job.outputDir;
+        result.eventCsvPath = CSVLogger::appendEventLog(events, id, config);
+        if (result.eventCsvPath.empty()) {
+            return ExportResult{id};
+        }
+        return result;  // 作業ディレクトリは破棄される
+    }
+
+    ExportResult finalize(SessionJob& job, std::promise<Statistics::StatisticsData>& statsPromise) {
+        // 統計計算（ここまで終われば画面に結果を出せる）
+        Statistics::StatisticsData stats = job.calculator->calculate(job.events, job.correctCount, job.incorrectCount);
+        statsPromise.set_value(stats);
+
+        // CSV出力（作業ディレクトリに書き込む）
+        ExportResult result;
+        result.sessionId = job.sessionId.empty() ? CSVLogger::generateSessionId() : job.sessionId;
+        SessionDirectory::Staging staging;
+        if (!staging.open(job.outputDir, result.sessionId)) {
+            return result;  // ディレクトリ作成失敗
+        }
+
+        const std::string& dir = staging.path();
+        const std::string& id = result.sessionId;
+        // イベントを書き出す処理はEventViewで読むので、ここで配列に戻す（ジョブの終わりに解放される）
+        std::vector<InputRecorder::InputEvent> unpacked = job.events.unpack();
+        InputRecorder::EventView events(unpacked);
+        if (!job.useEventLog) {
+            result.eventCsvPath = CSVLogger::writeEventCSV(events, dir, id, job.compressEventCsv);
+            if (result.eventCsvPath.empty()) {
+                return ExportResult{result.sessionId};  // 作業ディレクトリは破棄される
+            }
+        }
+        result.summaryCsvPath = CSVLogger::writeSummaryCSV(stats, dir, id);
+        if (result.summaryCsvPath.empty()) {
+            return ExportResult{result.sessionId};
+        }
+        if (job.writeEventColumns && !job.useEventLog) {
+            result.eventColumnsPath = CSVLogger::writeEventColumns(events, dir, id);
+        }
+        result.sketchCsvPath = CSVLogger::writeSketchCSV(job.calculator->getSketches(), dir, id);
+        result.digraphCsvPath = CSVLogger::writeDigraphCSV(job.calculator->getDigraphMatrix(), dir, id);
+        result.trigramCsvPath = CSVLogger::writeTrigramCSV(job.calculator->getTrigramTable(), dir, id);
+        result.timeSeriesCsvPath = CSVLogger::writeTimeSeriesCSV(job.calculator->getTimeSeries(), dir, id);
+
+        if (job.useEventLog) {
+            return appendToLogs(job, events, std::move(result), dir);
+        }
+
+        // 目録を書いてセッションディレクトリに移す
+        result.sessionDir = staging.commit();
+        if (result.sessionDir.empty()) {
+            return ExportResult{result.sessionId};
+        }
+
+        // 移動後のパスに置き換える
+        std::vector<std::string*> moved = {&result.eventCsvPath, &result.summaryCsvPath, &result.eventColumnsPath,
+                                           &result.sketchCsvPath, &result.digraphCsvPath, &result.trigramCsvPath,
+                                           &result.timeSeriesCsvPath};
+        for (std::string* path : moved) {
+            if (!path->empty()) {
+                *path = result.sessionDir + "/" + std::filesystem::path(*path).filename().string();
+            }
+        }
+        return result;
+    }
+
+    Pending Finalizer::submit(SessionJob job) {
+        // std::functionはコピー可能である必要があるため、移動のみの状態は共有ポインタで持つ
+        struct State {
+            SessionJob job;
+            std::promise<Statistics::StatisticsData> stats;
+            std::promise<ExportResult> files;
+        };
+        auto state = std::make_shared<State>();
+        state->job = std::move(job);
+        if (state->job.sessionId.empty()) {
+            state->job.sessionId = CSVLogger::generateSessionId();
+        }
+
+        Pending pending;
+        pending.stats = state->stats.get_future();
+        pending.files = state->files.get_future();
+
+        queue_.submit([state]() {
+            state->files.set_value(finalize(state->job, state->stats));
+            // 出力が終わったイベント・計算器はここで解放する
+            state->job.events = {};
+            state->job.calculator.reset();
+        });
+        return pending;
+    }
+
+} // namespace SessionFinalizer
@@ -0,0 +1,89 @@
+#pragma once
+
+// session_finalizer.h
+// セッション終了後の処理（統計計算・CSV出力）のバックグラウンド実行
+//
+// 用語解説:
+// - 後処理(Finalize): セッション終了後に行う統計計算とファイル出力
+// - future: 別スレッドで計算中の値を後から受け取るためのC++標準の仕組み
+//
+// 入力スレッドで統計計算とCSV出力を行うと、結果が表示されるまで画面が止まる。
+// イベントと計算器をジョブに移してバックグラウンドで処理し、統計が出た時点で
+// 結果を表示できるようにする。ファイル出力はその後も続き、完了を待たずに次の操作に移れる。
+// 1セッションのファイルはすべて同じセッションIDで作業ディレクトリに書き込み、
+// 揃ってからセッションディレクトリ（output/session_<セッションID>/）に移す。
+// イベントログに追記する場合はセッションディレクトリを作らず、サマリなどは日ごとのセッションログに、
+// イベントは最後にイベントログに追記する（イベントログの索引に載った時点でセッションが確定する）。
+
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+#include "packed_events.h"
+#include "statistics.h"
+#include "../helper/job_queue.h"
+
+namespace SessionFinalizer {
+
+    // CSV出力の結果（失敗したファイルは空文字列）
+    struct ExportResult {
+        std::string sessionId;
+        std::string sessionDir;         // セッションディレクトリ（失敗時・イベントログに追記した場合は空文字列）
+        std::string eventCsvPath;       // イベントログに追記した場合はログのパス（以下のCSVも追記したセッションログのパス）
+        std::string eventColumnsPath;   // 列指向バイナリ（出力しない場合は空）
+        std::string summaryCsvPath;
+        std::string sketchCsvPath;
+        std::string digraphCsvPath;
+        std::string trigramCsvPath;     // トライグラムがなければ空
+        std::string timeSeriesCsvPath;
+
+        // イベント・サマリCSVが揃ったか（失敗時はどちらも空文字列にする）
+        bool succeeded() const {
+            return !eventCsvPath.empty() && !summaryCsvPath.empty();
+        }
+    };
+
+    // 1セッション分の後処理の入力（すべてジョブに移動する）
+    struct SessionJob {
+        InputRecorder::PackedEvents events;                     // Recorder::takeEvents()
+        std::unique_ptr<Statistics::Calculator> calculator;     // endSession済み
+        size_t correctCount = 0;
+        size_t incorrectCount = 0;
+        std::string outputDir = "output";
+        std::string sessionId;          // 空ならsubmit時に発行する
+        bool useEventLog = false;       // trueならoutputDirのイベントログ・セッションログに追記する
+        bool writeEventColumns = false; // trueならイベントの列指向バイナリも出力する（イベントログには使わない）
+        bool compressEventCsv = false;  // trueならイベントCSVをブロック単位で圧縮する（イベントログには使わない）
+    };
+
+    // 後処理の結果の受け取り口
+    struct Pending {
+        std::future<Statistics::StatisticsData> stats;   // 統計計算が終わると受け取れる
+        std::future<ExportResult> files;                 // 全ファイルの出力が終わると受け取れる
+    };
+
+    // 後処理のキュー（ジョブは追加した順に1つずつ実行）
+    class Finalizer {
+    private:
+        Parallel::JobQueue queue_;
+
+    public:
+        // 後処理を追加（すぐに戻る）
+        // セッションIDはここで発行するので、追加した順に大きくなる
+        Pending submit(SessionJob job);
+
+        // 追加済みの後処理がすべて終わるまで待つ
+        void waitAll() { queue_.waitIdle(); }
+
+        // 未完了の後処理の数
+        size_t pendingCount() const { return queue_.pendingCount(); }
+    };
+
+    // 後処理の本体（呼び出したスレッドで実行）
+    // 統計計算が終わった時点でstatsPromiseに値を設定し、その後CSVを出力する
+    // イベント・サマリCSVのどちらかが出力できなければセッションディレクトリは作らない
+    // （イベントログに追記する場合はイベントを追記しない）
+    ExportResult finalize(SessionJob& job, std::promise<Statistics::StatisticsData>& statsPromise);
+
+} // namespace SessionFinalizer
@@ -2,40 +2,92 @@
 // タイピング統計計算モジュールの実装
 
 #include "statistics.h"
+#include "interval_kernels.h"
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <limits>
 
 namespace Statistics {
 
-    Calculator::Calculator()
+    // KanaDictionary: かなをIDに変換
+    uint16_t KanaDictionary::intern(const std::string& kana) {
+        auto it = ids_.find(kana);
+        if (it != ids_.end()) {
+            return it->second;
+        }
+        uint16_t id = static_cast<uint16_t>(names_.size());
+        names_.push_back(kana);
+        ids_.emplace(kana, id);
+        return id;
+    }
+
+    void KanaDictionary::clear() {
+        names_.clear();
+        ids_.clear();
+    }
+
+    template <MetricSet Set>
+    BasicCalculator<Set>::BasicCalculator()
         : sessionStartTime_(0)
         , sessionEndTime_(0)
     {
     }
 
-    void Calculator::startSession(uint64_t startTime) {
+    template <MetricSet Set>
+    void BasicCalculator<Set>::startSession(uint64_t startTime) {
         sessionStartTime_ = startTime;
         events_.clear();
+        detail::DigraphStore<HAS_DIGRAPH>::clearStore();
     }
 
-    void Calculator::endSession(uint64_t endTime) {
+    template <MetricSet Set>
+    void BasicCalculator<Set>::endSession(uint64_t endTime) {
         sessionEndTime_ = endTime;
     }
 
-    void Calculator::recordKeyDown(uint64_t timestamp, int virtualKey, char character) {
-        events_.emplace_back(EventType::KEY_DOWN, timestamp, virtualKey, character);
+    template <MetricSet Set>
+    void BasicCalculator<Set>::recordKeyDown(uint64_t timestamp, int virtualKey, char character) {
+        events_.emplace_back(EventType::KEY_DOWN, timestamp, virtualKey, 0, character);
+    }
+
+    template <MetricSet Set>
+    void BasicCalculator<Set>::recordKeyUp(uint64_t timestamp, int virtualKey) {
+        events_.emplace_back(EventType::KEY_UP, timestamp, virtualKey, 0);
+    }
+
+    template <MetricSet Set>
+    void BasicCalculator<Set>::recordBackspace(uint64_t timestamp) {
+        events_.emplace_back(EventType::BACKSPACE, timestamp, 0x08, 0);
+    }
+
+    template <MetricSet Set>
+    void BasicCalculator<Set>::recordBounce(uint64_t timestamp, int virtualKey) {
+        events_.emplace_back(EventType::KEY_DOWN, timestamp, virtualKey, 0);
+        events_.back().suspect = InputRecorder::Suspect::CHATTER;
+    }
+
+    template <MetricSet Set>
+    StatisticsData BasicCalculator<Set>::calculate(size_t correctCount, size_t incorrectCount) {
+        return calculate(EventView(events_), correctCount, incorrectCount);
     }
 
-    void Calculator::recordKeyUp(uint64_t timestamp, int virtualKey) {
-        events_.emplace_back(EventType::KEY_UP, timestamp, virtualKey, '\0');
+    template <MetricSet Set>
+    StatisticsData BasicCalculator<Set>::calculate(EventView events, size_t correctCount, size_t incorrectCount) {
+        return calculateWith([events](auto&& function) {
+            for (const auto& event : events) function(event);
+        }, correctCount, incorrectCount);
     }
 
-    void Calculator::recordBackspace(uint64_t timestamp) {
-        events_.emplace_back(EventType::BACKSPACE, timestamp, 0x08, '\0');
+    template <MetricSet Set>
+    StatisticsData BasicCalculator<Set>::calculate(const PackedEvents& events, size_t correctCount,
+                                                   size_t incorrectCount) {
+        return calculateWith([&events](auto&& function) { events.forEach(function); }, correctCount, incorrectCount);
     }
 
-    StatisticsData Calculator::calculate(size_t correctCount, size_t incorrectCount) {
+    template <MetricSet Set>
+    template <typename ForEachEvent>
+    StatisticsData BasicCalculator<Set>::calculateWith(ForEachEvent forEachEvent, size_t correctCount,
+                                                       size_t incorrectCount) {
         StatisticsData data;
         
         // 基本情報
@@ -43,20 +95,45 @@ namespace Statistics {
         data.correctKeyCount = correctCount;
         data.incorrectKeyCount = incorrectCount;
         
-        // イベントから統計を集計
-        size_t keyDownCount = 0;
-        size_t backspaceCount = 0;
-        
-        for (const auto& event : events_) {
-            if (event.type == EventType::KEY_DOWN) {
-                keyDownCount++;
-            } else if (event.type == EventType::BACKSPACE) {
-                backspaceCount++;
+        // イベントから統計を集計（キー数・押下時間・キーペア・同時押下を1パスで）
+        if constexpr (HAS_DIGRAPH) {
+            if (this->digraphsCounted_) {
+                this->digraphs_.clear();
+                this->trigrams_.clear();
             }
+            this->digraphsCounted_ = true;
+        }
+        if constexpr (HAS_INTERVAL) {
+            this->intervalScratch_.clear();  // 容量は前回の計算から引き継ぐ
+        }
+        if constexpr (HAS_TIME_SERIES) {
+            this->series_.begin(sessionStartTime_);
+        }
+        if constexpr (HAS_SKETCH) {
+            this->sketches_.clear();
         }
         
-        data.totalKeyCount = keyDownCount;
-        data.backspaceCount = backspaceCount;
+        StreamState state;
+        forEachEvent([this, &state](const KeyEvent& event) { accumulateEvent(state, event); });
+        if constexpr (HAS_TIME_SERIES) {
+            this->series_.finish(sessionEndTime_);
+        }
+        
+        data.totalKeyCount = state.keyDownCount;
+        data.backspaceCount = state.backspaceCount;
+        if constexpr (HAS_BOUNCE) {
+            data.bounceCount = state.bounceTotal;
+            for (size_t vk = 0; vk < KEY_TABLE_SIZE; ++vk) {
+                if (state.bounceCount[vk] > 0) {
+                    data.bounceCountByKey[static_cast<int>(vk)] = state.bounceCount[vk];
+                }
+            }
+        }
+        if constexpr (HAS_ROLLOVER) {
+            data.maxSimultaneousKeys = state.maxHeldCount;
+            data.heldTimeByCount = state.heldTime;
+            data.rolloverLimitEvents = std::move(state.rolloverEvents);
+        }
         
         // WPM/CPM計算
         data.wpmTotal = calculateWPM(data.totalKeyCount, data.totalDuration);
@@ -64,27 +141,61 @@ namespace Statistics {
         data.cpmTotal = calculateCPM(data.totalKeyCount, data.totalDuration);
         data.cpmCorrect = calculateCPM(data.correctKeyCount, data.totalDuration);
         
-        // キー間隔計算
-        calculateInterKeyIntervals(data);
+        // キー間隔計算（1パス中に集めたKEY_DOWN時刻から）
+        if constexpr (HAS_INTERVAL) {
+            calculateInterKeyIntervals(data);
+        }
         
         // キー押下時間計算
-        calculateKeyPressDuration(data);
+        if constexpr (HAS_KEY_PRESS) {
+            finishKeyPressDuration(state, data);
+        }
         
         // Phase 3-2: 50音別入力時間の計算
-        data.kanaInputTime = getAvgKanaInputTime();
+        if constexpr (HAS_KANA) {
+            data.kanaInputTime = this->getAvgKanaInputTime();
+        }
+        
+        // かな別入力時間のスケッチ（IDで集計してから名前に対応付ける）
+        if constexpr (HAS_SKETCH && HAS_KANA) {
+            std::vector<TDigest> byId(this->kanaDict_.size());
+            for (size_t i = 0; i < this->kanaInputIds_.size(); ++i) {
+                byId[this->kanaInputIds_[i]].add(static_cast<double>(this->kanaInputDurations_[i]) / 1000.0);
+            }
+            for (size_t id = 0; id < byId.size(); ++id) {
+                if (!byId[id].empty()) {
+                    byId[id].compress();
+                    this->sketches_.kana.emplace(this->kanaDict_.name(static_cast<uint16_t>(id)),
+                                                 std::move(byId[id]));
+                }
+            }
+        }
+        
+        // スケッチは圧縮してから渡す（出力・表示のスレッドから読むだけにする）
+        if constexpr (HAS_SKETCH) {
+            this->sketches_.interval.compress();
+            this->sketches_.dwell.compress();
+        }
         
         return data;
     }
 
-    void Calculator::reset() {
+    template <MetricSet Set>
+    void BasicCalculator<Set>::reset() {
         events_.clear();
-        kanaInputs_.clear();  // Phase 3-2
+        detail::IntervalStore<HAS_INTERVAL>::clearStore();
+        detail::KanaStore<HAS_KANA>::clearStore();  // Phase 3-2
+        detail::DigraphStore<HAS_DIGRAPH>::clearStore();
+        detail::RolloverStore<HAS_ROLLOVER>::clearStore();
+        detail::TimeSeriesStore<HAS_TIME_SERIES>::clearStore();
+        detail::SketchStore<HAS_SKETCH>::clearStore();
         sessionStartTime_ = 0;
         sessionEndTime_ = 0;
     }
 
     // WPM計算（英語基準: 5文字=1単語）
-    double Calculator::calculateWPM(size_t charCount, uint64_t duration) const {
+    template <MetricSet Set>
+    double BasicCalculator<Set>::calculateWPM(size_t charCount, uint64_t duration) const {
         if (duration == 0) return 0.0;
         
         // マイクロ秒→分に変換
@@ -97,7 +208,8 @@ namespace Statistics {
     }
 
     // CPM計算
-    double Calculator::calculateCPM(size_t charCount, uint64_t duration) const {
+    template <MetricSet Set>
+    double BasicCalculator<Set>::calculateCPM(size_t charCount, uint64_t duration) const {
         if (duration == 0) return 0.0;
         
         // マイクロ秒→分に変換
@@ -108,121 +220,210 @@ namespace Statistics {
     }
 
     // キー間隔の計算
-    void Calculator::calculateInterKeyIntervals(StatisticsData& data) const {
-        std::vector<uint64_t> keyDownTimestamps;
-        
-        // KEY_DOWNイベントのタイムスタンプを収集
-        for (const auto& event : events_) {
-            if (event.type == EventType::KEY_DOWN) {
-                keyDownTimestamps.push_back(event.timestamp);
+    // intervalScratch_（KEY_DOWN時刻、チャタリング等は除外済み）をその場で差分に変換して集計する
+    template <MetricSet Set>
+    void BasicCalculator<Set>::calculateInterKeyIntervals(StatisticsData& data) {
+        if constexpr (HAS_INTERVAL) {
+            std::vector<uint64_t>& scratch = this->intervalScratch_;
+            if (scratch.size() < 2) {
+                data.avgInterKeyInterval = 0.0;
+                data.minInterKeyInterval = 0.0;
+                data.maxInterKeyInterval = 0.0;
+                data.stdDevInterKeyInterval = 0.0;
+                return;
             }
+            
+            // [0]は先頭時刻のまま、[1..]が連続するキー間の時間差（マイクロ秒）になる
+            IntervalKernels::deltaInPlace(scratch.data(), scratch.size());
+            const uint64_t* intervals = scratch.data() + 1;
+            size_t count = scratch.size() - 1;
+            
+            IntervalKernels::Summary summary = IntervalKernels::summarize(intervals, count);
+            if constexpr (HAS_SKETCH) {
+                for (size_t i = 0; i < count; ++i) {
+                    this->sketches_.interval.add(static_cast<double>(intervals[i]) / 1000.0);
+                }
+            }
+            double mean = summary.mean();
+            double variance = IntervalKernels::variance(intervals, count, mean);
+            
+            // マイクロ秒→ミリ秒
+            data.avgInterKeyInterval = mean / 1000.0;
+            data.minInterKeyInterval = static_cast<double>(summary.min) / 1000.0;
+            data.maxInterKeyInterval = static_cast<double>(summary.max) / 1000.0;
+            data.stdDevInterKeyInterval = std::sqrt(variance) / 1000.0;
         }
-        
-        if (keyDownTimestamps.size() < 2) {
-            data.avgInterKeyInterval = 0.0;
-            data.minInterKeyInterval = 0.0;
-            data.maxInterKeyInterval = 0.0;
-            return;
+    }
+
+    // 1イベント分の集計
+    // 無効な指標の処理は if constexpr で取り除かれる
+    template <MetricSet Set>
+    void BasicCalculator<Set>::accumulateEvent(StreamState& state, const KeyEvent& event) {
+        // 直前のイベントからの経過時間を、その間の同時押下数に計上
+        if constexpr (HAS_ROLLOVER) {
+            if (state.hasTimestamp && event.timestamp_us >= state.lastTimestamp) {
+                size_t level = std::min(state.heldCount, HELD_LEVEL_COUNT - 1);
+                state.heldTime[level] += event.timestamp_us - state.lastTimestamp;
+            }
+            state.lastTimestamp = event.timestamp_us;
+            state.hasTimestamp = true;
         }
         
-        // 連続するキー間の時間差を計算
-        std::vector<double> intervals;
-        for (size_t i = 1; i < keyDownTimestamps.size(); ++i) {
-            uint64_t diff = keyDownTimestamps[i] - keyDownTimestamps[i - 1];
-            // マイクロ秒→ミリ秒
-            intervals.push_back(static_cast<double>(diff) / 1000.0);
+        if (event.type == EventType::BACKSPACE) {
+            state.backspaceCount++;
+            if constexpr (HAS_DIGRAPH) {
+                state.recentCount = 0;  // 修正を挟んだ遷移は数えない
+            }
+            return;
         }
         
-        // 平均・最小・最大を計算
-        double sum = 0.0;
-        double minVal = std::numeric_limits<double>::max();
-        double maxVal = 0.0;
-        
-        for (double interval : intervals) {
-            sum += interval;
-            minVal = std::min(minVal, interval);
-            maxVal = std::max(maxVal, interval);
+        if (event.vk_code < 0 || event.vk_code >= static_cast<int>(KEY_TABLE_SIZE)) {
+            return;
         }
+        size_t vk = static_cast<size_t>(event.vk_code);
         
-        data.avgInterKeyInterval = sum / static_cast<double>(intervals.size());
-        data.minInterKeyInterval = minVal;
-        data.maxInterKeyInterval = maxVal;
-    }
-
-    // キー押下時間の計算
-    void Calculator::calculateKeyPressDuration(StatisticsData& data) const {
-        // KEY_DOWNとKEY_UPのペアを見つけて押下時間を計算
-        std::map<int, uint64_t> keyDownTime;  // virtualKey -> timestamp
-        std::map<char, std::vector<double>> pressDurations;  // character -> durations
-        
-        for (const auto& event : events_) {
+        if (event.suspect != InputRecorder::Suspect::NONE) {
+            // キー数・押下時間・キーペア・同時押下のいずれにも含めない（入力時に判定にも渡していない）
             if (event.type == EventType::KEY_DOWN) {
-                keyDownTime[event.virtualKey] = event.timestamp;
-            } else if (event.type == EventType::KEY_UP) {
-                auto it = keyDownTime.find(event.virtualKey);
-                if (it != keyDownTime.end()) {
-                    uint64_t downTime = it->second;
-                    uint64_t duration = event.timestamp - downTime;
-                    
-                    // 対応するKEY_DOWNの文字を見つける
-                    for (const auto& e : events_) {
-                        if (e.type == EventType::KEY_DOWN && 
-                            e.virtualKey == event.virtualKey && 
-                            e.timestamp == downTime) {
-                            // マイクロ秒→ミリ秒
-                            pressDurations[e.character].push_back(
-                                static_cast<double>(duration) / 1000.0
-                            );
-                            break;
-                        }
+                if constexpr (HAS_BOUNCE) {
+                    state.bounceCount[vk]++;
+                    state.bounceTotal++;
+                }
+            }
+        } else if (event.type == EventType::KEY_DOWN) {
+            state.keyDownCount++;
+            if constexpr (HAS_INTERVAL) {
+                this->intervalScratch_.push_back(event.timestamp_us);
+            }
+            if constexpr (HAS_TIME_SERIES) {
+                this->series_.addKeyDown(event.timestamp_us, event.is_correct);
+            }
+            
+            // 同時押下数がすでに上限なら、このイベントは欠落・入れ替わりの疑いあり
+            if constexpr (HAS_ROLLOVER) {
+                if (state.heldCount >= this->rolloverLimit_) {
+                    state.rolloverEvents.push_back({event.type, event.timestamp_us, event.vk_code, state.heldCount});
+                }
+            }
+            
+            // KEY_DOWNとKEY_UPのペアを見つけるため押下開始を記録
+            if constexpr (HAS_KEY_PRESS) {
+                state.keyDownTime[vk] = event.timestamp_us;
+                state.keyDownChar[vk] = event.character;
+            }
+            if constexpr (HAS_KEY_PRESS || HAS_ROLLOVER) {
+                if (!state.heldKeys.test(vk)) {
+                    state.heldKeys.set(vk);
+                    state.heldCount++;
+                    if constexpr (HAS_ROLLOVER) {
+                        state.maxHeldCount = std::max(state.maxHeldCount, state.heldCount);
                     }
-                    
-                    keyDownTime.erase(it);
                 }
             }
-        }
-        
-        // 各文字の平均押下時間を計算
-        for (const auto& pair : pressDurations) {
-            char ch = pair.first;
-            const auto& durations = pair.second;
             
-            if (!durations.empty()) {
-                double sum = 0.0;
-                for (double d : durations) {
-                    sum += d;
+            // キーペア遷移時間（文字を持たないキーは連鎖に入れない）
+            if constexpr (HAS_DIGRAPH) {
+                if (isTransitionChar(event.character)) {
+                    if (state.recentCount >= 1) {
+                        this->digraphs_.add(state.recentChar[0], event.character,
+                                            event.timestamp_us - state.recentTime[0]);
+                    }
+                    if (this->trigramEnabled_ && state.recentCount >= 2) {
+                        this->trigrams_.add(state.recentChar[1], state.recentChar[0], event.character,
+                                            event.timestamp_us - state.recentTime[1]);
+                    }
+                    state.recentChar[1] = state.recentChar[0];
+                    state.recentTime[1] = state.recentTime[0];
+                    state.recentChar[0] = event.character;
+                    state.recentTime[0] = event.timestamp_us;
+                    if (state.recentCount < 2) state.recentCount++;
+                }
+            }
+        } else if (event.type == EventType::KEY_UP) {
+            if constexpr (HAS_ROLLOVER) {
+                if (state.heldCount >= this->rolloverLimit_) {
+                    state.rolloverEvents.push_back({event.type, event.timestamp_us, event.vk_code, state.heldCount});
+                }
+            }
+            
+            if constexpr (HAS_KEY_PRESS || HAS_ROLLOVER) {
+                if (state.heldKeys.test(vk)) {
+                    if constexpr (HAS_KEY_PRESS) {
+                        size_t ch = static_cast<unsigned char>(state.keyDownChar[vk]);
+                        uint64_t dwell = event.timestamp_us - state.keyDownTime[vk];
+                        state.pressSum[ch] += dwell;
+                        state.pressCount[ch]++;
+                        if constexpr (HAS_SKETCH) {
+                            this->sketches_.dwell.add(static_cast<double>(dwell) / 1000.0);
+                        }
+                    }
+                    state.heldKeys.reset(vk);
+                    state.heldCount--;
                 }
-                data.avgKeyPressDuration[ch] = sum / static_cast<double>(durations.size());
             }
         }
     }
 
-    // Phase 3-2: かな別入力時間の記録
-    void Calculator::recordKanaInput(const std::string& kana, const std::string& romaji,
-                                      uint64_t startTime, uint64_t endTime) {
-        kanaInputs_.emplace_back(kana, romaji, startTime, endTime);
+    // キー押下時間の計算
+    template <MetricSet Set>
+    void BasicCalculator<Set>::finishKeyPressDuration(const StreamState& state, StatisticsData& data) const {
+        if constexpr (HAS_KEY_PRESS) {
+            // 各文字の平均押下時間を計算（マイクロ秒→ミリ秒）
+            for (size_t ch = 0; ch < KEY_TABLE_SIZE; ++ch) {
+                if (state.pressCount[ch] > 0) {
+                    data.avgKeyPressDuration[static_cast<char>(ch)] =
+                        static_cast<double>(state.pressSum[ch]) / state.pressCount[ch] / 1000.0;
+                }
+            }
+        }
     }
 
-    // Phase 3-2: かな別平均入力時間の計算
-    std::map<std::string, double> Calculator::getAvgKanaInputTime() const {
-        std::map<std::string, std::vector<uint64_t>> kanaDurations;
-        
-        // かなごとに入力時間を集計
-        for (const auto& kanaInput : kanaInputs_) {
-            kanaDurations[kanaInput.kana].push_back(kanaInput.duration);
+    // 使用する指標の組み合わせ（新しい組み合わせを使うときはここに追加する）
+    template class BasicCalculator<Metric::ALL>;
+    template class BasicCalculator<Metric::FLEET>;
+    template class BasicCalculator<Metric::BASIC>;
+
+    namespace detail {
+
+        void KanaStore<true>::clearStore() {
+            kanaInputIds_.clear();
+            kanaInputDurations_.clear();
+            kanaDict_.clear();
+            kanaDurationSum_.clear();
+            kanaDurationCount_.clear();
         }
-        
-        // 各かなの平均を計算（ミリ秒単位）
-        std::map<std::string, double> avgTimes;
-        for (const auto& pair : kanaDurations) {
-            uint64_t sum = 0;
-            for (uint64_t duration : pair.second) {
-                sum += duration;
+
+        // Phase 3-2: かな別入力時間の記録
+        void KanaStore<true>::recordKanaInput(const std::string& kana, const std::string& /*romaji*/,
+                                              uint64_t startTime, uint64_t endTime) {
+            uint16_t id = kanaDict_.intern(kana);
+            if (id >= kanaDurationSum_.size()) {
+                kanaDurationSum_.resize(id + 1, 0);
+                kanaDurationCount_.resize(id + 1, 0);
             }
-            avgTimes[pair.first] = sum / static_cast<double>(pair.second.size()) / 1000.0;  // μs -> ms
+            // 平均とスケッチが同じ値になるよう、どちらにもuint32_tに収めた所要時間を使う（約71分で頭打ち）
+            uint32_t duration = static_cast<uint32_t>(std::min<uint64_t>(endTime - startTime, UINT32_MAX));
+            kanaDurationSum_[id] += duration;
+            kanaDurationCount_[id]++;
+            
+            kanaInputIds_.push_back(id);
+            kanaInputDurations_.push_back(duration);
         }
-        
-        return avgTimes;
-    }
+
+        // Phase 3-2: かな別平均入力時間の計算
+        std::map<std::string, double> KanaStore<true>::getAvgKanaInputTime() const {
+            // 記録時に集計済みの配列から出力用のマップを作る（ミリ秒単位）
+            std::map<std::string, double> avgTimes;
+            for (size_t id = 0; id < kanaDict_.size(); ++id) {
+                if (kanaDurationCount_[id] > 0) {
+                    avgTimes[kanaDict_.name(static_cast<uint16_t>(id))] =
+                        kanaDurationSum_[id] / static_cast<double>(kanaDurationCount_[id]) / 1000.0;  // μs -> ms
+                }
+            }
+            
+            return avgTimes;
+        }
+
+    } // namespace detail
 
 } // namespace Statistics
@@ -11,26 +11,40 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <array>
+#include <bitset>
 #include <cstdint>
+#include "input_event.h"
+#include "packed_events.h"
+#include "digraph_matrix.h"
+#include "time_series.h"
+#include "tdigest.h"
 
 namespace Statistics {
 
-    // キーイベントの種類
-    enum class EventType {
-        KEY_DOWN,
-        KEY_UP,
-        BACKSPACE
-    };
+    // キー別テーブルのサイズ（仮想キーコード・ASCII文字の両方を収容）
+    constexpr size_t KEY_TABLE_SIZE = 256;
+
+    // 同時押下数ヒストグラムの段数（最後の段は「それ以上」）
+    constexpr size_t HELD_LEVEL_COUNT = 8;
+
+    // ロールオーバー上限のデフォルト（USBブートプロトコルの6キー）
+    constexpr size_t DEFAULT_ROLLOVER_LIMIT = 6;
 
-    // キーイベント情報
-    struct KeyEvent {
+    // キーイベント（InputRecorderと共通の型）
+    using EventType = InputRecorder::EventType;
+    using KeyEvent = InputRecorder::InputEvent;
+    using EventView = InputRecorder::EventView;
+    using PackedEvents = InputRecorder::PackedEvents;
+
+    // ロールオーバー上限に達した状態で届いたイベント
+    // （N-key rolloverの限界により欠落・順序入れ替わりが起きている可能性がある）
+    struct RolloverEvent {
         EventType type;
         uint64_t timestamp;     // マイクロ秒単位
         int virtualKey;         // 仮想キーコード
-        char character;         // 実際の文字（ASCII）
-        
-        KeyEvent(EventType t, uint64_t ts, int vk, char ch)
-            : type(t), timestamp(ts), virtualKey(vk), character(ch) {}
+        size_t heldCount;       // 到着時点の同時押下数
     };
 
     // 統計データ
@@ -41,6 +55,7 @@ namespace Statistics {
         size_t correctKeyCount;         // 正解キー数
         size_t incorrectKeyCount;       // 誤入力キー数
         size_t backspaceCount;          // Backspace回数
+        size_t bounceCount;             // チャタリング・ゴースト押下の検出数
         
         // WPM/CPM
         double wpmTotal;                // 総入力ベースWPM（総文字数/5/分）
@@ -52,19 +67,31 @@ namespace Statistics {
         double avgInterKeyInterval;     // 平均キー間隔（ミリ秒）
         double minInterKeyInterval;     // 最小キー間隔（ミリ秒）
         double maxInterKeyInterval;     // 最大キー間隔（ミリ秒）
+        double stdDevInterKeyInterval;  // キー間隔の標準偏差（ミリ秒）
         
         // キー別平均時間（キー押下時間）
+        // ※ 集計は固定長配列で行い、ここには出力用のビューとして格納する
         std::map<char, double> avgKeyPressDuration;  // 各文字の平均押下時間（ミリ秒）
         
         // 50音別入力時間（ローマ字入力での統計）
+        // ※ 集計はかなIDで索引する配列で行い、ここには出力用のビューとして格納する
         std::map<std::string, double> kanaInputTime;  // かな→平均入力時間（ミリ秒）
         
+        // キー別チャタリング検出数（出力用のビュー）
+        std::map<int, size_t> bounceCountByKey;  // 仮想キーコード→検出数
+        
+        // キーロールオーバー・同時押し
+        size_t maxSimultaneousKeys;     // 最大同時押下数
+        std::array<uint64_t, HELD_LEVEL_COUNT> heldTimeByCount;  // 同時押下数ごとの滞在時間（マイクロ秒）
+        std::vector<RolloverEvent> rolloverLimitEvents;          // 上限到達中に届いたイベント
+        
         StatisticsData()
             : totalDuration(0)
             , totalKeyCount(0)
             , correctKeyCount(0)
             , incorrectKeyCount(0)
             , backspaceCount(0)
+            , bounceCount(0)
             , wpmTotal(0.0)
             , wpmCorrect(0.0)
             , cpmTotal(0.0)
@@ -72,54 +99,293 @@ namespace Statistics {
             , avgInterKeyInterval(0.0)
             , minInterKeyInterval(0.0)
             , maxInterKeyInterval(0.0)
+            , stdDevInterKeyInterval(0.0)
+            , maxSimultaneousKeys(0)
+            , heldTimeByCount{}
         {}
+        
+        // 2キー以上を同時に押していた時間（マイクロ秒）
+        uint64_t overlapTime() const {
+            uint64_t sum = 0;
+            for (size_t n = 2; n < HELD_LEVEL_COUNT; ++n) sum += heldTimeByCount[n];
+            return sum;
+        }
     };
 
-    // かな入力データ（Phase 3-2）
-    struct KanaInputData {
-        std::string kana;              // 仮名文字（例: "し", "しゅ"）
-        std::string romaji;            // 対応するローマ字（例: "shi", "shu"）
-        uint64_t startTime;            // 先頭キーダウン（マイクロ秒）
-        uint64_t endTime;              // 最後のキーアップ（マイクロ秒）
-        uint64_t duration;             // 所要時間（マイクロ秒）
-        
-        KanaInputData(const std::string& k, const std::string& r, 
-                      uint64_t start, uint64_t end)
-            : kana(k), romaji(r), startTime(start), endTime(end)
-            , duration(end - start)
-        {}
+    // かなID辞書
+    // かな文字列を小さな整数IDに変換し、かな別統計を配列で扱えるようにする
+    class KanaDictionary {
+    private:
+        std::vector<std::string> names_;                 // ID → かな
+        std::unordered_map<std::string, uint16_t> ids_;  // かな → ID
+
+    public:
+        // かなをIDに変換（未登録なら新規登録）
+        uint16_t intern(const std::string& kana);
+
+        // IDからかなを取得
+        const std::string& name(uint16_t id) const { return names_[id]; }
+
+        // 登録済みかな数
+        size_t size() const { return names_.size(); }
+
+        void clear();
     };
 
+    // 計算する指標の集合（コンパイル時に選択）
+    // 基本情報・WPM/CPM・正誤数は常に計算する。それ以外はフラグで選び、
+    // 選ばなかった指標は状態もイベントごとの分岐も生成されない
+    using MetricSet = uint32_t;
+
+    namespace Metric {
+        constexpr MetricSet INTERVAL  = 1u << 0;   // キー間隔（平均・最小・最大・標準偏差）
+        constexpr MetricSet KEY_PRESS = 1u << 1;   // 文字別の平均押下時間
+        constexpr MetricSet KANA      = 1u << 2;   // かな別入力時間
+        constexpr MetricSet DIGRAPH   = 1u << 3;   // キーペア・トライグラム遷移時間
+        constexpr MetricSet BOUNCE    = 1u << 4;   // チャタリング検出数（キー別）
+        constexpr MetricSet ROLLOVER  = 1u << 5;   // 同時押下・ロールオーバー
+        constexpr MetricSet TIME_SERIES = 1u << 6; // 移動窓のWPM/CPM・正確率・キー間隔中央値
+        constexpr MetricSet SKETCH    = 1u << 7;   // 分位点スケッチ（INTERVAL・KEY_PRESSが必要）
+
+        constexpr MetricSet BASIC = 0;             // WPM/CPM・正誤数のみ
+        constexpr MetricSet FLEET = INTERVAL;      // 集計ツール用: WPM・正確率・キー間隔
+        constexpr MetricSet ALL   = INTERVAL | KEY_PRESS | KANA | DIGRAPH | BOUNCE | ROLLOVER | TIME_SERIES | SKETCH;
+    }
+
+    constexpr bool hasMetric(MetricSet set, MetricSet metric) {
+        return (set & metric) != 0;
+    }
+
+    // 指標ごとの状態
+    // 無効な指標は空の基底クラスになり、空基底最適化でサイズを持たない
+    namespace detail {
+
+        // --- 計算器が保持する状態 ---
+
+        template <bool Enabled> struct IntervalStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct IntervalStore<true> {
+        protected:
+            // キー間隔計算の作業領域（KEY_DOWN時刻→その場で差分に変換。計算間で再利用）
+            std::vector<uint64_t> intervalScratch_;
+            void clearStore() {}
+        };
+
+        template <bool Enabled> struct KanaStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct KanaStore<true> {
+        protected:
+            // Phase 3-2: 50音別入力時間（入力順）
+            // かなはIDで、所要時間は32bitで持つ（1入力あたり6バイト。約71分を超える所要時間は上限で止める）
+            std::vector<uint16_t> kanaInputIds_;          // かなID
+            std::vector<uint32_t> kanaInputDurations_;    // 所要時間（マイクロ秒）
+            
+            // かな別集計（かなIDで索引）
+            KanaDictionary kanaDict_;
+            std::vector<uint64_t> kanaDurationSum_;    // 所要時間の合計（マイクロ秒）
+            std::vector<uint32_t> kanaDurationCount_;  // 入力回数
+            
+            void clearStore();
+            
+        public:
+            // Phase 3-2: かな入力記録（romajiは記録しない）
+            void recordKanaInput(const std::string& kana, const std::string& romaji,
+                                 uint64_t startTime, uint64_t endTime);
+            
+            // Phase 3-2: 50音別平均入力時間取得
+            std::map<std::string, double> getAvgKanaInputTime() const;
+        };
+
+        template <bool Enabled> struct DigraphStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct DigraphStore<true> {
+        protected:
+            // キーペア遷移時間（calculate()の1パスで更新）
+            // クリアはstartSession()で行う。同じセッションで再計算する場合だけcalculate()でもクリアする
+            DigraphMatrix digraphs_;
+            TrigramTable trigrams_;
+            bool trigramEnabled_ = false;
+            bool digraphsCounted_ = false;  // このセッションで集計済みか
+            
+            void clearStore() {
+                digraphs_.clear();
+                trigrams_.clear();
+                digraphsCounted_ = false;
+            }
+            
+        public:
+            // トライグラム集計の有効化（デフォルト: 無効）
+            void setTrigramEnabled(bool enabled) { trigramEnabled_ = enabled; }
+            
+            // キーペア遷移時間の取得（calculate()後に有効）
+            const DigraphMatrix& getDigraphMatrix() const { return digraphs_; }
+            const TrigramTable& getTrigramTable() const { return trigrams_; }
+        };
+
+        template <bool Enabled> struct RolloverStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct RolloverStore<true> {
+        protected:
+            // ロールオーバー上限（同時押下数）
+            size_t rolloverLimit_ = DEFAULT_ROLLOVER_LIMIT;
+            void clearStore() {}
+            
+        public:
+            // ロールオーバー上限の設定（デフォルト: DEFAULT_ROLLOVER_LIMIT）
+            void setRolloverLimit(size_t limit) { rolloverLimit_ = limit; }
+        };
+
+        template <bool Enabled> struct TimeSeriesStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct TimeSeriesStore<true> {
+        protected:
+            // 移動窓の時系列（calculate()の1パスで更新）
+            TimeSeries series_;
+            void clearStore() { series_.clear(); }
+            
+        public:
+            // 窓の幅・サンプル間隔・バケット数の設定
+            void setTimeSeriesConfig(const TimeSeriesConfig& config) { series_.setConfig(config); }
+            
+            // 時系列の取得（calculate()後に有効）
+            const TimeSeries& getTimeSeries() const { return series_; }
+        };
+
+        template <bool Enabled> struct SketchStore {
+        protected:
+            void clearStore() {}
+        };
+        template <> struct SketchStore<true> {
+        protected:
+            // キー間隔・押下時間・かな別入力時間の分位点スケッチ
+            SessionSketches sketches_;
+            void clearStore() { sketches_.clear(); }
+            
+        public:
+            // スケッチの取得（calculate()後に有効）
+            const SessionSketches& getSketches() const { return sketches_; }
+        };
+
+        // --- 1パス集計の作業領域 ---
+
+        // 押下中のキー（押下時間・同時押下の両方で使う）
+        template <bool Enabled> struct HeldState {};
+        template <> struct HeldState<true> {
+            std::bitset<KEY_TABLE_SIZE> heldKeys;                // 押下中のキー集合（256ビット）
+            size_t heldCount = 0;
+        };
+
+        template <bool Enabled> struct PressState {};
+        template <> struct PressState<true> {
+            std::array<uint64_t, KEY_TABLE_SIZE> keyDownTime{};  // virtualKey -> timestamp
+            std::array<char, KEY_TABLE_SIZE> keyDownChar{};      // virtualKey -> KEY_DOWN時の文字
+            std::array<uint64_t, KEY_TABLE_SIZE> pressSum{};     // character -> 押下時間合計（マイクロ秒）
+            std::array<uint32_t, KEY_TABLE_SIZE> pressCount{};   // character -> 押下回数
+        };
+
+        template <bool Enabled> struct BounceState {};
+        template <> struct BounceState<true> {
+            std::array<uint32_t, KEY_TABLE_SIZE> bounceCount{};  // virtualKey -> チャタリング検出数
+            size_t bounceTotal = 0;
+        };
+
+        template <bool Enabled> struct RolloverState {};
+        template <> struct RolloverState<true> {
+            size_t maxHeldCount = 0;
+            uint64_t lastTimestamp = 0;
+            bool hasTimestamp = false;
+            std::array<uint64_t, HELD_LEVEL_COUNT> heldTime{};
+            std::vector<RolloverEvent> rolloverEvents;
+        };
+
+        template <bool Enabled> struct DigraphState {};
+        template <> struct DigraphState<true> {
+            // 直近のKEY_DOWN（[0]が最新）。Backspaceで連鎖を切る
+            char recentChar[2] = {'\0', '\0'};
+            uint64_t recentTime[2] = {0, 0};
+            int recentCount = 0;
+        };
+
+    } // namespace detail
+
     // 統計計算クラス
-    class Calculator {
+    // Set: 計算する指標（Metric::のフラグの組み合わせ）
+    // 定義はstatistics.cppにあり、使用する組み合わせはそこで明示的にインスタンス化する
+    template <MetricSet Set>
+    class BasicCalculator
+        : public detail::IntervalStore<hasMetric(Set, Metric::INTERVAL)>
+        , public detail::KanaStore<hasMetric(Set, Metric::KANA)>
+        , public detail::DigraphStore<hasMetric(Set, Metric::DIGRAPH)>
+        , public detail::RolloverStore<hasMetric(Set, Metric::ROLLOVER)>
+        , public detail::TimeSeriesStore<hasMetric(Set, Metric::TIME_SERIES)>
+        , public detail::SketchStore<hasMetric(Set, Metric::SKETCH)>
+    {
+    public:
+        static constexpr bool HAS_INTERVAL  = hasMetric(Set, Metric::INTERVAL);
+        static constexpr bool HAS_KEY_PRESS = hasMetric(Set, Metric::KEY_PRESS);
+        static constexpr bool HAS_KANA      = hasMetric(Set, Metric::KANA);
+        static constexpr bool HAS_DIGRAPH   = hasMetric(Set, Metric::DIGRAPH);
+        static constexpr bool HAS_BOUNCE    = hasMetric(Set, Metric::BOUNCE);
+        static constexpr bool HAS_ROLLOVER  = hasMetric(Set, Metric::ROLLOVER);
+        static constexpr bool HAS_TIME_SERIES = hasMetric(Set, Metric::TIME_SERIES);
+        static constexpr bool HAS_SKETCH    = hasMetric(Set, Metric::SKETCH);
+        
+        static_assert(!HAS_SKETCH || (HAS_INTERVAL && HAS_KEY_PRESS),
+                      "Metric::SKETCH requires Metric::INTERVAL and Metric::KEY_PRESS");
+        
     private:
         std::vector<KeyEvent> events_;
         uint64_t sessionStartTime_;
         uint64_t sessionEndTime_;
         
-        // Phase 3-2: 50音別入力時間
-        std::vector<KanaInputData> kanaInputs_;
+        // 1パス集計の作業領域（有効な指標の分だけ持つ）
+        struct StreamState
+            : detail::HeldState<HAS_KEY_PRESS || HAS_ROLLOVER>
+            , detail::PressState<HAS_KEY_PRESS>
+            , detail::BounceState<HAS_BOUNCE>
+            , detail::RolloverState<HAS_ROLLOVER>
+            , detail::DigraphState<HAS_DIGRAPH>
+        {
+            size_t keyDownCount = 0;
+            size_t backspaceCount = 0;
+        };
         
     public:
-        Calculator();
+        BasicCalculator();
         
         // セッション管理
         void startSession(uint64_t startTime);
         void endSession(uint64_t endTime);
         
-        // イベント記録
+        // イベント記録（Recorderを使わない場合・テスト用）
         void recordKeyDown(uint64_t timestamp, int virtualKey, char character);
         void recordKeyUp(uint64_t timestamp, int virtualKey);
         void recordBackspace(uint64_t timestamp);
         
-        // Phase 3-2: かな入力記録
-        void recordKanaInput(const std::string& kana, const std::string& romaji,
-                             uint64_t startTime, uint64_t endTime);
-        
-        // Phase 3-2: 50音別平均入力時間取得
-        std::map<std::string, double> getAvgKanaInputTime() const;
+        // チャタリング・ゴースト押下と判定されたキーダウンの記録
+        void recordBounce(uint64_t timestamp, int virtualKey);
         
         // 統計計算（judgeResultを使用）
+        // events: 記録済みイベント列（Recorder::getEvents()をコピーせずに渡す）
+        // 正誤数は渡された値をそのまま使う（ゴースト押下は判定に渡す前に除かれている）
+        // チャタリング等の疑いがあるイベントはキー数・WPM・打鍵間隔・キーペア遷移からだけ除外する
+        // 無効な指標のフィールドは初期値のまま
+        StatisticsData calculate(EventView events, size_t correctCount, size_t incorrectCount);
+        
+        // 統計計算（Recorder::takeEvents()で取り出した詰めた形のまま、ブロックごとに復号しながら読む）
+        StatisticsData calculate(const PackedEvents& events, size_t correctCount, size_t incorrectCount);
+        
+        // recordKeyDown()等で記録したイベントで統計計算
         StatisticsData calculate(size_t correctCount, size_t incorrectCount);
         
         // イベント数取得
@@ -132,8 +398,22 @@ namespace Statistics {
         // 内部計算関数
         double calculateWPM(size_t charCount, uint64_t duration) const;
         double calculateCPM(size_t charCount, uint64_t duration) const;
-        void calculateInterKeyIntervals(StatisticsData& data) const;
-        void calculateKeyPressDuration(StatisticsData& data) const;
+        void calculateInterKeyIntervals(StatisticsData& data);
+        void accumulateEvent(StreamState& state, const KeyEvent& event);
+        // forEachEvent(f)が全イベントをf(const KeyEvent&)に渡す
+        template <typename ForEachEvent>
+        StatisticsData calculateWith(ForEachEvent forEachEvent, size_t correctCount, size_t incorrectCount);
+        void finishKeyPressDuration(const StreamState& state, StatisticsData& data) const;
     };
 
+    // 全指標を計算する標準の計算器
+    using Calculator = BasicCalculator<Metric::ALL>;
+
+    // WPM・正確率・キー間隔のみを計算する計算器（集計ツール用）
+    using FleetCalculator = BasicCalculator<Metric::FLEET>;
+
+    extern template class BasicCalculator<Metric::ALL>;
+    extern template class BasicCalculator<Metric::FLEET>;
+    extern template class BasicCalculator<Metric::BASIC>;
+
 } // namespace Statistics
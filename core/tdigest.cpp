@@ -0,0 +1,169 @@
+// tdigest.cpp
+// t-digestの実装（マージ方式）
+
+#include "tdigest.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Statistics {
+
+    // 未圧縮バッファの上限（圧縮パラメータの倍数）
+    static const size_t TDIGEST_BUFFER_FACTOR = 5;
+
+    static const double PI = 3.14159265358979323846;
+
+    // スケール関数 k1(q) = δ/(2π)·asin(2q-1)
+    // 1つのセントロイドが占めるkの幅を1以下に保つと、両端ほどセントロイドが小さくなる
+    static double scale(double q, double compression) {
+        q = std::min(std::max(q, 0.0), 1.0);
+        return compression / (2.0 * PI) * std::asin(2.0 * q - 1.0);
+    }
+
+    TDigest::TDigest(double compression)
+        : compression_(compression)
+        , totalWeight_(0.0)
+        , min_(0.0)
+        , max_(0.0)
+    {
+    }
+
+    void TDigest::clear() {
+        centroids_.clear();
+        buffer_.clear();
+        totalWeight_ = 0.0;
+        min_ = 0.0;
+        max_ = 0.0;
+    }
+
+    void TDigest::add(double value, double weight) {
+        if (weight <= 0.0 || std::isnan(value)) return;
+
+        if (totalWeight_ <= 0.0) {
+            min_ = value;
+            max_ = value;
+        } else {
+            min_ = std::min(min_, value);
+            max_ = std::max(max_, value);
+        }
+        totalWeight_ += weight;
+
+        buffer_.push_back({value, weight});
+        if (buffer_.size() >= TDIGEST_BUFFER_FACTOR * static_cast<size_t>(compression_)) {
+            compress();
+        }
+    }
+
+    void TDigest::merge(const TDigest& other) {
+        if (other.empty()) return;
+
+        if (totalWeight_ <= 0.0) {
+            min_ = other.min_;
+            max_ = other.max_;
+        } else {
+            min_ = std::min(min_, other.min_);
+            max_ = std::max(max_, other.max_);
+        }
+        totalWeight_ += other.totalWeight_;
+
+        buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+        buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+        if (buffer_.size() >= TDIGEST_BUFFER_FACTOR * static_cast<size_t>(compression_)) {
+            compress();
+        }
+    }
+
+    void TDigest::compress() {
+        if (buffer_.empty()) return;
+
+        buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+        std::sort(buffer_.begin(), buffer_.end(),
+                  [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+        double total = 0.0;
+        for (const auto& c : buffer_) total += c.weight;
+
+        centroids_.clear();
+        Centroid current = buffer_[0];
+        double weightBefore = 0.0;   // currentより前の累積重み
+        double kLeft = scale(0.0, compression_);
+
+        for (size_t i = 1; i < buffer_.size(); ++i) {
+            const Centroid& next = buffer_[i];
+            double proposed = current.weight + next.weight;
+            double kRight = scale((weightBefore + proposed) / total, compression_);
+
+            if (kRight - kLeft <= 1.0) {
+                // 統合（重み付き平均）
+                current.mean += (next.mean - current.mean) * next.weight / proposed;
+                current.weight = proposed;
+            } else {
+                centroids_.push_back(current);
+                weightBefore += current.weight;
+                kLeft = scale(weightBefore / total, compression_);
+                current = next;
+            }
+        }
+        centroids_.push_back(current);
+        buffer_.clear();
+    }
+
+    double TDigest::quantile(double q) const {
+        if (!compressed()) {
+            TDigest copy = *this;
+            copy.compress();
+            return copy.quantile(q);
+        }
+        if (centroids_.empty()) return 0.0;
+
+        q = std::min(std::max(q, 0.0), 1.0);
+        if (centroids_.size() == 1) {
+            // 1つしかなければ最小〜最大で補間
+            return min_ + (max_ - min_) * q;
+        }
+
+        double target = q * totalWeight_;
+
+        // 先頭セントロイドの中心より左: 最小値と補間
+        double firstCenter = centroids_[0].weight / 2.0;
+        if (target < firstCenter) {
+            return min_ + (centroids_[0].mean - min_) * (target / firstCenter);
+        }
+
+        double cumulative = 0.0;
+        for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+            const Centroid& left = centroids_[i];
+            const Centroid& right = centroids_[i + 1];
+            double leftCenter = cumulative + left.weight / 2.0;
+            double rightCenter = cumulative + left.weight + right.weight / 2.0;
+            if (target < rightCenter) {
+                double t = (target - leftCenter) / (rightCenter - leftCenter);
+                return left.mean + (right.mean - left.mean) * t;
+            }
+            cumulative += left.weight;
+        }
+
+        // 末尾セントロイドの中心より右: 最大値と補間
+        const Centroid& last = centroids_.back();
+        double lastCenter = totalWeight_ - last.weight / 2.0;
+        double span = totalWeight_ - lastCenter;
+        double t = span > 0.0 ? (target - lastCenter) / span : 1.0;
+        return last.mean + (max_ - last.mean) * std::min(t, 1.0);
+    }
+
+    TDigest TDigest::fromCentroids(const std::vector<Centroid>& centroids, double min, double max,
+                                   double compression) {
+        TDigest digest(compression);
+        for (const auto& c : centroids) {
+            if (c.weight <= 0.0) continue;
+            digest.buffer_.push_back(c);
+            digest.totalWeight_ += c.weight;
+        }
+        if (digest.totalWeight_ > 0.0) {
+            digest.min_ = min;
+            digest.max_ = max;
+        }
+        digest.compress();
+        return digest;
+    }
+
+} // namespace Statistics
@@ -0,0 +1,90 @@
+#pragma once
+
+// tdigest.h
+// マージ可能な分位点スケッチ（t-digest）
+//
+// 用語解説:
+// - 分位点(Quantile): 値を小さい順に並べたときの位置（p50=中央値、p99=上位1%の境界）
+// - スケッチ(Sketch): 元データを保持せずに統計量を近似する小さな要約
+// - セントロイド(Centroid): 近い値をまとめた「平均値と件数」の組
+//
+// 平均値は複数セッションで合算しても正しいパーセンタイルにならないため、
+// セッションごとにスケッチを保存し、後から合算（マージ）して全体の分位点を求める。
+// 分布の両端ほどセントロイドを細かく保つので、p99などの裾の精度が高い。
+
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace Statistics {
+
+    // t-digestの圧縮パラメータのデフォルト（大きいほど高精度・大きい）
+    constexpr double TDIGEST_DEFAULT_COMPRESSION = 100.0;
+
+    class TDigest {
+    public:
+        struct Centroid {
+            double mean;
+            double weight;
+        };
+
+    private:
+        double compression_;
+        std::vector<Centroid> centroids_;   // 平均値の昇順（圧縮済み）
+        std::vector<Centroid> buffer_;      // 未圧縮の追加分
+        double totalWeight_;
+        double min_;
+        double max_;
+
+    public:
+        explicit TDigest(double compression = TDIGEST_DEFAULT_COMPRESSION);
+
+        // 値の追加
+        void add(double value, double weight = 1.0);
+
+        // 別のスケッチを合算
+        void merge(const TDigest& other);
+
+        // 未圧縮の追加分をセントロイドに統合する
+        // constの関数は内部を書き換えないので、複数スレッドで共有する前に呼んでおく
+        void compress();
+
+        // 未圧縮の追加分がないか
+        bool compressed() const { return buffer_.empty(); }
+
+        // 分位点（q: 0.0〜1.0。空のときは0）
+        // 未圧縮の追加分があれば写しを圧縮して求める（遅くなるのでcompress()してから呼ぶ）
+        double quantile(double q) const;
+
+        // 件数・最小・最大
+        double count() const { return totalWeight_; }
+        double min() const { return totalWeight_ > 0 ? min_ : 0.0; }
+        double max() const { return totalWeight_ > 0 ? max_ : 0.0; }
+        bool empty() const { return totalWeight_ <= 0; }
+
+        // 保存用（圧縮済みのセントロイド。未圧縮の追加分は含まないのでcompress()してから呼ぶ）
+        const std::vector<Centroid>& centroids() const { return centroids_; }
+
+        // 保存したセントロイドから復元
+        static TDigest fromCentroids(const std::vector<Centroid>& centroids, double min, double max,
+                                     double compression = TDIGEST_DEFAULT_COMPRESSION);
+
+        void clear();
+    };
+
+    // 1セッション分のスケッチ（ミリ秒単位）
+    struct SessionSketches {
+        TDigest interval;                       // キー間隔
+        TDigest dwell;                          // キー押下時間
+        std::map<std::string, TDigest> kana;    // かな別入力時間
+
+        void clear() {
+            interval.clear();
+            dwell.clear();
+            kana.clear();
+        }
+    };
+
+} // namespace Statistics
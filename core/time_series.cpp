@@ -0,0 +1,238 @@
+// time_series.cpp
+// 移動窓時系列の実装
+
+#include "time_series.h"
+#include <algorithm>
+
+namespace Statistics {
+
+    // ---- SeriesRange ----
+
+    void SeriesRange::add(double v) {
+        if (count == 0) {
+            min = v;
+            max = v;
+        } else {
+            min = std::min(min, v);
+            max = std::max(max, v);
+        }
+        sum += v;
+        count++;
+    }
+
+    void SeriesRange::merge(const SeriesRange& other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        sum += other.sum;
+        count += other.count;
+    }
+
+    // ---- TimeSeries ----
+
+    TimeSeries::TimeSeries(const TimeSeriesConfig& config)
+        : intervalBins_(SERIES_INTERVAL_BINS, 0)
+        , intervalBlocks_((SERIES_INTERVAL_BINS + SERIES_INTERVAL_BLOCK - 1) / SERIES_INTERVAL_BLOCK, 0)
+    {
+        setConfig(config);
+        clear();
+    }
+
+    void TimeSeries::setConfig(const TimeSeriesConfig& config) {
+        config_ = config;
+        if (config_.stepUs == 0) config_.stepUs = 1;
+        if (config_.windowUs == 0) config_.windowUs = config_.stepUs;
+    }
+
+    void TimeSeries::clear() {
+        window_.clear();
+        windowCorrect_ = 0;
+        std::fill(intervalBins_.begin(), intervalBins_.end(), 0);
+        std::fill(intervalBlocks_.begin(), intervalBlocks_.end(), 0);
+        intervalCount_ = 0;
+        origin_ = 0;
+        nextSample_ = config_.stepUs;
+        lastKeyTime_ = 0;
+        hasLastKey_ = false;
+        buckets_.clear();
+        samplesPerBucket_ = 1;
+    }
+
+    void TimeSeries::begin(uint64_t startTime) {
+        clear();
+        origin_ = startTime;
+        nextSample_ = startTime + config_.stepUs;
+    }
+
+    void TimeSeries::addKeyDown(uint64_t timestamp, bool correct) {
+        // このキーより前のサンプル時刻を確定させる（同時刻のサンプルはこのキーを含める）
+        while (nextSample_ < timestamp) {
+            emitSample(nextSample_);
+            nextSample_ += config_.stepUs;
+
+            // 窓が空なら、次のキーまでのサンプルはすべて0なのでまとめて置く
+            if (window_.empty() && nextSample_ < timestamp) {
+                uint64_t idle = (timestamp - nextSample_ + config_.stepUs - 1) / config_.stepUs;
+                addIdleSamples(nextSample_, idle);
+                nextSample_ += idle * config_.stepUs;
+            }
+        }
+
+        int bin = -1;
+        if (hasLastKey_ && timestamp >= lastKeyTime_) {
+            uint64_t ms = (timestamp - lastKeyTime_) / 1000;
+            bin = static_cast<int>(std::min<uint64_t>(ms, SERIES_INTERVAL_BINS - 1));
+            intervalBins_[bin]++;
+            intervalBlocks_[bin / SERIES_INTERVAL_BLOCK]++;
+            intervalCount_++;
+        }
+        lastKeyTime_ = timestamp;
+        hasLastKey_ = true;
+
+        window_.push_back({timestamp, correct, bin});
+        if (correct) windowCorrect_++;
+    }
+
+    void TimeSeries::finish(uint64_t endTime) {
+        while (nextSample_ <= endTime) {
+            emitSample(nextSample_);
+            nextSample_ += config_.stepUs;
+            if (window_.empty() && nextSample_ <= endTime) {
+                uint64_t idle = (endTime - nextSample_) / config_.stepUs + 1;
+                addIdleSamples(nextSample_, idle);
+                nextSample_ += idle * config_.stepUs;
+            }
+        }
+
+        // ステップの途中で終わった分
+        if (endTime > origin_ && nextSample_ - config_.stepUs < endTime) {
+            emitSample(endTime);
+            nextSample_ = endTime + config_.stepUs;
+        }
+    }
+
+    void TimeSeries::evictBefore(uint64_t cutoff) {
+        while (!window_.empty() && window_.front().timestamp <= cutoff) {
+            const WindowEntry& entry = window_.front();
+            if (entry.correct) windowCorrect_--;
+            if (entry.intervalBin >= 0) {
+                intervalBins_[entry.intervalBin]--;
+                intervalBlocks_[entry.intervalBin / SERIES_INTERVAL_BLOCK]--;
+                intervalCount_--;
+            }
+            window_.pop_front();
+        }
+    }
+
+    double TimeSeries::medianIntervalMs() const {
+        // 下側中央値の順位をブロック→ビンの順に探す
+        size_t target = (intervalCount_ - 1) / 2;
+        size_t seen = 0;
+        size_t block = 0;
+        while (seen + intervalBlocks_[block] <= target) {
+            seen += intervalBlocks_[block];
+            block++;
+        }
+        size_t bin = block * SERIES_INTERVAL_BLOCK;
+        while (seen + intervalBins_[bin] <= target) {
+            seen += intervalBins_[bin];
+            bin++;
+        }
+        // ビンの中央の値（最後のビンは上限値）
+        if (bin == SERIES_INTERVAL_BINS - 1) return static_cast<double>(SERIES_INTERVAL_BINS);
+        return static_cast<double>(bin) + 0.5;
+    }
+
+    void TimeSeries::emitSample(uint64_t timestamp) {
+        if (timestamp >= config_.windowUs) {
+            evictBefore(timestamp - config_.windowUs);
+        }
+
+        // セッション開始直後は経過時間を窓の幅とする（ウォームアップ中の過小評価を防ぐ）
+        uint64_t span = config_.windowUs;
+        if (timestamp > origin_ && timestamp - origin_ < span) {
+            span = timestamp - origin_;
+        }
+        double minutes = static_cast<double>(span) / 1000000.0 / 60.0;
+
+        TimeSeriesPoint point;
+        point.timestamp = timestamp;
+        point.keyCount = window_.size();
+        point.cpm = minutes > 0.0 ? static_cast<double>(point.keyCount) / minutes : 0.0;
+        point.wpm = point.cpm / 5.0;
+        point.accuracy = point.keyCount > 0
+            ? static_cast<double>(windowCorrect_) / point.keyCount * 100.0 : 0.0;
+        point.hasInterval = intervalCount_ > 0;
+        point.medianInterval = point.hasInterval ? medianIntervalMs() : 0.0;
+
+        addPoint(point);
+    }
+
+    void TimeSeries::addPoint(const TimeSeriesPoint& point) {
+        if (buckets_.empty() || buckets_.back().samples >= samplesPerBucket_) {
+            buckets_.push_back(TimeSeriesBucket{point.timestamp, point.timestamp, 0, {}, {}, {}, {}});
+        }
+
+        TimeSeriesBucket& bucket = buckets_.back();
+        bucket.endTime = point.timestamp;
+        bucket.samples++;
+        bucket.wpm.add(point.wpm);
+        bucket.cpm.add(point.cpm);
+        if (point.keyCount > 0) bucket.accuracy.add(point.accuracy);
+        if (point.hasInterval) bucket.medianInterval.add(point.medianInterval);
+
+        if (buckets_.size() > std::max<size_t>(config_.maxBuckets, 2)) {
+            compact();
+        }
+    }
+
+    void TimeSeries::addIdleSamples(uint64_t firstTimestamp, uint64_t count) {
+        // addPoint()をcount回呼ぶのと同じ結果を、バケット単位でまとめて作る
+        // （休止中もステップごとのサンプルを置き、バケットの時間幅を揃える）
+        while (count > 0) {
+            if (buckets_.empty() || buckets_.back().samples >= samplesPerBucket_) {
+                buckets_.push_back(TimeSeriesBucket{firstTimestamp, firstTimestamp, 0, {}, {}, {}, {}});
+            }
+
+            TimeSeriesBucket& bucket = buckets_.back();
+            uint64_t n = std::min<uint64_t>(count, samplesPerBucket_ - bucket.samples);
+            SeriesRange zeros;
+            zeros.count = static_cast<size_t>(n);
+            bucket.endTime = firstTimestamp + (n - 1) * config_.stepUs;
+            bucket.samples += static_cast<size_t>(n);
+            bucket.wpm.merge(zeros);
+            bucket.cpm.merge(zeros);
+            firstTimestamp += n * config_.stepUs;
+            count -= n;
+
+            if (buckets_.size() > std::max<size_t>(config_.maxBuckets, 2)) {
+                compact();
+            }
+        }
+    }
+
+    void TimeSeries::compact() {
+        // 隣り合う2バケットを統合し、1バケットあたりのサンプル数を2倍にする
+        size_t out = 0;
+        for (size_t i = 0; i < buckets_.size(); i += 2) {
+            TimeSeriesBucket merged = buckets_[i];
+            if (i + 1 < buckets_.size()) {
+                const TimeSeriesBucket& next = buckets_[i + 1];
+                merged.endTime = next.endTime;
+                merged.samples += next.samples;
+                merged.wpm.merge(next.wpm);
+                merged.cpm.merge(next.cpm);
+                merged.accuracy.merge(next.accuracy);
+                merged.medianInterval.merge(next.medianInterval);
+            }
+            buckets_[out++] = merged;
+        }
+        buckets_.resize(out);
+        samplesPerBucket_ *= 2;
+    }
+
+} // namespace Statistics
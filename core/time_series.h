@@ -0,0 +1,133 @@
+#pragma once
+
+// time_series.h
+// 移動窓によるWPM/CPM・正確率・キー間隔中央値の時系列
+//
+// 用語解説:
+// - 移動窓(Rolling Window): 各時点から過去N秒間だけを対象にした集計
+// - ダウンサンプリング(Downsampling): 点数を減らして長い時系列を小さく保つこと
+// - バケット(Bucket): 連続するサンプルをまとめた区間（最小・最大・平均を保持）
+//
+// 疲労・ウォームアップによる速度変化を見るため、一定間隔（ステップ）ごとに
+// 直近の窓の値をサンプルする。イベントごとの処理は償却O(1)。
+// サンプルは最大バケット数を超えると隣り合う2つを統合して解像度を半分にするため、
+// 24時間のセッションでもメモリと出力は一定の大きさに収まる。
+// 休止中もステップごとにキー数0のサンプルを置く（バケット単位でまとめて追加する）ので、
+// 最後以外のバケットはすべて同じ時間幅（getSamplesPerBucket() × stepUs）になる。
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+namespace Statistics {
+
+    // キー間隔中央値のヒストグラム（1ms刻み、上限以上は最後のビン）
+    constexpr size_t SERIES_INTERVAL_BINS = 2000;
+    constexpr size_t SERIES_INTERVAL_BLOCK = 50;     // 中央値探索用のブロック幅（ビン数）
+
+    // 時系列の設定
+    struct TimeSeriesConfig {
+        uint64_t windowUs;      // 移動窓の幅（マイクロ秒）
+        uint64_t stepUs;        // サンプル間隔（マイクロ秒）
+        size_t maxBuckets;      // 保持するバケット数の上限（偶数）
+
+        TimeSeriesConfig()
+            : windowUs(10000000)    // 10秒
+            , stepUs(1000000)       // 1秒
+            , maxBuckets(512)
+        {}
+    };
+
+    // 1時点のサンプル
+    struct TimeSeriesPoint {
+        uint64_t timestamp;         // サンプル時刻（マイクロ秒）
+        size_t keyCount;            // 窓内のキー数
+        double wpm;
+        double cpm;
+        double accuracy;            // 正解率（%）。keyCount == 0 のときは無効
+        double medianInterval;      // キー間隔の中央値（ミリ秒）。間隔がないときは無効
+        bool hasInterval;
+    };
+
+    // 値の範囲（最小・最大・平均）
+    struct SeriesRange {
+        double min = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        size_t count = 0;
+
+        void add(double v);
+        void merge(const SeriesRange& other);
+        double mean() const { return count > 0 ? sum / count : 0.0; }
+    };
+
+    // ダウンサンプリング後の1区間
+    struct TimeSeriesBucket {
+        uint64_t startTime;         // 最初のサンプル時刻（マイクロ秒）
+        uint64_t endTime;           // 最後のサンプル時刻（マイクロ秒）
+        size_t samples;             // まとめたサンプル数
+        SeriesRange wpm;
+        SeriesRange cpm;
+        SeriesRange accuracy;       // キーのあったサンプルのみ
+        SeriesRange medianInterval; // 間隔のあったサンプルのみ
+    };
+
+    // 移動窓の時系列
+    class TimeSeries {
+    private:
+        struct WindowEntry {
+            uint64_t timestamp;
+            bool correct;
+            int intervalBin;        // 直前のキーからの間隔のビン（先頭キーは-1）
+        };
+
+        TimeSeriesConfig config_;
+
+        // 移動窓の状態
+        std::deque<WindowEntry> window_;
+        size_t windowCorrect_;
+        std::vector<uint32_t> intervalBins_;     // 1ms刻みの件数
+        std::vector<uint32_t> intervalBlocks_;   // SERIES_INTERVAL_BLOCKビンごとの件数
+        size_t intervalCount_;
+        uint64_t origin_;
+        uint64_t nextSample_;
+        uint64_t lastKeyTime_;
+        bool hasLastKey_;
+
+        // ダウンサンプリング済みの系列
+        std::vector<TimeSeriesBucket> buckets_;
+        size_t samplesPerBucket_;
+
+        void evictBefore(uint64_t cutoff);
+        void emitSample(uint64_t timestamp);
+        void addPoint(const TimeSeriesPoint& point);
+        void addIdleSamples(uint64_t firstTimestamp, uint64_t count);  // キー数0のサンプルをcount個
+        void compact();
+        double medianIntervalMs() const;
+
+    public:
+        explicit TimeSeries(const TimeSeriesConfig& config = TimeSeriesConfig());
+
+        // 設定の変更（次のbegin()から有効）
+        void setConfig(const TimeSeriesConfig& config);
+        const TimeSeriesConfig& getConfig() const { return config_; }
+
+        // セッション開始（系列をクリアし、経過時間の基準を設定）
+        void begin(uint64_t startTime);
+
+        // 集計対象のKEY_DOWN（チャタリング等は呼び出し側で除外）
+        void addKeyDown(uint64_t timestamp, bool correct);
+
+        // セッション終了時刻までのサンプルを確定
+        void finish(uint64_t endTime);
+
+        // 結果
+        const std::vector<TimeSeriesBucket>& getBuckets() const { return buckets_; }
+        size_t getSamplesPerBucket() const { return samplesPerBucket_; }
+        uint64_t getOrigin() const { return origin_; }
+
+        void clear();
+    };
+
+} // namespace Statistics
@@ -1,4 +1,5 @@
 #include "terminal.h"
+#include "../text_width.h"
 #include <windows.h>
 #include <iostream>
 #include <string>
@@ -57,25 +58,7 @@ namespace Terminal {
 
     // 文字列の表示幅を計算（全角2、半角1）
     int getDisplayWidth(const std::string& str) {
-        std::wstring_convert<std::codecvt_utf8<wchar_t>> conv;
-        std::wstring wstr = conv.from_bytes(str);
-        int width = 0;
-        for (wchar_t wc : wstr) {
-            // 全角判定（簡易版）
-            if ((wc >= 0x1100 && wc <= 0x115F) ||
-                (wc >= 0x2E80 && wc <= 0xA4CF) ||
-                (wc >= 0xAC00 && wc <= 0xD7A3) ||
-                (wc >= 0xF900 && wc <= 0xFAFF) ||
-                (wc >= 0xFE10 && wc <= 0xFE19) ||
-                (wc >= 0xFE30 && wc <= 0xFE6F) ||
-                (wc >= 0xFF00 && wc <= 0xFF60) ||
-                (wc >= 0xFFE0 && wc <= 0xFFE6)) {
-                width += 2;
-            } else {
-                width += 1;
-            }
-        }
-        return width;
+        return TextWidth::displayWidth(str);
     }
 
     // 指定位置に部分的に文字列を上書き
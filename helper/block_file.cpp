@@ -0,0 +1,308 @@
+// block_file.cpp
+// ブロック単位で圧縮したファイルの実装
+
+#include "block_file.h"
+#include "byte_order.h"
+#include "job_queue.h"
+#include "lz_block.h"
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+
+namespace BlockFile {
+
+    using ByteOrder::putU32;
+    using ByteOrder::putU64;
+    using ByteOrder::getU32;
+    using ByteOrder::getU64;
+
+    static const char HEADER_MAGIC[8] = {'T', 'P', 'L', 'Z', 'B', 'L', 'K', '1'};
+    static const char TRAILER_MAGIC[8] = {'T', 'P', 'L', 'Z', 'B', 'L', 'K', 'F'};
+    static const uint32_t FORMAT_VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t INDEX_ENTRY_SIZE = 16;
+    static const size_t TRAILER_SIZE = 32;
+    static const size_t MAX_PENDING_BLOCKS = 4;     // 1ファイルの圧縮待ちのブロックがこれを超えたら待つ
+
+    bool isCompressedPath(const std::string& filepath) {
+        const std::string suffix = FILE_SUFFIX;
+        return filepath.size() > suffix.size() &&
+               filepath.compare(filepath.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+    // ---- 書き込み ----
+
+    // 全Writerで共有する圧縮・書き出しのキュー（ジョブは追加順に1つずつ実行する）
+    static Parallel::JobQueue& compressionQueue() {
+        static Parallel::JobQueue queue;
+        return queue;
+    }
+
+    struct Writer::Output {
+        std::FILE* file = nullptr;
+        uint64_t position = 0;
+        std::vector<BlockEntry> index;
+        bool failed = false;
+
+        // このファイルの未完了のジョブ数（キューは他のファイルと共有するので自分の分だけ数える）
+        std::mutex mutex;
+        std::condition_variable jobDone;
+        size_t pending = 0;
+
+        // 1ブロックを圧縮して書き出す（共有のキューのスレッドで実行）
+        void writeBlock(const std::vector<uint8_t>& raw) {
+            if (failed) return;
+            std::vector<uint8_t> compressed(LZBlock::compressBound(raw.size()));
+            size_t size = LZBlock::compress(raw.data(), raw.size(), compressed.data(), compressed.size());
+            const std::vector<uint8_t>* stored = &compressed;
+            if (size == 0 || size >= raw.size()) {
+                stored = &raw;      // 縮まなければそのまま格納する
+                size = raw.size();
+            }
+            if (std::fwrite(stored->data(), 1, size, file) != size) {
+                failed = true;
+                return;
+            }
+            BlockEntry entry;
+            entry.offset = position;
+            entry.storedSize = static_cast<uint32_t>(size);
+            entry.rawSize = static_cast<uint32_t>(raw.size());
+            index.push_back(entry);
+            position += size;
+        }
+
+        // 未完了のジョブがlimit未満になるまで待つ
+        void waitPending(size_t limit) {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobDone.wait(lock, [this, limit]() { return pending < limit; });
+        }
+    };
+
+    Writer::Writer()
+        : blockSize_(DEFAULT_BLOCK_SIZE)
+        , rawSize_(0)
+    {
+    }
+
+    Writer::~Writer() {
+        close();
+    }
+
+    bool Writer::open(const std::string& filepath, size_t blockSize) {
+        close();
+        if (blockSize == 0 || blockSize > UINT32_MAX) {
+            return false;
+        }
+
+        std::FILE* file = std::fopen(filepath.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+
+        std::vector<uint8_t> header(HEADER_MAGIC, HEADER_MAGIC + sizeof(HEADER_MAGIC));
+        putU32(header, FORMAT_VERSION);
+        putU32(header, static_cast<uint32_t>(blockSize));
+        if (std::fwrite(header.data(), 1, header.size(), file) != header.size()) {
+            std::fclose(file);
+            return false;
+        }
+
+        output_ = std::make_unique<Output>();
+        output_->file = file;
+        output_->position = header.size();
+        blockSize_ = blockSize;
+        rawSize_ = 0;
+        block_.clear();
+        block_.reserve(blockSize_);
+        return true;
+    }
+
+    void Writer::write(const void* data, size_t size) {
+        if (output_ == nullptr) {
+            return;
+        }
+        const uint8_t* p = static_cast<const uint8_t*>(data);
+        rawSize_ += size;
+        while (size > 0) {
+            size_t n = blockSize_ - block_.size();
+            if (n > size) n = size;
+            block_.insert(block_.end(), p, p + n);
+            p += n;
+            size -= n;
+            if (block_.size() == blockSize_) {
+                submitBlock();
+            }
+        }
+    }
+
+    void Writer::submitBlock() {
+        if (block_.empty()) {
+            return;
+        }
+        // 圧縮が追いつかない間はメモリを使いすぎないように待つ
+        Output* output = output_.get();
+        output->waitPending(MAX_PENDING_BLOCKS);
+        {
+            std::lock_guard<std::mutex> lock(output->mutex);
+            output->pending++;
+        }
+
+        // ジョブは追加順に1つずつ実行されるので、ブロックの順番は保たれる
+        auto raw = std::make_shared<std::vector<uint8_t>>(std::move(block_));
+        compressionQueue().submit([output, raw]() {
+            output->writeBlock(*raw);
+            std::lock_guard<std::mutex> lock(output->mutex);
+            output->pending--;
+            output->jobDone.notify_all();
+        });
+
+        block_ = std::vector<uint8_t>();
+        block_.reserve(blockSize_);
+    }
+
+    bool Writer::close() {
+        if (output_ == nullptr) {
+            return true;
+        }
+        submitBlock();
+        output_->waitPending(1);    // このファイルのジョブがすべて終わるまで待つ
+
+        // 索引と末尾
+        Output& output = *output_;
+        if (!output.failed) {
+            std::vector<uint8_t> tail;
+            for (const BlockEntry& entry : output.index) {
+                putU64(tail, entry.offset);
+                putU32(tail, entry.storedSize);
+                putU32(tail, entry.rawSize);
+            }
+            putU64(tail, output.position);
+            putU64(tail, output.index.size());
+            putU64(tail, rawSize_);
+            tail.insert(tail.end(), TRAILER_MAGIC, TRAILER_MAGIC + sizeof(TRAILER_MAGIC));
+            if (std::fwrite(tail.data(), 1, tail.size(), output.file) != tail.size()) {
+                output.failed = true;
+            }
+        }
+        if (std::fclose(output.file) != 0) {
+            output.failed = true;
+        }
+
+        bool ok = !output.failed;
+        output_.reset();
+        block_ = std::vector<uint8_t>();
+        return ok;
+    }
+
+    // ---- 読み込み ----
+
+    Reader::Reader()
+        : blockSize_(0)
+        , rawSize_(0)
+        , blocksDecoded_(0)
+    {
+    }
+
+    bool Reader::open(const std::string& filepath) {
+        index_.clear();
+        blockSize_ = 0;
+        rawSize_ = 0;
+        blocksDecoded_ = 0;
+        if (!file_.open(filepath) || file_.size() < HEADER_SIZE + TRAILER_SIZE) {
+            return false;
+        }
+        const uint8_t* base = reinterpret_cast<const uint8_t*>(file_.data());
+        const uint64_t fileSize = file_.size();
+
+        if (std::memcmp(base, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0 ||
+            getU32(base + 8) != FORMAT_VERSION) {
+            return false;
+        }
+        uint32_t blockSize = getU32(base + 12);
+        const uint8_t* trailer = base + fileSize - TRAILER_SIZE;
+        if (blockSize == 0 || std::memcmp(trailer + 24, TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0) {
+            return false;  // 書き込み途中で終わったファイル
+        }
+
+        uint64_t indexOffset = getU64(trailer);
+        uint64_t blockCount = getU64(trailer + 8);
+        uint64_t rawSize = getU64(trailer + 16);
+        uint64_t indexEnd = fileSize - TRAILER_SIZE;
+        if (indexOffset < HEADER_SIZE || indexOffset > indexEnd ||
+            blockCount != (indexEnd - indexOffset) / INDEX_ENTRY_SIZE ||
+            (indexEnd - indexOffset) % INDEX_ENTRY_SIZE != 0) {
+            return false;
+        }
+
+        // 最後以外のブロックはちょうどブロックサイズ、格納範囲は索引より前に収まる
+        std::vector<BlockEntry> index(static_cast<size_t>(blockCount));
+        uint64_t total = 0;
+        for (size_t i = 0; i < index.size(); ++i) {
+            const uint8_t* p = base + indexOffset + i * INDEX_ENTRY_SIZE;
+            BlockEntry& entry = index[i];
+            entry.offset = getU64(p);
+            entry.storedSize = getU32(p + 8);
+            entry.rawSize = getU32(p + 12);
+            bool last = i + 1 == index.size();
+            if (entry.rawSize == 0 || entry.rawSize > blockSize || (!last && entry.rawSize != blockSize)) {
+                return false;
+            }
+            if (entry.offset < HEADER_SIZE || entry.offset > indexOffset ||
+                entry.storedSize > indexOffset - entry.offset) {
+                return false;
+            }
+            total += entry.rawSize;
+        }
+        if (total != rawSize) {
+            return false;
+        }
+
+        index_ = std::move(index);
+        blockSize_ = blockSize;
+        rawSize_ = rawSize;
+        return true;
+    }
+
+    bool Reader::decodeBlock(size_t block, uint8_t* dst) {
+        const BlockEntry& entry = index_[block];
+        const uint8_t* stored = reinterpret_cast<const uint8_t*>(file_.data()) + entry.offset;
+        blocksDecoded_++;
+        if (entry.storedSize == entry.rawSize) {
+            std::memcpy(dst, stored, entry.rawSize);
+            return true;
+        }
+        return LZBlock::decompress(stored, entry.storedSize, dst, entry.rawSize);
+    }
+
+    bool Reader::read(uint64_t offset, size_t size, std::vector<char>& out) {
+        if (offset > rawSize_ || size > rawSize_ - offset) {
+            return false;
+        }
+        out.resize(size);
+        if (size == 0) {
+            return true;
+        }
+
+        // 範囲がブロック全体を含むなら直接書き込み、端のブロックは一時領域に復号して必要な部分だけ写す
+        std::vector<uint8_t> scratch;
+        uint8_t* dst = reinterpret_cast<uint8_t*>(out.data());
+        uint64_t end = offset + size;
+        for (size_t block = static_cast<size_t>(offset / blockSize_);
+             block < index_.size() && static_cast<uint64_t>(block) * blockSize_ < end; ++block) {
+            uint64_t blockBegin = static_cast<uint64_t>(block) * blockSize_;
+            uint64_t blockEnd = blockBegin + index_[block].rawSize;
+            uint64_t from = offset > blockBegin ? offset : blockBegin;
+            uint64_t to = end < blockEnd ? end : blockEnd;
+            uint8_t* target = dst + (from - offset);
+            if (from == blockBegin && to == blockEnd) {
+                if (!decodeBlock(block, target)) return false;
+            } else {
+                scratch.resize(index_[block].rawSize);
+                if (!decodeBlock(block, scratch.data())) return false;
+                std::memcpy(target, scratch.data() + (from - blockBegin), static_cast<size_t>(to - from));
+            }
+        }
+        return true;
+    }
+
+} // namespace BlockFile
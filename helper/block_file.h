@@ -0,0 +1,115 @@
+#pragma once
+
+// block_file.h
+// ブロック単位で圧縮したファイル（書き込み・読み込み）
+//
+// 用語解説:
+// - ブロック(Block): 圧縮前のデータを固定サイズ（デフォルト256KiB）で区切ったもの。1つずつ独立に圧縮する
+// - 索引(Index): ファイル末尾に置く、各ブロックの位置と大きさの一覧
+//
+// 書き込み側はブロックが埋まるたびにバックグラウンドのスレッドへ渡して圧縮・書き出しを行うので、
+// 呼び出し元はCSVの組み立てを続けられる。スレッドは全Writerで1つを共有する（ファイルごとに作らない）。読み込み側は索引から必要なブロックだけを復号する。
+// 圧縮にはLZBlock（LZ4ブロック形式）を使い、縮まなかったブロックはそのまま格納する。
+//
+// ファイル構成（数値はすべてリトルエンディアン）:
+//   ヘッダー  : "TPLZBLK1"(8) / バージョン(u32) / ブロックサイズ(u32)
+//   ブロック  : 圧縮したブロックを順に並べる
+//   索引      : ブロックごとに 開始位置(u64) / 格納バイト数(u32) / 圧縮前のバイト数(u32)
+//               格納バイト数 == 圧縮前のバイト数 なら無圧縮
+//   末尾      : 索引の開始位置(u64) / ブロック数(u64) / 圧縮前の合計バイト数(u64) / "TPLZBLKF"(8)
+// 末尾が書かれていないファイル（書き込み途中で終了したもの）は読み込めない。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+
+namespace BlockFile {
+
+    // 圧縮したファイルに付ける拡張子（例: typing_events_<セッションID>.csv.lzb）
+    constexpr const char* FILE_SUFFIX = ".lzb";
+
+    // デフォルトのブロックサイズ（256KiB）
+    constexpr size_t DEFAULT_BLOCK_SIZE = 256 << 10;
+
+    // 1ブロックの位置
+    struct BlockEntry {
+        uint64_t offset = 0;        // ファイル上の開始位置
+        uint32_t storedSize = 0;    // ファイル上のバイト数
+        uint32_t rawSize = 0;       // 圧縮前のバイト数
+    };
+
+    // 書き込み（圧縮・書き出しは共有のバックグラウンドのスレッドで行う）
+    class Writer {
+    private:
+        // バックグラウンドのスレッドと共有する状態（block_file.cppで定義）
+        struct Output;
+
+        std::unique_ptr<Output> output_;
+        std::vector<uint8_t> block_;    // 書き込み中のブロック
+        size_t blockSize_;
+        uint64_t rawSize_;
+
+        // 書き込み中のブロックをバックグラウンドのスレッドに渡す
+        void submitBlock();
+
+    public:
+        Writer();
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // ファイルを開く（既存の内容は消える）
+        // 戻り値: 成功時true
+        bool open(const std::string& filepath, size_t blockSize = DEFAULT_BLOCK_SIZE);
+        bool isOpen() const { return output_ != nullptr; }
+
+        // データを追加する（ブロックが埋まると圧縮を依頼してすぐに戻る）
+        void write(const void* data, size_t size);
+
+        // 残りのブロックと索引を書き出して閉じる（圧縮が終わるまで待つ）
+        // 戻り値: すべての書き込みが成功していればtrue
+        bool close();
+    };
+
+    // 読み込み（ファイルはメモリマップしたまま保持する）
+    class Reader {
+    private:
+        FileMapping::MappedFile file_;
+        std::vector<BlockEntry> index_;
+        size_t blockSize_;
+        uint64_t rawSize_;
+        size_t blocksDecoded_;
+
+        // 1ブロックを復号してdstに書き込む（dstはrawSizeバイト以上）
+        bool decodeBlock(size_t block, uint8_t* dst);
+
+    public:
+        Reader();
+
+        // ファイルを開き、ヘッダー・索引を検証する
+        // 戻り値: 成功時true（形式が異なる・索引がファイルをはみ出す場合はfalse）
+        bool open(const std::string& filepath);
+
+        uint64_t rawSize() const { return rawSize_; }
+        size_t blockCount() const { return index_.size(); }
+
+        // 圧縮前のデータの[offset, offset + size)を取り出す（範囲を含むブロックだけを復号する）
+        // 戻り値: 成功時true（範囲が圧縮前のデータをはみ出す・データが壊れている場合はfalse）
+        bool read(uint64_t offset, size_t size, std::vector<char>& out);
+
+        // 圧縮前のデータ全体を取り出す
+        bool readAll(std::vector<char>& out) { return read(0, static_cast<size_t>(rawSize_), out); }
+
+        // これまでに復号したブロック数
+        size_t blocksDecoded() const { return blocksDecoded_; }
+    };
+
+    // パスが圧縮したファイル（FILE_SUFFIXで終わる）か
+    bool isCompressedPath(const std::string& filepath);
+
+} // namespace BlockFile
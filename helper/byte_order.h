@@ -0,0 +1,36 @@
+#pragma once
+
+// byte_order.h
+// リトルエンディアンの整数の書き込み・読み込み（バイナリ形式のファイル用）
+//
+// EventColumns・BlockFileのヘッダー・索引の数値はこの関数で読み書きする。
+// 実行するCPUのバイト順によらず同じファイルになる。
+
+#include <cstdint>
+#include <vector>
+
+namespace ByteOrder {
+
+    // outの末尾に書き足す
+    inline void putU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    inline void putU64(std::vector<uint8_t>& out, uint64_t value) {
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+
+    // pから読む（範囲の確認は呼び出し側で行う）
+    inline uint32_t getU32(const uint8_t* p) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) value |= static_cast<uint32_t>(p[i]) << (8 * i);
+        return value;
+    }
+
+    inline uint64_t getU64(const uint8_t* p) {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+        return value;
+    }
+
+} // namespace ByteOrder
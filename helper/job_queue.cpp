@@ -0,0 +1,64 @@
+// job_queue.cpp
+// バックグラウンドのジョブキューの実装
+
+#include "job_queue.h"
+
+namespace Parallel {
+
+    JobQueue::JobQueue()
+        : running_(0)
+        , stopping_(false)
+    {
+        worker_ = std::thread(&JobQueue::run, this);
+    }
+
+    JobQueue::~JobQueue() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        jobAdded_.notify_one();
+        worker_.join();
+    }
+
+    void JobQueue::submit(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        jobAdded_.notify_one();
+    }
+
+    void JobQueue::waitIdle() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return jobs_.empty() && running_ == 0; });
+    }
+
+    size_t JobQueue::pendingCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return jobs_.size() + running_;
+    }
+
+    void JobQueue::run() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            jobAdded_.wait(lock, [this] { return !jobs_.empty() || stopping_; });
+            // 終了指示があっても残っているジョブは実行する
+            if (jobs_.empty()) break;
+
+            std::function<void()> job = std::move(jobs_.front());
+            jobs_.pop_front();
+            running_ = 1;
+
+            lock.unlock();
+            job();
+            lock.lock();
+
+            running_ = 0;
+            if (jobs_.empty()) {
+                idle_.notify_all();
+            }
+        }
+    }
+
+} // namespace Parallel
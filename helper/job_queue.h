@@ -0,0 +1,52 @@
+#pragma once
+
+// job_queue.h
+// バックグラウンドのジョブキュー
+//
+// 用語解説:
+// - ジョブ(Job): 後で実行する処理（関数オブジェクト）
+// - キュー(Queue): 追加した順に取り出す待ち行列
+//
+// 専用のスレッドが1つあり、追加されたジョブを順番に実行する。
+// 呼び出し元はジョブを追加するとすぐに戻るので、ファイル出力などの遅い処理で画面が止まらない。
+// 破棄時は残っているジョブをすべて実行してから終了する（出力が途中で失われない）。
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace Parallel {
+
+    class JobQueue {
+    private:
+        std::deque<std::function<void()>> jobs_;
+        mutable std::mutex mutex_;
+        std::condition_variable jobAdded_;
+        std::condition_variable idle_;
+        size_t running_;        // 実行中のジョブ数（0か1）
+        bool stopping_;
+        std::thread worker_;
+
+        void run();
+
+    public:
+        JobQueue();
+        ~JobQueue();
+
+        JobQueue(const JobQueue&) = delete;
+        JobQueue& operator=(const JobQueue&) = delete;
+
+        // ジョブを追加（すぐに戻る）
+        void submit(std::function<void()> job);
+
+        // 追加済みのジョブがすべて終わるまで待つ
+        void waitIdle();
+
+        // 未完了のジョブ数（実行中を含む）
+        size_t pendingCount() const;
+    };
+
+} // namespace Parallel
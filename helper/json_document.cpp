@@ -0,0 +1,223 @@
+// json_document.cpp
+// 読み取り専用のJSON文書の実装
+
+#include "json_document.h"
+#include <cstring>
+#include <memory>
+
+namespace JsonDocument {
+
+    static const size_t MIN_CHUNK_SIZE = 64 << 10;
+    static const size_t MAX_CHUNK_SIZE = 1 << 20;   // 最後のチャンクの使い残しをこれ以下に抑える
+
+    static const Node NULL_NODE;
+
+    // ---- Node ----
+
+    const Node& Node::operator[](size_t index) const {
+        return isArray() && index < size ? items[index] : NULL_NODE;
+    }
+
+    const Node& Node::operator[](std::string_view key) const {
+        const Node* node = find(key);
+        return node != nullptr ? *node : NULL_NODE;
+    }
+
+    const Node* Node::find(std::string_view key) const {
+        if (!isObject()) return nullptr;
+        for (size_t i = 0; i < size; ++i) {
+            if (members[i].key == key) return &members[i].value;
+        }
+        return nullptr;
+    }
+
+    Range<Node> Node::arrayItems() const {
+        return isArray() ? Range<Node>{items, items + size} : Range<Node>{nullptr, nullptr};
+    }
+
+    Range<Member> Node::objectMembers() const {
+        return isObject() ? Range<Member>{members, members + size} : Range<Member>{nullptr, nullptr};
+    }
+
+    // ---- Arena ----
+
+    Arena::Arena()
+        : current_(nullptr)
+        , remaining_(0)
+        , totalBytes_(0)
+    {
+    }
+
+    void* Arena::allocate(size_t size, size_t align) {
+        size_t padding = (align - reinterpret_cast<uintptr_t>(current_) % align) % align;
+        if (current_ == nullptr || padding + size > remaining_) {
+            // 新しいチャンク（これまでの合計と同じ大きさまで伸ばし、大きな確保はそれ専用にする）
+            size_t chunkSize = totalBytes_;
+            if (chunkSize < MIN_CHUNK_SIZE) chunkSize = MIN_CHUNK_SIZE;
+            if (chunkSize > MAX_CHUNK_SIZE) chunkSize = MAX_CHUNK_SIZE;
+            if (chunkSize < size + align) chunkSize = size + align;
+            chunks_.push_back(std::make_unique<char[]>(chunkSize));
+            current_ = chunks_.back().get();
+            remaining_ = chunkSize;
+            totalBytes_ += chunkSize;
+            padding = (align - reinterpret_cast<uintptr_t>(current_) % align) % align;
+        }
+        char* result = current_ + padding;
+        current_ = result + size;
+        remaining_ -= padding + size;
+        return result;
+    }
+
+    void Arena::clear() {
+        chunks_.clear();
+        current_ = nullptr;
+        remaining_ = 0;
+        totalBytes_ = 0;
+    }
+
+    // ---- 解析 ----
+
+    namespace {
+
+        using JsonReader::Token;
+
+        // JsonReaderのトークンから木を組み立てる
+        class Builder {
+        private:
+            JsonReader::Reader& reader_;
+            Arena& arena_;
+
+            // 解析中の配列・オブジェクトの要素（入れ子の内側ほど後ろ。閉じたらアリーナに移す）
+            std::vector<Node> itemStack_;
+            std::vector<Member> memberStack_;
+
+            // 連続した要素をアリーナに移す
+            template <typename T>
+            const T* moveToArena(std::vector<T>& stack, size_t base) {
+                size_t count = stack.size() - base;
+                if (count == 0) return nullptr;
+                T* target = static_cast<T*>(arena_.allocate(count * sizeof(T), alignof(T)));
+                std::uninitialized_copy(stack.begin() + base, stack.end(), target);
+                stack.resize(base);
+                return target;
+            }
+
+            // 読み取りの文字列（復号したものは次のトークンで消えるのでアリーナに写す）
+            std::string_view keepString() {
+                std::string_view text = reader_.string();
+                if (!reader_.copied() || text.empty()) return text;
+                char* copy = static_cast<char*>(arena_.allocate(text.size(), 1));
+                std::memcpy(copy, text.data(), text.size());
+                return std::string_view(copy, text.size());
+            }
+
+        public:
+            Builder(JsonReader::Reader& reader, Arena& arena)
+                : reader_(reader)
+                , arena_(arena)
+            {
+            }
+
+            // tokenから始まる値を組み立てる（入れ子の深さはreaderが制限する）
+            // 戻り値: 成功時true（大きすぎる値はerrorに理由）
+            bool build(Token token, Node& node, std::string& error) {
+                switch (token) {
+                    case Token::STRING: {
+                        std::string_view text = keepString();
+                        if (text.size() > UINT32_MAX) {
+                            error = "string too long";
+                            return false;
+                        }
+                        node.type = Type::STRING;
+                        node.chars = text.data();
+                        node.size = static_cast<uint32_t>(text.size());
+                        return true;
+                    }
+                    case Token::NUMBER:
+                        node.type = Type::NUMBER;
+                        node.number = reader_.number();
+                        return true;
+                    case Token::BOOLEAN:
+                        node.type = Type::BOOLEAN;
+                        node.boolean = reader_.boolean();
+                        return true;
+                    case Token::NULL_VALUE:
+                        node.type = Type::NULL_VALUE;
+                        return true;
+                    case Token::START_ARRAY: {
+                        size_t base = itemStack_.size();
+                        for (Token item = reader_.next(); item != Token::END_ARRAY; item = reader_.next()) {
+                            Node child;
+                            if (!build(item, child, error)) return false;
+                            itemStack_.push_back(child);
+                        }
+                        if (itemStack_.size() - base > UINT32_MAX) {
+                            error = "too many elements";
+                            return false;
+                        }
+                        node.type = Type::ARRAY;
+                        node.size = static_cast<uint32_t>(itemStack_.size() - base);
+                        node.items = moveToArena(itemStack_, base);
+                        return true;
+                    }
+                    case Token::START_OBJECT: {
+                        size_t base = memberStack_.size();
+                        for (Token key = reader_.next(); key != Token::END_OBJECT; key = reader_.next()) {
+                            if (key != Token::KEY) return false;
+                            Member member;
+                            member.key = keepString();
+                            if (!build(reader_.next(), member.value, error)) return false;
+                            memberStack_.push_back(member);
+                        }
+                        if (memberStack_.size() - base > UINT32_MAX) {
+                            error = "too many members";
+                            return false;
+                        }
+                        node.type = Type::OBJECT;
+                        node.size = static_cast<uint32_t>(memberStack_.size() - base);
+                        node.members = moveToArena(memberStack_, base);
+                        return true;
+                    }
+                    default:
+                        // ERROR（readerが理由を持つ）
+                        return false;
+                }
+            }
+        };
+
+    } // namespace
+
+    // ---- Document ----
+
+    bool Document::parse(std::string_view json) {
+        arena_.clear();
+        root_ = Node();
+        error_.clear();
+
+        JsonReader::Reader reader(json);
+        Builder builder(reader, arena_);
+        Node root;
+        if (!builder.build(reader.next(), root, error_) || reader.next() != JsonReader::Token::END) {
+            if (error_.empty()) error_ = reader.error();
+            arena_.clear();
+            return false;
+        }
+        root_ = root;
+        return true;
+    }
+
+    bool Document::loadFile(const std::string& filePath) {
+        root_ = Node();
+        arena_.clear();
+        if (!file_.open(filePath)) {
+            error_ = "cannot open " + filePath;
+            return false;
+        }
+        std::string_view json(file_.data(), file_.size());
+        if (json.substr(0, 3) == "\xEF\xBB\xBF") {
+            json.remove_prefix(3);
+        }
+        return parse(json);
+    }
+
+} // namespace JsonDocument
@@ -0,0 +1,150 @@
+#pragma once
+
+// json_document.h
+// 読み取り専用のJSON文書（アリーナ確保・文字列のコピーなし）
+//
+// 用語解説:
+// - アリーナ(Arena): 大きなメモリ領域をまとめて確保し、そこから順に切り出していく確保方法。
+//   個別の解放はせず、文書を破棄するときにまとめて解放する
+// - string_view: 文字列をコピーせず、元のバッファの位置と長さだけを持つ参照
+// - エスケープ(Escape): 文字列中の \" \n あ などの表記
+//
+// JsonHelper::parseJsonは書き換えられる木を作るため、文字列ごと・配列やオブジェクトごとに確保する。
+// シナリオの読み込みのように値を読むだけの用途では、
+// 次のようにすればコピーと確保の大半が不要になる。
+// - 文字列は元のJSONを指すstring_viewにする（エスケープを含む文字列だけを復号してアリーナに置く）
+// - 値はアリーナに確保し、配列・オブジェクトの要素は連続した配列にする
+// - オブジェクトはキーと値の組の配列にする（出現順。同じキーが複数あれば最初のものを返す）
+// loadFileで読み込んだ場合はファイルをメモリマップし、文字列はマップ上を直接指す。
+// 字句の解析と書式の検査はJsonReader::Readerが行い、ここではそのトークンから木を組み立てる。
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "json_reader.h"
+#include "mapped_file.h"
+
+namespace JsonDocument {
+
+    enum class Type : uint8_t {
+        NULL_VALUE,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    struct Member;
+
+    // 連続した要素の範囲（範囲for文用）
+    template <typename T>
+    struct Range {
+        const T* first;
+        const T* last;
+        const T* begin() const { return first; }
+        const T* end() const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+    };
+
+    // JSONの値（文書のアリーナ上にあり、文書が破棄されるまで有効）
+    // 要素を連続して並べるので16バイトに収める（文字列の長さ・要素数はsizeに持つ）
+    struct Node {
+        Type type = Type::NULL_VALUE;
+        uint32_t size = 0;                  // STRING: バイト数、ARRAY/OBJECT: 要素数
+        union {
+            double number = 0.0;            // NUMBER
+            bool boolean;                   // BOOLEAN
+            const char* chars;              // STRING
+            const Node* items;              // ARRAY
+            const Member* members;          // OBJECT（出現順）
+        };
+
+        bool isNull() const { return type == Type::NULL_VALUE; }
+        bool isBool() const { return type == Type::BOOLEAN; }
+        bool isNumber() const { return type == Type::NUMBER; }
+        bool isString() const { return type == Type::STRING; }
+        bool isArray() const { return type == Type::ARRAY; }
+        bool isObject() const { return type == Type::OBJECT; }
+
+        // 値の取得（型が異なる場合は空・0・false）
+        std::string_view asString() const { return isString() ? std::string_view(chars, size) : std::string_view(); }
+        double asNumber() const { return isNumber() ? number : 0.0; }
+        bool asBool() const { return isBool() && boolean; }
+
+        // 配列の要素（範囲外・配列でない場合はnull）
+        const Node& operator[](size_t index) const;
+
+        // オブジェクトのメンバー（ない場合はnull）
+        const Node& operator[](std::string_view key) const;
+        const Node* find(std::string_view key) const;
+
+        Range<Node> arrayItems() const;
+        Range<Member> objectMembers() const;
+    };
+
+    // オブジェクトのキーと値の組
+    struct Member {
+        std::string_view key;
+        Node value;
+    };
+
+    // 値を切り出すアリーナ（確保した領域は破棄時にまとめて解放する）
+    class Arena {
+    private:
+        std::vector<std::unique_ptr<char[]>> chunks_;
+        char* current_;
+        size_t remaining_;
+        size_t totalBytes_;
+
+    public:
+        Arena();
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // alignの倍数の位置からsizeバイトを確保
+        void* allocate(size_t size, size_t align);
+
+        // 確保したチャンクの合計バイト数
+        size_t totalBytes() const { return totalBytes_; }
+
+        void clear();
+    };
+
+    // JSON文書
+    class Document {
+    private:
+        FileMapping::MappedFile file_;
+        Arena arena_;
+        Node root_;
+        std::string error_;
+
+    public:
+        Document() = default;
+
+        Document(const Document&) = delete;
+        Document& operator=(const Document&) = delete;
+
+        // JSON文字列を解析する（文字列の値はjsonを指すので、jsonは文書より長く保持すること）
+        // 戻り値: 成功時true（失敗時はerror()に位置と理由）
+        bool parse(std::string_view json);
+
+        // ファイルをメモリマップして解析する（先頭のUTF-8 BOMは読み飛ばす）
+        // 戻り値: 成功時true
+        bool loadFile(const std::string& filePath);
+
+        // ルートの値（解析前・失敗時はnull）
+        const Node& root() const { return root_; }
+
+        // 失敗の理由（例: "line 3, column 5: expected ':'"）
+        const std::string& error() const { return error_; }
+
+        // アリーナが確保したバイト数
+        size_t arenaBytes() const { return arena_.totalBytes(); }
+    };
+
+} // namespace JsonDocument
@@ -1,298 +1,258 @@
 #include "json_helper.h"
+#include "json_reader.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
-#include <cctype>
+#include <functional>
 
 namespace JsonHelper {
-    
-    // JsonValueのメソッド実装
-    JsonValue& JsonValue::operator[](const std::string& key) {
-        if (type != JsonType::OBJECT) {
-            type = JsonType::OBJECT;
-            objectValue.clear();
+
+    // ---- JsonObject ----
+
+    JsonObject::JsonObject() = default;
+    JsonObject::JsonObject(const JsonObject& other) = default;
+    JsonObject::JsonObject(JsonObject&& other) noexcept = default;
+    JsonObject& JsonObject::operator=(const JsonObject& other) = default;
+    JsonObject& JsonObject::operator=(JsonObject&& other) noexcept = default;
+    JsonObject::~JsonObject() = default;
+
+    static size_t hashKey(std::string_view key) {
+        return std::hash<std::string_view>()(key);
+    }
+
+    size_t JsonObject::findIndex(std::string_view key) const {
+        if (index_.empty()) {
+            for (size_t i = 0; i < members_.size(); ++i) {
+                if (members_[i].key == key) return i;
+            }
+            return members_.size();
         }
-        return objectValue[key];
+        size_t mask = index_.size() - 1;
+        for (size_t slot = hashKey(key) & mask; index_[slot] != 0; slot = (slot + 1) & mask) {
+            size_t member = index_[slot] - 1;
+            if (members_[member].key == key) return member;
+        }
+        return members_.size();
     }
 
-    const JsonValue& JsonValue::operator[](const std::string& key) const {
-        static JsonValue nullValue;
-        if (type != JsonType::OBJECT) return nullValue;
-        auto it = objectValue.find(key);
-        return (it != objectValue.end()) ? it->second : nullValue;
+    void JsonObject::addToIndex(size_t member) {
+        size_t mask = index_.size() - 1;
+        size_t slot = hashKey(members_[member].key) & mask;
+        while (index_[slot] != 0) slot = (slot + 1) & mask;
+        index_[slot] = static_cast<uint32_t>(member + 1);
     }
 
-    void JsonValue::pushBack(const JsonValue& value) {
-        if (type != JsonType::ARRAY) {
-            type = JsonType::ARRAY;
-            arrayValue.clear();
-        }
-        arrayValue.push_back(value);
+    void JsonObject::rebuildIndex() {
+        // 使用率を1/2以下に保つ
+        size_t capacity = 16;
+        while (capacity < members_.size() * 2) capacity *= 2;
+        index_.assign(capacity, 0);
+        for (size_t i = 0; i < members_.size(); ++i) addToIndex(i);
     }
 
-    size_t JsonValue::size() const {
-        if (type == JsonType::ARRAY) return arrayValue.size();
-        if (type == JsonType::OBJECT) return objectValue.size();
-        return 0;
+    void JsonObject::reserve(size_t count) {
+        members_.reserve(count);
     }
 
-    // パーサーのヘルパー関数
-    void skipWhitespace(const std::string& str, size_t& pos) {
-        while (pos < str.length() && std::isspace(str[pos])) {
-            pos++;
-        }
+    const JsonValue* JsonObject::find(std::string_view key) const {
+        size_t member = findIndex(key);
+        return member < members_.size() ? &members_[member].value : nullptr;
+    }
+
+    JsonValue* JsonObject::find(std::string_view key) {
+        size_t member = findIndex(key);
+        return member < members_.size() ? &members_[member].value : nullptr;
+    }
+
+    JsonValue& JsonObject::operator[](std::string_view key) {
+        size_t member = findIndex(key);
+        if (member < members_.size()) return members_[member].value;
+        return set(std::string(key), JsonValue());
     }
 
-    std::string parseString(const std::string& str, size_t& pos) {
-        if (pos >= str.length() || str[pos] != '"') {
-            throw std::runtime_error("Expected '\"' at position " + std::to_string(pos));
+    JsonValue& JsonObject::set(std::string key, JsonValue value) {
+        size_t member = findIndex(key);
+        if (member < members_.size()) {
+            members_[member].value = std::move(value);
+            return members_[member].value;
         }
-        pos++; // skip opening quote
-        
-        std::string result;
-        while (pos < str.length() && str[pos] != '"') {
-            if (str[pos] == '\\' && pos + 1 < str.length()) {
-                pos++;
-                switch (str[pos]) {
-                    case '"': result += '"'; break;
-                    case '\\': result += '\\'; break;
-                    case '/': result += '/'; break;
-                    case 'b': result += '\b'; break;
-                    case 'f': result += '\f'; break;
-                    case 'n': result += '\n'; break;
-                    case 'r': result += '\r'; break;
-                    case 't': result += '\t'; break;
-                    default: result += str[pos]; break;
-                }
+        members_.push_back(JsonMember{std::move(key), std::move(value)});
+        if (members_.size() > LINEAR_MEMBERS) {
+            if (members_.size() * 2 > index_.size()) {
+                rebuildIndex();
             } else {
-                result += str[pos];
+                addToIndex(members_.size() - 1);
             }
-            pos++;
         }
-        
-        if (pos >= str.length() || str[pos] != '"') {
-            throw std::runtime_error("Unterminated string");
-        }
-        pos++; // skip closing quote
-        return result;
+        return members_.back().value;
     }
 
-    double parseNumber(const std::string& str, size_t& pos) {
-        size_t start = pos;
-        if (pos < str.length() && str[pos] == '-') pos++;
-        
-        while (pos < str.length() && std::isdigit(str[pos])) pos++;
-        
-        if (pos < str.length() && str[pos] == '.') {
-            pos++;
-            while (pos < str.length() && std::isdigit(str[pos])) pos++;
-        }
-        
-        if (pos < str.length() && (str[pos] == 'e' || str[pos] == 'E')) {
-            pos++;
-            if (pos < str.length() && (str[pos] == '+' || str[pos] == '-')) pos++;
-            while (pos < str.length() && std::isdigit(str[pos])) pos++;
-        }
-        
-        return std::stod(str.substr(start, pos - start));
+    // ---- JsonValue ----
+
+    static const JsonValue& nullValue() {
+        static const JsonValue value;
+        return value;
     }
 
-    JsonValue parseValue(const std::string& str, size_t& pos);
+    const std::string& JsonValue::asString() const {
+        static const std::string empty;
+        const std::string* str = std::get_if<std::string>(&value_);
+        return str ? *str : empty;
+    }
 
-    JsonValue parseObject(const std::string& str, size_t& pos) {
-        JsonValue obj;
-        obj.type = JsonType::OBJECT;
-        
-        if (pos >= str.length() || str[pos] != '{') {
-            throw std::runtime_error("Expected '{' at position " + std::to_string(pos));
-        }
-        pos++; // skip '{'
-        
-        skipWhitespace(str, pos);
-        
-        if (pos < str.length() && str[pos] == '}') {
-            pos++;
-            return obj;
-        }
-        
-        while (pos < str.length()) {
-            skipWhitespace(str, pos);
-            
-            // パースキー
-            std::string key = parseString(str, pos);
-            
-            skipWhitespace(str, pos);
-            
-            if (pos >= str.length() || str[pos] != ':') {
-                throw std::runtime_error("Expected ':' after key");
-            }
-            pos++; // skip ':'
-            
-            skipWhitespace(str, pos);
-            
-            // パース値
-            JsonValue value = parseValue(str, pos);
-            obj.objectValue[key] = value;
-            
-            skipWhitespace(str, pos);
-            
-            if (pos >= str.length()) break;
-            
-            if (str[pos] == '}') {
-                pos++;
-                break;
-            } else if (str[pos] == ',') {
-                pos++;
-                continue;
-            } else {
-                throw std::runtime_error("Expected ',' or '}' in object");
-            }
-        }
-        
-        return obj;
+    double JsonValue::asNumber() const {
+        const double* num = std::get_if<double>(&value_);
+        return num ? *num : 0.0;
     }
 
-    JsonValue parseArray(const std::string& str, size_t& pos) {
-        JsonValue arr;
-        arr.type = JsonType::ARRAY;
-        
-        if (pos >= str.length() || str[pos] != '[') {
-            throw std::runtime_error("Expected '[' at position " + std::to_string(pos));
-        }
-        pos++; // skip '['
-        
-        skipWhitespace(str, pos);
-        
-        if (pos < str.length() && str[pos] == ']') {
-            pos++;
-            return arr;
-        }
-        
-        while (pos < str.length()) {
-            skipWhitespace(str, pos);
-            
-            JsonValue value = parseValue(str, pos);
-            arr.arrayValue.push_back(value);
-            
-            skipWhitespace(str, pos);
-            
-            if (pos >= str.length()) break;
-            
-            if (str[pos] == ']') {
-                pos++;
-                break;
-            } else if (str[pos] == ',') {
-                pos++;
-                continue;
-            } else {
-                throw std::runtime_error("Expected ',' or ']' in array");
-            }
-        }
-        
-        return arr;
+    bool JsonValue::asBool() const {
+        const bool* b = std::get_if<bool>(&value_);
+        return b ? *b : false;
     }
 
-    JsonValue parseValue(const std::string& str, size_t& pos) {
-        skipWhitespace(str, pos);
-        
-        if (pos >= str.length()) {
-            throw std::runtime_error("Unexpected end of input");
-        }
-        
-        char c = str[pos];
-        
-        if (c == '"') {
-            return JsonValue(parseString(str, pos));
-        } else if (c == '{') {
-            return parseObject(str, pos);
-        } else if (c == '[') {
-            return parseArray(str, pos);
-        } else if (c == 't' && str.substr(pos, 4) == "true") {
-            pos += 4;
-            return JsonValue(true);
-        } else if (c == 'f' && str.substr(pos, 5) == "false") {
-            pos += 5;
-            return JsonValue(false);
-        } else if (c == 'n' && str.substr(pos, 4) == "null") {
-            pos += 4;
-            JsonValue nullVal;
-            nullVal.type = JsonType::JSON_NULL;
-            return nullVal;
-        } else if (c == '-' || std::isdigit(c)) {
-            return JsonValue(parseNumber(str, pos));
-        } else {
-            throw std::runtime_error("Unexpected character '" + std::string(1, c) + "' at position " + std::to_string(pos));
+    const JsonArray& JsonValue::asArray() const {
+        static const JsonArray empty;
+        const JsonArray* array = std::get_if<JsonArray>(&value_);
+        return array ? *array : empty;
+    }
+
+    const JsonObject& JsonValue::asObject() const {
+        static const JsonObject empty;
+        const JsonObject* object = std::get_if<JsonObject>(&value_);
+        return object ? *object : empty;
+    }
+
+    JsonValue& JsonValue::operator[](std::string_view key) {
+        if (!isObject()) value_ = JsonObject();
+        return std::get<JsonObject>(value_)[key];
+    }
+
+    const JsonValue& JsonValue::operator[](std::string_view key) const {
+        const JsonObject* object = std::get_if<JsonObject>(&value_);
+        if (!object) return nullValue();
+        const JsonValue* value = object->find(key);
+        return value ? *value : nullValue();
+    }
+
+    void JsonValue::pushBack(JsonValue value) {
+        if (!isArray()) value_ = JsonArray();
+        std::get<JsonArray>(value_).push_back(std::move(value));
+    }
+
+    JsonValue& JsonValue::operator[](size_t index) {
+        if (!isArray()) value_ = JsonArray();
+        JsonArray& array = std::get<JsonArray>(value_);
+        if (index >= array.size()) array.resize(index + 1);
+        return array[index];
+    }
+
+    const JsonValue& JsonValue::operator[](size_t index) const {
+        const JsonArray* array = std::get_if<JsonArray>(&value_);
+        if (!array || index >= array->size()) return nullValue();
+        return (*array)[index];
+    }
+
+    size_t JsonValue::size() const {
+        if (const JsonArray* array = std::get_if<JsonArray>(&value_)) return array->size();
+        if (const JsonObject* object = std::get_if<JsonObject>(&value_)) return object->size();
+        return 0;
+    }
+
+    // ---- パーサー（JsonReaderのトークンから木を組み立てる） ----
+
+    // tokenから始まる値を組み立てる（入れ子の深さはreaderが制限する）
+    // 戻り値: 成功時true
+    static bool buildValue(JsonReader::Reader& reader, JsonReader::Token token, JsonValue& value) {
+        using JsonReader::Token;
+        switch (token) {
+            case Token::STRING:
+                value = JsonValue(std::string(reader.string()));
+                return true;
+            case Token::NUMBER:
+                value = JsonValue(reader.number());
+                return true;
+            case Token::BOOLEAN:
+                value = JsonValue(reader.boolean());
+                return true;
+            case Token::NULL_VALUE:
+                value = JsonValue();
+                return true;
+            case Token::START_ARRAY: {
+                JsonArray array;
+                for (Token item = reader.next(); item != Token::END_ARRAY; item = reader.next()) {
+                    array.emplace_back();
+                    if (!buildValue(reader, item, array.back())) return false;
+                }
+                value = JsonValue(std::move(array));
+                return true;
+            }
+            case Token::START_OBJECT: {
+                JsonObject object;
+                for (Token key = reader.next(); key != Token::END_OBJECT; key = reader.next()) {
+                    if (key != Token::KEY) return false;
+                    // 同じキーが複数あれば後のものを使う
+                    JsonValue& member = object.set(std::string(reader.string()), JsonValue());
+                    if (!buildValue(reader, reader.next(), member)) return false;
+                }
+                value = JsonValue(std::move(object));
+                return true;
+            }
+            default:
+                return false;
         }
     }
 
     // 公開関数の実装
     JsonValue parseJson(const std::string& jsonStr) {
-        size_t pos = 0;
-        try {
-            return parseValue(jsonStr, pos);
-        } catch (const std::exception& e) {
-            std::cerr << "JSON Parse Error: " << e.what() << std::endl;
+        JsonReader::Reader reader(jsonStr);
+        JsonValue root;
+        if (!buildValue(reader, reader.next(), root) || reader.next() != JsonReader::Token::END) {
+            std::cerr << "JSON Parse Error: " << reader.error() << std::endl;
             return JsonValue();
         }
+        return root;
     }
 
-    std::string escapeString(const std::string& str) {
-        std::string result = "\"";
-        for (char c : str) {
-            switch (c) {
-                case '"': result += "\\\""; break;
-                case '\\': result += "\\\\"; break;
-                case '\b': result += "\\b"; break;
-                case '\f': result += "\\f"; break;
-                case '\n': result += "\\n"; break;
-                case '\r': result += "\\r"; break;
-                case '\t': result += "\\t"; break;
-                default: result += c; break;
-            }
-        }
-        result += "\"";
-        return result;
-    }
-
-    std::string jsonToString(const JsonValue& json, int indent) {
-        std::string indentStr(indent * 2, ' ');
-        std::string nextIndentStr((indent + 1) * 2, ' ');
-        
-        switch (json.type) {
+    void writeJson(JsonWriter::Writer& writer, const JsonValue& json) {
+        switch (json.type()) {
             case JsonType::STRING:
-                return escapeString(json.stringValue);
+                writer.value(json.asString());
+                return;
             case JsonType::NUMBER:
-                return std::to_string(json.numberValue);
+                writer.value(json.asNumber());
+                return;
             case JsonType::BOOLEAN:
-                return json.boolValue ? "true" : "false";
+                writer.value(json.asBool());
+                return;
             case JsonType::JSON_NULL:
-                return "null";
-            case JsonType::ARRAY: {
-                if (json.arrayValue.empty()) return "[]";
-                std::string result = "[\n";
-                for (size_t i = 0; i < json.arrayValue.size(); ++i) {
-                    result += nextIndentStr + jsonToString(json.arrayValue[i], indent + 1);
-                    if (i < json.arrayValue.size() - 1) result += ",";
-                    result += "\n";
+                writer.null();
+                return;
+            case JsonType::ARRAY:
+                writer.startArray();
+                for (const JsonValue& item : json.asArray()) {
+                    writeJson(writer, item);
                 }
-                result += indentStr + "]";
-                return result;
-            }
-            case JsonType::OBJECT: {
-                if (json.objectValue.empty()) return "{}";
-                std::string result = "{\n";
-                auto it = json.objectValue.begin();
-                while (it != json.objectValue.end()) {
-                    result += nextIndentStr + escapeString(it->first) + ": " + jsonToString(it->second, indent + 1);
-                    ++it;
-                    if (it != json.objectValue.end()) result += ",";
-                    result += "\n";
+                writer.endArray();
+                return;
+            case JsonType::OBJECT:
+                writer.startObject();
+                for (const JsonMember& member : json.asObject()) {
+                    writer.key(member.key);
+                    writeJson(writer, member.value);
                 }
-                result += indentStr + "}";
-                return result;
-            }
+                writer.endObject();
+                return;
         }
-        return "null";
+    }
+
+    std::string jsonToString(const JsonValue& json, int indent, JsonWriter::Style style) {
+        std::string result;
+        JsonWriter::Writer writer(style);
+        writer.attach(result);
+        writer.setBaseIndent(indent);
+        writeJson(writer, json);
+        writer.close();
+        return result;
     }
 
     JsonValue loadJsonFromFile(const std::string& filePath) {
@@ -309,27 +269,22 @@ namespace JsonHelper {
         return parseJson(buffer.str());
     }
 
-    bool saveJsonToFile(const JsonValue& json, const std::string& filePath) {
-        std::ofstream file(filePath);
-        if (!file.is_open()) {
+    bool saveJsonToFile(const JsonValue& json, const std::string& filePath, JsonWriter::Style style) {
+        JsonWriter::Writer writer(style);
+        if (!writer.open(filePath)) {
             std::cerr << "Failed to create file: " << filePath << std::endl;
             return false;
         }
-        
-        file << jsonToString(json, 0);
-        file.close();
-        return true;
+
+        writeJson(writer, json);
+        return writer.close();
     }
 
     JsonValue createObject() {
-        JsonValue obj;
-        obj.type = JsonType::OBJECT;
-        return obj;
+        return JsonValue(JsonObject());
     }
 
     JsonValue createArray() {
-        JsonValue arr;
-        arr.type = JsonType::ARRAY;
-        return arr;
+        return JsonValue(JsonArray());
     }
 }
\ No newline at end of file
@@ -1,7 +1,16 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <map>
+#include <string_view>
+#include <variant>
 #include <vector>
+#include "json_writer.h"
+
+// 値は型ごとに必要なものだけを持つ（std::variant）。配列・オブジェクトの要素はムーブで受け渡し、
+// 取得は参照で返すので、部分木を取り出すときにコピーしない（const auto& entries = json["entries"];）。
+// オブジェクトのメンバーは書かれた順に並べて持つ（キー"1".."10"もファイルの順のまま）。
+// メンバーが少ないうちは先頭から比べ、LINEAR_MEMBERSを超えたらキーのハッシュ表を作って探す。
 
 namespace JsonHelper {
     // JSONの値の型
@@ -14,58 +23,123 @@ namespace JsonHelper {
         JSON_NULL
     };
 
+    class JsonValue;
+    struct JsonMember;
+
+    using JsonArray = std::vector<JsonValue>;
+
+    // オブジェクト（メンバーは追加した順）
+    class JsonObject {
+    private:
+        std::vector<JsonMember> members_;
+        std::vector<uint32_t> index_;   // キーのハッシュ表（メンバーの番号+1。0は空き。少ないうちは空）
+
+        size_t findIndex(std::string_view key) const;
+        void rebuildIndex();
+        void addToIndex(size_t member);
+
+    public:
+        // これ以下のメンバー数ではハッシュ表を作らない
+        static constexpr size_t LINEAR_MEMBERS = 8;
+
+        JsonObject();
+        JsonObject(const JsonObject& other);
+        JsonObject(JsonObject&& other) noexcept;
+        JsonObject& operator=(const JsonObject& other);
+        JsonObject& operator=(JsonObject&& other) noexcept;
+        ~JsonObject();
+
+        size_t size() const { return members_.size(); }
+        bool empty() const { return members_.empty(); }
+        void reserve(size_t count);
+
+        // キーの値（なければnullptr）
+        const JsonValue* find(std::string_view key) const;
+        JsonValue* find(std::string_view key);
+
+        // キーの値（なければnullを追加する）
+        JsonValue& operator[](std::string_view key);
+
+        // キーの値を置き換える（なければ末尾に追加する）
+        JsonValue& set(std::string key, JsonValue value);
+
+        std::vector<JsonMember>::const_iterator begin() const;
+        std::vector<JsonMember>::const_iterator end() const;
+        std::vector<JsonMember>::iterator begin();
+        std::vector<JsonMember>::iterator end();
+    };
+
     // JSON値を表現するクラス
     class JsonValue {
+    private:
+        // 並びはJsonTypeと同じ
+        std::variant<std::string, double, bool, JsonArray, JsonObject, std::monostate> value_;
+
     public:
-        JsonType type;
-        std::string stringValue;
-        double numberValue;
-        bool boolValue;
-        std::vector<JsonValue> arrayValue;
-        std::map<std::string, JsonValue> objectValue;
-
-        JsonValue() : type(JsonType::JSON_NULL), numberValue(0), boolValue(false) {}
-        JsonValue(const std::string& str) : type(JsonType::STRING), stringValue(str), numberValue(0), boolValue(false) {}
-        JsonValue(double num) : type(JsonType::NUMBER), numberValue(num), boolValue(false) {}
-        JsonValue(bool b) : type(JsonType::BOOLEAN), numberValue(0), boolValue(b) {}
+        JsonValue() : value_(std::monostate()) {}
+        JsonValue(std::string str) : value_(std::move(str)) {}
+        JsonValue(const char* str) : value_(std::string(str)) {}
+        JsonValue(double num) : value_(num) {}
+        JsonValue(bool b) : value_(b) {}
+        JsonValue(JsonArray array) : value_(std::move(array)) {}
+        JsonValue(JsonObject object) : value_(std::move(object)) {}
+
+        JsonType type() const { return static_cast<JsonType>(value_.index()); }
 
         // 型チェック
-        bool isString() const { return type == JsonType::STRING; }
-        bool isNumber() const { return type == JsonType::NUMBER; }
-        bool isBool() const { return type == JsonType::BOOLEAN; }
-        bool isArray() const { return type == JsonType::ARRAY; }
-        bool isObject() const { return type == JsonType::OBJECT; }
-        bool isNull() const { return type == JsonType::JSON_NULL; }
-
-        // 値取得
-        std::string asString() const { return stringValue; }
-        double asNumber() const { return numberValue; }
-        bool asBool() const { return boolValue; }
-        const std::vector<JsonValue>& asArray() const { return arrayValue; }
-        const std::map<std::string, JsonValue>& asObject() const { return objectValue; }
-
-        // オブジェクト操作
-        JsonValue& operator[](const std::string& key);
-        const JsonValue& operator[](const std::string& key) const;
-        
-        // 配列操作
-        void pushBack(const JsonValue& value);
+        bool isString() const { return type() == JsonType::STRING; }
+        bool isNumber() const { return type() == JsonType::NUMBER; }
+        bool isBool() const { return type() == JsonType::BOOLEAN; }
+        bool isArray() const { return type() == JsonType::ARRAY; }
+        bool isObject() const { return type() == JsonType::OBJECT; }
+        bool isNull() const { return type() == JsonType::JSON_NULL; }
+
+        // 値取得（型が違う場合は空・0・false）
+        const std::string& asString() const;
+        double asNumber() const;
+        bool asBool() const;
+        const JsonArray& asArray() const;
+        const JsonObject& asObject() const;
+
+        // オブジェクト操作（オブジェクトでなければオブジェクトにする。constはなければnull）
+        JsonValue& operator[](std::string_view key);
+        const JsonValue& operator[](std::string_view key) const;
+
+        // 配列操作（配列でなければ配列にする。範囲外はnullで埋めて広げる。constは範囲外ならnull）
+        void pushBack(JsonValue value);
+        JsonValue& operator[](size_t index);
+        const JsonValue& operator[](size_t index) const;
         size_t size() const;
     };
 
+    struct JsonMember {
+        std::string key;
+        JsonValue value;
+    };
+
+    inline std::vector<JsonMember>::const_iterator JsonObject::begin() const { return members_.begin(); }
+    inline std::vector<JsonMember>::const_iterator JsonObject::end() const { return members_.end(); }
+    inline std::vector<JsonMember>::iterator JsonObject::begin() { return members_.begin(); }
+    inline std::vector<JsonMember>::iterator JsonObject::end() { return members_.end(); }
+
     // JSON文字列をパース
     JsonValue parseJson(const std::string& jsonStr);
-    
-    // JSONオブジェクトを文字列に変換
-    std::string jsonToString(const JsonValue& json, int indent = 0);
-    
+
+    // JSON値をwriterに書く
+    void writeJson(JsonWriter::Writer& writer, const JsonValue& json);
+
+    // JSONオブジェクトを文字列に変換（indentは整形時の字下げの基準の段数）
+    std::string jsonToString(const JsonValue& json, int indent = 0,
+                             JsonWriter::Style style = JsonWriter::Style::PRETTY);
+
     // ファイルからJSONを読み込み
     JsonValue loadJsonFromFile(const std::string& filePath);
-    
-    // JSONをファイルに保存
-    bool saveJsonToFile(const JsonValue& json, const std::string& filePath);
-    
+
+    // JSONをファイルに保存（全体の文字列を作らず、バッファが一杯になるたびに書き出す）
+    bool saveJsonToFile(const JsonValue& json, const std::string& filePath,
+                        JsonWriter::Style style = JsonWriter::Style::PRETTY);
+
     // 便利な作成関数
     JsonValue createObject();
     JsonValue createArray();
-}
\ No newline at end of file
+}
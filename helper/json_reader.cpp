@@ -0,0 +1,352 @@
+// json_reader.cpp
+// プル型のJSON読み取りの実装
+
+#include "json_reader.h"
+#include <charconv>
+#include <cstring>
+
+namespace JsonReader {
+
+    Reader::Reader()
+        : Reader(std::string_view())
+    {
+    }
+
+    Reader::Reader(std::string_view json) {
+        reset(json);
+    }
+
+    void Reader::reset(std::string_view json) {
+        begin_ = json.data();
+        p_ = json.data();
+        end_ = json.data() + json.size();
+        state_ = State::VALUE;
+        stack_.clear();
+        string_ = std::string_view();
+        copied_ = false;
+        number_ = 0.0;
+        boolean_ = false;
+        error_.clear();
+    }
+
+    Token Reader::fail(const char* message) {
+        if (state_ != State::FAILED) {
+            size_t line = 1;
+            const char* lineBegin = begin_;
+            for (const char* c = begin_; c < p_; ++c) {
+                if (*c == '\n') {
+                    line++;
+                    lineBegin = c + 1;
+                }
+            }
+            error_ = "line " + std::to_string(line) + ", column " +
+                     std::to_string(p_ - lineBegin + 1) + ": " + message;
+            state_ = State::FAILED;
+        }
+        return Token::ERROR;
+    }
+
+    void Reader::skipWhitespace() {
+        while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) p_++;
+    }
+
+    Token Reader::next() {
+        skipWhitespace();
+        switch (state_) {
+            case State::VALUE:
+                return readValue();
+
+            case State::FIRST_ITEM:
+                if (p_ < end_ && *p_ == ']') {
+                    p_++;
+                    stack_.pop_back();
+                    state_ = State::AFTER_VALUE;
+                    return Token::END_ARRAY;
+                }
+                return readValue();
+
+            case State::FIRST_MEMBER:
+                if (p_ < end_ && *p_ == '}') {
+                    p_++;
+                    stack_.pop_back();
+                    state_ = State::AFTER_VALUE;
+                    return Token::END_OBJECT;
+                }
+                return readKey();
+
+            case State::MEMBER:
+                return readKey();
+
+            case State::AFTER_VALUE: {
+                if (stack_.empty()) {
+                    // ルートの値の後ろに空白以外があれば失敗
+                    if (p_ != end_) return fail("unexpected data after value");
+                    state_ = State::DONE;
+                    return Token::END;
+                }
+                char open = stack_.back();
+                if (p_ < end_ && *p_ == ',') {
+                    p_++;
+                    skipWhitespace();
+                    if (open == '{') return readKey();
+                    return readValue();
+                }
+                if (p_ < end_ && *p_ == (open == '{' ? '}' : ']')) {
+                    p_++;
+                    stack_.pop_back();
+                    return open == '{' ? Token::END_OBJECT : Token::END_ARRAY;
+                }
+                return fail(open == '{' ? "expected ',' or '}'" : "expected ',' or ']'");
+            }
+
+            case State::DONE:
+                return Token::END;
+
+            case State::FAILED:
+                break;
+        }
+        return Token::ERROR;
+    }
+
+    bool Reader::skipValue() {
+        if (state_ != State::FIRST_ITEM && state_ != State::FIRST_MEMBER) return state_ != State::FAILED;
+        size_t target = stack_.size() - 1;
+        while (true) {
+            Token token = next();
+            if (token == Token::ERROR) return false;
+            if ((token == Token::END_OBJECT || token == Token::END_ARRAY) && stack_.size() == target) return true;
+        }
+    }
+
+    Token Reader::readKey() {
+        if (p_ >= end_ || *p_ != '"') return fail("expected string key");
+        if (!readString()) return Token::ERROR;
+        skipWhitespace();
+        if (p_ >= end_ || *p_ != ':') return fail("expected ':'");
+        p_++;
+        state_ = State::VALUE;
+        return Token::KEY;
+    }
+
+    Token Reader::readValue() {
+        if (p_ >= end_) return fail("unexpected end of input");
+        char c = *p_;
+        if (c == '{' || c == '[') {
+            if (stack_.size() >= MAX_DEPTH) return fail("nesting too deep");
+            p_++;
+            stack_.push_back(c);
+            state_ = c == '{' ? State::FIRST_MEMBER : State::FIRST_ITEM;
+            return c == '{' ? Token::START_OBJECT : Token::START_ARRAY;
+        }
+
+        Token token;
+        bool ok;
+        switch (c) {
+            case '"':
+                token = Token::STRING;
+                ok = readString();
+                break;
+            case 't':
+                token = Token::BOOLEAN;
+                boolean_ = true;
+                ok = readLiteral("true", 4);
+                break;
+            case 'f':
+                token = Token::BOOLEAN;
+                boolean_ = false;
+                ok = readLiteral("false", 5);
+                break;
+            case 'n':
+                token = Token::NULL_VALUE;
+                ok = readLiteral("null", 4);
+                break;
+            default:
+                token = Token::NUMBER;
+                ok = readNumber();
+                break;
+        }
+        if (!ok) return Token::ERROR;
+        state_ = State::AFTER_VALUE;
+        return token;
+    }
+
+    // 文字列（p_は開きの"を指す）
+    bool Reader::readString() {
+        p_++;
+        const char* start = p_;
+        while (p_ < end_) {
+            char c = *p_;
+            if (c == '"') {
+                string_ = std::string_view(start, static_cast<size_t>(p_ - start));  // 元のJSONを指す
+                copied_ = false;
+                p_++;
+                return true;
+            }
+            if (c == '\\') return decodeEscapes(start);
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fail("control character in string");
+                return false;
+            }
+            p_++;
+        }
+        fail("unterminated string");
+        return false;
+    }
+
+    // エスケープを含む文字列の残りを復号する（p_は最初の\を指す）
+    bool Reader::decodeEscapes(const char* start) {
+        decoded_.assign(start, p_);
+        while (true) {
+            if (p_ >= end_) {
+                fail("unterminated string");
+                return false;
+            }
+            char c = *p_;
+            if (c == '"') break;
+            if (static_cast<unsigned char>(c) < 0x20) {
+                fail("control character in string");
+                return false;
+            }
+            if (c != '\\') {
+                decoded_ += c;
+                p_++;
+                continue;
+            }
+            if (++p_ >= end_) {
+                fail("unterminated string");
+                return false;
+            }
+            char e = *p_++;
+            switch (e) {
+                case '"':  decoded_ += '"'; break;
+                case '\\': decoded_ += '\\'; break;
+                case '/':  decoded_ += '/'; break;
+                case 'b':  decoded_ += '\b'; break;
+                case 'f':  decoded_ += '\f'; break;
+                case 'n':  decoded_ += '\n'; break;
+                case 'r':  decoded_ += '\r'; break;
+                case 't':  decoded_ += '\t'; break;
+                case 'u': {
+                    uint32_t cp = 0;
+                    if (!readHex4(cp)) return false;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        // サロゲートペア（BMP外の文字）
+                        uint32_t low = 0;
+                        if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') {
+                            fail("unpaired surrogate");
+                            return false;
+                        }
+                        p_ += 2;
+                        if (!readHex4(low)) return false;
+                        if (low < 0xDC00 || low > 0xDFFF) {
+                            fail("unpaired surrogate");
+                            return false;
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                        fail("unpaired surrogate");
+                        return false;
+                    }
+                    appendUtf8(cp);
+                    break;
+                }
+                default:
+                    p_--;
+                    fail("invalid escape");
+                    return false;
+            }
+        }
+        p_++;  // 閉じる"
+        string_ = decoded_;
+        copied_ = true;
+        return true;
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    bool Reader::readHex4(uint32_t& value) {
+        if (end_ - p_ < 4) {
+            fail("incomplete \\u escape");
+            return false;
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            int digit = hexValue(p_[i]);
+            if (digit < 0) {
+                fail("invalid \\u escape");
+                return false;
+            }
+            value = value * 16 + static_cast<uint32_t>(digit);
+        }
+        p_ += 4;
+        return true;
+    }
+
+    void Reader::appendUtf8(uint32_t cp) {
+        if (cp < 0x80) {
+            decoded_ += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            decoded_ += static_cast<char>(0xC0 | (cp >> 6));
+            decoded_ += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            decoded_ += static_cast<char>(0xE0 | (cp >> 12));
+            decoded_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            decoded_ += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            decoded_ += static_cast<char>(0xF0 | (cp >> 18));
+            decoded_ += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            decoded_ += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            decoded_ += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+
+    bool Reader::readNumber() {
+        // JSONの数値の書式を確認してからfrom_charsで変換する
+        const char* start = p_;
+        bool valid = true;
+        if (p_ < end_ && *p_ == '-') p_++;
+        if (p_ < end_ && *p_ == '0') {
+            p_++;
+        } else if (p_ < end_ && *p_ >= '1' && *p_ <= '9') {
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+        } else {
+            valid = false;
+        }
+        if (valid && p_ < end_ && *p_ == '.') {
+            p_++;
+            valid = p_ < end_ && *p_ >= '0' && *p_ <= '9';
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+        }
+        if (valid && p_ < end_ && (*p_ == 'e' || *p_ == 'E')) {
+            p_++;
+            if (p_ < end_ && (*p_ == '+' || *p_ == '-')) p_++;
+            valid = p_ < end_ && *p_ >= '0' && *p_ <= '9';
+            while (p_ < end_ && *p_ >= '0' && *p_ <= '9') p_++;
+        }
+
+        if (valid) {
+            auto result = std::from_chars(start, p_, number_);
+            valid = result.ptr == p_ || result.ec == std::errc::result_out_of_range;
+        }
+        if (!valid) {
+            fail(p_ == start ? "unexpected character" : "invalid number");
+            return false;
+        }
+        return true;
+    }
+
+    bool Reader::readLiteral(const char* word, size_t length) {
+        if (static_cast<size_t>(end_ - p_) < length || std::memcmp(p_, word, length) != 0) {
+            fail("unexpected character");
+            return false;
+        }
+        p_ += length;
+        return true;
+    }
+
+} // namespace JsonReader
@@ -0,0 +1,110 @@
+#pragma once
+
+// json_reader.h
+// JSONを先頭から1トークンずつ読むプル型の読み取り
+//
+// 用語解説:
+// - トークン(Token): JSONの構成要素（{ } [ ] キー 文字列 数値 true/false null）
+// - プル型(Pull): 呼び出し側がnext()で次のトークンを取りに行く読み方。
+//   木（DOM）を作らないので、ファイルが大きくても使うメモリは入れ子の深さの分だけになる
+//
+// 書式の検査（カンマ・コロンの位置、末尾の余計なデータ、入れ子の深さ）はここで行う。
+// JsonDocument::Documentもこの読み取りの上で木を組み立てる。
+// KEY・STRINGの文字列はエスケープがなければ元のJSONを指す。エスケープがあれば内部のバッファに
+// 復号し（copied()がtrue）、次にnext()を呼ぶまで有効。
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JsonReader {
+
+    // これより深い入れ子は受け付けない
+    constexpr size_t MAX_DEPTH = 512;
+
+    enum class Token : uint8_t {
+        START_OBJECT,
+        END_OBJECT,
+        START_ARRAY,
+        END_ARRAY,
+        KEY,            // オブジェクトのキー（次のトークンがその値）
+        STRING,
+        NUMBER,
+        BOOLEAN,
+        NULL_VALUE,
+        END,            // ルートの値を読み終えた
+        ERROR           // 書式の誤り（error()に位置と理由。以降もERRORを返す）
+    };
+
+    class Reader {
+    private:
+        enum class State : uint8_t {
+            VALUE,              // 値が来る
+            FIRST_ITEM,         // [ の直後（値か ] が来る）
+            FIRST_MEMBER,       // { の直後（キーか } が来る）
+            MEMBER,             // オブジェクトの , の直後（キーが来る）
+            AFTER_VALUE,        // 値の直後（, か閉じ括弧、ルートなら終わり）
+            DONE,
+            FAILED
+        };
+
+        const char* begin_;
+        const char* p_;
+        const char* end_;
+        State state_;
+        std::vector<char> stack_;   // 開いている括弧（'{' か '['）
+        std::string_view string_;
+        bool copied_;
+        double number_;
+        bool boolean_;
+        std::string decoded_;       // エスケープの復号用
+        std::string error_;
+
+        Token fail(const char* message);
+        void skipWhitespace();
+        Token readValue();
+        Token readKey();
+        bool readString();
+        bool decodeEscapes(const char* start);
+        bool readHex4(uint32_t& value);
+        void appendUtf8(uint32_t cp);
+        bool readNumber();
+        bool readLiteral(const char* word, size_t length);
+
+    public:
+        Reader();
+        explicit Reader(std::string_view json);
+
+        // 読み取るJSONを設定し、先頭から読み直す
+        void reset(std::string_view json);
+
+        // 次のトークン
+        Token next();
+
+        // 直前に返したSTART_OBJECT・START_ARRAYの中身を閉じ括弧まで読み飛ばす
+        // （スカラー値の直後に呼んだ場合は何もしない）
+        // 戻り値: 成功時true（書式の誤りがあればfalse）
+        bool skipValue();
+
+        // KEY・STRINGの文字列
+        std::string_view string() const { return string_; }
+
+        // 文字列がエスケープを復号した内部のバッファを指すか（次のnext()で無効になる）
+        bool copied() const { return copied_; }
+
+        double number() const { return number_; }
+        bool boolean() const { return boolean_; }
+
+        // 開いている括弧の数
+        size_t depth() const { return stack_.size(); }
+
+        // 読み終えた位置（JSONの先頭からのバイト数）
+        size_t offset() const { return static_cast<size_t>(p_ - begin_); }
+
+        // 失敗の理由（例: "line 3, column 5: expected ':'"）
+        const std::string& error() const { return error_; }
+    };
+
+} // namespace JsonReader
@@ -0,0 +1,225 @@
+// json_writer.cpp
+// JSONのストリーム型の書き込みの実装
+
+#include "json_writer.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace JsonWriter {
+
+    // to_charsで書く数値の最大文字数
+    static constexpr size_t MAX_NUMBER_CHARS = 32;
+
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    Writer::Writer(Style style, size_t bufferSize)
+        : file_(nullptr)
+        , text_(nullptr)
+        , buffer_(bufferSize < MAX_NUMBER_CHARS ? MAX_NUMBER_CHARS : bufferSize)
+        , used_(0)
+        , failed_(false)
+        , style_(style)
+        , baseIndent_(0)
+        , first_(false)
+        , afterKey_(false)
+    {
+    }
+
+    Writer::~Writer() {
+        close();
+    }
+
+    bool Writer::open(const std::string& filepath) {
+        close();
+        failed_ = false;
+        file_ = std::fopen(filepath.c_str(), "wb");
+        return file_ != nullptr;
+    }
+
+    void Writer::attach(std::string& text) {
+        close();
+        failed_ = false;
+        text_ = &text;
+    }
+
+    void Writer::writeOut(const char* data, size_t size) {
+        if (text_ != nullptr) {
+            text_->append(data, size);
+        } else if (file_ == nullptr || std::fwrite(data, 1, size, file_) != size) {
+            failed_ = true;
+        }
+    }
+
+    void Writer::raw(std::string_view text) {
+        if (text.size() > buffer_.size() - used_) {
+            flush();
+            // バッファより大きい文字列は直接書き出す
+            if (text.size() > buffer_.size()) {
+                writeOut(text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer_.data() + used_, text.data(), text.size());
+        used_ += text.size();
+    }
+
+    void Writer::newline(size_t depth) {
+        if (style_ != Style::PRETTY) return;
+        put('\n');
+        size_t spaces = (static_cast<size_t>(baseIndent_ > 0 ? baseIndent_ : 0) + depth) * 2;
+        while (spaces > 0) {
+            static const char SPACES[] = "                                ";
+            size_t count = spaces < sizeof(SPACES) - 1 ? spaces : sizeof(SPACES) - 1;
+            raw(std::string_view(SPACES, count));
+            spaces -= count;
+        }
+    }
+
+    void Writer::beforeValue() {
+        if (afterKey_) {
+            afterKey_ = false;
+            return;
+        }
+        if (stack_.empty()) return;
+        if (stack_.back() == '{') {
+            failed_ = true;     // キーのないオブジェクトの値
+        }
+        if (!first_) put(',');
+        newline(stack_.size());
+        first_ = false;
+    }
+
+    void Writer::openBracket(char bracket) {
+        beforeValue();
+        put(bracket);
+        stack_.push_back(bracket);
+        first_ = true;
+    }
+
+    void Writer::closeBracket(char bracket) {
+        char expected = bracket == '}' ? '{' : '[';
+        if (stack_.empty() || stack_.back() != expected || afterKey_) {
+            failed_ = true;
+            return;
+        }
+        stack_.pop_back();
+        if (!first_) newline(stack_.size());
+        put(bracket);
+        first_ = false;
+    }
+
+    void Writer::key(std::string_view name) {
+        if (stack_.empty() || stack_.back() != '{' || afterKey_) {
+            failed_ = true;
+            return;
+        }
+        if (!first_) put(',');
+        newline(stack_.size());
+        first_ = false;
+        writeString(name);
+        put(':');
+        if (style_ == Style::PRETTY) put(' ');
+        afterKey_ = true;
+    }
+
+    void Writer::writeString(std::string_view text) {
+        put('"');
+        // エスケープの要らない部分はまとめて書く
+        size_t start = 0;
+        for (size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+            raw(text.substr(start, i - start));
+            start = i + 1;
+            switch (c) {
+                case '"': raw("\\\""); break;
+                case '\\': raw("\\\\"); break;
+                case '\b': raw("\\b"); break;
+                case '\f': raw("\\f"); break;
+                case '\n': raw("\\n"); break;
+                case '\r': raw("\\r"); break;
+                case '\t': raw("\\t"); break;
+                default: {
+                    char escaped[6] = {'\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0x0F]};
+                    raw(std::string_view(escaped, sizeof(escaped)));
+                    break;
+                }
+            }
+        }
+        raw(text.substr(start));
+        put('"');
+    }
+
+    void Writer::value(std::string_view text) {
+        beforeValue();
+        writeString(text);
+    }
+
+    void Writer::value(double number) {
+        if (!std::isfinite(number)) {
+            null();
+            return;
+        }
+        beforeValue();
+        reserve(MAX_NUMBER_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), number);
+        used_ += result.ptr - begin;
+    }
+
+    void Writer::value(int64_t number) {
+        beforeValue();
+        reserve(MAX_NUMBER_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), number);
+        used_ += result.ptr - begin;
+    }
+
+    void Writer::value(uint64_t number) {
+        beforeValue();
+        reserve(MAX_NUMBER_CHARS);
+        char* begin = buffer_.data() + used_;
+        auto result = std::to_chars(begin, buffer_.data() + buffer_.size(), number);
+        used_ += result.ptr - begin;
+    }
+
+    void Writer::value(bool boolean) {
+        beforeValue();
+        raw(boolean ? "true" : "false");
+    }
+
+    void Writer::null() {
+        beforeValue();
+        raw("null");
+    }
+
+    bool Writer::flush() {
+        if (used_ > 0) {
+            writeOut(buffer_.data(), used_);
+            used_ = 0;
+        }
+        return !failed_;
+    }
+
+    bool Writer::close() {
+        if (file_ == nullptr && text_ == nullptr) {
+            used_ = 0;
+            return !failed_;
+        }
+        if (!stack_.empty() || afterKey_) {
+            failed_ = true;
+        }
+        flush();
+        if (file_ != nullptr && std::fclose(file_) != 0) {
+            failed_ = true;
+        }
+        file_ = nullptr;
+        text_ = nullptr;
+        stack_.clear();
+        first_ = false;
+        afterKey_ = false;
+        return !failed_;
+    }
+
+} // namespace JsonWriter
@@ -0,0 +1,108 @@
+#pragma once
+
+// json_writer.h
+// JSONを先頭から順に書き出すストリーム型の書き込み
+//
+// 用語解説:
+// - ストリーム型: 木（DOM）の文字列を組み立ててから書くのではなく、{ [ キー 値 を呼んだ順にそのまま書き出す書き方。
+//   バッファが一杯になるたびに書き出すので、出力の大きさによらず使うメモリはバッファの分だけになる
+// - 整形(Pretty): 要素ごとに改行し、入れ子の深さだけ字下げする書式。コンパクト(Compact)は空白を入れない
+// - to_chars: 数値を文字列に変換するC++17の関数。doubleは元の値に戻せる最短の桁数で書く
+//   （std::to_stringは小数点以下6桁で丸めるため、小さな値や桁の多い値が変わってしまう）
+//
+// JsonReaderの逆向き。カンマ・コロン・字下げはここで入れるので、呼び出し側は値の並びだけを書けばよい。
+// 書き出し先はファイル（open）か文字列（attach）。JsonHelper::jsonToString・saveJsonToFileもこの上に作っている。
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace JsonWriter {
+
+    // デフォルトのバッファサイズ（64KiB）
+    constexpr size_t DEFAULT_BUFFER_SIZE = 1 << 16;
+
+    enum class Style : uint8_t {
+        PRETTY,     // 改行と字下げ（2文字）あり
+        COMPACT     // 空白なし
+    };
+
+    class Writer {
+    private:
+        std::FILE* file_;
+        std::string* text_;         // attachした文字列（ファイルに書く場合はnullptr）
+        std::vector<char> buffer_;
+        size_t used_;
+        bool failed_;
+        Style style_;
+        int baseIndent_;            // 字下げの基準（整形時、最初の行以外に付ける段数）
+        std::vector<char> stack_;   // 開いている括弧（'{' か '['）
+        bool first_;                // 開いた括弧の直後（まだ要素がない）
+        bool afterKey_;             // キーの直後（次は値）
+
+        void reserve(size_t size) {
+            if (buffer_.size() - used_ < size) flush();
+        }
+        void put(char ch) {
+            reserve(1);
+            buffer_[used_++] = ch;
+        }
+        void raw(std::string_view text);
+        void writeString(std::string_view text);    // " で囲み、" \ と制御文字をエスケープする
+        void newline(size_t depth);
+        void beforeValue();
+        void openBracket(char bracket);
+        void closeBracket(char bracket);
+        void writeOut(const char* data, size_t size);
+
+    public:
+        explicit Writer(Style style = Style::PRETTY, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // ファイルに書き出す（既存の内容は消える）
+        // 戻り値: 成功時true
+        bool open(const std::string& filepath);
+
+        // 文字列の末尾に書き足す（flush・closeまでは書き足されない分がある）
+        void attach(std::string& text);
+
+        // 字下げの基準の段数（既存の文書の途中に埋め込む場合）
+        void setBaseIndent(int level) { baseIndent_ = level; }
+
+        void startObject() { openBracket('{'); }
+        void endObject() { closeBracket('}'); }
+        void startArray() { openBracket('['); }
+        void endArray() { closeBracket(']'); }
+
+        // オブジェクトのキー（次に書く値がその値）
+        void key(std::string_view name);
+
+        // 値
+        void value(std::string_view text);
+        void value(const char* text) { value(std::string_view(text)); }
+        void value(double number);         // NaN・無限大はJSONにないのでnull
+        void value(int64_t number);
+        void value(uint64_t number);
+        void value(int number) { value(static_cast<int64_t>(number)); }
+        void value(bool boolean);
+        void null();
+
+        // 開いている括弧の数
+        size_t depth() const { return stack_.size(); }
+
+        // バッファの内容を書き出す
+        // 戻り値: これまでの書き込みがすべて成功していればtrue（括弧の対応の誤りも失敗）
+        bool flush();
+
+        // 書き出して閉じる（括弧が閉じていなければ失敗）
+        // 戻り値: これまでの書き込みがすべて成功していればtrue
+        bool close();
+    };
+
+} // namespace JsonWriter
@@ -0,0 +1,214 @@
+// lz_block.cpp
+// LZ系のブロック圧縮（LZ4ブロック形式）の実装
+
+#include "lz_block.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace LZBlock {
+
+    static const size_t MIN_MATCH = 4;
+    static const size_t LAST_LITERALS = 5;      // 最後の5バイトは必ずリテラル
+    static const size_t MATCH_FIND_LIMIT = 12;  // 最後の12バイトからは一致を探さない
+    static const size_t MAX_DISTANCE = 65535;
+    static const int HASH_LOG = 15;
+    static const int MAX_CHAIN_DEPTH = 16;      // 1か所で調べる候補の数（多いほど縮むが遅い）
+    static const uint32_t NO_POSITION = UINT32_MAX;
+
+    // 一致を探す表（スレッドごとに1組を使い回し、ブロックごとに確保しない）
+    // head: ハッシュごとの最新の位置（NO_POSITIONなら空き）、chain: 同じハッシュの1つ前の位置までの距離（0なら終わり）
+    struct MatchTables {
+        std::vector<uint32_t> head;
+        std::vector<uint16_t> chain;
+
+        MatchTables() : head(size_t(1) << HASH_LOG), chain(MAX_DISTANCE + 1) {}
+    };
+
+    static uint32_t read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static uint32_t hash4(uint32_t value) {
+        return (value * 2654435761u) >> (32 - HASH_LOG);
+    }
+
+    // 長さの延長バイト（15を超えた分を255ずつ）
+    static uint8_t* putLength(uint8_t* op, size_t length) {
+        while (length >= 255) {
+            *op++ = 255;
+            length -= 255;
+        }
+        *op++ = static_cast<uint8_t>(length);
+        return op;
+    }
+
+    size_t compressBound(size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    // シーケンスを1つ書き込む（matchLength == 0なら最後のリテラルのみ）
+    // 戻り値: 書き込み後の位置（dstが足りなければnullptr）
+    static uint8_t* putSequence(uint8_t* op, uint8_t* oend, const uint8_t* literals, size_t literalLength,
+                                size_t offset, size_t matchLength) {
+        size_t need = 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+        if (static_cast<size_t>(oend - op) < need) {
+            return nullptr;
+        }
+
+        uint8_t* token = op++;
+        *token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+        if (literalLength >= 15) {
+            op = putLength(op, literalLength - 15);
+        }
+        std::memcpy(op, literals, literalLength);
+        op += literalLength;
+        if (matchLength == 0) {
+            return op;
+        }
+
+        *op++ = static_cast<uint8_t>(offset);
+        *op++ = static_cast<uint8_t>(offset >> 8);
+        size_t code = matchLength - MIN_MATCH;
+        *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+        if (code >= 15) {
+            op = putLength(op, code - 15);
+        }
+        return op;
+    }
+
+    size_t compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity) {
+        uint8_t* op = dst;
+        uint8_t* oend = dst + dstCapacity;
+        size_t anchor = 0;
+
+        // 位置は32bitで持つ（4GiB以上のデータは一致を探さずリテラルのみにする）
+        if (srcSize >= MATCH_FIND_LIMIT + 1 && srcSize < NO_POSITION) {
+            // chainは今回挿入した位置の分しか読まないので、消すのはheadだけでよい
+            thread_local MatchTables tables;
+            std::vector<uint32_t>& head = tables.head;
+            std::vector<uint16_t>& chain = tables.chain;
+            std::fill(head.begin(), head.end(), NO_POSITION);
+            auto insert = [&](size_t pos) {
+                uint32_t h = hash4(read32(src + pos));
+                uint32_t prev = head[h];
+                size_t distance = prev == NO_POSITION ? 0 : pos - prev;
+                chain[pos & MAX_DISTANCE] = static_cast<uint16_t>(distance > MAX_DISTANCE ? 0 : distance);
+                head[h] = static_cast<uint32_t>(pos);
+            };
+
+            const size_t findLimit = srcSize - MATCH_FIND_LIMIT;
+            const size_t matchLimit = srcSize - LAST_LITERALS;
+            size_t inserted = 0;
+            size_t ip = 0;
+            while (ip <= findLimit) {
+                while (inserted < ip) insert(inserted++);
+
+                // 候補を新しい順にたどり、最も長い一致を選ぶ
+                size_t bestLength = 0;
+                size_t bestOffset = 0;
+                uint32_t sequence = read32(src + ip);
+                uint32_t candidate = head[hash4(sequence)];
+                for (int depth = 0; depth < MAX_CHAIN_DEPTH && candidate != NO_POSITION; ++depth) {
+                    size_t pos = candidate;
+                    size_t distance = ip - pos;
+                    if (distance > MAX_DISTANCE) break;
+                    if (read32(src + pos) == sequence) {
+                        size_t length = MIN_MATCH;
+                        while (ip + length < matchLimit && src[pos + length] == src[ip + length]) length++;
+                        if (length > bestLength) {
+                            bestLength = length;
+                            bestOffset = distance;
+                        }
+                    }
+                    uint16_t step = chain[pos & MAX_DISTANCE];
+                    if (step == 0) break;
+                    candidate -= step;
+                }
+
+                if (bestLength < MIN_MATCH) {
+                    ip++;
+                    continue;
+                }
+
+                op = putSequence(op, oend, src + anchor, ip - anchor, bestOffset, bestLength);
+                if (op == nullptr) {
+                    return 0;
+                }
+                ip += bestLength;
+                anchor = ip;
+            }
+        }
+
+        // 残りはリテラルのみ
+        op = putSequence(op, oend, src + anchor, srcSize - anchor, 0, 0);
+        if (op == nullptr) {
+            return 0;
+        }
+        return static_cast<size_t>(op - dst);
+    }
+
+    // 長さの延長バイトを読む
+    // 戻り値: 成功時true（入力が途中で終わればfalse）
+    static bool readLength(const uint8_t*& ip, const uint8_t* iend, size_t& length) {
+        uint8_t byte;
+        do {
+            if (ip >= iend) return false;
+            byte = *ip++;
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+        const uint8_t* ip = src;
+        const uint8_t* iend = src + srcSize;
+        uint8_t* op = dst;
+        uint8_t* oend = dst + dstSize;
+
+        while (ip < iend) {
+            uint8_t token = *ip++;
+
+            // リテラル
+            size_t literalLength = token >> 4;
+            if (literalLength == 15 && !readLength(ip, iend, literalLength)) return false;
+            if (literalLength > static_cast<size_t>(iend - ip) ||
+                literalLength > static_cast<size_t>(oend - op)) {
+                return false;
+            }
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+            if (ip == iend) {
+                break;  // 最後のシーケンス
+            }
+
+            // 参照
+            if (iend - ip < 2) return false;
+            size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+                return false;  // 出力の先頭より前を参照している
+            }
+            size_t matchLength = token & 15;
+            if (matchLength == 15 && !readLength(ip, iend, matchLength)) return false;
+            matchLength += MIN_MATCH;
+            if (matchLength > static_cast<size_t>(oend - op)) {
+                return false;
+            }
+
+            const uint8_t* match = op - offset;
+            if (offset >= matchLength) {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            } else {
+                // 重なる参照（同じパターンの繰り返し）は1バイトずつ
+                for (size_t i = 0; i < matchLength; ++i) *op++ = match[i];
+            }
+        }
+        return op == oend;
+    }
+
+} // namespace LZBlock
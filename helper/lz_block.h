@@ -0,0 +1,40 @@
+#pragma once
+
+// lz_block.h
+// LZ系のブロック圧縮（LZ4ブロック形式）
+//
+// 用語解説:
+// - LZ圧縮(LZ77系): 以前に出てきた同じバイト列を「何バイト前から何バイト」という参照に置き換える圧縮
+// - リテラル(Literal): 参照にできず、そのまま書き込むバイト
+// - シーケンス(Sequence): リテラルの並びと、それに続く1つの参照の組
+// - ハッシュチェーン(Hash Chain): 先頭4バイトが同じ位置を新しい順につないだ表。一致の候補を探すのに使う
+//
+// 形式はLZ4のブロック形式と同じ（外部ライブラリは使わず、ここで符号化・復号する）。
+// 各シーケンスは次の並び:
+//   トークン(1) : 上位4bitがリテラル長、下位4bitが一致長-4（15ならその後に延長バイト）
+//   延長バイト  : リテラル長の続き（255が続く間は加算）
+//   リテラル    : リテラル長バイト
+//   オフセット  : 参照先までの距離（u16、リトルエンディアン、1以上）
+//   延長バイト  : 一致長の続き
+// 最後のシーケンスはリテラルだけで終わる（最後の5バイトは必ずリテラル）。
+// 復号は整数演算とコピーだけなので、圧縮前のデータを読むのとほぼ同じ速さで戻せる。
+
+#include <cstddef>
+#include <cstdint>
+
+namespace LZBlock {
+
+    // 圧縮後の最大バイト数（圧縮できないデータでもこれを超えない）
+    size_t compressBound(size_t size);
+
+    // srcを圧縮してdstに書き込む（一致を探す表はスレッドごとに使い回すので、別のスレッドから同時に呼んでよい）
+    // dstCapacity: compressBound(srcSize)以上
+    // 戻り値: 圧縮後のバイト数（dstが足りなければ0）
+    size_t compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+    // srcを復号してdstに書き込む
+    // dstSize: 圧縮前のバイト数（ちょうどこの長さに戻らなければ失敗）
+    // 戻り値: 成功時true（データが壊れている・範囲外を参照する場合はfalse）
+    bool decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+} // namespace LZBlock
@@ -0,0 +1,131 @@
+// mapped_file.cpp
+// 読み取り専用のメモリマップトファイルの実装
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FileMapping {
+
+#ifdef _WIN32
+
+    MappedFile::MappedFile()
+        : data_(nullptr), size_(0), open_(false), file_(nullptr), mapping_(nullptr) {}
+
+    bool MappedFile::open(const std::string& filepath) {
+        close();
+
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                  nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        // 空のファイルはマップできないので、開いたことだけを記録する
+        if (size.QuadPart == 0) {
+            CloseHandle(file);
+            open_ = true;
+            return true;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        file_ = file;
+        mapping_ = mapping;
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(size.QuadPart);
+        open_ = true;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(static_cast<HANDLE>(mapping_));
+        if (file_ != nullptr) CloseHandle(static_cast<HANDLE>(file_));
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+        file_ = nullptr;
+        mapping_ = nullptr;
+    }
+
+#else
+
+    MappedFile::MappedFile()
+        : data_(nullptr), size_(0), open_(false) {}
+
+    bool MappedFile::open(const std::string& filepath) {
+        close();
+
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+
+        // 空のファイルはマップできないので、開いたことだけを記録する
+        if (st.st_size == 0) {
+            ::close(fd);
+            open_ = true;
+            return true;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        // マップ後はファイル記述子がなくても内容を読める
+        ::close(fd);
+        if (view == MAP_FAILED) {
+            return false;
+        }
+        // 先頭から順に読むことをOSに伝え、先読みを増やしてもらう
+        madvise(view, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+        data_ = static_cast<const char*>(view);
+        size_ = static_cast<size_t>(st.st_size);
+        open_ = true;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (data_ != nullptr) {
+            munmap(const_cast<char*>(data_), size_);
+        }
+        data_ = nullptr;
+        size_ = 0;
+        open_ = false;
+    }
+
+#endif
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+} // namespace FileMapping
@@ -0,0 +1,50 @@
+#pragma once
+
+// mapped_file.h
+// 読み取り専用のメモリマップトファイル
+//
+// 用語解説:
+// - メモリマップ(Memory Map): ファイルの内容をメモリのアドレスに対応付け、
+//   配列と同じようにポインタで読めるようにするOSの機能
+//
+// ストリームで読むと、OSのキャッシュから自前のバッファへのコピーと、行ごとの文字列の確保が発生する。
+// マップしたファイルを直接走査すれば、どちらも不要になる。
+// Windowsでは CreateFileMapping / MapViewOfFile、それ以外では mmap を使う。
+
+#include <cstddef>
+#include <string>
+
+namespace FileMapping {
+
+    class MappedFile {
+    private:
+        const char* data_;
+        size_t size_;
+        bool open_;
+#ifdef _WIN32
+        void* file_;        // HANDLE
+        void* mapping_;     // HANDLE
+#endif
+
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // ファイルをマップする（空のファイルも開ける。data()はnullptr、size()は0）
+        // 戻り値: 成功時true
+        bool open(const std::string& filepath);
+
+        // マップを解除する
+        void close();
+
+        bool isOpen() const { return open_; }
+
+        // ファイルの内容（末尾にヌル文字はない）
+        const char* data() const { return data_; }
+        size_t size() const { return size_; }
+    };
+
+} // namespace FileMapping
@@ -0,0 +1,56 @@
+// text_width.cpp
+// 文字列の表示幅の実装
+
+#include "text_width.h"
+
+namespace TextWidth {
+
+    int codePointWidth(char32_t cp) {
+        // 全角判定（簡易版）
+        if ((cp >= 0x1100 && cp <= 0x115F) ||
+            (cp >= 0x2E80 && cp <= 0xA4CF) ||
+            (cp >= 0xAC00 && cp <= 0xD7A3) ||
+            (cp >= 0xF900 && cp <= 0xFAFF) ||
+            (cp >= 0xFE10 && cp <= 0xFE19) ||
+            (cp >= 0xFE30 && cp <= 0xFE6F) ||
+            (cp >= 0xFF00 && cp <= 0xFF60) ||
+            (cp >= 0xFFE0 && cp <= 0xFFE6)) {
+            return 2;
+        }
+        return 1;
+    }
+
+    int displayWidth(std::string_view utf8) {
+        int width = 0;
+        size_t i = 0;
+        while (i < utf8.size()) {
+            unsigned char lead = static_cast<unsigned char>(utf8[i]);
+            size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x06 ? 2 : (lead >> 4) == 0x0E ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+            if (length == 0 || i + length > utf8.size()) {
+                // 不正なバイト
+                width += 1;
+                i += 1;
+                continue;
+            }
+            char32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+            bool valid = true;
+            for (size_t k = 1; k < length; ++k) {
+                unsigned char next = static_cast<unsigned char>(utf8[i + k]);
+                if ((next & 0xC0) != 0x80) {
+                    valid = false;
+                    break;
+                }
+                cp = (cp << 6) | (next & 0x3F);
+            }
+            if (!valid) {
+                width += 1;
+                i += 1;
+                continue;
+            }
+            width += codePointWidth(cp);
+            i += length;
+        }
+        return width;
+    }
+
+} // namespace TextWidth
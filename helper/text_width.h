@@ -0,0 +1,21 @@
+#pragma once
+
+// text_width.h
+// 文字列の表示幅（ターミナルの桁数）
+//
+// 用語解説:
+// - 表示幅(Display Width): ターミナルで文字が占める桁数。全角文字は2、半角文字は1
+//
+// Terminal::getDisplayWidthと同じ判定をWindows APIなしで行う（シナリオのキャッシュ作成などで使う）。
+
+#include <string_view>
+
+namespace TextWidth {
+
+    // 1文字（コードポイント）の表示幅（全角2、半角1）
+    int codePointWidth(char32_t cp);
+
+    // UTF-8文字列の表示幅（不正なバイトは1桁として数える）
+    int displayWidth(std::string_view utf8);
+
+} // namespace TextWidth
@@ -0,0 +1,104 @@
+// work_stealing_pool.cpp
+// ワークスティーリングによる並列ループの実装
+
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+    // ワーカーごとの未処理範囲 [begin, end)
+    // 隣のワーカーの範囲と同じキャッシュラインに載らないように64バイト境界に置く
+    struct alignas(64) WorkRange {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    size_t defaultThreadCount() {
+        unsigned int n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    // 自分の範囲の先頭から1つ取り出す
+    static bool popOwn(WorkRange& range, size_t& index) {
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin >= range.end) return false;
+        index = range.begin++;
+        return true;
+    }
+
+    // 他のワーカーの残りの後ろ半分（残り1つならその1つ）を奪う
+    static bool steal(WorkRange& victim, size_t& begin, size_t& end) {
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        size_t remaining = victim.end - victim.begin;
+        if (remaining == 0) return false;
+        begin = victim.begin + remaining / 2;
+        end = victim.end;
+        victim.end = begin;
+        return true;
+    }
+
+    size_t forEach(size_t count, size_t threadCount, const IndexTask& task) {
+        if (count == 0) return 0;
+        if (threadCount == 0) threadCount = defaultThreadCount();
+        threadCount = std::min(threadCount, count);
+
+        if (threadCount == 1) {
+            for (size_t i = 0; i < count; ++i) {
+                task(i, 0);
+            }
+            return 1;
+        }
+
+        // 最初は等分（std::mutexは移動できないので配列で確保）
+        std::unique_ptr<WorkRange[]> ranges(new WorkRange[threadCount]);
+        for (size_t w = 0; w < threadCount; ++w) {
+            ranges[w].begin = count * w / threadCount;
+            ranges[w].end = count * (w + 1) / threadCount;
+        }
+
+        auto worker = [&](size_t w) {
+            WorkRange& own = ranges[w];
+            for (;;) {
+                size_t index = 0;
+                if (popOwn(own, index)) {
+                    task(index, w);
+                    continue;
+                }
+
+                // 隣から順に奪える範囲を探す
+                bool stolen = false;
+                for (size_t k = 1; k < threadCount && !stolen; ++k) {
+                    size_t begin = 0;
+                    size_t end = 0;
+                    if (steal(ranges[(w + k) % threadCount], begin, end)) {
+                        std::lock_guard<std::mutex> lock(own.mutex);
+                        own.begin = begin;
+                        own.end = end;
+                        stolen = true;
+                    }
+                }
+
+                // どこにも残っていなければ終了
+                // （処理中の番号は各ワーカーが自分で終わらせる）
+                if (!stolen) break;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (size_t w = 1; w < threadCount; ++w) {
+            threads.emplace_back(worker, w);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return threadCount;
+    }
+
+} // namespace Parallel
@@ -0,0 +1,32 @@
+#pragma once
+
+// work_stealing_pool.h
+// ワークスティーリングによる並列ループ
+//
+// 用語解説:
+// - ワークスティーリング(Work Stealing): 自分の担当分を終えたスレッドが、
+//   まだ残っている他のスレッドの担当分を横取りして処理する負荷分散の方法
+// - ワーカー番号: 0〜スレッド数-1。呼び出し元のスレッドが0番として参加する
+//
+// 0〜count-1の番号を最初にスレッド数で等分し、各スレッドは自分の範囲の先頭から1つずつ処理する。
+// 自分の範囲が空になったら、他のスレッドの残りの後ろ半分を奪う。
+// ファイルごとに処理時間が大きく異なる場合でも、全スレッドがほぼ同時に終わる。
+
+#include <cstddef>
+#include <functional>
+
+namespace Parallel {
+
+    // 処理内容（index: 処理対象の番号, worker: 実行中のワーカー番号）
+    // workerごとに部分集計を持てば、集計中のロックは不要になる
+    using IndexTask = std::function<void(size_t index, size_t worker)>;
+
+    // 利用可能なスレッド数（取得できなければ1）
+    size_t defaultThreadCount();
+
+    // 0〜count-1の全番号についてtaskを1回ずつ呼び出し、すべて終わるまで待つ
+    // threadCount: 0なら defaultThreadCount()。countより多い場合はcountに切り詰める
+    // 戻り値: 実際に使ったワーカー数（部分集計の数）
+    size_t forEach(size_t count, size_t threadCount, const IndexTask& task);
+
+} // namespace Parallel
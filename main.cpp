@@ -3,18 +3,25 @@
 #include <windows.h>
 #include "helper/WinAPI/terminal.h"
 #include "helper/WinAPI/timer.h"
-#include "helper/json_helper.h"
 #include "core/input_recorder.h"
 #include "core/typing_judge.h"
 #include "core/romaji_converter.h"
 #include "core/statistics.h"
 #include "core/csv_logger.h"
+#include "core/session_finalizer.h"
+#include "core/scenario_stream.h"
+#include "core/scenario_cache.h"
+#include "core/scenario_catalog.h"
 #include "helper/WinAPI/windowmaker/windowmaker.h"
 #include <vector>
 #include <filesystem>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <deque>
 
 namespace fs = std::filesystem;
 struct Cursor {
@@ -22,6 +29,12 @@ struct Cursor {
     int y;
 };
 
+// 判定待ちの押下（ゴースト押下でないと分かるまで判定しない）
+struct PendingPress {
+    size_t eventIndex;  // Recorderのイベントの位置
+    char ch;
+};
+
 int initialized_UI(const char* version) {
     std::string Char_version = "Error! Cannot get version info";
     if (version){
@@ -66,27 +79,114 @@ int initialized_UI(const char* version) {
 
 }
 
-int typing_mode() {
+// trueにするとイベントをセッションごとのCSVではなく、日ごとのイベントログ
+// （output/typing_eventlog_YYYYMMDD_NNN.csv）に追記する
+constexpr bool USE_EVENT_LOG = false;
+
+// trueにするとイベントの列指向バイナリ（typing_events_<セッションID>.evcol）も出力する
+constexpr bool WRITE_EVENT_COLUMNS = false;
+
+// trueにするとイベントCSVをブロック単位で圧縮して出力する（typing_events_<セッションID>.csv.lzb）
+constexpr bool COMPRESS_EVENT_CSV = false;
+
+// Phase 5: セッションの後処理（統計計算・CSV出力）をバックグラウンドに渡す
+// イベントと計算器はジョブに移動する（recorder・statsCalcは空になる）
+SessionFinalizer::Pending submit_session(SessionFinalizer::Finalizer& finalizer,
+                                         InputRecorder::Recorder& recorder,
+                                         std::unique_ptr<Statistics::Calculator>& statsCalc,
+                                         const TypingJudge::Judge& judge) {
+    SessionFinalizer::SessionJob job;
+    job.events = recorder.takeEvents();
+    job.calculator = std::move(statsCalc);
+    job.correctCount = judge.getCorrectCount();
+    job.incorrectCount = judge.getIncorrectCount();
+    job.outputDir = "output";
+    job.useEventLog = USE_EVENT_LOG;
+    job.writeEventColumns = WRITE_EVENT_COLUMNS;
+    job.compressEventCsv = COMPRESS_EVENT_CSV;
+    return finalizer.submit(std::move(job));
+}
+
+// Phase 5: CSV出力結果を表示
+void show_export_result(const SessionFinalizer::ExportResult& result, int line) {
+    auto size = Terminal::getTerminalSize();
+    Terminal::overwriteString(0, line, Terminal::Value_to_Blank(size.width, " "));
+    Terminal::overwriteString(0, line + 1, Terminal::Value_to_Blank(size.width, " "));
+    if (!result.eventCsvPath.empty()) {
+        Terminal::overwriteString(0, line, "Event CSV saved: " + result.eventCsvPath);
+    } else {
+        Terminal::overwriteString(0, line, "Event CSV export failed");
+    }
+    if (!result.summaryCsvPath.empty()) {
+        std::string message = "Summary CSV saved: " + result.summaryCsvPath;
+        if (result.digraphCsvPath.empty()) {
+            message += " (digraph CSV export failed)";
+        }
+        Terminal::overwriteString(0, line + 1, message);
+    } else {
+        Terminal::overwriteString(0, line + 1, "Summary CSV export failed");
+    }
+}
+
+// 途中終了時にCSV出力を待つ上限（これを過ぎたら残りはFinalizer::waitAllで待つ）
+constexpr int EXPORT_WAIT_MS = 3000;
+
+// 途中終了時: CSV出力が終わるまで（最大EXPORT_WAIT_MS）待って保存先を表示する
+// ESCはもう押されているので、もう一度押させずに戻る
+void wait_for_export(std::future<SessionFinalizer::ExportResult>& files, int line) {
+    if (files.wait_for(std::chrono::milliseconds(EXPORT_WAIT_MS)) == std::future_status::ready) {
+        show_export_result(files.get(), line);
+    }
+}
+
+// ESCキーが押されて離されるまで待つ
+// 待っている間にCSV出力が終われば保存先を表示する
+void wait_for_escape(std::future<SessionFinalizer::ExportResult>& files, int line) {
+    bool shown = false;
+    while (!(GetAsyncKeyState(VK_ESCAPE) & 0x8000)) {
+        if (!shown && files.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+            show_export_result(files.get(), line);
+            shown = true;
+        }
+        Sleep(100);
+    }
+    
+    // キーが離されるまで
+    while (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
+        Sleep(10);
+    }
+}
+
+int typing_mode(SessionFinalizer::Finalizer& finalizer) {
     // ターミナルサイズ取得
     auto size = Terminal::getTerminalSize();
     
     // Phase 2-3: scenarioファイルからtext/rubiを読み込み
     std::string scenarioPath = "scenario/scenarioexample.json";
-    auto scenarioData = JsonHelper::loadJsonFromFile(scenarioPath);
     
-    // 最初のエントリ（"1"）を取得
+    // 最初のエントリ（"1"）を取得（見つかったところで読むのをやめる）
     std::string targetText = "こんにちは";  // デフォルト
     std::string targetRubi = "konnichiha";  // デフォルト
     
-    if (scenarioData.isObject() && scenarioData["entries"].isObject()) {
-        auto entries = scenarioData["entries"];
-        if (entries["1"].isObject()) {
-            auto entry = entries["1"];
-            if (entry["text"].isString()) {
-                targetText = entry["text"].asString();
-            }
-            if (entry["rubi"].isString()) {
-                targetRubi = entry["rubi"].asString();
+    // 隣のバイナリキャッシュを使う（古ければ作り直す。書けない場所ではJSONから読む）
+    ScenarioCache::Image scenarioCache;
+    ScenarioCache::Entry cachedEntry;
+    std::string cacheError;
+    if (ScenarioCache::load(scenarioPath, scenarioCache, cacheError) != ScenarioCache::LoadStatus::FAILED) {
+        if (scenarioCache.find("1", cachedEntry)) {
+            if (!cachedEntry.text.empty()) targetText = std::string(cachedEntry.text);
+            if (!cachedEntry.rubi.empty()) targetRubi = std::string(cachedEntry.rubi);
+        }
+    } else {
+        ScenarioStream::EntryReader scenario;
+        ScenarioStream::Entry entry;
+        if (scenario.open(scenarioPath)) {
+            while (scenario.next(entry)) {
+                if (entry.key == "1") {
+                    if (!entry.text.empty()) targetText = entry.text;
+                    if (!entry.rubi.empty()) targetRubi = entry.rubi;
+                    break;
+                }
             }
         }
     }
@@ -106,9 +206,11 @@ int typing_mode() {
     recorder.startSession();
     
     // Phase 3-3: Statistics統合
-    Statistics::Calculator statsCalc;
+    // 後処理でバックグラウンドに移動するためヒープに確保
+    auto statsCalc = std::make_unique<Statistics::Calculator>();
+    statsCalc->setTrigramEnabled(true);
     uint64_t startTime = WinTimer::now_us();
-    statsCalc.startSession(startTime);
+    statsCalc->startSession(startTime);
     
     // Phase 3-4: かな入力追跡用
     RomajiConverter::Converter romajiConv;
@@ -117,6 +219,7 @@ int typing_mode() {
     
     // Phase 3-4: キーリピート防止用（前回のキー状態を記録）
     bool lastKeyStates[256] = {false};  // 全てのキーの前回の状態
+    std::deque<PendingPress> pendingPresses;  // 押下が確定するまでの待ち
     
     // Phase 2-3: 目標テキストとルビを表示
     Terminal::overwriteString(0, 4, "Target: " + targetText + " [" + targetRubi + "]");
@@ -132,28 +235,18 @@ int typing_mode() {
             
             // Phase 3-3: 統計計算（途中終了でも表示）
             uint64_t endTime = WinTimer::now_us();
-            statsCalc.endSession(endTime);
+            statsCalc->endSession(endTime);
             
-            const auto& events = recorder.getEvents();
-            for (const auto& event : events) {
-                if (event.type == InputRecorder::EventType::KEY_DOWN) {
-                    statsCalc.recordKeyDown(event.timestamp_us, event.vk_code, event.character);
-                } else if (event.type == InputRecorder::EventType::KEY_UP) {
-                    statsCalc.recordKeyUp(event.timestamp_us, event.vk_code);
-                } else if (event.type == InputRecorder::EventType::BACKSPACE) {
-                    statsCalc.recordBackspace(event.timestamp_us);
-                }
-            }
+            // Phase 5: 統計計算とCSV出力（イベント + サマリ + スケッチ + キーペア + 時系列）をバックグラウンドで実行
+            size_t eventCount = recorder.getEventCount();
+            SessionFinalizer::Pending pending = submit_session(finalizer, recorder, statsCalc, judge);
             
-            auto stats = statsCalc.calculate(judge.getCorrectCount(), judge.getIncorrectCount());
+            // 統計計算が終わったらすぐに表示（CSV出力は続行中）
+            auto stats = pending.stats.get();
             double accuracy = (stats.correctKeyCount + stats.incorrectKeyCount > 0) 
                 ? static_cast<double>(stats.correctKeyCount) / (stats.correctKeyCount + stats.incorrectKeyCount) 
                 : 0.0;
             
-            // Phase 4: CSV出力（イベント + サマリ）
-            std::string eventCsvPath = CSVLogger::writeEventCSV(recorder, "output");
-            std::string summaryCsvPath = CSVLogger::writeSummaryCSV(stats, "output");
-            
             // 画面クリア（統計情報表示エリア）
             for (int y = 0; y < size.height; ++y) {
                 Terminal::overwriteString(0, y, Terminal::Value_to_Blank(size.width, " "));
@@ -173,18 +266,17 @@ int typing_mode() {
             Terminal::overwriteString(0, size.height - 6, 
                 "Backspaces: " + std::to_string(stats.backspaceCount));
             Terminal::overwriteString(0, size.height - 4, 
-                "Session ended. Events: " + std::to_string(recorder.getEventCount()) + 
+                "Session ended. Events: " + std::to_string(eventCount) + 
                 " | Duration: " + std::to_string(stats.totalDuration / 1000) + " ms");
             
-            // Phase 4: CSV出力結果を表示
-            if (!eventCsvPath.empty()) {
-                Terminal::overwriteString(0, size.height - 3, "Event CSV saved: " + eventCsvPath);
-            }
-            if (!summaryCsvPath.empty()) {
-                Terminal::overwriteString(0, size.height - 2, "Summary CSV saved: " + summaryCsvPath);
-            }
+            // Phase 5: CSV出力は完了次第表示（固定の待ち時間は置かない）
+            Terminal::overwriteString(0, size.height - 3, "Saving CSV...");
+            wait_for_export(pending.files, size.height - 3);
             
-            Sleep(3000);  // 3秒表示
+            // 終了に使ったESCキーが離されるまで
+            while (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
+                Sleep(10);
+            }
             
             HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
             FlushConsoleInputBuffer(hStdin);
@@ -266,7 +358,6 @@ int typing_mode() {
             if (keyPressed && !lastKeyStates[key]) {
                 lastKeyStates[key] = true;
                 
-                auto& line = lines[cursor.y];
                 char ch = static_cast<char>(key);
                 if (ch >= 'A' && ch <= 'Z') {
                     bool shift = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
@@ -274,168 +365,19 @@ int typing_mode() {
                 }
                 
                 // InputRecorder: キーダウン記録
-                recorder.recordKeyDown(key, 0, ch);
-                
-                // Phase 3-4: かな入力追跡
-                uint64_t keyDownTime = WinTimer::now_us();
-                
-                // Phase 2-3: タイピング判定
-                auto result = judge.judgeChar(ch);
-                
-                // Phase 3-3: 統計データ記録
-                recorder.setLastEventCorrectness(result == TypingJudge::JudgeResult::CORRECT);
-                
-                // Phase 3-4: かな確定検知
-                if (result == TypingJudge::JudgeResult::CORRECT) {
-                    // バッファが空なら、かな入力開始
-                    if (currentRomajiBuffer.empty()) {
-                        kanaStartTime = keyDownTime;
-                    }
-                    
-                    // ローマ字バッファに追加
-                    currentRomajiBuffer += ch;
-                    
-                    // かな変換を試行
-                    auto convertResult = romajiConv.convert(currentRomajiBuffer);
-                    if (convertResult.status == RomajiConverter::ConvertStatus::MATCHED) {
-                        // かな確定！統計に記録
-                        uint64_t keyUpTime = WinTimer::now_us();
-                        statsCalc.recordKanaInput(convertResult.kana, currentRomajiBuffer, 
-                                                  kanaStartTime, keyUpTime);
-                        
-                        // バッファをクリア
-                        currentRomajiBuffer.clear();
-                        kanaStartTime = 0;
-                    }
-                    // PARTIAL（入力途中）の場合は何もせず、次の文字を待つ
-                } else if (result == TypingJudge::JudgeResult::INCORRECT) {
-                    // 誤入力時はバッファをクリア
-                    currentRomajiBuffer.clear();
-                    kanaStartTime = 0;
-                }
-                
-                // 判定結果を画面に表示（デバッグ用）
-                std::string resultStr;
-                if (result == TypingJudge::JudgeResult::CORRECT) {
-                    resultStr = "CORRECT";
-                } else if (result == TypingJudge::JudgeResult::INCORRECT) {
-                    resultStr = "INCORRECT";
-                } else {
-                    resultStr = "ALREADY_DONE";
+                // 判定は押下が確定してから（チャタリング・ゴースト押下は判定・表示に渡さない）
+                size_t eventIndex = recorder.recordKeyDown(key, 0, ch);
+                if (recorder.getPressStatus(eventIndex) != InputRecorder::PressStatus::REJECTED) {
+                    pendingPresses.push_back({eventIndex, ch});
                 }
-                Terminal::overwriteString(0, 5, "Result: " + resultStr + " | Progress: " + 
-                    std::to_string(judge.getCurrentPosition()) + "/" + std::to_string(judge.getTargetLength()) +
-                    " | Remaining: [" + judge.getRemainingRubi() + "]");
-                
-                // Phase 2-3: 完了判定（自動終了）
-                if (judge.isCompleted()) {
-                    // セッション終了
-                    recorder.endSession();
-                    
-                    // Phase 3-3: 統計計算
-                    uint64_t endTime = WinTimer::now_us();
-                    statsCalc.endSession(endTime);
-                    
-                    const auto& events = recorder.getEvents();
-                    for (const auto& event : events) {
-                        if (event.type == InputRecorder::EventType::KEY_DOWN) {
-                            statsCalc.recordKeyDown(event.timestamp_us, event.vk_code, event.character);
-                        } else if (event.type == InputRecorder::EventType::KEY_UP) {
-                            statsCalc.recordKeyUp(event.timestamp_us, event.vk_code);
-                        } else if (event.type == InputRecorder::EventType::BACKSPACE) {
-                            statsCalc.recordBackspace(event.timestamp_us);
-                        }
-                    }
-                    
-                    auto stats = statsCalc.calculate(judge.getCorrectCount(), judge.getIncorrectCount());
-                    double accuracy = (stats.correctKeyCount + stats.incorrectKeyCount > 0) 
-                        ? static_cast<double>(stats.correctKeyCount) / (stats.correctKeyCount + stats.incorrectKeyCount) 
-                        : 0.0;
-                    
-                    // Phase 4: CSV出力（イベント + サマリ）
-                    std::string eventCsvPath = CSVLogger::writeEventCSV(recorder, "output");
-                    std::string summaryCsvPath = CSVLogger::writeSummaryCSV(stats, "output");
-                    
-                    // 画面クリア（統計情報表示エリア）
-                    for (int y = 0; y < size.height; ++y) {
-                        Terminal::overwriteString(0, y, Terminal::Value_to_Blank(size.width, " "));
-                    }
-                    
-                    // 統計情報の表示
-                    Terminal::overwriteString(0, size.height - 10, "=== Typing Statistics ===");
-                    Terminal::overwriteString(0, size.height - 9, 
-                        "Accuracy: " + std::to_string(static_cast<int>(accuracy * 100)) + "%" +
-                        " | Correct: " + std::to_string(stats.correctKeyCount) +
-                        " | Incorrect: " + std::to_string(stats.incorrectKeyCount));
-                    Terminal::overwriteString(0, size.height - 8, 
-                        "WPM: " + std::to_string(static_cast<int>(stats.wpmCorrect)) +
-                        " | CPM: " + std::to_string(static_cast<int>(stats.cpmCorrect)));
-                    Terminal::overwriteString(0, size.height - 7, 
-                        "Avg Inter-key: " + std::to_string(static_cast<int>(stats.avgInterKeyInterval)) + " ms");
-                    Terminal::overwriteString(0, size.height - 6, 
-                        "Backspaces: " + std::to_string(stats.backspaceCount));
-                    
-                    // かな別入力時間の表示（上位5件）
-                    int displayLine = size.height - 5;
-                    Terminal::overwriteString(0, displayLine++, "Top 5 Kana Input Times:");
-                    int count = 0;
-                    for (const auto& [kana, time] : stats.kanaInputTime) {
-                        if (count >= 5) break;
-                        std::ostringstream oss;
-                        oss << "  " << kana << ": " << std::fixed << std::setprecision(0) << time << " ms";
-                        Terminal::overwriteString(0, displayLine++, oss.str());
-                        count++;
-                    }
-                    
-                    Terminal::overwriteString(0, size.height - 3, "*** COMPLETED! *** Press ESC to exit...");
-                    
-                    // Phase 4: CSV出力結果を表示
-                    if (!eventCsvPath.empty()) {
-                        Terminal::overwriteString(0, size.height - 2, "Event CSV saved: " + eventCsvPath);
-                    }
-                    if (!summaryCsvPath.empty()) {
-                        Terminal::overwriteString(0, size.height - 1, "Summary CSV saved: " + summaryCsvPath);
-                    }
-                    
-                    // バッファクリア（ESC待機前）
-                    HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
-                    FlushConsoleInputBuffer(hStdin);
-                    
-                    // ESCキー待ち
-                    while (!(GetAsyncKeyState(VK_ESCAPE) & 0x8000)) {
-                        Sleep(100);
-                    }
-                    
-                    // ESCキー待ち（キーが離されるまで）
-                    while (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
-                        Sleep(10);
-                    }
-                    
-                    // Phase 3-4: 終了前に画面をクリア
-                    for (int y = 0; y < size.height; ++y) {
-                        Terminal::overwriteString(0, y, Terminal::Value_to_Blank(size.width, " "));
-                    }
-                    Terminal::overwriteString(0, 0, "Thank you for using Typinger!");
-                    
-                    FlushConsoleInputBuffer(hStdin);
-                    return 0;
-                }
-                
-                // line.size()の範囲内ならどこでも挿入可能
-                if (cursor.x < 0) cursor.x = 0;
-                if (cursor.x > (int)line.size()) cursor.x = (int)line.size();
-                line.insert(cursor.x, 1, ch);
-                cursor.x++;
-                updated = true;
                 
                 // Phase 3-4: キーアップ待ちを削除（高速入力対応）
                 // キーアップ記録は次のループで処理
-                recorder.recordKeyUp(key, 0);
-                
                 break;
             } else if (!keyPressed && lastKeyStates[key]) {
                 // キーが離された
                 lastKeyStates[key] = false;
+                recorder.recordKeyUp(key, 0);
             }
         }
         
@@ -446,21 +388,41 @@ int typing_mode() {
         if (hyphenKeyPressed && !lastKeyStates[0xBD]) {
             lastKeyStates[0xBD] = true;
             
-            auto& line = lines[cursor.y];
             bool shift = (GetAsyncKeyState(VK_SHIFT) & 0x8000) != 0;
             char ch = shift ? '_' : '-';
             
             // InputRecorder: キーダウン記録
-            recorder.recordKeyDown(0xBD, 0, ch);
+            // 判定は押下が確定してから（チャタリング・ゴースト押下は判定・表示に渡さない）
+            size_t eventIndex = recorder.recordKeyDown(0xBD, 0, ch);
+            if (recorder.getPressStatus(eventIndex) != InputRecorder::PressStatus::REJECTED) {
+                pendingPresses.push_back({eventIndex, ch});
+            }
+            
+            // Phase 3-4: キーアップ待ちを削除（高速入力対応）
+            // キーアップ記録は次のループで処理
+        } else if (!hyphenKeyPressed && lastKeyStates[0xBD]) {
+            // キーが離された
+            lastKeyStates[0xBD] = false;
+            recorder.recordKeyUp(0xBD, 0);
+        }
+
+        // 確定した押下を押した順に判定する（ゴースト押下は判定・表示に渡さずに捨てる）
+        while (!pendingPresses.empty()) {
+            InputRecorder::PressStatus status = recorder.getPressStatus(pendingPresses.front().eventIndex);
+            if (status == InputRecorder::PressStatus::PENDING) break;
+            PendingPress press = pendingPresses.front();
+            pendingPresses.pop_front();
+            if (status == InputRecorder::PressStatus::REJECTED) continue;
+            char ch = press.ch;
             
             // Phase 3-4: かな入力追跡
-            uint64_t keyDownTime = WinTimer::now_us();
+            uint64_t keyDownTime = recorder.getEvents()[press.eventIndex].timestamp_us;
             
             // Phase 2-3: タイピング判定
             auto result = judge.judgeChar(ch);
             
             // Phase 3-3: 統計データ記録
-            recorder.setLastEventCorrectness(result == TypingJudge::JudgeResult::CORRECT);
+            recorder.setEventCorrectness(press.eventIndex, result == TypingJudge::JudgeResult::CORRECT);
             
             // Phase 3-4: かな確定検知
             if (result == TypingJudge::JudgeResult::CORRECT) {
@@ -477,7 +439,7 @@ int typing_mode() {
                 if (convertResult.status == RomajiConverter::ConvertStatus::MATCHED) {
                     // かな確定！統計に記録
                     uint64_t keyUpTime = WinTimer::now_us();
-                    statsCalc.recordKanaInput(convertResult.kana, currentRomajiBuffer, 
+                    statsCalc->recordKanaInput(convertResult.kana, currentRomajiBuffer, 
                                               kanaStartTime, keyUpTime);
                     
                     // バッファをクリア
@@ -491,7 +453,7 @@ int typing_mode() {
                 kanaStartTime = 0;
             }
             
-            // 判定結果を画面に表示
+            // 判定結果を画面に表示（デバッグ用）
             std::string resultStr;
             if (result == TypingJudge::JudgeResult::CORRECT) {
                 resultStr = "CORRECT";
@@ -511,28 +473,17 @@ int typing_mode() {
                 
                 // Phase 3-3: 統計計算
                 uint64_t endTime = WinTimer::now_us();
-                statsCalc.endSession(endTime);
+                statsCalc->endSession(endTime);
                 
-                const auto& events = recorder.getEvents();
-                for (const auto& event : events) {
-                    if (event.type == InputRecorder::EventType::KEY_DOWN) {
-                        statsCalc.recordKeyDown(event.timestamp_us, event.vk_code, event.character);
-                    } else if (event.type == InputRecorder::EventType::KEY_UP) {
-                        statsCalc.recordKeyUp(event.timestamp_us, event.vk_code);
-                    } else if (event.type == InputRecorder::EventType::BACKSPACE) {
-                        statsCalc.recordBackspace(event.timestamp_us);
-                    }
-                }
+                // Phase 5: 統計計算とCSV出力（イベント + サマリ + スケッチ + キーペア + 時系列）をバックグラウンドで実行
+                SessionFinalizer::Pending pending = submit_session(finalizer, recorder, statsCalc, judge);
                 
-                auto stats = statsCalc.calculate(judge.getCorrectCount(), judge.getIncorrectCount());
+                // 統計計算が終わったらすぐに表示（CSV出力は続行中）
+                auto stats = pending.stats.get();
                 double accuracy = (stats.correctKeyCount + stats.incorrectKeyCount > 0) 
                     ? static_cast<double>(stats.correctKeyCount) / (stats.correctKeyCount + stats.incorrectKeyCount) 
                     : 0.0;
                 
-                // Phase 4: CSV出力（イベント + サマリ）
-                std::string eventCsvPath = CSVLogger::writeEventCSV(recorder, "output");
-                std::string summaryCsvPath = CSVLogger::writeSummaryCSV(stats, "output");
-                
                 // 画面クリア（統計情報表示エリア）
                 for (int y = 0; y < size.height; ++y) {
                     Terminal::overwriteString(0, y, Terminal::Value_to_Blank(size.width, " "));
@@ -566,27 +517,15 @@ int typing_mode() {
                 
                 Terminal::overwriteString(0, size.height - 3, "*** COMPLETED! *** Press ESC to exit...");
                 
-                // Phase 4: CSV出力結果を表示
-                if (!eventCsvPath.empty()) {
-                    Terminal::overwriteString(0, size.height - 2, "Event CSV saved: " + eventCsvPath);
-                }
-                if (!summaryCsvPath.empty()) {
-                    Terminal::overwriteString(0, size.height - 1, "Summary CSV saved: " + summaryCsvPath);
-                }
+                // Phase 5: CSV出力は完了次第表示
+                Terminal::overwriteString(0, size.height - 2, "Saving CSV...");
                 
                 // バッファクリア（ESC待機前）
                 HANDLE hStdin = GetStdHandle(STD_INPUT_HANDLE);
                 FlushConsoleInputBuffer(hStdin);
                 
-                // ESCキー待ち
-                while (!(GetAsyncKeyState(VK_ESCAPE) & 0x8000)) {
-                    Sleep(100);
-                }
-                
-                // ESCキー待ち（キーが離されるまで）
-                while (GetAsyncKeyState(VK_ESCAPE) & 0x8000) {
-                    Sleep(10);
-                }
+                // ESCキー待ち（待っている間に出力が終われば保存先を表示）
+                wait_for_escape(pending.files, size.height - 2);
                 
                 // Phase 3-4: 終了前に画面をクリア
                 for (int y = 0; y < size.height; ++y) {
@@ -599,18 +538,12 @@ int typing_mode() {
             }
             
             // line.size()の範囲内ならどこでも挿入可能
+            auto& line = lines[cursor.y];
             if (cursor.x < 0) cursor.x = 0;
             if (cursor.x > (int)line.size()) cursor.x = (int)line.size();
             line.insert(cursor.x, 1, ch);
             cursor.x++;
             updated = true;
-            
-            // Phase 3-4: キーアップ待ちを削除（高速入力対応）
-            // キーアップ記録は次のループで処理
-            recorder.recordKeyUp(0xBD, 0);
-        } else if (!hyphenKeyPressed && lastKeyStates[0xBD]) {
-            // キーが離された
-            lastKeyStates[0xBD] = false;
         }
 
         // 入力があった時だけ描画
@@ -703,13 +636,18 @@ int view_mode(const std::string& filePath) {
 }
 
 std::string select_file(const fs::path& exeDir) {
-    std::vector<fs::path> files;
+    // シナリオのカタログ（前回の目録を読み、変わったファイルだけを読み直して保存する）
+    ScenarioCatalog::Catalog catalog;
     if(fs::exists(exeDir) && fs::is_directory(exeDir)) {
-        for (auto& entry : fs::directory_iterator(exeDir)) {
-            if (fs::is_regular_file(entry.path())) {
-                files.push_back(entry.path());
-            }
-        }
+        std::string catalogPath = (exeDir / ScenarioCatalog::CATALOG_FILENAME).string();
+        catalog.load(catalogPath);
+        catalog.refresh(exeDir.string());
+        catalog.save(catalogPath);
+    }
+
+    std::vector<fs::path> files;
+    for (const auto& info : catalog.scenarios()) {
+        files.push_back(exeDir / fs::u8path(info.path));
     }
 
     if (files.empty()) {
@@ -720,7 +658,15 @@ std::string select_file(const fs::path& exeDir) {
     Terminal::clearScreen();
     Terminal::overwriteString(0, 0, "Select a file to view at startup (press number, or ESC to skip):");
     for (size_t i = 0; i < files.size() && i < static_cast<size_t>(size.height - 2); ++i) {
-        Terminal::overwriteString(0, i + 1, std::to_string(i + 1) + ": " + files[i].filename().string());
+        const auto& info = catalog.scenarios()[i];
+        std::string label = info.path;
+        if (!info.ok) {
+            label += " (読み込めません)";
+        } else {
+            if (!info.name.empty()) label += " - " + info.name;
+            label += " [" + std::to_string(info.entries.size()) + "]";
+        }
+        Terminal::overwriteString(0, i + 1, std::to_string(i + 1) + ": " + label);
     }
 
     while (true) {
@@ -782,7 +728,15 @@ int main() {
     // UI再描画
     initialized_UI(version);
 
-    typing_mode();
+    // セッション終了後のCSV出力を行うバックグラウンドキュー
+    SessionFinalizer::Finalizer finalizer;
+    typing_mode(finalizer);
+
+    // 出力が残っていれば終わるまで待つ
+    if (finalizer.pendingCount() > 0) {
+        Terminal::overwriteString(0, 1, "Saving CSV files...");
+        finalizer.waitAll();
+    }
 
     return 0;
 }
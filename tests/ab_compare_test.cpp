@@ -0,0 +1,216 @@
+// ab_compare_test.cpp
+// A/B比較（検定・効果量・ブートストラップ）とイベントCSV読み込みのユニットテスト
+
+#include "../core/ab_compare.h"
+#include "../core/csv_reader.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+using namespace ABCompare;
+
+bool doubleEquals(double a, double b, double epsilon = 0.001) {
+    return std::abs(a - b) < epsilon;
+}
+
+// テスト1: 完全に分離した2群
+void test_mann_whitney_separated() {
+    std::cout << "Test: Mann-Whitney U (separated groups)..." << std::endl;
+
+    std::vector<double> a = {1, 2, 3, 4, 5};
+    std::vector<double> b = {6, 7, 8, 9, 10};
+
+    MannWhitneyResult r = mannWhitneyU(a, b);
+    assert(doubleEquals(r.u, 25.0));
+    assert(doubleEquals(r.z, 2.507, 0.01));
+    assert(doubleEquals(r.pValue, 0.0122, 0.001));
+    assert(doubleEquals(cliffsDelta(r, a.size(), b.size()), 1.0));
+
+    // 向きを入れ替えると符号が反転
+    MannWhitneyResult rev = mannWhitneyU(b, a);
+    assert(doubleEquals(rev.u, 0.0));
+    assert(doubleEquals(cliffsDelta(rev, b.size(), a.size()), -1.0));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 同順位を含む場合
+void test_mann_whitney_ties() {
+    std::cout << "Test: Mann-Whitney U (ties)..." << std::endl;
+
+    std::vector<double> a = {1, 2, 2, 3};
+    std::vector<double> b = {2, 3, 3, 4};
+
+    // Bが大きい組: 各bについて (a<b) + 0.5*(a==b)
+    // b=2: 1 + 0.5*2 = 2, b=3: 3 + 0.5 = 3.5 (×2), b=4: 4 → 13
+    MannWhitneyResult r = mannWhitneyU(a, b);
+    assert(doubleEquals(r.u, 13.0));
+    assert(r.pValue > 0.05 && r.pValue < 1.0);
+
+    // 全て同じ値なら差なし
+    std::vector<double> same = {5, 5, 5};
+    MannWhitneyResult s = mannWhitneyU(same, same);
+    assert(doubleEquals(s.pValue, 1.0));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: Cohenのd
+void test_cohens_d() {
+    std::cout << "Test: Cohen's d..." << std::endl;
+
+    std::vector<double> a = {1, 2, 3, 4, 5};     // 平均3, 分散2.5
+    std::vector<double> b = {3, 4, 5, 6, 7};     // 平均5, 分散2.5
+    assert(doubleEquals(cohensD(a, b), 2.0 / std::sqrt(2.5)));
+    assert(doubleEquals(cohensD(b, a), -2.0 / std::sqrt(2.5)));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: ブートストラップの再現性（スレッド数によらない）
+void test_bootstrap_reproducible() {
+    std::cout << "Test: Bootstrap reproducibility..." << std::endl;
+
+    std::vector<double> a;
+    std::vector<double> b;
+    for (int i = 0; i < 200; ++i) {
+        a.push_back(60.0 + (i * 37 % 100) / 10.0);   // 平均 約65
+        b.push_back(63.0 + (i * 53 % 100) / 10.0);   // 平均 約68
+    }
+
+    BootstrapOptions options;
+    options.resamples = 2000;
+    options.seed = 42;
+
+    options.threads = 1;
+    ConfidenceInterval single = bootstrapMeanDiff(a, b, options);
+    options.threads = 4;
+    ConfidenceInterval multi = bootstrapMeanDiff(a, b, options);
+
+    assert(single.low == multi.low);
+    assert(single.high == multi.high);
+
+    // 真の差（約3）を含み、0を含まない
+    assert(single.low < 3.0 && single.high > 3.0);
+    assert(single.low > 0.0);
+
+    // シードを変えると変わる
+    options.seed = 43;
+    ConfidenceInterval other = bootstrapMeanDiff(a, b, options);
+    assert(other.low != single.low || other.high != single.high);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: イベントCSVの読み込み（エスケープの逆変換）
+void test_read_event_csv() {
+    std::cout << "Test: Read event CSV..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/typing_events_20250101_000000.csv";
+    {
+        std::ofstream file(path);
+        file << "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note\n";
+        file << "1000,KEY_DOWN,65,30,a,1,0,\n";
+        file << "2000,KEY_DOWN,188,51,\\,,0,1000,\n";       // カンマ
+        file << "3000,KEY_DOWN,220,43,\\,1,1000,\n";        // バックスラッシュ
+        file << "3500,KEY_DOWN,220,43,\\,1,500,chatter\n";  // チャタリング
+        file << "4000,KEY_UP,65,30,,0,0,\n";
+        file << "5000,BACKSPACE,8,14,,0,0,\n";
+        file << "broken line\n";                            // 読み飛ばす
+    }
+
+    std::vector<InputRecorder::InputEvent> events;
+    assert(CSVReader::readEventCSV(path, events));
+    assert(events.size() == 6);
+    assert(events[0].character == 'a' && events[0].is_correct);
+    assert(events[1].character == ',' && !events[1].is_correct);
+    assert(events[1].inter_key_time_us == 1000);
+    assert(events[2].character == '\\' && events[2].is_correct);
+    assert(events[3].suspect == InputRecorder::Suspect::CHATTER);
+    assert(events[4].type == InputRecorder::EventType::KEY_UP && events[4].character == '\0');
+    assert(events[5].type == InputRecorder::EventType::BACKSPACE);
+
+    std::vector<std::string> listed = CSVReader::listEventCSV("test_output");
+    assert(listed.size() == 1);
+
+    // イベントCSVでないファイル
+    assert(!CSVReader::readEventCSV("test_output/not_found.csv", events));
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: セッション指標と全体比較
+void test_measure_and_compare() {
+    std::cout << "Test: Measure sessions and compare..." << std::endl;
+
+    // 100msごと（A）と80msごと（B）に60キー、Aは10回に1回ミス
+    auto makeSession = [](uint64_t stepUs, int missEvery, uint64_t jitter) {
+        std::vector<InputRecorder::InputEvent> events;
+        for (int i = 0; i < 60; ++i) {
+            uint64_t t = i * stepUs + (i % 3) * jitter;
+            events.emplace_back(InputRecorder::EventType::KEY_DOWN, t, 'A', 30, 'a');
+            events.back().is_correct = missEvery == 0 || i % missEvery != 0;
+            events.emplace_back(InputRecorder::EventType::KEY_UP, t + 40000, 'A', 30);
+        }
+        return events;
+    };
+
+    std::vector<SessionMetrics> a;
+    std::vector<SessionMetrics> b;
+    for (uint64_t j = 0; j < 8; ++j) {
+        auto ea = makeSession(100000, 10, j * 1000);
+        auto eb = makeSession(80000, 0, j * 1000);
+        a.push_back(measureSession(ea));
+        b.push_back(measureSession(eb));
+    }
+    assert(doubleEquals(a[0].accuracy, 90.0));
+    assert(doubleEquals(a[0].interKeyInterval, 100.0));
+    assert(doubleEquals(b[0].accuracy, 100.0));
+
+    // 判定に渡していないキーダウン（ゴースト押下・Shift）は正確率に含めない
+    auto ec = makeSession(100000, 0, 0);
+    ec.emplace_back(InputRecorder::EventType::KEY_DOWN, 6000000, 'B', 48, 'b');
+    ec.back().suspect = InputRecorder::Suspect::GHOST;
+    ec.emplace_back(InputRecorder::EventType::KEY_DOWN, 6100000, 0x10, 42);
+    assert(doubleEquals(measureSession(ec).accuracy, 100.0));
+
+    BootstrapOptions options;
+    options.resamples = 500;
+    std::vector<MetricComparison> results = compare(a, b, options);
+    assert(results.size() == METRIC_COUNT);
+
+    const MetricComparison& wpm = results[0];
+    assert(wpm.name == "wpm");
+    assert(wpm.meanDiff > 0.0);
+    assert(wpm.test.pValue < 0.01);
+    assert(doubleEquals(wpm.cliffsDelta, 1.0));
+
+    const MetricComparison& interval = results[2];
+    assert(interval.meanDiff < 0.0);
+    assert(interval.ci.high < 0.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== A/B Compare Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_mann_whitney_separated();
+    test_mann_whitney_ties();
+    test_cohens_d();
+    test_bootstrap_reproducible();
+    test_read_event_csv();
+    test_measure_and_compare();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
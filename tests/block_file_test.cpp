@@ -0,0 +1,280 @@
+// block_file_test.cpp
+// LZブロック圧縮とブロック単位で圧縮したファイルのユニットテスト
+
+#include "../helper/lz_block.h"
+#include "../helper/block_file.h"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// 圧縮→復号で元に戻ることを確認し、圧縮後のバイト数を返す
+static size_t roundTrip(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed(LZBlock::compressBound(data.size()));
+    size_t size = LZBlock::compress(data.data(), data.size(), compressed.data(), compressed.size());
+    assert(size > 0 && size <= compressed.size());
+
+    std::vector<uint8_t> restored(data.size());
+    assert(LZBlock::decompress(compressed.data(), size, restored.data(), restored.size()));
+    assert(restored == data);
+    return size;
+}
+
+static std::vector<uint8_t> bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+// イベントCSVに似た行（数値だけが変わる）
+static std::string eventLines(size_t count) {
+    std::mt19937 rng(1);
+    std::string text;
+    uint64_t timestamp = 1000000;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t interval = 60000 + rng() % 200000;
+        timestamp += interval;
+        text += std::to_string(timestamp) + ",KEY_DOWN,65,30,a,1," + std::to_string(interval) + ",\n";
+        text += std::to_string(timestamp + 40000) + ",KEY_UP,65,30,,0,0,\n";
+    }
+    return text;
+}
+
+// テスト1: さまざまなデータで元に戻る
+void test_lz_round_trip() {
+    std::cout << "Test: LZ block round trip..." << std::endl;
+
+    // 空・一致を探さない短いデータ
+    roundTrip({});
+    roundTrip(bytes("a"));
+    roundTrip(bytes("abcdabcdabcd"));
+
+    // 同じバイトの繰り返し（重なる参照）は大きく縮む
+    std::vector<uint8_t> run(100000, 'x');
+    assert(roundTrip(run) < 1000);
+
+    // 乱数は縮まないが、上限を超えない
+    std::mt19937 rng(7);
+    std::vector<uint8_t> noise(70000);
+    for (auto& b : noise) b = static_cast<uint8_t>(rng());
+    assert(roundTrip(noise) <= LZBlock::compressBound(noise.size()));
+
+    // イベントCSVの行
+    std::vector<uint8_t> csv = bytes(eventLines(5000));
+    size_t size = roundTrip(csv);
+    assert(size * 2 < csv.size());
+
+    std::cout << "  Event lines: " << csv.size() << " -> " << size << " bytes" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 壊れたデータは範囲外を読み書きせずに失敗する
+void test_lz_corrupt() {
+    std::cout << "Test: LZ block rejects corrupt data..." << std::endl;
+
+    std::vector<uint8_t> data = bytes(eventLines(200));
+    std::vector<uint8_t> compressed(LZBlock::compressBound(data.size()));
+    size_t size = LZBlock::compress(data.data(), data.size(), compressed.data(), compressed.size());
+    compressed.resize(size);
+    std::vector<uint8_t> out(data.size());
+
+    // 途中で切れている・長さが違う
+    assert(!LZBlock::decompress(compressed.data(), size / 2, out.data(), out.size()));
+    assert(!LZBlock::decompress(compressed.data(), size, out.data(), out.size() - 1));
+    std::vector<uint8_t> larger(data.size() + 1);
+    assert(!LZBlock::decompress(compressed.data(), size, larger.data(), larger.size()));
+
+    // 出力の先頭より前を参照する（リテラル1バイトの後に距離2の参照）
+    const uint8_t badOffset[] = {0x10, 'a', 0x02, 0x00, 0x00};
+    assert(!LZBlock::decompress(badOffset, sizeof(badOffset), out.data(), 10));
+
+    // どのバイトを壊しても落ちない（成功する場合もあるが、長さは必ず一致する）
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 2000; ++trial) {
+        std::vector<uint8_t> broken = compressed;
+        broken[rng() % broken.size()] = static_cast<uint8_t>(rng());
+        LZBlock::decompress(broken.data(), broken.size(), out.data(), out.size());
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: ブロック単位で圧縮したファイルの書き込みと部分読み込み
+void test_block_file() {
+    std::cout << "Test: Block file write and partial read..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/blocks.csv.lzb";
+    std::string text = eventLines(20000);
+
+    // 小さなブロックで、ブロック境界をまたぐ書き込みを混ぜる
+    const size_t blockSize = 4096;
+    {
+        BlockFile::Writer writer;
+        assert(writer.open(path, blockSize));
+        size_t pos = 0;
+        size_t step = 1;
+        while (pos < text.size()) {
+            size_t n = std::min(step, text.size() - pos);
+            writer.write(text.data() + pos, n);
+            pos += n;
+            step = step * 3 % 10007 + 1;
+        }
+        assert(writer.close());
+    }
+    assert(BlockFile::isCompressedPath(path));
+    assert(fs::file_size(path) * 2 < text.size());
+
+    BlockFile::Reader reader;
+    assert(reader.open(path));
+    assert(reader.rawSize() == text.size());
+    assert(reader.blockCount() == (text.size() + blockSize - 1) / blockSize);
+
+    std::vector<char> all;
+    assert(reader.readAll(all));
+    assert(std::string(all.begin(), all.end()) == text);
+    assert(reader.blocksDecoded() == reader.blockCount());
+
+    // 1ブロックの中・2ブロックにまたがる範囲は、そのブロックだけを復号する
+    BlockFile::Reader partial;
+    assert(partial.open(path));
+    std::vector<char> part;
+    assert(partial.read(blockSize * 5 + 100, 200, part));
+    assert(std::string(part.begin(), part.end()) == text.substr(blockSize * 5 + 100, 200));
+    assert(partial.blocksDecoded() == 1);
+    assert(partial.read(blockSize * 7 - 10, 20, part));
+    assert(std::string(part.begin(), part.end()) == text.substr(blockSize * 7 - 10, 20));
+    assert(partial.blocksDecoded() == 3);
+
+    // 末尾まで・範囲外
+    assert(partial.read(text.size() - 5, 5, part));
+    assert(std::string(part.begin(), part.end()) == text.substr(text.size() - 5));
+    assert(!partial.read(text.size() - 5, 6, part));
+
+    fs::remove_all("test_output");
+
+    std::cout << "  Compressed " << text.size() << " bytes into " << reader.blockCount() << " blocks" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 空のファイル・書き込み途中のファイル・別形式のファイル
+void test_block_file_invalid() {
+    std::cout << "Test: Block file rejects incomplete files..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/empty.lzb";
+    {
+        BlockFile::Writer writer;
+        assert(writer.open(path));
+        assert(writer.close());
+    }
+    BlockFile::Reader reader;
+    assert(reader.open(path));
+    assert(reader.rawSize() == 0 && reader.blockCount() == 0);
+    std::vector<char> out;
+    assert(reader.readAll(out) && out.empty());
+
+    // 末尾の索引がない（書き込み途中で終了した）ファイル
+    std::string text = eventLines(1000);
+    {
+        BlockFile::Writer writer;
+        assert(writer.open(path, 1024));
+        writer.write(text.data(), text.size());
+        assert(writer.close());
+    }
+    fs::resize_file(path, fs::file_size(path) - 1);
+    assert(!reader.open(path));
+
+    // 圧縮していないCSV
+    { std::ofstream("test_output/plain.csv.lzb") << text; }
+    assert(!reader.open("test_output/plain.csv.lzb"));
+    assert(!reader.open("test_output/missing.lzb"));
+
+    // 開けない出力先
+    BlockFile::Writer writer;
+    assert(!writer.open("test_output/missing/dir/file.lzb"));
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: 複数のファイルを同時に書く（圧縮のスレッドを共有しても混ざらない）
+void test_block_file_concurrent() {
+    std::cout << "Test: Concurrent block file writers..." << std::endl;
+
+    fs::create_directories("test_output");
+    const size_t writerCount = 4;
+    std::vector<std::string> texts;
+    for (size_t w = 0; w < writerCount; ++w) {
+        texts.push_back(eventLines(3000 + 500 * w));
+    }
+
+    // 交互に少しずつ書く
+    std::vector<BlockFile::Writer> writers(writerCount);
+    for (size_t w = 0; w < writerCount; ++w) {
+        assert(writers[w].open("test_output/writer" + std::to_string(w) + ".lzb", 1024));
+    }
+    std::vector<size_t> written(writerCount, 0);
+    bool remaining = true;
+    while (remaining) {
+        remaining = false;
+        for (size_t w = 0; w < writerCount; ++w) {
+            size_t n = std::min<size_t>(700, texts[w].size() - written[w]);
+            writers[w].write(texts[w].data() + written[w], n);
+            written[w] += n;
+            remaining = remaining || written[w] < texts[w].size();
+        }
+    }
+    for (size_t w = 0; w < writerCount; ++w) {
+        assert(writers[w].close());
+    }
+
+    // 別のスレッドから同時に書く
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < writerCount; ++w) {
+        threads.emplace_back([&texts, w]() {
+            BlockFile::Writer writer;
+            assert(writer.open("test_output/thread" + std::to_string(w) + ".lzb", 1024));
+            writer.write(texts[w].data(), texts[w].size());
+            assert(writer.close());
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    for (const char* prefix : {"test_output/writer", "test_output/thread"}) {
+        for (size_t w = 0; w < writerCount; ++w) {
+            BlockFile::Reader reader;
+            assert(reader.open(prefix + std::to_string(w) + ".lzb"));
+            std::vector<char> all;
+            assert(reader.readAll(all));
+            assert(std::string(all.begin(), all.end()) == texts[w]);
+        }
+    }
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Block File Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_lz_round_trip();
+    test_lz_corrupt();
+    test_block_file();
+    test_block_file_invalid();
+    test_block_file_concurrent();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
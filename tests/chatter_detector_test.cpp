@@ -0,0 +1,133 @@
+// chatter_detector_test.cpp
+// チャタリング・ゴースト押下検出のユニットテスト
+
+#include "../core/chatter_detector.h"
+#include <iostream>
+#include <cassert>
+
+using namespace InputRecorder;
+
+// テスト1: 通常の打鍵は検出しない
+void test_normal_typing() {
+    std::cout << "Test: Normal typing..." << std::endl;
+
+    ChatterDetector detector;
+
+    // 'A'を80ms押下し、200ms後に再度押下
+    assert(detector.onKeyDown('A', 0) == Suspect::NONE);
+    assert(detector.onKeyUp('A', 80000) == Suspect::NONE);
+    assert(detector.onKeyDown('A', 280000) == Suspect::NONE);
+    assert(detector.onKeyUp('A', 350000) == Suspect::NONE);
+
+    assert(detector.getTotalBounceCount() == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: KEY_DOWN→KEY_UP→KEY_DOWNが数ミリ秒以内（チャタリング）
+void test_chatter() {
+    std::cout << "Test: Chatter detection..." << std::endl;
+
+    ChatterDetector detector;
+
+    assert(detector.onKeyDown('A', 0) == Suspect::NONE);
+    assert(detector.onKeyUp('A', 60000) == Suspect::NONE);
+    assert(detector.onKeyDown('A', 62000) == Suspect::CHATTER);  // 2ms後に再入力
+    assert(detector.onKeyUp('A', 70000) == Suspect::CHATTER);    // 解放も同じ押下として扱う
+
+    // 別のキーは影響を受けない
+    assert(detector.onKeyDown('B', 71000) == Suspect::NONE);
+
+    assert(detector.getBounceCount('A') == 1);
+    assert(detector.getBounceCount('B') == 0);
+    assert(detector.getTotalBounceCount() == 1);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 押下時間が極端に短い（ゴースト押下）
+void test_ghost_press() {
+    std::cout << "Test: Ghost press detection..." << std::endl;
+
+    ChatterDetector detector;
+
+    assert(detector.onKeyDown('C', 100000) == Suspect::NONE);
+    assert(detector.onKeyUp('C', 101000) == Suspect::GHOST);  // 1ms
+
+    assert(detector.getBounceCount('C') == 1);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 閾値の設定
+void test_config() {
+    std::cout << "Test: Configurable thresholds..." << std::endl;
+
+    ChatterConfig config;
+    config.chatterWindowUs = 20000;  // 20ms
+    config.ghostMaxDwellUs = 0;      // ゴースト判定を無効化
+
+    ChatterDetector detector(config);
+
+    assert(detector.onKeyDown('A', 0) == Suspect::NONE);
+    assert(detector.onKeyUp('A', 500) == Suspect::NONE);       // ゴースト判定なし
+    assert(detector.onKeyDown('A', 15000) == Suspect::CHATTER); // 20ms未満
+
+    assert(detector.getConfig().chatterWindowUs == 20000);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: リセット（閾値は保持）
+void test_reset() {
+    std::cout << "Test: Reset..." << std::endl;
+
+    ChatterConfig config;
+    config.chatterWindowUs = 20000;
+    ChatterDetector detector(config);
+
+    detector.onKeyDown('A', 0);
+    detector.onKeyUp('A', 50000);
+    detector.onKeyDown('A', 51000);
+    assert(detector.getTotalBounceCount() == 1);
+
+    detector.reset();
+
+    assert(detector.getTotalBounceCount() == 0);
+    assert(detector.getBounceCount('A') == 0);
+    assert(detector.getConfig().chatterWindowUs == 20000);
+    // リセット後の最初の押下は検出しない
+    assert(detector.onKeyDown('A', 52000) == Suspect::NONE);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: 範囲外のVK
+void test_out_of_range() {
+    std::cout << "Test: Out-of-range VK..." << std::endl;
+
+    ChatterDetector detector;
+
+    assert(detector.onKeyDown(-1, 0) == Suspect::NONE);
+    assert(detector.onKeyUp(1000, 10) == Suspect::NONE);
+    assert(detector.getBounceCount(1000) == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Chatter Detector Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_normal_typing();
+    test_chatter();
+    test_ghost_press();
+    test_config();
+    test_reset();
+    test_out_of_range();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -4,9 +4,14 @@
 #include <filesystem>
 #include <cassert>
 #include <sstream>
+#include <cmath>
+#include <set>
+#include <thread>
+#include <vector>
 #include "../core/csv_logger.h"
 #include "../core/input_recorder.h"
 #include "../core/statistics.h"
+#include "../core/csv_reader.h"
 
 namespace fs = std::filesystem;
 
@@ -336,6 +341,430 @@ void test_summary_csv_format() {
     std::cout << "  PASS" << std::endl;
 }
 
+// Test 9b: チャタリング検出数のサマリ出力とイベントへの印付け
+void test_bounce_summary() {
+    std::cout << "Test: Bounce counts in summary..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    // 閾値を大きくしてテスト中の実時間でも確実に検出させる
+    InputRecorder::ChatterConfig config;
+    config.chatterWindowUs = 10000000;  // 10秒
+    config.ghostMaxDwellUs = 0;
+    
+    InputRecorder::Recorder recorder;
+    recorder.setChatterConfig(config);
+    recorder.startSession();
+    recorder.recordKeyDown(65, 0, 'a');
+    assert(!recorder.isLastEventSuspect());
+    recorder.recordKeyUp(65, 0);
+    recorder.recordKeyDown(65, 0, 'a');
+    assert(recorder.isLastEventSuspect());
+    recorder.endSession();
+    
+    const auto& events = recorder.getEvents();
+    assert(events.back().suspect == InputRecorder::Suspect::CHATTER);
+    assert(events.back().note == "chatter");
+    assert(recorder.getChatterDetector().getBounceCount(65) == 1);
+    
+    Statistics::StatisticsData stats;
+    stats.bounceCount = 1;
+    stats.bounceCountByKey[65] = 1;
+    std::string filepath = CSVLogger::writeSummaryCSV(stats, "test_output");
+    
+    std::ifstream file(filepath);
+    std::string line;
+    bool foundTotal = false;
+    bool foundKey = false;
+    while (std::getline(file, line)) {
+        if (line == "bounce_count,1,events") foundTotal = true;
+        if (line == "bounce_count_vk_65,1,events") foundKey = true;
+    }
+    assert(foundTotal);
+    assert(foundKey);
+    file.close();
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// Test 9c: ゴースト押下は押下時間が分かるまで判定に渡さない
+void test_press_status() {
+    std::cout << "Test: Press status holds back ghost presses..." << std::endl;
+    
+    // 閾値を大きくしてテスト中の実時間でも確実にゴースト押下と判定させる
+    InputRecorder::ChatterConfig config;
+    config.chatterWindowUs = 0;
+    config.ghostMaxDwellUs = 10000000;  // 10秒
+    
+    InputRecorder::Recorder recorder;
+    recorder.setChatterConfig(config);
+    recorder.startSession();
+    size_t ghost = recorder.recordKeyDown(65, 0, 'a');
+    size_t held = recorder.recordKeyDown(66, 0, 'b');
+    assert(recorder.getPressStatus(ghost) == InputRecorder::PressStatus::PENDING);
+    recorder.recordKeyUp(65, 0);
+    assert(recorder.getPressStatus(ghost) == InputRecorder::PressStatus::REJECTED);
+    assert(recorder.getPressStatus(held) == InputRecorder::PressStatus::PENDING);
+    
+    // ゴースト判定を無効にすれば押下時点で確定
+    config.ghostMaxDwellUs = 0;
+    recorder.setChatterConfig(config);
+    assert(recorder.getPressStatus(held) == InputRecorder::PressStatus::ACCEPTED);
+    recorder.setEventCorrectness(held, true);
+    recorder.endSession();
+    assert(recorder.getEvents()[held].is_correct);
+    assert(recorder.recordKeyDown(67, 0, 'c') == InputRecorder::NO_EVENT);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// Test 10: キーペア遷移時間CSV出力
+void test_digraph_csv() {
+    std::cout << "Test: Digraph CSV..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    Statistics::DigraphMatrix digraphs;
+    digraphs.add('k', 'a', 100000);
+    digraphs.add('k', 'a', 200000);
+    digraphs.add(',', 'a', 50000);
+    
+    std::string filepath = CSVLogger::writeDigraphCSV(digraphs, "test_output");
+    assert(!filepath.empty());
+    assert(fs::exists(filepath));
+    
+    std::ifstream file(filepath);
+    std::string line;
+    std::getline(file, line);
+    assert(line.find("from,to,count,mean_ms,") == 0);
+    
+    // 遷移のあったセルのみ出力される
+    int rowCount = 0;
+    bool foundKa = false;
+    while (std::getline(file, line)) {
+        rowCount++;
+        if (line.find("k,a,2,150.00,") == 0) foundKa = true;
+    }
+    assert(rowCount == 2);
+    assert(foundKa);
+    file.close();
+    
+    // トライグラムは登録がなければ出力しない
+    Statistics::TrigramTable trigrams;
+    assert(CSVLogger::writeTrigramCSV(trigrams, "test_output").empty());
+    
+    std::cout << "  Output file: " << filepath << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// 移動窓時系列CSVのテスト
+void test_timeseries_csv() {
+    std::cout << "Test: Time series CSV..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    Statistics::TimeSeriesConfig config;
+    config.windowUs = 2000000;  // 2秒
+    config.stepUs = 1000000;    // 1秒
+    Statistics::TimeSeries series(config);
+    series.begin(0);
+    for (uint64_t t = 0; t < 3000000; t += 250000) {
+        series.addKeyDown(t, true);
+    }
+    series.finish(3000000);
+    
+    std::string filepath = CSVLogger::writeTimeSeriesCSV(series, "test_output");
+    assert(!filepath.empty());
+    assert(filepath.find("typing_timeseries_") != std::string::npos);
+    
+    std::ifstream file(filepath);
+    std::string line;
+    std::getline(file, line);
+    assert(line.find("elapsed_s,span_s,samples,wpm_mean,") == 0);
+    
+    // 1秒ごとに3点（2秒目以降は240CPM = 48WPM）
+    int rowCount = 0;
+    bool foundSteady = false;
+    while (std::getline(file, line)) {
+        rowCount++;
+        if (line.find("2.00,0.00,1,48.00,48.00,48.00,240.00,") == 0) foundSteady = true;
+    }
+    assert(rowCount == 3);
+    assert(foundSteady);
+    file.close();
+    
+    std::cout << "  Output file: " << filepath << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_sketch_csv() {
+    std::cout << "Test: Sketch CSV..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    Statistics::SessionSketches sketches;
+    for (int i = 1; i <= 1000; ++i) {
+        sketches.interval.add(static_cast<double>(i));
+        sketches.dwell.add(50.0 + (i % 20));
+    }
+    sketches.kana["し"].add(180.0);
+    sketches.kana["し"].add(220.0);
+    sketches.kana["た"].add(1.0 / 3.0);
+    
+    std::string filepath = CSVLogger::writeSketchCSV(sketches, "test_output");
+    assert(!filepath.empty());
+    assert(filepath.find("typing_sketch_") != std::string::npos);
+    
+    std::ifstream file(filepath);
+    std::string line;
+    std::getline(file, line);
+    assert(line == "sketch,count,min,max,centroids");
+    std::getline(file, line);
+    assert(line.find("dwell_ms,1000,50,69,") == 0);
+    std::getline(file, line);
+    assert(line.find("interval_ms,1000,1,1000,") == 0);
+    std::getline(file, line);
+    assert(line == "kana_ms:し,2,180,220,180:1;220:1");
+    // 元の値に戻せる最短の桁数（固定桁数で丸めない）
+    std::getline(file, line);
+    assert(line == "kana_ms:た,1,0.3333333333333333,0.3333333333333333,0.3333333333333333:1");
+    file.close();
+    
+    // 読み戻して2回分を合算
+    std::map<std::string, Statistics::TDigest> merged;
+    assert(CSVReader::readSketchCSV(filepath, merged));
+    assert(CSVReader::readSketchCSV(filepath, merged));
+    assert(merged.size() == 4);
+    assert(merged["interval_ms"].count() == 2000.0);
+    assert(std::abs(merged["interval_ms"].quantile(0.5) - 500.0) < 10.0);
+    assert(merged["kana_ms:し"].count() == 4.0);
+    assert(merged["kana_ms:し"].max() == 220.0);
+    
+    // スケッチCSVでないファイルは読まない
+    assert(!CSVReader::readSketchCSV("test_output/not_found.csv", merged));
+    
+    std::cout << "  Output file: " << filepath << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// セッションIDと目録のテスト（スレッドをまたいでもIDは重ならない）
+void test_session_id() {
+    std::cout << "Test: Session ID is unique..." << std::endl;
+    
+    // YYYYMMDD_HHMMSS_mmm_<プロセスID>_<連番>
+    std::string id = CSVLogger::generateSessionId();
+    assert(id.size() >= 25);
+    assert(id[8] == '_' && id[15] == '_' && id[19] == '_');
+    assert(CSVLogger::generateFilename("typing_events", id) == "typing_events_" + id + ".csv");
+    
+    // 4スレッドで同時に発行しても重複しない
+    std::vector<std::vector<std::string>> issued(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < issued.size(); ++t) {
+        threads.emplace_back([&issued, t] {
+            for (int i = 0; i < 1000; ++i) {
+                issued[t].push_back(CSVLogger::generateSessionId());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    
+    std::set<std::string> unique;
+    for (const auto& ids : issued) {
+        unique.insert(ids.begin(), ids.end());
+    }
+    assert(unique.size() == 4000);
+    
+    // 同じ秒に出力したサマリ・かな別CSVはIDを渡せば同じ名前になる
+    cleanupTestFiles();
+    Statistics::StatisticsData stats;
+    stats.kanaInputTime["あ"] = 150.0;
+    std::string first = CSVLogger::writeSummaryCSV(stats, "test_output", id);
+    std::string second = CSVLogger::writeSummaryCSV(stats, "test_output");
+    assert(first == "test_output/typing_summary_" + id + ".csv");
+    assert(!second.empty() && second != first);
+    assert(fs::exists("test_output/typing_kana_" + id + ".csv"));
+    
+    // 目録にはファイル名とバイト数を記録する（目録自身は含めない）
+    std::string manifest = CSVLogger::writeManifestCSV("test_output", id);
+    assert(!manifest.empty());
+    std::vector<CSVReader::ManifestEntry> entries;
+    assert(CSVReader::readManifestCSV(manifest, entries));
+    assert(entries.size() == 4);   // サマリ・かな別 × 2
+    for (const auto& entry : entries) {
+        assert(entry.sessionId == id);
+        assert(entry.bytes == fs::file_size("test_output/" + entry.file));
+    }
+    
+    std::cout << "  Session ID: " << id << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// イベントCSVの書き込み→読み込みで元のイベントに戻る（全エスケープ・CRLF・大きなファイル）
+void test_event_csv_round_trip() {
+    std::cout << "Test: Event CSV round trip..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    // エスケープされる文字とバックスラッシュを繰り返し含む20万イベント
+    const char characters[] = {'a', ',', '\n', '\r', '\t', '"', '\\', '\0', ' ', 'z'};
+    std::vector<InputRecorder::InputEvent> events;
+    for (size_t i = 0; i < 200000; ++i) {
+        InputRecorder::EventType type = (i % 7 == 0) ? InputRecorder::EventType::KEY_UP
+                                                     : InputRecorder::EventType::KEY_DOWN;
+        events.emplace_back(type, 1000000000ULL + i * 1234, static_cast<int>(i % 256), static_cast<int>(i % 90),
+                            characters[i % sizeof(characters)]);
+        events.back().is_correct = (i % 3 != 0);
+        events.back().inter_key_time_us = i * 17;
+        if (i % 101 == 0) events.back().note = "chatter";
+    }
+    
+    std::string filepath = CSVLogger::writeEventCSV(InputRecorder::EventView(events), "test_output");
+    assert(!filepath.empty());
+    
+    std::vector<InputRecorder::InputEvent> loaded;
+    assert(CSVReader::readEventCSV(filepath, loaded));
+    
+    assert(loaded.size() == events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        assert(loaded[i].type == events[i].type);
+        assert(loaded[i].timestamp_us == events[i].timestamp_us);
+        assert(loaded[i].vk_code == events[i].vk_code);
+        assert(loaded[i].scan_code == events[i].scan_code);
+        assert(loaded[i].character == events[i].character);
+        assert(loaded[i].is_correct == events[i].is_correct);
+        assert(loaded[i].inter_key_time_us == events[i].inter_key_time_us);
+        assert(loaded[i].note == events[i].note);
+    }
+    
+    // CRLF改行・最終行の改行なしでも読める
+    {
+        std::ofstream file("test_output/typing_events_crlf.csv", std::ios::binary);
+        file << "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note\r\n";
+        file << "1000,KEY_DOWN,65,30,\\t,1,0,\r\n";
+        file << "2000,KEY_UP,65,30,,0,0,ghost";
+    }
+    loaded.clear();
+    assert(CSVReader::readEventCSV("test_output/typing_events_crlf.csv", loaded));
+    assert(loaded.size() == 2);
+    assert(loaded[0].character == '\t' && loaded[0].note.empty());
+    assert(loaded[1].suspect == InputRecorder::Suspect::GHOST && loaded[1].note == "ghost");
+    
+    // 空のファイルはイベントCSVではない
+    { std::ofstream("test_output/typing_events_empty.csv"); }
+    assert(!CSVReader::readEventCSV("test_output/typing_events_empty.csv", loaded));
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// 圧縮したイベントCSVの書き込み→読み込み
+void test_compressed_event_csv() {
+    std::cout << "Test: Compressed event CSV..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    // 打鍵間隔が揺らぐ5万イベント
+    std::vector<InputRecorder::InputEvent> events;
+    uint64_t timestamp = 1000000;
+    for (size_t i = 0; i < 50000; ++i) {
+        uint64_t interval = 80000 + (i * 7919) % 150000;
+        timestamp += interval;
+        events.emplace_back(InputRecorder::EventType::KEY_DOWN, timestamp, 'A' + static_cast<int>(i % 20),
+                            30 + static_cast<int>(i % 20), static_cast<char>('a' + i % 20));
+        events.back().is_correct = (i % 9 != 0);
+        events.back().inter_key_time_us = interval;
+        events.emplace_back(InputRecorder::EventType::KEY_UP, timestamp + 45000, 'A' + static_cast<int>(i % 20),
+                            30 + static_cast<int>(i % 20));
+    }
+    
+    InputRecorder::EventView view(events);
+    std::string plainPath = CSVLogger::writeEventCSV(view, "test_output", "plain");
+    std::string compressedPath = CSVLogger::writeEventCSV(view, "test_output", "packed", true);
+    assert(compressedPath == "test_output/typing_events_packed.csv.lzb");
+    
+    std::vector<InputRecorder::InputEvent> plain;
+    std::vector<InputRecorder::InputEvent> loaded;
+    assert(CSVReader::readEventCSV(plainPath, plain));
+    assert(CSVReader::readEventCSV(compressedPath, loaded));
+    assert(loaded.size() == events.size());
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        assert(loaded[i].timestamp_us == plain[i].timestamp_us);
+        assert(loaded[i].type == plain[i].type);
+        assert(loaded[i].vk_code == plain[i].vk_code);
+        assert(loaded[i].character == plain[i].character);
+        assert(loaded[i].is_correct == plain[i].is_correct);
+        assert(loaded[i].inter_key_time_us == plain[i].inter_key_time_us);
+    }
+    
+    // 圧縮したファイルも一覧に含まれる
+    std::vector<std::string> listed = CSVReader::listEventCSV("test_output");
+    assert(listed.size() == 2);
+    
+    uintmax_t plainBytes = fs::file_size(plainPath);
+    uintmax_t compressedBytes = fs::file_size(compressedPath);
+    assert(compressedBytes * 2 < plainBytes);
+    
+    std::cout << "  " << plainBytes << " -> " << compressedBytes << " bytes" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// イベントログのテスト（追記・索引・上限での切り替え）
+void test_event_log() {
+    std::cout << "Test: Event log..." << std::endl;
+    
+    cleanupTestFiles();
+    
+    std::vector<InputRecorder::InputEvent> events;
+    events.emplace_back(InputRecorder::EventType::KEY_DOWN, 1000, 'A', 30, ',');
+    events.back().is_correct = true;
+    events.emplace_back(InputRecorder::EventType::KEY_UP, 2000, 'A', 30, '\n');
+    events.emplace_back(InputRecorder::EventType::KEY_DOWN, 3000, 'B', 48, 'b');
+    events.back().inter_key_time_us = 2000;
+    events.back().note = "chatter";
+    
+    // 上限を小さくして、2セッション目で次のファイルに切り替える
+    CSVLogger::EventLogConfig config;
+    config.directory = "test_output";
+    config.maxBytes = 100;
+    std::string first = CSVLogger::appendEventLog(InputRecorder::EventView(events), "s1", config);
+    std::string second = CSVLogger::appendEventLog(InputRecorder::EventView(events.data(), 2), "s2", config);
+    config.maxBytes = 0;
+    std::string third = CSVLogger::appendEventLog(InputRecorder::EventView(events), "s3", config);
+    assert(!first.empty() && first.find("test_output/typing_eventlog_") == 0);
+    assert(first.substr(first.size() - 8) == "_001.csv");
+    assert(second.substr(second.size() - 8) == "_002.csv");
+    assert(third == second);
+    
+    // ヘッダーにsession_id列が付く
+    std::ifstream file(second);
+    std::string line;
+    std::getline(file, line);
+    assert(line == "session_id,timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note");
+    file.close();
+    
+    // 索引から1セッション分だけを読み込む
+    std::vector<CSVReader::EventLogEntry> entries;
+    assert(CSVReader::readEventLogIndex(second + CSVReader::EVENT_LOG_INDEX_SUFFIX, entries));
+    assert(entries.size() == 2);
+    assert(entries[0].sessionId == "s2" && entries[0].eventCount == 2);
+    assert(entries[1].sessionId == "s3" && entries[1].offset == entries[0].offset + entries[0].bytes);
+    
+    std::vector<InputRecorder::InputEvent> loaded;
+    assert(CSVReader::readEventLogSession(second, entries[1], loaded));
+    assert(loaded.size() == 3);
+    assert(loaded[0].character == ',' && loaded[0].is_correct);
+    assert(loaded[1].character == '\n');
+    assert(loaded[2].inter_key_time_us == 2000 && loaded[2].suspect == InputRecorder::Suspect::CHATTER);
+    
+    // 範囲が別のセッションの行を指していれば読まない
+    CSVReader::EventLogEntry wrong = entries[1];
+    wrong.sessionId = "s2";
+    assert(!CSVReader::readEventLogSession(second, wrong, loaded));
+    
+    std::cout << "  Log file: " << second << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
 int main() {
     std::cout << "=== CSV Logger Unit Tests ===" << std::endl;
     std::cout << std::endl;
@@ -353,6 +782,27 @@ int main() {
         test_summary_csv_with_data();
         test_summary_csv_with_kana_data();
         test_summary_csv_format();
+        test_bounce_summary();
+        test_press_status();
+        
+        // キーペア遷移時間CSVテスト
+        test_digraph_csv();
+        
+        // 移動窓時系列CSVテスト
+        test_timeseries_csv();
+        
+        // 分位点スケッチCSVテスト
+        test_sketch_csv();
+        
+        // セッションID・目録テスト
+        test_session_id();
+        
+        // イベントCSV読み込みテスト
+        test_event_csv_round_trip();
+        test_compressed_event_csv();
+        
+        // イベントログテスト
+        test_event_log();
         
         // テスト後のクリーンアップ
         cleanupTestFiles();
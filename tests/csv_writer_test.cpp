@@ -0,0 +1,105 @@
+// csv_writer_test.cpp
+// バッファ付きCSV書き込みのユニットテスト
+
+#include "../core/csv_writer.h"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+using CSVWriter::BufferedWriter;
+
+static std::string readAll(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// テスト1: 数値と文字列の書式
+void test_formatting() {
+    std::cout << "Test: Number and text formatting..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/writer.csv";
+    {
+        BufferedWriter writer;
+        assert(writer.open(path));
+        writer.writeUnsigned(0);
+        writer.put(',');
+        writer.writeUnsigned(std::numeric_limits<uint64_t>::max());
+        writer.put(',');
+        writer.writeSigned(-42);
+        writer.put(',');
+        writer.writeFixed(3.14159, 2);
+        writer.put(',');
+        writer.writeFixed(-0.5, 3);
+        writer.put(',');
+        writer.writeFixed(1234567.0, 0);
+        writer.write(",KEY_DOWN\n");
+        assert(writer.close());
+    }
+
+    assert(readAll(path) == "0,18446744073709551615,-42,3.14,-0.500,1234567,KEY_DOWN\n");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: バッファより長い出力（書き出しの境界）
+void test_buffer_boundary() {
+    std::cout << "Test: Buffer boundary..." << std::endl;
+
+    std::string path = "test_output/boundary.csv";
+    std::string expected;
+    {
+        // 最小サイズのバッファで何度も書き出させる
+        BufferedWriter writer(16);
+        assert(writer.open(path));
+        for (uint64_t i = 0; i < 10000; ++i) {
+            writer.writeUnsigned(i * 7919);
+            writer.put('\n');
+            expected += std::to_string(i * 7919) + "\n";
+        }
+        // バッファより長い文字列
+        std::string longText(5000, 'x');
+        writer.write(longText);
+        expected += longText;
+        assert(writer.close());
+    }
+
+    assert(readAll(path) == expected);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 開けないファイル
+void test_open_failure() {
+    std::cout << "Test: Open failure..." << std::endl;
+
+    BufferedWriter writer;
+    assert(!writer.open("test_output/no_such_dir/file.csv"));
+    assert(!writer.isOpen());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== CSV Writer Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_formatting();
+    test_buffer_boundary();
+    test_open_failure();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
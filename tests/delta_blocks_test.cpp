@@ -0,0 +1,125 @@
+// delta_blocks_test.cpp
+// 整数列のメモリ内圧縮のユニットテスト
+
+#include "../core/delta_blocks.h"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+using DeltaBlocks::Sequence;
+using DeltaBlocks::BLOCK_VALUES;
+
+static Sequence makeSequence(const std::vector<uint64_t>& values) {
+    Sequence sequence;
+    for (uint64_t value : values) sequence.push_back(value);
+    return sequence;
+}
+
+// 打鍵のタイムスタンプに近い列（60〜260msの間隔）
+static std::vector<uint64_t> typingTimestamps(size_t count) {
+    std::mt19937 rng(1);
+    std::vector<uint64_t> values;
+    uint64_t timestamp = 32034289195ULL;
+    for (size_t i = 0; i < count; ++i) {
+        timestamp += 60000 + rng() % 200000;
+        values.push_back(timestamp);
+    }
+    return values;
+}
+
+// テスト1: 任意の位置の値・ブロック単位・全体の復号
+void test_random_access() {
+    std::cout << "Test: Random access..." << std::endl;
+
+    std::vector<uint64_t> values = typingTimestamps(BLOCK_VALUES * 5 + 17);
+    Sequence sequence = makeSequence(values);
+    assert(sequence.size() == values.size());
+    assert(sequence.blockCount() == 6);
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        assert(sequence[i] == values[i]);
+    }
+
+    uint64_t block[BLOCK_VALUES];
+    assert(sequence.decodeBlock(2, block) == BLOCK_VALUES);
+    assert(block[0] == values[BLOCK_VALUES * 2] && block[BLOCK_VALUES - 1] == values[BLOCK_VALUES * 3 - 1]);
+    assert(sequence.decodeBlock(5, block) == 17);
+    assert(block[16] == values.back());
+
+    assert(sequence.toVector() == values);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 減少・大きな差・空の列
+void test_edge_values() {
+    std::cout << "Test: Decreasing and extreme values..." << std::endl;
+
+    const uint64_t max = std::numeric_limits<uint64_t>::max();
+    std::vector<uint64_t> values = {5, 3, 0, max, 0, max - 1, 1ULL << 63, 42, 42, 41};
+    std::mt19937_64 rng(9);
+    for (int i = 0; i < 1000; ++i) values.push_back(rng() >> (rng() % 64));
+    Sequence sequence = makeSequence(values);
+    assert(sequence.toVector() == values);
+    for (size_t i = 0; i < values.size(); ++i) {
+        assert(sequence[i] == values[i]);
+    }
+
+    Sequence empty;
+    assert(empty.empty() && empty.blockCount() == 0);
+    assert(empty.toVector().empty());
+    size_t calls = 0;
+    empty.forEach([&calls](uint64_t) { calls++; });
+    assert(calls == 0);
+
+    sequence.clear();
+    assert(sequence.empty());
+    sequence.push_back(7);
+    assert(sequence.size() == 1 && sequence[0] == 7);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 打鍵のタイムスタンプは1値あたり3バイト程度になる
+void test_typing_timestamps() {
+    std::cout << "Test: Typing timestamps are compact..." << std::endl;
+
+    const size_t count = 1000000;
+    std::vector<uint64_t> values = typingTimestamps(count);
+    Sequence sequence = makeSequence(values);
+    sequence.shrinkToFit();
+
+    double bytesPerValue = static_cast<double>(sequence.memoryBytes()) / count;
+    assert(bytesPerValue < 4.0);
+
+    // 隣り合う差の合計（キー間隔の集計と同じ読み方）
+    uint64_t vectorSum = 0;
+    for (size_t i = 1; i < values.size(); ++i) vectorSum += values[i] - values[i - 1];
+
+    uint64_t blockSum = 0;
+    uint64_t previous = values[0];
+    sequence.forEach([&](uint64_t value) {
+        blockSum += value - previous;
+        previous = value;
+    });
+    assert(blockSum == vectorSum);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Delta Blocks Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_random_access();
+    test_edge_values();
+    test_typing_timestamps();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
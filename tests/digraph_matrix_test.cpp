@@ -0,0 +1,155 @@
+// digraph_matrix_test.cpp
+// キーペア（ダイグラフ）遷移時間集計のユニットテスト
+
+#include "../core/digraph_matrix.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace Statistics;
+
+// テスト1: 遷移の追加と平均
+void test_digraph_add() {
+    std::cout << "Test: Digraph add and mean..." << std::endl;
+
+    DigraphMatrix matrix;
+    matrix.add('k', 'a', 100000);  // 100ms
+    matrix.add('k', 'a', 200000);  // 200ms
+    matrix.add('a', 'k', 50000);   // 50ms
+
+    assert(matrix.getTransitionCount() == 3);
+    assert(matrix.at('k', 'a').count == 2);
+    assert(std::abs(matrix.at('k', 'a').meanMs() - 150.0) < 0.01);
+    assert(matrix.at('a', 'k').count == 1);
+    assert(matrix.at('x', 'y').count == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: ヒストグラムのビン分け
+void test_histogram_bins() {
+    std::cout << "Test: Histogram bins..." << std::endl;
+
+    assert(transitionHistogramBin(0) == 0);
+    assert(transitionHistogramBin(24999) == 0);
+    assert(transitionHistogramBin(25000) == 1);
+    assert(transitionHistogramBin(120000) == 3);
+    assert(transitionHistogramBin(10000000) == DIGRAPH_HISTOGRAM_BINS - 1);
+
+    DigraphMatrix matrix;
+    matrix.add('a', 'b', 10000);
+    matrix.add('a', 'b', 600000);
+
+    const auto& stats = matrix.at('a', 'b');
+    assert(stats.histogram[0] == 1);
+    assert(stats.histogram[DIGRAPH_HISTOGRAM_BINS - 1] == 1);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: ASCII範囲外の文字・文字を持たないキーは無視
+void test_out_of_range() {
+    std::cout << "Test: Out-of-range characters..." << std::endl;
+
+    DigraphMatrix matrix;
+    matrix.add(static_cast<char>(0xE3), 'a', 1000);
+    matrix.add('\0', 'a', 1000);     // Shiftなど
+    matrix.add('a', '\0', 1000);
+    matrix.add('\t', 'a', 1000);
+
+    assert(matrix.getTransitionCount() == 0);
+    assert(matrix.at(static_cast<char>(0xE3), 'a').count == 0);
+    assert(matrix.at('\0', 'a').count == 0 && matrix.at('\0', '\0').count == 0);
+
+    TrigramTable trigrams(16);
+    trigrams.add('a', '\0', 'b', 1000);
+    assert(trigrams.size() == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: クリア
+void test_digraph_clear() {
+    std::cout << "Test: Digraph clear..." << std::endl;
+
+    DigraphMatrix matrix;
+    matrix.add('a', 'b', 1000);
+    matrix.clear();
+
+    assert(matrix.getTransitionCount() == 0);
+    assert(matrix.at('a', 'b').count == 0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: トライグラム（疎な表）
+void test_trigram_table() {
+    std::cout << "Test: Trigram table..." << std::endl;
+
+    TrigramTable table(16);
+    table.add('s', 'h', 'i', 300000);
+    table.add('s', 'h', 'i', 100000);
+    table.add('c', 'h', 'i', 250000);
+
+    assert(table.size() == 2);
+    const TransitionStats* shi = table.find('s', 'h', 'i');
+    assert(shi != nullptr);
+    assert(shi->count == 2);
+    assert(std::abs(shi->meanMs() - 200.0) < 0.01);
+    assert(table.find('t', 's', 'u') == nullptr);
+
+    // 列挙
+    size_t visited = 0;
+    table.forEach([&](char a, char b, char c, const TransitionStats& stats) {
+        assert(b == 'h' && c == 'i');
+        assert(a == 's' || a == 'c');
+        assert(stats.count >= 1);
+        visited++;
+    });
+    assert(visited == 2);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: トライグラム表の拡張（全組を登録しても検索できる）
+void test_trigram_growth() {
+    std::cout << "Test: Trigram table growth..." << std::endl;
+
+    TrigramTable table(16);
+    for (char a = 'a'; a <= 'z'; ++a) {
+        for (char b = 'a'; b <= 'z'; ++b) {
+            table.add(a, b, 'x', 1000);
+        }
+    }
+
+    assert(table.size() == 26 * 26);
+    for (char a = 'a'; a <= 'z'; ++a) {
+        for (char b = 'a'; b <= 'z'; ++b) {
+            const TransitionStats* stats = table.find(a, b, 'x');
+            assert(stats != nullptr && stats->count == 1);
+        }
+    }
+
+    table.clear();
+    assert(table.size() == 0);
+    assert(table.find('a', 'a', 'x') == nullptr);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Digraph Matrix Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_digraph_add();
+    test_histogram_bins();
+    test_out_of_range();
+    test_digraph_clear();
+    test_trigram_table();
+    test_trigram_growth();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+// event_columns_test.cpp
+// イベントの列指向バイナリ形式のユニットテスト
+
+#include "../core/event_columns.h"
+#include "../core/csv_logger.h"
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+using InputRecorder::EventType;
+using InputRecorder::InputEvent;
+
+// テスト用のイベント列（100msごとのキーダウン・アップ）
+static std::vector<InputEvent> makeEvents(size_t keys) {
+    std::vector<InputEvent> events;
+    for (size_t i = 0; i < keys; ++i) {
+        uint64_t t = 1700000000000000ULL + i * 100000;
+        events.emplace_back(EventType::KEY_DOWN, t, 65 + static_cast<int>(i % 26), 30, static_cast<char>('a' + i % 26));
+        events.back().is_correct = (i % 5 != 0);
+        events.back().inter_key_time_us = i == 0 ? 0 : 60000;
+        if (i % 50 == 0) {
+            events.back().suspect = InputRecorder::Suspect::CHATTER;
+            events.back().note = "chatter";
+        }
+        events.emplace_back(EventType::KEY_UP, t + 40000, 65 + static_cast<int>(i % 26), 30);
+    }
+    return events;
+}
+
+// テスト1: 書き込んだイベントがそのまま読み戻せる
+void test_round_trip() {
+    std::cout << "Test: Round trip..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::vector<InputEvent> events = makeEvents(1000);
+    events.emplace_back(EventType::BACKSPACE, events.back().timestamp_us - 5, 8, 14, '\0');   // 時刻が戻る
+    events.emplace_back(EventType::KEY_DOWN, events.back().timestamp_us + 1, 188, 51, ',');
+
+    assert(EventColumns::writeFile(InputRecorder::EventView(events), "test_output/events.evcol"));
+
+    EventColumns::Reader reader;
+    assert(reader.open("test_output/events.evcol"));
+    assert(reader.eventCount() == events.size());
+
+    std::vector<InputEvent> loaded;
+    assert(reader.readEvents(loaded));
+    assert(loaded.size() == events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        assert(loaded[i].type == events[i].type);
+        assert(loaded[i].timestamp_us == events[i].timestamp_us);
+        assert(loaded[i].vk_code == events[i].vk_code);
+        assert(loaded[i].scan_code == events[i].scan_code);
+        assert(loaded[i].character == events[i].character);
+        assert(loaded[i].is_correct == events[i].is_correct);
+        assert(loaded[i].inter_key_time_us == events[i].inter_key_time_us);
+        assert(loaded[i].suspect == events[i].suspect);
+        assert(loaded[i].note == events[i].note);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 1列だけを読む・正解数はビット列から数える
+void test_single_column() {
+    std::cout << "Test: Read single columns..." << std::endl;
+
+    std::vector<InputEvent> events = makeEvents(1000);
+    assert(EventColumns::writeFile(InputRecorder::EventView(events), "test_output/events.evcol"));
+
+    EventColumns::Reader reader;
+    assert(reader.open("test_output/events.evcol"));
+
+    std::vector<uint64_t> timestamps;
+    assert(reader.readTimestamps(timestamps));
+    assert(timestamps.size() == 2000 && timestamps[2] == events[2].timestamp_us);
+
+    std::vector<int> vkCodes;
+    assert(reader.readVkCodes(vkCodes));
+    assert(vkCodes[0] == 65 && vkCodes[2] == 66);
+    assert(reader.column(EventColumns::Column::VK_CODE).encoding == EventColumns::Encoding::UINT8);
+
+    std::vector<uint8_t> correct;
+    assert(reader.readCorrect(correct));
+    uint64_t expected = 0;
+    for (const auto& event : events) expected += event.is_correct ? 1 : 0;
+    assert(reader.countCorrect() == expected);
+    assert(correct[0] == 0 && correct[2] == 1);
+
+    // 各列はフッターの範囲に収まり、タイムスタンプは1イベント数バイトに縮む
+    EventColumns::ColumnView ts = reader.column(EventColumns::Column::TIMESTAMP);
+    assert(ts.size < events.size() * 4);
+
+    std::cout << "  Timestamp column: " << ts.size << " bytes for " << events.size() << " events" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 2バイトに収まらない整数・空のイベント列
+void test_wide_values_and_empty() {
+    std::cout << "Test: Wide integers and empty sessions..." << std::endl;
+
+    std::vector<InputEvent> events;
+    events.emplace_back(EventType::KEY_DOWN, 10, 70000, -5, 'x');
+    events.emplace_back(EventType::KEY_UP, 20, 65, 300, 'x');
+    assert(EventColumns::writeFile(InputRecorder::EventView(events), "test_output/wide.evcol"));
+
+    EventColumns::Reader reader;
+    assert(reader.open("test_output/wide.evcol"));
+    assert(reader.column(EventColumns::Column::VK_CODE).encoding == EventColumns::Encoding::INT32);
+    assert(reader.column(EventColumns::Column::SCAN_CODE).encoding == EventColumns::Encoding::INT16);
+    std::vector<int> vkCodes;
+    std::vector<int> scanCodes;
+    assert(reader.readVkCodes(vkCodes) && vkCodes[0] == 70000);
+    assert(reader.readScanCodes(scanCodes) && scanCodes[0] == -5 && scanCodes[1] == 300);
+
+    std::vector<InputEvent> none;
+    assert(EventColumns::writeFile(InputRecorder::EventView(none), "test_output/empty.evcol"));
+    assert(reader.open("test_output/empty.evcol"));
+    assert(reader.eventCount() == 0);
+    std::vector<InputEvent> loaded;
+    assert(reader.readEvents(loaded) && loaded.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 形式の異なるファイル・壊れたファイルは開かない
+void test_invalid_files() {
+    std::cout << "Test: Reject invalid files..." << std::endl;
+
+    EventColumns::Reader reader;
+    assert(!reader.open("test_output/not_found.evcol"));
+
+    { std::ofstream("test_output/text.evcol") << "timestamp_us,event_type\n"; }
+    assert(!reader.open("test_output/text.evcol"));
+
+    // 末尾を切り詰める
+    std::vector<InputEvent> events = makeEvents(100);
+    std::vector<uint8_t> data = EventColumns::encode(InputRecorder::EventView(events));
+    {
+        std::ofstream file("test_output/truncated.evcol", std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() - 20));
+    }
+    assert(!reader.open("test_output/truncated.evcol"));
+
+    // 定義にないイベントの種類は読み込まない（種類の列はKEY_DOWN・KEY_UPが交互に200個）
+    size_t typesAt = 0;
+    for (size_t i = 0; i + events.size() <= data.size() && typesAt == 0; ++i) {
+        size_t j = 0;
+        while (j < events.size() && data[i + j] == j % 2) ++j;
+        if (j == events.size()) typesAt = i;
+    }
+    assert(typesAt > 0);
+    data[typesAt + 1] = 0xFF;
+    {
+        std::ofstream file("test_output/bad_type.evcol", std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+    assert(reader.open("test_output/bad_type.evcol"));
+    std::vector<EventType> types;
+    assert(!reader.readEventTypes(types));
+    std::vector<InputEvent> loaded;
+    assert(!reader.readEvents(loaded) && loaded.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: CSVより小さい
+void test_size_against_csv() {
+    std::cout << "Test: Smaller than CSV..." << std::endl;
+
+    std::vector<InputEvent> events = makeEvents(20000);
+    std::string csv = CSVLogger::writeEventCSV(InputRecorder::EventView(events), "test_output", "size");
+    std::string columns = CSVLogger::writeEventColumns(InputRecorder::EventView(events), "test_output", "size");
+    assert(columns == "test_output/typing_events_size.evcol");
+
+    uintmax_t csvBytes = fs::file_size(csv);
+    uintmax_t columnBytes = fs::file_size(columns);
+    assert(columnBytes * 3 < csvBytes);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  CSV: " << csvBytes << " bytes, columnar: " << columnBytes << " bytes" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Event Columns Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_round_trip();
+    test_single_column();
+    test_wide_values_and_empty();
+    test_invalid_files();
+    test_size_against_csv();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+// interval_kernels_test.cpp
+// タイムスタンプ集計カーネルのユニットテスト
+// AVX2対応CPUではAVX2版とスカラー版の結果が一致することも確認する
+
+#include "../core/interval_kernels.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace IntervalKernels;
+
+// テスト用のタイムスタンプ列（単調増加、間隔は不規則）
+static std::vector<uint64_t> makeTimestamps(size_t count) {
+    std::vector<uint64_t> ts(count);
+    uint64_t t = 1000000;
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245u + 12345u;
+        t += 20000 + (seed >> 8) % 400000;  // 20ms〜420ms
+        ts[i] = t;
+    }
+    return ts;
+}
+
+// テスト1: 差分変換（その場）
+void test_delta_in_place() {
+    std::cout << "Test: Delta in place..." << std::endl;
+
+    // 端数処理を確認するため長さを変えて試す
+    for (size_t n = 0; n <= 13; ++n) {
+        std::vector<uint64_t> ts = makeTimestamps(n);
+        std::vector<uint64_t> expected = ts;
+        for (size_t i = n; i-- > 1; ) expected[i] -= expected[i - 1];
+
+        deltaInPlace(ts.data(), ts.size());
+        assert(ts == expected);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 合計・最小・最大
+void test_summarize() {
+    std::cout << "Test: Sum/min/max..." << std::endl;
+
+    uint64_t values[] = {150, 90, 300, 120, 95, 410, 88, 200, 130};
+    Summary s = summarize(values, 9);
+    assert(s.count == 9);
+    assert(s.sum == 1583);
+    assert(s.min == 88);
+    assert(s.max == 410);
+    assert(sum(values, 9) == 1583);
+    assert(min(values, 9) == 88);
+    assert(max(values, 9) == 410);
+
+    // 空配列
+    Summary empty = summarize(values, 0);
+    assert(empty.count == 0 && empty.sum == 0 && empty.min == 0 && empty.max == 0);
+    assert(empty.mean() == 0.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 分散
+void test_variance() {
+    std::cout << "Test: Variance..." << std::endl;
+
+    uint64_t values[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    double mean = summarize(values, 8).mean();
+    assert(std::fabs(mean - 5.0) < 1e-9);
+    assert(std::fabs(variance(values, 8, mean) - 4.0) < 1e-9);
+    assert(variance(values, 0, 0.0) == 0.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: ヒストグラム
+void test_histogram() {
+    std::cout << "Test: Histogram..." << std::endl;
+
+    const uint64_t edges[] = {100, 200, 300};
+    uint64_t values[] = {0, 99, 100, 150, 199, 200, 299, 300, 5000};
+    uint32_t bins[4] = {0, 0, 0, 0};
+
+    histogram(values, 9, edges, 3, bins);
+    assert(bins[0] == 2);  // < 100
+    assert(bins[1] == 3);  // 100〜199
+    assert(bins[2] == 2);  // 200〜299
+    assert(bins[3] == 2);  // >= 300
+
+    // 加算されること
+    histogram(values, 1, edges, 3, bins);
+    assert(bins[0] == 3);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: AVX2版とスカラー版の一致
+void test_isa_consistency() {
+    std::cout << "Test: SIMD/scalar consistency..." << std::endl;
+
+    Isa original = activeIsa();
+    std::cout << "  active ISA: " << (original == Isa::AVX2 ? "AVX2" : "scalar") << std::endl;
+
+    const uint64_t edges[] = {25000, 50000, 100000, 150000, 200000, 300000, 500000};
+    const size_t n = 1003;
+
+    std::vector<uint64_t> scalarTs = makeTimestamps(n);
+    std::vector<uint64_t> simdTs = scalarTs;
+
+    overrideIsa(Isa::SCALAR);
+    assert(activeIsa() == Isa::SCALAR);
+    deltaInPlace(scalarTs.data(), n);
+    Summary s1 = summarize(scalarTs.data() + 1, n - 1);
+    double v1 = variance(scalarTs.data() + 1, n - 1, s1.mean());
+    uint32_t h1[8] = {};
+    histogram(scalarTs.data() + 1, n - 1, edges, 7, h1);
+
+    overrideIsa(Isa::AVX2);  // 非対応CPUではスカラーのまま
+    deltaInPlace(simdTs.data(), n);
+    Summary s2 = summarize(simdTs.data() + 1, n - 1);
+    double v2 = variance(simdTs.data() + 1, n - 1, s2.mean());
+    uint32_t h2[8] = {};
+    histogram(simdTs.data() + 1, n - 1, edges, 7, h2);
+
+    assert(scalarTs == simdTs);
+    assert(s1.sum == s2.sum && s1.min == s2.min && s1.max == s2.max);
+    assert(std::fabs(v1 - v2) <= 1e-9 * v1);
+    for (int i = 0; i < 8; ++i) assert(h1[i] == h2[i]);
+
+    overrideIsa(original);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: 集計中に別スレッドから命令セットを切り替えても結果は同じ
+void test_isa_switch_across_threads() {
+    std::cout << "Test: ISA switch across threads..." << std::endl;
+
+    Isa original = activeIsa();
+    std::vector<uint64_t> ts = makeTimestamps(1003);
+    deltaInPlace(ts.data(), ts.size());
+    Summary expected = summarize(ts.data() + 1, ts.size() - 1);
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 4; ++t) {
+        workers.emplace_back([&ts, &expected] {
+            for (int i = 0; i < 2000; ++i) {
+                Summary s = summarize(ts.data() + 1, ts.size() - 1);
+                assert(s.sum == expected.sum && s.min == expected.min && s.max == expected.max);
+            }
+        });
+    }
+    for (int i = 0; i < 2000; ++i) {
+        overrideIsa(i % 2 == 0 ? Isa::SCALAR : Isa::AVX2);
+    }
+    for (auto& worker : workers) worker.join();
+
+    overrideIsa(original);
+    assert(activeIsa() == original);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Interval Kernels Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_delta_in_place();
+    test_summarize();
+    test_variance();
+    test_histogram();
+    test_isa_consistency();
+    test_isa_switch_across_threads();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+// json_document_test.cpp
+// 読み取り専用のJSON文書とプル型の読み取りのユニットテスト
+
+#include "../helper/json_document.h"
+#include "../helper/json_helper.h"
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+using JsonDocument::Document;
+using JsonDocument::Node;
+using JsonReader::Reader;
+using JsonReader::Token;
+
+static const char* SCENARIO_JSON = R"({
+    "meta": {"name": "テスト", "uniqueid": "test-001", "requiredver": 1.5},
+    "entries": {
+        "1": {"text": "こんにちは", "rubi": "konnichiha", "level": 1},
+        "2": {"text": "さようなら", "rubi": "sayounara", "level": 2}
+    }
+})";
+
+// n個のエントリを持つシナリオ
+static std::string makeScenario(size_t count) {
+    std::string json = "{\"meta\":{\"name\":\"big\",\"uniqueid\":\"big-001\",\"requiredver\":1},\"entries\":{";
+    for (size_t i = 1; i <= count; ++i) {
+        if (i > 1) json += ",";
+        json += "\"" + std::to_string(i) + "\":{\"text\":\"今日は良い天気ですね" + std::to_string(i) +
+                "\",\"rubi\":\"kyouhayoitenkidesune\",\"level\":" + std::to_string(i % 5 + 1) + "}";
+    }
+    json += "}}";
+    return json;
+}
+
+// テスト1: シナリオの読み取りと文字列のコピーなし
+void test_parse_scenario() {
+    std::cout << "Test: Parse scenario..." << std::endl;
+
+    std::string json = SCENARIO_JSON;
+    Document doc;
+    assert(doc.parse(json));
+    assert(doc.error().empty());
+
+    const Node& root = doc.root();
+    assert(root.isObject() && root.size == 2);
+    assert(root["meta"]["name"].asString() == "テスト");
+    assert(root["meta"]["requiredver"].asNumber() == 1.5);
+
+    const Node& entry = root["entries"]["2"];
+    assert(entry["text"].asString() == "さようなら");
+    assert(entry["rubi"].asString() == "sayounara");
+    assert(entry["level"].asNumber() == 2.0);
+
+    // エスケープのない文字列は元のJSONを指す
+    std::string_view text = entry["text"].asString();
+    assert(text.data() >= json.data() && text.data() + text.size() <= json.data() + json.size());
+
+    // 出現順に並ぶ
+    size_t index = 0;
+    for (const JsonDocument::Member& member : root["entries"].objectMembers()) {
+        assert(member.key == std::to_string(++index));
+    }
+    assert(index == 2);
+
+    // ない値・型の違う値はnull・空
+    assert(root["missing"].isNull());
+    assert(root["entries"]["3"]["text"].asString().empty());
+    assert(root["meta"][0].isNull());
+    assert(root["meta"]["name"].asNumber() == 0.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: エスケープ・数値・配列・リテラル
+void test_values() {
+    std::cout << "Test: Escapes, numbers and arrays..." << std::endl;
+
+    std::string json = R"({"s": "a\"b\\c\/\n\t\u3042\ud83d\ude00", "n": [0, -1, 2.5e3, -0.125, 1E-2],
+                          "b": [true, false, null], "e": [], "o": {}, "k": 1, "k": 2})";
+    Document doc;
+    assert(doc.parse(json));
+    const Node& root = doc.root();
+
+    assert(root["s"].asString() == "a\"b\\c/\n\t\xE3\x81\x82\xF0\x9F\x98\x80");
+
+    const Node& numbers = root["n"];
+    assert(numbers.isArray() && numbers.size == 5);
+    assert(numbers[0].asNumber() == 0.0 && numbers[1].asNumber() == -1.0);
+    assert(numbers[2].asNumber() == 2500.0 && numbers[3].asNumber() == -0.125);
+    assert(numbers[4].asNumber() == 0.01);
+    assert(numbers[5].isNull());
+
+    double sum = 0.0;
+    for (const Node& item : numbers.arrayItems()) sum += item.asNumber();
+    assert(sum == 2500.0 - 1.0 - 0.125 + 0.01);
+
+    assert(root["b"][0].asBool() && root["b"][1].isBool() && !root["b"][1].asBool());
+    assert(root["b"][2].isNull());
+    assert(root["e"].isArray() && root["e"].size == 0);
+    assert(root["o"].isObject() && root["o"].size == 0);
+
+    // 同じキーは最初のもの
+    assert(root["k"].asNumber() == 1.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 不正なJSONは位置つきのエラー
+void test_errors() {
+    std::cout << "Test: Invalid JSON is rejected..." << std::endl;
+
+    const char* invalid[] = {
+        "",
+        "{\"a\": 1,}",
+        "[1, 2",
+        "{\"a\" 1}",
+        "{\"a\": \"abc}",
+        "{\"a\": 01}",
+        "{\"a\": 1.}",
+        "{\"a\": -}",
+        "{\"a\": tru}",
+        "{\"a\": \"\\x\"}",
+        "{\"a\": \"\\ud83d\"}",
+        "{\"a\": \"tab\there\"}",
+        "{a: 1}",
+        "{} {}",
+    };
+    for (const char* json : invalid) {
+        Document doc;
+        assert(!doc.parse(json));
+        assert(!doc.error().empty());
+        assert(doc.root().isNull());
+    }
+
+    Document doc;
+    assert(!doc.parse("{\n  \"a\": 1,\n  \"b\" 2\n}"));
+    assert(doc.error().rfind("line 3, column 7:", 0) == 0);
+
+    // 深すぎる入れ子
+    std::string deep(1000, '[');
+    deep += std::string(1000, ']');
+    assert(!doc.parse(deep));
+    std::string shallow(100, '[');
+    shallow += std::string(100, ']');
+    assert(doc.parse(shallow));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: ファイルの読み込み（BOM付き）と大きなシナリオ（JsonHelperと同じ内容）
+void test_load_file() {
+    std::cout << "Test: Load scenario file..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/scenario.json";
+    { std::ofstream(path, std::ios::binary) << "\xEF\xBB\xBF" << SCENARIO_JSON; }
+
+    Document doc;
+    assert(doc.loadFile(path));
+    assert(doc.root()["entries"]["1"]["text"].asString() == "こんにちは");
+    assert(!doc.loadFile("test_output/missing.json"));
+    assert(doc.root().isNull());
+
+    const size_t count = 100000;
+    std::string big = makeScenario(count);
+    { std::ofstream(path, std::ios::binary) << big; }
+
+    assert(doc.loadFile(path));
+    const Node& entries = doc.root()["entries"];
+    assert(entries.size == count);
+    assert(entries["50000"]["level"].asNumber() == 50000 % 5 + 1);
+    assert(entries.members[count - 1].value["text"].asString() == "今日は良い天気ですね" + std::to_string(count));
+
+    JsonHelper::JsonValue value = JsonHelper::parseJson(big);
+    assert(value["entries"].asObject().size() == count);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: プル型の読み取りのトークン列と読み飛ばし
+void test_reader_tokens() {
+    std::cout << "Test: Reader tokens and skipValue..." << std::endl;
+
+    Reader reader(R"({"a": [1, {"b": null}], "s\n": "x\u3042", "c": true})");
+    assert(reader.next() == Token::START_OBJECT && reader.depth() == 1);
+    assert(reader.next() == Token::KEY && reader.string() == "a" && !reader.copied());
+    assert(reader.next() == Token::START_ARRAY && reader.depth() == 2);
+    assert(reader.next() == Token::NUMBER && reader.number() == 1.0);
+    assert(reader.next() == Token::START_OBJECT);
+    assert(reader.next() == Token::KEY && reader.string() == "b");
+    assert(reader.next() == Token::NULL_VALUE);
+    assert(reader.next() == Token::END_OBJECT);
+    assert(reader.next() == Token::END_ARRAY && reader.depth() == 1);
+    assert(reader.next() == Token::KEY && reader.string() == "s\n" && reader.copied());
+    assert(reader.next() == Token::STRING && reader.string() == "x\xE3\x81\x82");
+    assert(reader.next() == Token::KEY);
+    assert(reader.next() == Token::BOOLEAN && reader.boolean());
+    assert(reader.next() == Token::END_OBJECT && reader.depth() == 0);
+    assert(reader.next() == Token::END);
+    assert(reader.next() == Token::END);
+
+    // 入れ子の値を読み飛ばす（スカラー値の後では何もしない）
+    reader.reset(R"({"skip": {"x": [1, [2, 3]], "y": {}}, "n": 5})");
+    assert(reader.next() == Token::START_OBJECT);
+    assert(reader.next() == Token::KEY);
+    assert(reader.next() == Token::START_OBJECT);
+    assert(reader.skipValue() && reader.depth() == 1);
+    assert(reader.next() == Token::KEY && reader.string() == "n");
+    assert(reader.next() == Token::NUMBER && reader.skipValue());
+    assert(reader.next() == Token::END_OBJECT);
+    assert(reader.next() == Token::END);
+
+    // 誤りの後はERRORを返し続ける
+    reader.reset("[1, {\"a\": 2,]}]");
+    assert(reader.next() == Token::START_ARRAY);
+    assert(reader.next() == Token::NUMBER);
+    assert(reader.next() == Token::START_OBJECT);
+    assert(reader.next() == Token::KEY);
+    assert(reader.next() == Token::NUMBER);
+    assert(reader.next() == Token::ERROR);
+    assert(reader.error() == "line 1, column 13: expected string key");
+    assert(reader.next() == Token::ERROR);
+
+    reader.reset(R"({"skip": [1, 2 3]})");
+    assert(reader.next() == Token::START_OBJECT);
+    assert(reader.next() == Token::KEY);
+    assert(reader.next() == Token::START_ARRAY);
+    assert(!reader.skipValue() && !reader.error().empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== JSON Document Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_parse_scenario();
+    test_values();
+    test_errors();
+    test_load_file();
+    test_reader_tokens();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
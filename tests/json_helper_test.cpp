@@ -0,0 +1,196 @@
+// json_helper_test.cpp
+// JsonHelper（JsonValueの木）のユニットテスト
+
+#include "../helper/json_helper.h"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <utility>
+
+using JsonHelper::JsonArray;
+using JsonHelper::JsonObject;
+using JsonHelper::JsonType;
+using JsonHelper::JsonValue;
+
+// テスト1: 値の型と取得
+void test_value_types() {
+    std::cout << "Test: Value types and accessors..." << std::endl;
+
+    JsonValue value = JsonHelper::parseJson(
+        R"({"text":"こんにちは\n","num":-1.5e2,"flag":true,"none":null,"list":[1,"two",false]})");
+    assert(value.isObject() && value.size() == 5);
+    assert(value["text"].asString() == "こんにちは\n");
+    assert(value["num"].isNumber() && value["num"].asNumber() == -150.0);
+    assert(value["flag"].asBool());
+    assert(value["none"].isNull());
+
+    const JsonValue& list = value["list"];
+    assert(list.isArray() && list.size() == 3);
+    assert(list[0].asNumber() == 1.0 && list[1].asString() == "two" && !list[2].asBool());
+    assert(list[3].isNull());
+
+    // 型が違う・ないキーは空の値（例外にしない）
+    const JsonValue& constValue = value;
+    assert(constValue["missing"].isNull());
+    assert(constValue["text"].asNumber() == 0.0);
+    assert(constValue["num"].asString().empty());
+    assert(constValue["num"]["deeper"].isNull());
+    assert(constValue["text"].asArray().empty() && constValue["text"].asObject().empty());
+    assert(constValue.size() == 5);
+
+    // 文字列リテラルはboolではなく文字列
+    assert(JsonValue("abc").isString());
+    assert(JsonValue().type() == JsonType::JSON_NULL);
+
+    // 書式の誤りはnull
+    assert(JsonHelper::parseJson("{\"a\":1,}").isNull());
+    assert(JsonHelper::parseJson("[1 2]").isNull());
+    assert(JsonHelper::parseJson("{} trailing").isNull());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: メンバーは書かれた順（キー"1".."10"も数の順のまま）
+void test_member_order() {
+    std::cout << "Test: Members keep insertion order..." << std::endl;
+
+    std::string json = "{\"entries\":{";
+    for (int i = 1; i <= 12; ++i) {
+        if (i > 1) json += ",";
+        json += "\"" + std::to_string(i) + "\":{\"text\":\"t" + std::to_string(i) + "\"}";
+    }
+    json += "},\"meta\":{\"name\":\"n\",\"b\":1,\"a\":2}}";
+
+    JsonValue value = JsonHelper::parseJson(json);
+    int expected = 1;
+    for (const auto& member : value["entries"].asObject()) {
+        assert(member.key == std::to_string(expected));
+        assert(member.value["text"].asString() == "t" + std::to_string(expected));
+        expected++;
+    }
+    assert(expected == 13);
+
+    const JsonObject& meta = value["meta"].asObject();
+    auto it = meta.begin();
+    assert(it->key == "name" && (++it)->key == "b" && (++it)->key == "a");
+
+    // 同じキーは後の値で置き換え、位置は最初のまま
+    JsonValue duplicated = JsonHelper::parseJson(R"({"x":1,"y":2,"x":3})");
+    assert(duplicated.size() == 2);
+    assert(duplicated["x"].asNumber() == 3.0);
+    assert(duplicated.asObject().begin()->key == "x");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 大きなオブジェクト（ハッシュ表での検索・追加・置き換え）
+void test_large_object() {
+    std::cout << "Test: Large object lookup..." << std::endl;
+
+    JsonValue object = JsonHelper::createObject();
+    const int count = 1000;
+    for (int i = 0; i < count; ++i) {
+        object[std::to_string(i)] = JsonValue(static_cast<double>(i));
+    }
+    assert(object.size() == count);
+    for (int i = 0; i < count; ++i) {
+        assert(object[std::to_string(i)].asNumber() == i);
+    }
+
+    JsonObject members = object.asObject();
+    assert(members.find("999") && members.find("999")->asNumber() == 999.0);
+    assert(members.find("1000") == nullptr);
+    members.set("500", JsonValue("replaced"));
+    assert(members.size() == count && members.find("500")->asString() == "replaced");
+    assert(object["500"].asNumber() == 500.0);
+
+    // 先頭から比べる大きさ・ハッシュ表を作る大きさの境目
+    JsonObject small;
+    for (size_t i = 0; i <= JsonObject::LINEAR_MEMBERS + 1; ++i) {
+        small.set("k" + std::to_string(i), JsonValue(static_cast<double>(i)));
+        for (size_t j = 0; j <= i; ++j) {
+            assert(small.find("k" + std::to_string(j))->asNumber() == j);
+        }
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: ムーブと参照（部分木をコピーしない）
+void test_move_and_references() {
+    std::cout << "Test: Move semantics and references..." << std::endl;
+
+    std::string text(1000, 'a');
+    const char* data = text.data();
+    JsonValue value(std::move(text));
+    assert(value.asString().data() == data);
+
+    JsonValue moved = std::move(value);
+    assert(moved.asString().data() == data);
+
+    JsonValue array = JsonHelper::createArray();
+    array.pushBack(std::move(moved));
+    assert(array[0].asString().data() == data);
+
+    JsonValue root;
+    root["entries"]["1"]["text"] = std::move(array);
+    const JsonValue& entries = root["entries"];
+    const JsonValue& entry = entries["1"];
+    assert(&entry == &root["entries"]["1"]);
+    assert(entry["text"][0].asString().data() == data);
+
+    // 範囲外の添字はnullで埋めて広げる
+    JsonValue grown;
+    grown[2] = JsonValue(true);
+    assert(grown.isArray() && grown.size() == 3 && grown[0].isNull() && grown[2].asBool());
+
+    // 型の違う値への代入で中身を置き換える
+    root["entries"] = JsonValue(2.0);
+    assert(root["entries"].isNumber() && root.size() == 1);
+
+    // コピーは別の木
+    JsonValue copy = root;
+    copy["entries"] = JsonValue("copy");
+    assert(root["entries"].asNumber() == 2.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: 大きなシナリオの解析
+void test_large_scenario() {
+    std::cout << "Test: Parse large scenario..." << std::endl;
+
+    const size_t count = 100000;
+    std::string json = "{\"meta\":{\"name\":\"big\"},\"entries\":{";
+    for (size_t i = 1; i <= count; ++i) {
+        if (i > 1) json += ",";
+        json += "\"" + std::to_string(i) + "\":{\"text\":\"今日は良い天気ですね\",\"rubi\":\"kyouhayoitenkidesune\","
+                "\"level\":\"basic\"}";
+    }
+    json += "}}";
+
+    JsonValue value = JsonHelper::parseJson(json);
+
+    const JsonValue& entries = value["entries"];
+    assert(entries.size() == count);
+    assert(entries["50000"]["rubi"].asString() == "kyouhayoitenkidesune");
+    assert((entries.asObject().end() - 1)->key == std::to_string(count));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== JSON Helper Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_value_types();
+    test_member_order();
+    test_large_object();
+    test_move_and_references();
+    test_large_scenario();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
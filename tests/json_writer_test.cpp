@@ -0,0 +1,227 @@
+// json_writer_test.cpp
+// JSONのストリーム型の書き込みのユニットテスト
+
+#include "../helper/json_writer.h"
+#include "../helper/json_helper.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+using JsonWriter::Style;
+using JsonWriter::Writer;
+
+// 小さな文書を書く
+static void writeSample(Writer& writer) {
+    writer.startObject();
+    writer.key("name");
+    writer.value("typinger");
+    writer.key("scores");
+    writer.startArray();
+    writer.value(1);
+    writer.value(2.5);
+    writer.value(true);
+    writer.null();
+    writer.endArray();
+    writer.key("empty");
+    writer.startObject();
+    writer.endObject();
+    writer.key("list");
+    writer.startArray();
+    writer.endArray();
+    writer.endObject();
+}
+
+// テスト1: 整形とコンパクト
+void test_styles() {
+    std::cout << "Test: Pretty and compact styles..." << std::endl;
+
+    std::string pretty;
+    Writer writer;
+    writer.attach(pretty);
+    writeSample(writer);
+    assert(writer.close());
+    assert(pretty ==
+           "{\n"
+           "  \"name\": \"typinger\",\n"
+           "  \"scores\": [\n"
+           "    1,\n"
+           "    2.5,\n"
+           "    true,\n"
+           "    null\n"
+           "  ],\n"
+           "  \"empty\": {},\n"
+           "  \"list\": []\n"
+           "}");
+
+    std::string compact;
+    Writer compactWriter(Style::COMPACT);
+    compactWriter.attach(compact);
+    writeSample(compactWriter);
+    assert(compactWriter.close());
+    assert(compact == "{\"name\":\"typinger\",\"scores\":[1,2.5,true,null],\"empty\":{},\"list\":[]}");
+
+    // ルートがスカラー値
+    std::string scalar;
+    Writer scalarWriter;
+    scalarWriter.attach(scalar);
+    scalarWriter.value("x");
+    assert(scalarWriter.close() && scalar == "\"x\"");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 数値と文字列の書式
+void test_number_and_string_format() {
+    std::cout << "Test: Number and string formatting..." << std::endl;
+
+    std::string text;
+    Writer writer(Style::COMPACT);
+    writer.attach(text);
+    writer.startArray();
+    writer.value(0.1);
+    writer.value(1e-7);
+    writer.value(123456789.125);
+    writer.value(42.0);
+    writer.value(-0.5);
+    writer.value(std::nan(""));
+    writer.value(HUGE_VAL);
+    writer.value(static_cast<int64_t>(-9007199254740993LL));
+    writer.value(static_cast<uint64_t>(18446744073709551615ULL));
+    writer.endArray();
+    assert(writer.close());
+    // doubleは元の値に戻せる最短の桁数（std::to_stringのように6桁で丸めない）
+    assert(text == "[0.1,1e-07,123456789.125,42,-0.5,null,null,-9007199254740993,18446744073709551615]");
+
+    text.clear();
+    writer.attach(text);
+    writer.value("\"q\" \\ \n\t\x01\x1f こんにちは");
+    assert(writer.close());
+    assert(text == "\"\\\"q\\\" \\\\ \\n\\t\\u0001\\u001f こんにちは\"");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 括弧の対応の誤りは失敗
+void test_misuse() {
+    std::cout << "Test: Unbalanced output fails..." << std::endl;
+
+    std::string text;
+    Writer writer;
+
+    writer.attach(text);
+    writer.startObject();
+    assert(!writer.close());        // 閉じていない
+
+    writer.attach(text);
+    writer.startArray();
+    writer.endObject();             // 対応しない括弧
+    assert(!writer.close());
+
+    writer.attach(text);
+    writer.startObject();
+    writer.value(1);                // キーがない
+    writer.endObject();
+    assert(!writer.close());
+
+    writer.attach(text);
+    writer.startArray();
+    writer.key("k");                // 配列にキー
+    writer.endArray();
+    assert(!writer.close());
+
+    writer.attach(text);
+    writer.startObject();
+    writer.key("k");
+    writer.endObject();             // キーに値がない
+    assert(!writer.close());
+
+    // 失敗は次のattachで消える
+    text.clear();
+    writer.attach(text);
+    writer.startArray();
+    writer.endArray();
+    assert(writer.close() && text == "[]");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: JsonHelperの文字列化と保存（解析した値に戻る）
+void test_json_helper_round_trip() {
+    std::cout << "Test: JsonHelper round trip..." << std::endl;
+
+    JsonHelper::JsonValue value = JsonHelper::parseJson(
+        R"({"meta":{"name":"特殊\"練習\"","rate":0.1},"entries":{"2":{"rubi":"ka"},"1":{"rubi":"a"}},"list":[1e-7,[],{}]})");
+    assert(value.isObject());
+
+    std::string pretty = JsonHelper::jsonToString(value);
+    std::string compact = JsonHelper::jsonToString(value, 0, Style::COMPACT);
+    assert(compact == R"({"meta":{"name":"特殊\"練習\"","rate":0.1},"entries":{"2":{"rubi":"ka"},"1":{"rubi":"a"}},"list":[1e-07,[],{}]})");
+    assert(JsonHelper::jsonToString(JsonHelper::parseJson(pretty), 0, Style::COMPACT) == compact);
+
+    // 字下げの基準（既存の文書の途中に埋め込む）
+    assert(JsonHelper::jsonToString(value["list"], 1) == "[\n    1e-07,\n    [],\n    {}\n  ]");
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/report.json";
+    assert(JsonHelper::saveJsonToFile(value, path));
+    JsonHelper::JsonValue loaded = JsonHelper::loadJsonFromFile(path);
+    assert(JsonHelper::jsonToString(loaded, 0, Style::COMPACT) == compact);
+    assert(loaded["meta"]["rate"].asNumber() == 0.1);
+    assert(!JsonHelper::saveJsonToFile(value, "test_output/missing_dir/report.json"));
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: 大きな配列の書き出し
+void test_large_output() {
+    std::cout << "Test: Large report output..." << std::endl;
+
+    const size_t count = 200000;
+    JsonHelper::JsonValue sessions = JsonHelper::createArray();
+    for (size_t i = 0; i < count; ++i) {
+        JsonHelper::JsonValue session = JsonHelper::createObject();
+        session["id"] = JsonHelper::JsonValue(static_cast<double>(i));
+        session["kpm"] = JsonHelper::JsonValue(312.25 + static_cast<double>(i % 100) / 8.0);
+        session["scenario"] = JsonHelper::JsonValue("beginner.json");
+        sessions.pushBack(std::move(session));
+    }
+
+    std::string text = JsonHelper::jsonToString(sessions, 0, Style::COMPACT);
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/sessions.json";
+    assert(JsonHelper::saveJsonToFile(sessions, path, Style::COMPACT));
+
+    JsonHelper::JsonValue loaded = JsonHelper::loadJsonFromFile(path);
+    assert(loaded.size() == count);
+    assert(loaded[count - 1]["id"].asNumber() == static_cast<double>(count - 1));
+    assert(loaded[7]["kpm"].asNumber() == 312.25 + 7.0 / 8.0);
+    // 文字列化とファイルへの保存は同じ内容
+    assert(static_cast<size_t>(fs::file_size(path)) == text.size());
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== JSON Writer Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_styles();
+    test_number_and_string_format();
+    test_misuse();
+    test_json_helper_round_trip();
+    test_large_output();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+// packed_events_test.cpp
+// 記録済みイベント列のメモリ内圧縮のユニットテスト
+
+#include "../core/packed_events.h"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using InputRecorder::EventType;
+using InputRecorder::EventView;
+using InputRecorder::InputEvent;
+using InputRecorder::PackedEvents;
+using InputRecorder::Suspect;
+
+static bool sameEvent(const InputEvent& a, const InputEvent& b) {
+    return a.type == b.type && a.timestamp_us == b.timestamp_us && a.vk_code == b.vk_code &&
+           a.scan_code == b.scan_code && a.character == b.character && a.is_correct == b.is_correct &&
+           a.inter_key_time_us == b.inter_key_time_us && a.suspect == b.suspect && a.note == b.note;
+}
+
+// 打鍵の記録に近いイベント列（押下と解放が交互、60〜260msの間隔）
+static std::vector<InputEvent> typingEvents(size_t keys) {
+    std::mt19937 rng(1);
+    std::vector<InputEvent> events;
+    uint64_t timestamp = 32034289195ULL;
+    for (size_t i = 0; i < keys; ++i) {
+        uint64_t interval = 60000 + rng() % 200000;
+        timestamp += interval;
+        int vk = 'A' + static_cast<int>(i % 26);
+        InputEvent down(EventType::KEY_DOWN, timestamp, vk, 30 + static_cast<int>(i % 20),
+                        static_cast<char>('a' + i % 26));
+        down.is_correct = (i % 7 != 0);
+        down.inter_key_time_us = interval - 40000;
+        events.push_back(down);
+        events.emplace_back(EventType::KEY_UP, timestamp + 40000, vk, down.scan_code);
+    }
+    return events;
+}
+
+// テスト1: すべての項目が元に戻る（ブロックの境目・note・範囲外の値を含む）
+void test_round_trip() {
+    std::cout << "Test: Round trip..." << std::endl;
+
+    std::vector<InputEvent> events = typingEvents(DeltaBlocks::BLOCK_VALUES * 2 + 9);
+    events[0].note = "first";
+    events[5].suspect = Suspect::CHATTER;
+    events[5].note = "chatter";
+    events[DeltaBlocks::BLOCK_VALUES].suspect = Suspect::GHOST;
+    events[DeltaBlocks::BLOCK_VALUES].note = std::string(100, 'n');
+    events.back().note = "last";
+    events.emplace_back(EventType::BACKSPACE, events.back().timestamp_us + 1, 0x08, 14);
+    events.emplace_back(EventType::CORRECTION, events.back().timestamp_us, -1, 0x1E01D);
+    events.back().inter_key_time_us = UINT64_MAX;   // 時刻が戻る・大きな差も扱える
+    events.emplace_back(EventType::KEY_DOWN, 5, 255, 0, '\t');
+
+    PackedEvents packed{EventView(events)};
+    assert(packed.size() == events.size());
+
+    std::vector<InputEvent> unpacked = packed.unpack();
+    assert(unpacked.size() == events.size());
+    for (size_t i = 0; i < events.size(); ++i) {
+        assert(sameEvent(unpacked[i], events[i]));
+    }
+
+    size_t index = 0;
+    packed.forEach([&](const InputEvent& event) {
+        assert(sameEvent(event, events[index]));
+        index++;
+    });
+    assert(index == events.size());
+
+    // 1件ずつの追加でも同じ
+    PackedEvents appended;
+    for (const auto& event : events) appended.push_back(event);
+    assert(appended.size() == events.size());
+    assert(sameEvent(appended.unpack()[5], events[5]));
+
+    appended.clear();
+    assert(appended.empty() && appended.unpack().empty());
+    PackedEvents empty{EventView()};
+    assert(empty.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 打鍵の記録は1件あたり20バイト未満になる（InputEventは80バイト前後）
+void test_compact() {
+    std::cout << "Test: Typing events are compact..." << std::endl;
+
+    std::vector<InputEvent> events = typingEvents(100000);
+    PackedEvents packed{EventView(events)};
+
+    double bytesPerEvent = static_cast<double>(packed.memoryBytes()) / events.size();
+    assert(bytesPerEvent < 20.0);
+    assert(packed.memoryBytes() * 4 < events.size() * sizeof(InputEvent));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Packed Events Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_round_trip();
+    test_compact();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
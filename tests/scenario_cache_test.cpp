@@ -0,0 +1,203 @@
+// scenario_cache_test.cpp
+// シナリオのバイナリキャッシュのユニットテスト
+
+#include "../core/scenario_cache.h"
+#include "../core/scenario_stream.h"
+#include "../helper/text_width.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using ScenarioCache::Entry;
+using ScenarioCache::Image;
+using ScenarioCache::LoadStatus;
+
+static const char* SCENARIO_JSON = R"({
+    "meta":{"name":"拗音・促音練習","uniqueid":"com.typinger.special","requiredver":"0.1.0"},
+    "entries":{
+        "1":{"text":"あいうえお","rubi":"aiueo","level":"basic"},
+        "2":{"text":"きゃきゅきょ","rubi":"KyaKyuKyo","level":"intermediate"},
+        "3":{"text":"切手","rubi":"kitte","level":"advanced"}
+    }
+})";
+
+static void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// エントリのかなを連結する
+static std::string joinKana(const Image& image, const Entry& entry) {
+    std::string joined;
+    for (size_t i = 0; i < entry.kanaCount; ++i) {
+        if (i > 0) joined += "|";
+        joined += std::string(image.kana(entry.kanaIds[i]));
+    }
+    return joined;
+}
+
+// テスト1: キャッシュの内容（かなID・表示幅・meta）
+void test_build_image() {
+    std::cout << "Test: Build scenario cache image..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string source = "test_output/special.json";
+    writeFile(source, SCENARIO_JSON);
+
+    std::string error;
+    std::string cachePath = ScenarioCache::cachePathFor(source);
+    assert(cachePath == "test_output/special.json.tpsc");
+    assert(ScenarioCache::build(source, cachePath, error));
+
+    Image image;
+    assert(image.open(cachePath));
+    assert(image.entryCount() == 3);
+    assert(image.sourcePath() == source);
+    assert(image.name() == "拗音・促音練習" && image.uniqueId() == "com.typinger.special");
+    assert(image.requiredVersion() == "0.1.0");
+
+    Entry entry = image.entry(0);
+    assert(entry.key == "1" && entry.text == "あいうえお" && entry.rubi == "aiueo" && entry.level == "basic");
+    assert(entry.textWidth == 10 && entry.rubiWidth == 5);
+    assert(joinKana(image, entry) == "あ|い|う|え|お");
+
+    assert(image.find("2", entry));
+    assert(entry.rubi == "KyaKyuKyo" && entry.textWidth == 12);
+    assert(joinKana(image, entry) == "きゃ|きゅ|きょ");
+
+    assert(image.find("3", entry));
+    assert(entry.textWidth == 4 && joinKana(image, entry) == "き|っ|て");
+    assert(!image.find("4", entry));
+
+    // 同じかなは同じID
+    Entry first = image.entry(0);
+    Entry third = image.entry(2);
+    assert(image.kanaCount() == 11);
+    assert(image.kana(third.kanaIds[0]) == "き" && first.kanaIds[0] != third.kanaIds[0]);
+    assert(image.kana(static_cast<uint16_t>(image.kanaCount())).empty());
+
+    // 表示幅はTerminal::getDisplayWidthと同じ判定
+    assert(TextWidth::displayWidth("ｱｲｳ") == 3);
+    assert(TextWidth::displayWidth("ＡＢ") == 4);
+    assert(TextWidth::displayWidth("a\xE3\x81") == 3);
+
+    image.close();
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 古いキャッシュだけを作り直す
+void test_load_staleness() {
+    std::cout << "Test: Load rebuilds only stale caches..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string source = "test_output/special.json";
+    std::string cachePath = ScenarioCache::cachePathFor(source);
+    writeFile(source, SCENARIO_JSON);
+
+    Image image;
+    std::string error;
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::REBUILT);
+    assert(image.isOpen() && image.entryCount() == 3);
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::HIT);
+
+    // 更新時刻だけが変わった
+    fs::last_write_time(source, fs::last_write_time(source) + std::chrono::seconds(5));
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::RESTAMPED);
+    assert(image.entryCount() == 3);
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::HIT);
+
+    // 内容が変わった（サイズは同じ）
+    std::string changed = SCENARIO_JSON;
+    changed.replace(changed.find("aiueo"), 5, "AIUEO");
+    writeFile(source, changed);
+    fs::last_write_time(source, fs::last_write_time(source) + std::chrono::seconds(10));
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::REBUILT);
+    assert(image.entry(0).rubi == "AIUEO");
+
+    // 壊れたキャッシュ
+    image.close();
+    fs::resize_file(cachePath, fs::file_size(cachePath) - 3);
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::REBUILT);
+    image.close();
+    writeFile(cachePath, "not a cache");
+    assert(!image.open(cachePath));
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::REBUILT);
+    assert(image.entryCount() == 3);
+
+    // 元のシナリオがない・壊れている
+    image.close();
+    assert(ScenarioCache::load("test_output/missing.json", image, error) == LoadStatus::FAILED);
+    assert(!image.isOpen() && !error.empty());
+    writeFile(source, "{\"entries\":{\"1\":{\"text\":\"あ\"");
+    error.clear();
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::FAILED);
+    assert(!error.empty() && !image.isOpen());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 大きなシナリオ（作成したキャッシュ・JSONから同じ数のエントリを読める）
+void test_large_scenario() {
+    std::cout << "Test: Large scenario cache..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string source = "test_output/big.json";
+    const size_t count = 100000;
+    {
+        std::ofstream file(source, std::ios::binary);
+        file << "{\"meta\":{\"name\":\"big\"},\"entries\":{";
+        for (size_t i = 1; i <= count; ++i) {
+            if (i > 1) file << ",";
+            file << "\"" << i << "\":{\"text\":\"今日は良い天気ですね\",\"rubi\":\"kyouhayoitenkidesune\","
+                 << "\"level\":\"basic\"}";
+        }
+        file << "}}";
+    }
+
+    Image image;
+    std::string error;
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::REBUILT);
+    image.close();
+
+    assert(ScenarioCache::load(source, image, error) == LoadStatus::HIT);
+    Entry entry = image.entry(count - 1);
+    assert(image.entryCount() == count && entry.key == std::to_string(count));
+    assert(entry.kanaCount == 11 && entry.textWidth == 20);
+
+    // 同じ内容をJSONから読む
+    ScenarioStream::EntryReader reader;
+    ScenarioStream::Entry streamed;
+    size_t entries = 0;
+    assert(reader.open(source));
+    while (reader.next(streamed)) entries++;
+    assert(entries == count);
+
+    image.close();
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Scenario Cache Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_build_image();
+    test_load_staleness();
+    test_large_scenario();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+// scenario_catalog_test.cpp
+// シナリオカタログのユニットテスト
+
+#include "../core/scenario_catalog.h"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+using ScenarioCatalog::Catalog;
+using ScenarioCatalog::RefreshStats;
+using ScenarioCatalog::ScenarioInfo;
+
+static void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << text;
+}
+
+// meta と rubi・levelを指定したシナリオ
+static std::string scenarioJson(const std::string& name, const std::string& rubi, const std::string& level) {
+    return "{\"meta\":{\"name\":\"" + name + "\",\"uniqueid\":\"com.typinger." + rubi +
+           "\",\"requiredver\":\"0.1.0\"},\"entries\":{"
+           "\"1\":{\"text\":\"あ\",\"rubi\":\"" + rubi + "\",\"level\":\"" + level + "\"},"
+           "\"2\":{\"text\":\"い\",\"rubi\":\"i\",\"level\":\"basic\"}}}";
+}
+
+static const ScenarioInfo* findScenario(const Catalog& catalog, const std::string& path) {
+    for (const ScenarioInfo& info : catalog.scenarios()) {
+        if (info.path == path) return &info;
+    }
+    return nullptr;
+}
+
+// テスト1: ディレクトリからカタログを作る
+void test_build_catalog() {
+    std::cout << "Test: Build catalog from directory..." << std::endl;
+
+    fs::create_directories("test_output/catalog/team_a");
+    writeFile("test_output/catalog/beginner.json", scenarioJson("初級", "aiueo", "basic"));
+    writeFile("test_output/catalog/team_a/special.json", scenarioJson("特殊", "kyakyukyo", "advanced"));
+    writeFile("test_output/catalog/broken.json", "{\"entries\":{\"1\":");
+    writeFile("test_output/catalog/notes.txt", "not a scenario");
+
+    Catalog catalog;
+    RefreshStats stats = catalog.refresh("test_output/catalog", 2);
+    assert(stats.loaded == 3 && stats.failed == 1 && stats.reused == 0 && stats.removed == 0);
+    assert(catalog.scenarios().size() == 3);
+
+    // pathの順で、区切りは /
+    assert(catalog.scenarios()[0].path == "beginner.json");
+    assert(catalog.scenarios()[1].path == "broken.json");
+    assert(catalog.scenarios()[2].path == "team_a/special.json");
+
+    const ScenarioInfo* special = findScenario(catalog, "team_a/special.json");
+    assert(special != nullptr && special->ok);
+    assert(special->name == "特殊" && special->uniqueId == "com.typinger.kyakyukyo");
+    assert(special->requiredVersion == "0.1.0");
+    assert(special->entries.size() == 2);
+    assert(special->entries[0].key == "1" && special->entries[0].length == 9);
+    assert(catalog.levelName(special->entries[0].level) == "advanced");
+    assert(catalog.levelName(special->entries[1].level) == "basic");
+    assert(!findScenario(catalog, "broken.json")->ok);
+    assert(catalog.levelCount() == 2);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 保存と読み込み、変わったファイルだけを読み直す
+void test_save_and_refresh() {
+    std::cout << "Test: Save, load and refresh changed files only..." << std::endl;
+
+    fs::create_directories("test_output/catalog");
+    std::string catalogPath = std::string("test_output/catalog/") + ScenarioCatalog::CATALOG_FILENAME;
+    writeFile("test_output/catalog/a.json", scenarioJson("Say \\\"hi\\\", please", "aiueo", "basic"));
+    writeFile("test_output/catalog/b.json", scenarioJson("B", "kakikukeko", "intermediate"));
+    writeFile("test_output/catalog/c.json", scenarioJson("C", "sashisuseso", "basic"));
+
+    {
+        Catalog catalog;
+        assert(!catalog.load(catalogPath));
+        catalog.refresh("test_output/catalog");
+        assert(catalog.save(catalogPath));
+    }
+
+    // 保存したカタログは , や " を含む名前もそのまま戻る
+    Catalog catalog;
+    assert(catalog.load(catalogPath));
+    assert(catalog.scenarios().size() == 3);
+    assert(catalog.scenarios()[0].name == "Say \"hi\", please");
+    assert(catalog.scenarios()[1].entries[0].length == 10);
+    assert(catalog.levelName(catalog.scenarios()[1].entries[0].level) == "intermediate");
+
+    // 何も変わっていない
+    RefreshStats stats = catalog.refresh("test_output/catalog");
+    assert(stats.reused == 3 && stats.loaded == 0 && stats.removed == 0);
+
+    // 1つ更新・1つ削除・1つ追加
+    writeFile("test_output/catalog/b.json", scenarioJson("B2", "hahihuheho", "intermediate"));
+    fs::last_write_time("test_output/catalog/b.json",
+                        fs::last_write_time("test_output/catalog/b.json") + std::chrono::seconds(5));
+    fs::remove("test_output/catalog/c.json");
+    writeFile("test_output/catalog/d.json", scenarioJson("D", "tachitsuteto", "expert"));
+
+    stats = catalog.refresh("test_output/catalog");
+    assert(stats.reused == 1 && stats.loaded == 2 && stats.failed == 0 && stats.removed == 1);
+    assert(catalog.scenarios().size() == 3);
+    assert(findScenario(catalog, "b.json")->name == "B2");
+    assert(findScenario(catalog, "c.json") == nullptr);
+    assert(findScenario(catalog, "d.json")->entries[0].length == 12);
+
+    // 形式の違うカタログは空として扱う
+    writeFile(catalogPath, "path,name\nfoo.json,bar\n");
+    assert(!catalog.load(catalogPath));
+    assert(catalog.scenarios().empty());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: レベルと長さで選ぶ
+void test_select() {
+    std::cout << "Test: Select entries by level and length..." << std::endl;
+
+    fs::create_directories("test_output/catalog");
+    writeFile("test_output/catalog/a.json", scenarioJson("A", "aiueo", "basic"));
+    writeFile("test_output/catalog/b.json", scenarioJson("B", "kakikukeko", "advanced"));
+
+    Catalog catalog;
+    catalog.refresh("test_output/catalog");
+
+    // basic: a.jsonの2件 + b.jsonの"i"
+    assert(catalog.select("basic", 0, 100).size() == 3);
+    assert(catalog.select("basic", 2, 100).size() == 1);
+    assert(catalog.select("advanced", 0, 100).size() == 1);
+    assert(catalog.select("advanced", 0, 100)[0].scenario == 1);
+    assert(catalog.select("unknown", 0, 100).empty());
+    assert(catalog.select("", 5, 10).size() == 2);
+
+    std::vector<size_t> scenarios = catalog.selectScenarios("", 10, 10);
+    assert(scenarios.size() == 1 && scenarios[0] == 1);
+    assert(catalog.selectScenarios("basic", 0, 100).size() == 2);
+
+    uint32_t id = 0;
+    assert(catalog.findLevel("advanced", id) && catalog.levelName(id) == "advanced");
+    assert(!catalog.findLevel("expert", id));
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 多数のファイル（初回・カタログから・1ファイル更新）
+void test_many_files() {
+    std::cout << "Test: Catalog of many scenario files..." << std::endl;
+
+    fs::create_directories("test_output/catalog");
+    const size_t count = 2000;
+    for (size_t i = 0; i < count; ++i) {
+        std::ofstream file("test_output/catalog/s" + std::to_string(i) + ".json", std::ios::binary);
+        file << "{\"meta\":{\"name\":\"scenario " << i << "\"},\"entries\":{";
+        for (size_t e = 1; e <= 50; ++e) {
+            if (e > 1) file << ",";
+            file << "\"" << e << "\":{\"text\":\"今日は良い天気ですね\",\"rubi\":\"kyouhayoitenkidesune\","
+                 << "\"level\":\"" << (e % 2 == 0 ? "basic" : "advanced") << "\"}";
+        }
+        file << "}}";
+    }
+    std::string catalogPath = std::string("test_output/catalog/") + ScenarioCatalog::CATALOG_FILENAME;
+
+    Catalog catalog;
+    RefreshStats stats = catalog.refresh("test_output/catalog");
+    assert(catalog.save(catalogPath));
+    assert(stats.loaded == count && stats.failed == 0);
+
+    Catalog cached;
+    assert(cached.load(catalogPath));
+    stats = cached.refresh("test_output/catalog");
+    assert(stats.reused == count && stats.loaded == 0);
+    assert(cached.select("basic", 0, 100).size() == count * 25);
+
+    std::string changed = "test_output/catalog/s7.json";
+    writeFile(changed, scenarioJson("changed", "aiueo", "basic"));
+    fs::last_write_time(changed, fs::last_write_time(changed) + std::chrono::seconds(5));
+    stats = cached.refresh("test_output/catalog");
+    assert(stats.reused == count - 1 && stats.loaded == 1);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Scenario Catalog Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_build_catalog();
+    test_save_and_refresh();
+    test_select();
+    test_many_files();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,170 @@
+// scenario_stream_test.cpp
+// シナリオファイルのエントリを1件ずつ読むテスト
+
+#include "../core/scenario_stream.h"
+#include <iostream>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+using ScenarioStream::Entry;
+using ScenarioStream::EntryReader;
+
+static void writeFile(const std::string& path, const std::string& text) {
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+}
+
+// n個のエントリを持つシナリオ
+static std::string makeScenario(size_t count) {
+    std::string json = "{\n    \"meta\":{\"name\":\"big\",\"uniqueid\":\"com.example.big\",\"requiredver\":\"0.1.0\"},\n"
+                       "    \"entries\":{\n";
+    for (size_t i = 1; i <= count; ++i) {
+        if (i > 1) json += ",\n";
+        json += "        \"" + std::to_string(i) + "\":{\"text\":\"今日は良い天気ですね" + std::to_string(i) +
+                "\",\"rubi\":\"kyouhayoitenkidesune\",\"level\":\"basic\"}";
+    }
+    json += "\n    }\n}\n";
+    return json;
+}
+
+// テスト1: シナリオのエントリを順に読む
+void test_read_entries() {
+    std::cout << "Test: Read scenario entries..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/scenario.json";
+    writeFile(path, "\xEF\xBB\xBF" R"({
+    "meta":{"name":"初心者向け練習","uniqueid":"com.typinger.beginner","requiredver":"0.1.0"},
+    "entries":{
+        "1":{"text":"あいうえお","rubi":"aiueo","level":"basic"},
+        "2":{"text":"かき\"くけ\"こ","rubi":"kakikukeko","level":"basic","note":{"x":[1,2]}},
+        "3":"broken",
+        "4":{"rubi":"sa","text":"さ"}
+    }
+})");
+
+    EntryReader reader;
+    assert(reader.open(path));
+    assert(reader.meta().name.empty());
+
+    Entry entry;
+    assert(reader.next(entry));
+    assert(entry.key == "1" && entry.text == "あいうえお" && entry.rubi == "aiueo" && entry.level == "basic");
+    assert(reader.meta().name == "初心者向け練習");
+    assert(reader.meta().uniqueId == "com.typinger.beginner" && reader.meta().requiredVersion == "0.1.0");
+
+    // エスケープ・知らないキー・オブジェクトでないエントリ・順番の違うキー
+    assert(reader.next(entry));
+    assert(entry.key == "2" && entry.text == "かき\"くけ\"こ" && entry.rubi == "kakikukeko");
+    assert(reader.next(entry));
+    assert(entry.key == "4" && entry.text == "さ" && entry.rubi == "sa" && entry.level.empty());
+    assert(!reader.next(entry));
+    assert(reader.error().empty());
+    assert(!reader.next(entry));
+
+    // metaがentriesの後ろにある
+    writeFile(path, R"({"entries":{"1":{"text":"あ","rubi":"a"}},"other":[1],"meta":{"name":"後ろ"}})");
+    assert(reader.open(path));
+    assert(reader.next(entry) && entry.text == "あ");
+    assert(reader.meta().name.empty());
+    assert(!reader.next(entry) && reader.error().empty());
+    assert(reader.meta().name == "後ろ");
+
+    // entriesがない・空
+    writeFile(path, R"({"meta":{"name":"x"}})");
+    assert(reader.open(path));
+    assert(!reader.next(entry) && reader.error().empty());
+    writeFile(path, R"({"entries":{}})");
+    assert(reader.open(path));
+    assert(!reader.next(entry) && reader.error().empty());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 書式の誤り
+void test_invalid_scenario() {
+    std::cout << "Test: Invalid scenario files..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/scenario.json";
+    EntryReader reader;
+    Entry entry;
+
+    assert(!reader.open("test_output/missing.json"));
+    assert(!reader.error().empty());
+    assert(!reader.next(entry));
+
+    writeFile(path, "[1, 2]");
+    assert(!reader.open(path));
+
+    // 途中で壊れている（前のエントリは読める）
+    writeFile(path, R"({"entries":{"1":{"text":"あ","rubi":"a"},"2":{"text":"い" "rubi":"i"}}})");
+    assert(reader.open(path));
+    assert(reader.next(entry) && entry.key == "1");
+    assert(!reader.next(entry));
+    assert(reader.error().find("expected ',' or '}'") != std::string::npos);
+    assert(!reader.next(entry));
+
+    // 末尾の余計なデータ
+    writeFile(path, R"({"entries":{"1":{"text":"あ"}}} x)");
+    assert(reader.open(path));
+    assert(reader.next(entry));
+    assert(!reader.next(entry) && !reader.error().empty());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 大きなシナリオは最初のエントリをすぐ読める
+void test_large_scenario() {
+    std::cout << "Test: Large scenario streams entries..." << std::endl;
+
+    fs::create_directories("test_output");
+    std::string path = "test_output/big.json";
+    const size_t count = 300000;
+    writeFile(path, makeScenario(count));
+
+    EntryReader reader;
+    Entry entry;
+    assert(reader.open(path));
+    assert(reader.next(entry) && entry.key == "1");
+    assert(reader.offset() < 1024);
+
+    size_t entries = 1;
+    size_t lastKey = 1;
+    while (reader.next(entry)) {
+        size_t key = std::stoul(entry.key);
+        assert(key == lastKey + 1);
+        assert(entry.text == "今日は良い天気ですね" + entry.key);
+        lastKey = key;
+        entries++;
+    }
+    assert(reader.error().empty());
+    assert(entries == count);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Scenario Stream Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_read_entries();
+    test_invalid_scenario();
+    test_large_scenario();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
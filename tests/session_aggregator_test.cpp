@@ -0,0 +1,267 @@
+// session_aggregator_test.cpp
+// ワークスティーリング並列ループとセッション集計のユニットテスト
+
+#include "../core/session_aggregator.h"
+#include "../helper/work_stealing_pool.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace Aggregator;
+
+bool doubleEquals(double a, double b, double epsilon = 0.01) {
+    return std::abs(a - b) < epsilon;
+}
+
+// テスト1: 全番号がちょうど1回ずつ処理される
+void test_for_each_covers_all() {
+    std::cout << "Test: Parallel forEach covers every index once..." << std::endl;
+
+    for (size_t threads : {1, 2, 4, 7}) {
+        std::vector<std::atomic<int>> hits(1000);
+        for (auto& h : hits) h = 0;
+
+        size_t used = Parallel::forEach(hits.size(), threads, [&](size_t index, size_t worker) {
+            assert(worker < threads);
+            hits[index]++;
+        });
+        assert(used == threads);
+        for (auto& h : hits) assert(h == 1);
+    }
+
+    // 件数0・スレッド数が件数より多い場合
+    assert(Parallel::forEach(0, 4, [](size_t, size_t) { assert(false); }) == 0);
+    std::atomic<int> calls(0);
+    assert(Parallel::forEach(2, 8, [&](size_t, size_t) { calls++; }) == 2);
+    assert(calls == 2);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 偏った負荷でも他のワーカーが奪って処理する
+void test_for_each_steals() {
+    std::cout << "Test: Parallel forEach steals from a busy worker..." << std::endl;
+
+    // 先頭の範囲（ワーカー0の担当）だけ重くする
+    std::vector<size_t> workerOf(64, 99);
+    Parallel::forEach(workerOf.size(), 4, [&](size_t index, size_t worker) {
+        if (index < 16) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        workerOf[index] = worker;
+    });
+
+    size_t stolen = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        if (workerOf[i] != 0) stolen++;
+    }
+    assert(stolen > 0);
+
+    std::cout << "  Stolen from worker 0: " << stolen << " / 16" << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト用セッションファイルの作成
+static void writeSession(const std::string& dir, const std::string& id, double wpm, double kanaMs, bool miss) {
+    {
+        std::ofstream file(dir + "/typing_events_" + id + ".csv");
+        file << "timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note\n";
+        file << "0,KEY_DOWN,65,30,a,1,0,\n";
+        file << "50000,KEY_UP,65,30,,0,0,\n";
+        file << "150000,KEY_DOWN,66,48,b," << (miss ? 0 : 1) << ",100000,\n";
+        file << "152000,KEY_DOWN,66,48,b,1,2000,chatter\n";   // 除外される
+        file << "200000,KEY_UP,66,48,,0,0,\n";
+        file << "400000,KEY_DOWN,65,30,a,1,200000,\n";
+    }
+    {
+        std::ofstream file(dir + "/typing_summary_" + id + ".csv");
+        file << "metric,value,unit\n";
+        file << "total_duration_sec,10.000000,seconds\n";
+        file << "accuracy," << (miss ? "66.67" : "100.00") << ",percent\n";
+        file << "wpm_correct," << wpm << ",words_per_minute\n";
+    }
+    {
+        std::ofstream file(dir + "/typing_kana_" + id + ".csv");
+        file << "kana,avg_input_time_ms\n";
+        file << "か," << kanaMs << "\n";
+    }
+}
+
+// テスト3: セッションの列挙
+void test_find_sessions() {
+    std::cout << "Test: Find sessions..." << std::endl;
+
+    fs::remove_all("test_output");
+    fs::create_directories("test_output");
+    writeSession("test_output", "20250101_000000", 40.0, 200.0, false);
+    writeSession("test_output", "20250101_000100", 60.0, 300.0, true);
+    { std::ofstream("test_output/typing_summary_20250101_000200.csv") << "metric,value,unit\nwpm_correct,50,words_per_minute\n"; }
+    { std::ofstream("test_output/typing_digraph_20250101_000000.csv") << "from,to\n"; }   // 対象外
+
+    std::vector<SessionFiles> sessions = findSessions("test_output");
+    assert(sessions.size() == 3);
+    assert(sessions[0].id == "20250101_000000");
+    assert(!sessions[0].eventsPath.empty() && !sessions[0].summaryPath.empty() && !sessions[0].kanaPath.empty());
+    assert(sessions[2].eventsPath.empty() && !sessions[2].summaryPath.empty());
+
+    assert(findSessions("test_output/not_found").empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 並列集計の結果がスレッド数によらず同じ
+void test_aggregate() {
+    std::cout << "Test: Aggregate sessions..." << std::endl;
+
+    std::vector<SessionFiles> sessions = findSessions("test_output");
+    SessionFiles missing;
+    missing.id = "missing";
+    missing.eventsPath = "test_output/not_found.csv";
+    sessions.push_back(missing);
+
+    AggregateData single = aggregate(sessions, 1);
+    AggregateData multi = aggregate(sessions, 4);
+
+    for (const AggregateData* data : {&single, &multi}) {
+        assert(data->sessionCount == 3);
+        assert(data->failedCount == 1);
+        assert(data->eventCount == 12);
+
+        // A: 2セッション×2回、間隔は200msのみ（最初のキーは除く）
+        const KeyAggregate& a = data->keys['A'];
+        assert(a.sessions == 2 && a.downCount == 4 && a.correctCount == 4);
+        assert(a.intervalMs.count == 2 && doubleEquals(a.intervalMs.mean(), 200.0));
+
+        // B: チャタリングを除いて2回、うち1回ミス
+        const KeyAggregate& b = data->keys['B'];
+        assert(b.downCount == 2 && b.incorrectCount == 1);
+        assert(doubleEquals(b.intervalMs.max, 100.0));
+
+        // かな別（セッション平均の平均）
+        assert(data->kana.at("か").avgInputTimeMs.count == 2);
+        assert(doubleEquals(data->kana.at("か").avgInputTimeMs.mean(), 250.0));
+
+        // セッション単位: wpm_correct は3セッション分
+        assert(data->sessionValues[0].size() == 3);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: レポート出力
+void test_write_report() {
+    std::cout << "Test: Write aggregate report..." << std::endl;
+
+    AggregateData data = aggregate(findSessions("test_output"), 2);
+    std::string path = "test_output/aggregate_report.csv";
+    assert(writeReport(data, path));
+
+    std::ifstream file(path);
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string report = buffer.str();
+    assert(report.find("section,name,sessions,count,mean,median,min,max,accuracy\n") == 0);
+    assert(report.find("total,sessions,3,3,") != std::string::npos);
+    assert(report.find("session,wpm_correct,3,3,50.00,50.00,40.00,60.00,\n") != std::string::npos);
+    assert(report.find("key,vk_66,2,2,100.00,,100.00,100.00,50.00\n") != std::string::npos);
+    assert(report.find("kana,か,2,2,250.00,,200.00,300.00,\n") != std::string::npos);
+    file.close();
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: セッションディレクトリは目録に載っているファイルを使う
+void test_find_session_directories() {
+    std::cout << "Test: Find session directories..." << std::endl;
+
+    fs::remove_all("test_output");
+    fs::create_directories("test_output/session_20250101_000000_000_1_0001");
+    fs::create_directories("test_output/.staging_20250101_000000_000_1_0002");
+    writeSession("test_output/session_20250101_000000_000_1_0001", "20250101_000000_000_1_0001", 40.0, 200.0, false);
+    writeSession("test_output/.staging_20250101_000000_000_1_0002", "20250101_000000_000_1_0002", 60.0, 300.0, false);
+    writeSession("test_output", "20241231_235959", 50.0, 250.0, false);   // 以前の形式
+
+    // かな別CSVのバイト数を目録と変えておく（途中で書き換えられたファイルは使わない）
+    {
+        std::string dir = "test_output/session_20250101_000000_000_1_0001/";
+        std::ofstream manifest(dir + "manifest.csv");
+        manifest << "session_id,file,bytes\n";
+        for (const char* prefix : {"typing_events_", "typing_summary_", "typing_kana_"}) {
+            std::string name = std::string(prefix) + "20250101_000000_000_1_0001.csv";
+            uintmax_t bytes = fs::file_size(dir + name);
+            if (std::string(prefix) == "typing_kana_") bytes += 1;
+            manifest << "20250101_000000_000_1_0001," << name << "," << bytes << "\n";
+        }
+    }
+
+    std::vector<SessionFiles> sessions = findSessions("test_output");
+    assert(sessions.size() == 2);   // 作業ディレクトリは対象外
+    assert(sessions[0].id == "20241231_235959");
+    assert(sessions[1].id == "20250101_000000_000_1_0001");
+    assert(!sessions[1].eventsPath.empty() && !sessions[1].summaryPath.empty());
+    assert(sessions[1].kanaPath.empty());
+
+    assert(aggregate(sessions, 2).sessionCount == 2);
+
+    // イベントCSVのないセッションはイベントログの索引から探す
+    {
+        std::string log = "test_output/typing_eventlog_20250101_001.csv";
+        std::ofstream file(log);
+        file << "session_id,timestamp_us,event_type,vk_code,scan_code,character,is_correct,inter_key_time_us,note\n";
+        file.close();
+        uintmax_t offset = fs::file_size(log);
+        file.open(log, std::ios::app);
+        file << "20250101_000000_000_1_0003,0,KEY_DOWN,65,30,a,1,0,\n";
+        file << "20250101_000000_000_1_0003,100000,KEY_DOWN,66,48,b,1,100000,\n";
+        file.close();
+        std::ofstream index(log + ".idx");
+        index << "session_id,offset,bytes,events\n";
+        index << "20250101_000000_000_1_0003," << offset << "," << (fs::file_size(log) - offset) << ",2\n";
+    }
+    // サマリはセッションログから読む（イベントログの索引にないセッションの行は使わない）
+    {
+        std::ofstream summaryLog("test_output/typing_summarylog_20250101.csv");
+        summaryLog << "session_id,metric,value,unit\n";
+        summaryLog << "20250101_000000_000_1_0003,wpm_correct,80.00,words_per_minute\n";
+        summaryLog << "20250101_000000_000_1_0004,wpm_correct,10.00,words_per_minute\n";
+    }
+    sessions = findSessions("test_output");
+    assert(sessions.size() == 3);
+    assert(sessions[2].id == "20250101_000000_000_1_0003");
+    assert(sessions[2].eventsPath.empty() && !sessions[2].eventLogPath.empty());
+    assert(sessions[2].loggedSummary.at("wpm_correct") == 80.0);
+    AggregateData data = aggregate(sessions, 2);
+    assert(data.sessionCount == 3);
+    assert(std::count(data.sessionValues[0].begin(), data.sessionValues[0].end(), 80.0) == 1);
+    assert(std::count(data.sessionValues[0].begin(), data.sessionValues[0].end(), 10.0) == 0);
+    assert(data.keys['B'].intervalMs.count == 3);   // セッションディレクトリ・以前の形式・イベントログで1回ずつ
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Session Aggregator Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_for_each_covers_all();
+    test_for_each_steals();
+    test_find_sessions();
+    test_aggregate();
+    test_write_report();
+    test_find_session_directories();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,273 @@
+// session_finalizer_test.cpp
+// バックグラウンドのジョブキューとセッション後処理・セッションディレクトリのユニットテスト
+
+#include "../core/session_finalizer.h"
+#include "../core/session_directory.h"
+#include "../core/csv_logger.h"
+#include "../core/csv_reader.h"
+#include "../helper/job_queue.h"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <cmath>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using InputRecorder::EventType;
+using InputRecorder::InputEvent;
+
+// テスト1: ジョブは追加順に実行され、呼び出し元は待たない
+void test_job_queue_order() {
+    std::cout << "Test: Job queue runs jobs in order..." << std::endl;
+
+    std::vector<int> order;
+    std::atomic<bool> release(false);
+    {
+        Parallel::JobQueue queue;
+
+        // 1つ目のジョブが止まっている間もsubmitはすぐ戻る
+        queue.submit([&] {
+            while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            order.push_back(0);
+        });
+        for (int i = 1; i <= 5; ++i) {
+            queue.submit([&order, i] { order.push_back(i); });
+        }
+        assert(queue.pendingCount() == 6);
+
+        release = true;
+        queue.waitIdle();
+        assert(queue.pendingCount() == 0);
+        assert((order == std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+        // 破棄時に残りのジョブも実行される
+        queue.submit([&order] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            order.push_back(6);
+        });
+    }
+    assert(order.size() == 7 && order.back() == 6);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト用セッション（100msごとに20キー）
+static SessionFinalizer::SessionJob makeJob(const std::string& outputDir) {
+    SessionFinalizer::SessionJob job;
+    for (int i = 0; i < 20; ++i) {
+        InputEvent down(EventType::KEY_DOWN, i * 100000ULL, 'A', 30, 'a');
+        down.is_correct = true;
+        job.events.push_back(down);
+        job.events.push_back(InputEvent(EventType::KEY_UP, i * 100000ULL + 40000, 'A', 30));
+    }
+    job.calculator = std::make_unique<Statistics::Calculator>();
+    job.calculator->setTrigramEnabled(true);
+    job.calculator->startSession(0);
+    job.calculator->endSession(2000000);
+    job.correctCount = 20;
+    job.incorrectCount = 0;
+    job.outputDir = outputDir;
+    return job;
+}
+
+// テスト2: 統計を受け取ってから出力の完了を待つ
+void test_finalize_session() {
+    std::cout << "Test: Finalize session in background..." << std::endl;
+
+    fs::remove_all("test_output");
+
+    SessionFinalizer::Finalizer finalizer;
+    SessionFinalizer::Pending pending = finalizer.submit(makeJob("test_output"));
+
+    Statistics::StatisticsData stats = pending.stats.get();
+    assert(stats.totalKeyCount == 20);
+    assert(stats.correctKeyCount == 20);
+    assert(std::abs(stats.avgInterKeyInterval - 100.0) < 0.01);
+
+    SessionFinalizer::ExportResult result = pending.files.get();
+    assert(result.succeeded());
+    assert(!result.sessionId.empty());
+    assert(result.sessionDir == "test_output/session_" + result.sessionId);
+    assert(fs::exists(result.eventCsvPath));
+    assert(fs::exists(result.summaryCsvPath));
+    assert(result.eventCsvPath == result.sessionDir + "/typing_events_" + result.sessionId + ".csv");
+    assert(fs::exists(result.sketchCsvPath));
+    assert(fs::exists(result.digraphCsvPath));
+    assert(fs::exists(result.trigramCsvPath));
+    assert(fs::exists(result.timeSeriesCsvPath));
+
+    // 目録には全ファイルが載り、作業ディレクトリは残らない
+    std::vector<CSVReader::ManifestEntry> entries;
+    assert(CSVReader::readManifestCSV(result.sessionDir + "/manifest.csv", entries));
+    assert(entries.size() == 6);
+    assert(!fs::exists("test_output/.staging_" + result.sessionId));
+
+    finalizer.waitAll();
+    assert(finalizer.pendingCount() == 0);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 出力できなくても統計は受け取れる
+void test_finalize_export_failure() {
+    std::cout << "Test: Export failure still delivers stats..." << std::endl;
+
+    // 出力先にファイルを置いてディレクトリを作れないようにする
+    fs::create_directories("test_output");
+    { std::ofstream("test_output/blocked") << "x"; }
+
+    SessionFinalizer::Finalizer finalizer;
+    SessionFinalizer::Pending pending = finalizer.submit(makeJob("test_output/blocked"));
+
+    assert(pending.stats.get().totalKeyCount == 20);
+    SessionFinalizer::ExportResult result = pending.files.get();
+    assert(!result.succeeded());
+    assert(result.eventCsvPath.empty());
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 同じ秒に終わった複数のセッションも別のディレクトリに出力される
+void test_concurrent_sessions() {
+    std::cout << "Test: Concurrent sessions do not overwrite each other..." << std::endl;
+
+    fs::remove_all("test_output");
+
+    // 2つの後処理キューが同じディレクトリに同時に書き込む
+    std::vector<SessionFinalizer::Pending> pendings;
+    {
+        SessionFinalizer::Finalizer first;
+        SessionFinalizer::Finalizer second;
+        for (int i = 0; i < 8; ++i) {
+            pendings.push_back((i % 2 == 0 ? first : second).submit(makeJob("test_output")));
+        }
+    }
+
+    std::set<std::string> dirs;
+    for (auto& pending : pendings) {
+        SessionFinalizer::ExportResult result = pending.files.get();
+        assert(result.succeeded());
+        dirs.insert(result.sessionDir);
+    }
+    assert(dirs.size() == 8);
+
+    size_t sessionDirs = 0;
+    for (const auto& entry : fs::directory_iterator("test_output")) {
+        assert(entry.path().filename().string().rfind("session_", 0) == 0);
+        sessionDirs++;
+    }
+    assert(sessionDirs == 8);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: イベントログに追記する場合はセッションディレクトリを作らず、サマリなどもログに追記する
+void test_finalize_event_log() {
+    std::cout << "Test: Finalize session into event log..." << std::endl;
+
+    fs::remove_all("test_output");
+
+    SessionFinalizer::Finalizer finalizer;
+    std::vector<SessionFinalizer::Pending> pendings;
+    for (int i = 0; i < 3; ++i) {
+        SessionFinalizer::SessionJob job = makeJob("test_output");
+        job.useEventLog = true;
+        pendings.push_back(finalizer.submit(std::move(job)));
+    }
+
+    std::string logPath;
+    std::string summaryLogPath;
+    for (auto& pending : pendings) {
+        SessionFinalizer::ExportResult result = pending.files.get();
+        assert(result.succeeded());
+        assert(result.sessionDir.empty());
+        assert(result.eventCsvPath.find("test_output/typing_eventlog_") == 0);
+        assert(result.summaryCsvPath.find("test_output/typing_summarylog_") == 0);
+        assert(result.digraphCsvPath.find("test_output/typing_digraphlog_") == 0);
+        assert(logPath.empty() || logPath == result.eventCsvPath);
+        logPath = result.eventCsvPath;
+        summaryLogPath = result.summaryCsvPath;
+    }
+
+    // セッションディレクトリ・作業ディレクトリは残らない
+    for (const auto& entry : fs::directory_iterator("test_output")) {
+        assert(entry.is_regular_file());
+    }
+
+    std::map<std::string, std::map<std::string, double>> summaries;
+    assert(CSVReader::readSummaryLog(summaryLogPath, summaries));
+    assert(summaries.size() == 3);
+    assert(summaries.begin()->second.count("total_key_count") == 1);
+
+    std::vector<CSVReader::EventLogEntry> entries;
+    assert(CSVReader::readEventLogIndex(logPath + CSVReader::EVENT_LOG_INDEX_SUFFIX, entries));
+    assert(entries.size() == 3);
+    std::vector<InputEvent> events;
+    assert(CSVReader::readEventLogSession(logPath, entries[2], events));
+    assert(events.size() == 40);
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: 確定しなかった作業ディレクトリは削除される
+void test_staging_discard() {
+    std::cout << "Test: Uncommitted staging directory is removed..." << std::endl;
+
+    fs::remove_all("test_output");
+
+    std::string id = CSVLogger::generateSessionId();
+    {
+        SessionDirectory::Staging staging;
+        assert(staging.open("test_output", id));
+        assert(fs::is_directory(staging.path()));
+        { std::ofstream(staging.path() + "/partial.csv") << "x"; }
+
+        // 同じIDの作業ディレクトリは同時に開けない
+        SessionDirectory::Staging duplicate;
+        assert(!duplicate.open("test_output", id));
+    }
+    assert(fs::is_empty("test_output"));
+
+    // 確定後は同じIDで上書きしない
+    SessionDirectory::Staging staging;
+    assert(staging.open("test_output", id));
+    assert(staging.commit() == SessionDirectory::directoryPath("test_output", id));
+    assert(staging.open("test_output", id));
+    assert(staging.commit().empty());
+    assert(fs::exists(SessionDirectory::directoryPath("test_output", id) + "/manifest.csv"));
+
+    fs::remove_all("test_output");
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Session Finalizer Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_job_queue_order();
+    test_finalize_session();
+    test_finalize_export_failure();
+    test_concurrent_sessions();
+    test_finalize_event_log();
+    test_staging_discard();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <type_traits>
 
 using namespace Statistics;
 
@@ -140,6 +141,13 @@ void test_uneven_intervals() {
     assert(doubleEquals(data.avgInterKeyInterval, 83.33, 0.1));
     assert(doubleEquals(data.minInterKeyInterval, 50.0));
     assert(doubleEquals(data.maxInterKeyInterval, 150.0));
+    // 標準偏差: sqrt(((50-83.33)^2*2 + (150-83.33)^2)/3) = 47.14ms
+    assert(doubleEquals(data.stdDevInterKeyInterval, 47.14, 0.1));
+    
+    // 作業領域を再利用しても同じ結果になる
+    auto again = calc.calculate(4, 0);
+    assert(doubleEquals(again.avgInterKeyInterval, data.avgInterKeyInterval));
+    assert(doubleEquals(again.maxInterKeyInterval, data.maxInterKeyInterval));
     
     std::cout << "  PASS" << std::endl;
 }
@@ -172,6 +180,31 @@ void test_key_press_duration() {
     std::cout << "  PASS" << std::endl;
 }
 
+// テスト6b: 複数キーが重なった場合の押下時間
+void test_key_press_duration_overlapped() {
+    std::cout << "Test: Key press duration (overlapped keys)..." << std::endl;
+    
+    Calculator calc;
+    calc.startSession(0);
+    
+    // 'a'を押したまま'b'を押す（ロールオーバー）
+    calc.recordKeyDown(0, 'A', 'a');
+    calc.recordKeyDown(30000, 'B', 'b');
+    calc.recordKeyUp(80000, 'A');          // a: 80ms
+    calc.recordKeyUp(90000, 'B');          // b: 60ms
+    calc.recordKeyUp(95000, 'C');          // 対応するKEY_DOWNなし（無視）
+    
+    calc.endSession(100000);
+    
+    auto data = calc.calculate(2, 0);
+    
+    assert(data.avgKeyPressDuration.size() == 2);
+    assert(doubleEquals(data.avgKeyPressDuration.at('a'), 80.0));
+    assert(doubleEquals(data.avgKeyPressDuration.at('b'), 60.0));
+    
+    std::cout << "  PASS" << std::endl;
+}
+
 // テスト7: Backspaceカウント
 void test_backspace_count() {
     std::cout << "Test: Backspace count..." << std::endl;
@@ -251,6 +284,16 @@ void test_kana_single_input() {
     assert(data.kanaInputTime.count("あ") == 1);
     assert(std::abs(data.kanaInputTime.at("あ") - 100.0) < 0.01);  // 100ms
     
+    // 約71分を超える所要時間は、平均・スケッチとも同じ上限で止める
+    Calculator longCalc;
+    longCalc.startSession(0);
+    longCalc.recordKanaInput("い", "i", 0, 2ULL * 3600 * 1000000);
+    longCalc.endSession(2ULL * 3600 * 1000000);
+    StatisticsData longData = longCalc.calculate(1, 0);
+    double capped = static_cast<double>(UINT32_MAX) / 1000.0;
+    assert(std::abs(longData.kanaInputTime.at("い") - capped) < 0.01);
+    assert(std::abs(longCalc.getSketches().kana.at("い").max() - capped) < 0.01);
+    
     std::cout << "  PASS" << std::endl;
 }
 
@@ -318,6 +361,319 @@ void test_kana_averaging() {
     std::cout << "  PASS" << std::endl;
 }
 
+// キーペア遷移時間（calculate()の1パスで集計）
+void test_digraph_transitions() {
+    std::cout << "Test: Digraph transitions... ";
+    
+    Calculator calc;
+    calc.setTrigramEnabled(true);
+    calc.startSession(0);
+    
+    // "k" -> "a" -> "k" -> "a"、Backspaceの後の "a" は遷移に数えない
+    // 文字を持たないキー（Shift）は飛ばして前後をつなぐ
+    calc.recordKeyDown(0, 'K', 'k');
+    calc.recordKeyDown(50000, 0x10, '\0');
+    calc.recordKeyDown(100000, 'A', 'a');   // k->a: 100ms
+    calc.recordKeyDown(250000, 'K', 'k');   // a->k: 150ms
+    calc.recordKeyDown(300000, 'A', 'a');   // k->a: 50ms
+    calc.recordBackspace(400000);
+    calc.recordKeyDown(500000, 'A', 'a');
+    
+    calc.endSession(600000);
+    calc.calculate(5, 0);
+    
+    const auto& digraphs = calc.getDigraphMatrix();
+    assert(digraphs.getTransitionCount() == 3);
+    assert(digraphs.at('k', 'a').count == 2);
+    assert(std::abs(digraphs.at('k', 'a').meanMs() - 75.0) < 0.01);
+    assert(digraphs.at('a', 'k').count == 1);
+    assert(digraphs.at('a', 'a').count == 0);
+    
+    // トライグラム: k->a->k (250ms), a->k->a (200ms)
+    const auto& trigrams = calc.getTrigramTable();
+    assert(trigrams.size() == 2);
+    assert(std::abs(trigrams.find('k', 'a', 'k')->meanMs() - 250.0) < 0.01);
+    assert(std::abs(trigrams.find('a', 'k', 'a')->meanMs() - 200.0) < 0.01);
+    
+    // 再計算しても二重に数えない
+    calc.calculate(5, 0);
+    assert(calc.getDigraphMatrix().getTransitionCount() == 3);
+    assert(calc.getTrigramTable().size() == 2);
+    
+    // 次のセッションの開始でクリア
+    calc.startSession(1000000);
+    assert(calc.getDigraphMatrix().getTransitionCount() == 0);
+    assert(calc.getTrigramTable().size() == 0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// チャタリング判定されたキーダウンは統計から除外
+void test_bounce_excluded() {
+    std::cout << "Test: Bounce events excluded... ";
+    
+    Calculator calc;
+    calc.startSession(0);
+    
+    calc.recordKeyDown(0, 'A', 'a');
+    calc.recordKeyUp(50000, 'A');
+    calc.recordBounce(52000, 'A');          // チャタリング
+    calc.recordKeyDown(100000, 'B', 'b');   // a->b: 100ms
+    calc.recordBounce(150000, 'B');
+    calc.recordBounce(160000, 'C');
+    
+    calc.endSession(60000000);
+    
+    auto data = calc.calculate(2, 0);
+    
+    assert(data.totalKeyCount == 2);
+    assert(doubleEquals(data.avgInterKeyInterval, 100.0));
+    assert(calc.getDigraphMatrix().at('a', 'b').count == 1);
+    assert(data.bounceCount == 3);
+    assert(data.bounceCountByKey.size() == 3);
+    assert(data.bounceCountByKey.at('A') == 1);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// キーロールオーバー・同時押しの解析
+void test_rollover_overlap() {
+    std::cout << "Test: Rollover and overlap... ";
+    
+    Calculator calc;
+    calc.setRolloverLimit(2);
+    calc.startSession(0);
+    
+    calc.recordKeyDown(0, 'A', 'a');        // 1キー
+    calc.recordKeyDown(10000, 'B', 'b');    // 2キー（a: 10ms 単独）
+    calc.recordKeyDown(30000, 'C', 'c');    // 上限(2)到達中に到着 → 3キー（2キー: 20ms）
+    calc.recordKeyUp(35000, 'A');           // 上限到達中に到着（3キー: 5ms）
+    calc.recordKeyUp(45000, 'B');           // 上限到達中に到着（2キー: 10ms）
+    calc.recordKeyUp(60000, 'C');           // 1キー: 15ms
+    calc.recordKeyUp(70000, 'D');           // 押していないキーは無視
+    
+    calc.endSession(100000);
+    
+    auto data = calc.calculate(3, 0);
+    
+    assert(data.maxSimultaneousKeys == 3);
+    assert(data.heldTimeByCount[1] == 10000 + 15000);
+    assert(data.heldTimeByCount[2] == 20000 + 10000);
+    assert(data.heldTimeByCount[3] == 5000);
+    assert(data.overlapTime() == 35000);
+    
+    assert(data.rolloverLimitEvents.size() == 3);
+    assert(data.rolloverLimitEvents[0].virtualKey == 'C');
+    assert(data.rolloverLimitEvents[0].type == EventType::KEY_DOWN);
+    assert(data.rolloverLimitEvents[0].heldCount == 2);
+    assert(data.rolloverLimitEvents[1].heldCount == 3);
+    
+    // 押下時間もロールオーバー中に正しく対応付く
+    assert(doubleEquals(data.avgKeyPressDuration.at('a'), 35.0));
+    assert(doubleEquals(data.avgKeyPressDuration.at('c'), 30.0));
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// Recorderのイベント列をコピーせずに計算（共通イベント型）
+void test_calculate_over_event_view() {
+    std::cout << "Test: Calculate over event view... ";
+    
+    using InputRecorder::InputEvent;
+    using InputRecorder::Suspect;
+    
+    std::vector<InputEvent> events;
+    events.emplace_back(EventType::KEY_DOWN, 0, 'A', 30, 'a');
+    events.back().is_correct = true;
+    events.emplace_back(EventType::KEY_UP, 40000, 'A', 30);
+    events.emplace_back(EventType::KEY_DOWN, 100000, 'B', 48, 'b');
+    events.back().is_correct = true;
+    events.emplace_back(EventType::KEY_DOWN, 150000, 'C', 46, 'c');   // ゴースト押下（判定には渡していない）
+    events.back().suspect = Suspect::GHOST;
+    events.emplace_back(EventType::KEY_UP, 151000, 'C', 46);
+    events.back().suspect = Suspect::GHOST;
+    events.emplace_back(EventType::CORRECTION, 160000, 0, 0);          // 統計には影響しない
+    events.emplace_back(EventType::KEY_UP, 170000, 'B', 48);
+    
+    Calculator calc;
+    calc.startSession(0);
+    calc.endSession(60000000);
+    
+    auto data = calc.calculate(InputRecorder::EventView(events), 2, 0);
+    
+    assert(calc.getEventCount() == 0);          // Calculator側にはコピーされない
+    assert(data.totalKeyCount == 2);
+    assert(data.correctKeyCount == 2);
+    assert(data.bounceCount == 1);
+    assert(doubleEquals(data.avgInterKeyInterval, 100.0));
+    assert(doubleEquals(data.avgKeyPressDuration.at('a'), 40.0));
+    assert(doubleEquals(data.avgKeyPressDuration.at('b'), 70.0));
+    assert(data.avgKeyPressDuration.count('c') == 0);
+
+    // 詰めた形（takeEvents()が返す形）からも同じ結果になる
+    auto packedData = calc.calculate(PackedEvents(InputRecorder::EventView(events)), 2, 0);
+    assert(packedData.totalKeyCount == data.totalKeyCount);
+    assert(packedData.correctKeyCount == data.correctKeyCount);
+    assert(packedData.bounceCount == data.bounceCount);
+    assert(doubleEquals(packedData.avgInterKeyInterval, data.avgInterKeyInterval));
+    assert(packedData.avgKeyPressDuration == data.avgKeyPressDuration);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// 指標を絞った計算器（無効な指標は状態を持たない）
+void test_metric_subset() {
+    std::cout << "Test: Metric subset calculator... ";
+    
+    // 無効な指標の状態は空の基底クラスになる
+    static_assert(std::is_empty<detail::KanaStore<false>>::value, "disabled kana store must be empty");
+    static_assert(std::is_empty<detail::DigraphStore<false>>::value, "disabled digraph store must be empty");
+    static_assert(sizeof(FleetCalculator) < sizeof(Calculator), "fleet calculator must be smaller");
+    static_assert(sizeof(BasicCalculator<Metric::BASIC>) <= sizeof(FleetCalculator), "basic calculator must not grow");
+    
+    Calculator full;
+    FleetCalculator fleet;
+    full.startSession(0);
+    fleet.startSession(0);
+    
+    // aとbを重ねて押す（最大同時押下数2）
+    full.recordKeyDown(0, 'A', 'a');        fleet.recordKeyDown(0, 'A', 'a');
+    full.recordKeyDown(80000, 'B', 'b');    fleet.recordKeyDown(80000, 'B', 'b');
+    full.recordKeyUp(100000, 'A');          fleet.recordKeyUp(100000, 'A');
+    full.recordKeyUp(150000, 'B');          fleet.recordKeyUp(150000, 'B');
+    full.recordKeyDown(200000, 'C', 'c');   fleet.recordKeyDown(200000, 'C', 'c');
+    full.recordKeyUp(250000, 'C');          fleet.recordKeyUp(250000, 'C');
+    full.recordKeyDown(260000, 'D', 'd');   fleet.recordKeyDown(260000, 'D', 'd');
+    full.recordKeyUp(330000, 'D');          fleet.recordKeyUp(330000, 'D');
+    full.recordBounce(270000, 'D');
+    fleet.recordBounce(270000, 'D');
+    full.endSession(60000000);
+    fleet.endSession(60000000);
+    
+    auto a = full.calculate(3, 1);
+    auto b = fleet.calculate(3, 1);
+    
+    // 有効な指標は同じ結果
+    assert(a.totalKeyCount == b.totalKeyCount);
+    assert(a.correctKeyCount == b.correctKeyCount);
+    assert(doubleEquals(a.wpmTotal, b.wpmTotal));
+    assert(doubleEquals(a.cpmCorrect, b.cpmCorrect));
+    assert(doubleEquals(a.avgInterKeyInterval, b.avgInterKeyInterval));
+    assert(doubleEquals(a.maxInterKeyInterval, b.maxInterKeyInterval));
+    assert(doubleEquals(a.stdDevInterKeyInterval, b.stdDevInterKeyInterval));
+    
+    // 無効な指標は初期値のまま
+    assert(!a.avgKeyPressDuration.empty());
+    assert(b.avgKeyPressDuration.empty());
+    assert(a.bounceCount == 1);
+    assert(b.bounceCount == 0);
+    assert(a.maxSimultaneousKeys == 2);
+    assert(b.maxSimultaneousKeys == 0);
+    
+    // 基本指標のみ
+    BasicCalculator<Metric::BASIC> basic;
+    basic.startSession(0);
+    basic.recordKeyDown(0, 'A', 'a');
+    basic.recordKeyDown(100000, 'B', 'b');
+    basic.endSession(60000000);
+    auto c = basic.calculate(2, 0);
+    assert(c.totalKeyCount == 2);
+    assert(c.avgInterKeyInterval == 0.0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// 移動窓時系列（1パスで更新）
+void test_time_series() {
+    std::cout << "Test: Rolling time series... ";
+    
+    using InputRecorder::InputEvent;
+    
+    // 100msごとに10秒間、奇数番目はミス
+    std::vector<InputEvent> events;
+    for (int i = 0; i < 100; ++i) {
+        events.emplace_back(EventType::KEY_DOWN, i * 100000ULL, 'A', 30, 'a');
+        events.back().is_correct = (i % 2 == 0);
+        events.emplace_back(EventType::KEY_UP, i * 100000ULL + 50000, 'A', 30);
+    }
+    
+    Calculator calc;
+    TimeSeriesConfig config;
+    config.windowUs = 2000000;
+    config.stepUs = 1000000;
+    calc.setTimeSeriesConfig(config);
+    calc.startSession(0);
+    calc.endSession(10000000);
+    calc.calculate(InputRecorder::EventView(events), 50, 50);
+    
+    const auto& buckets = calc.getTimeSeries().getBuckets();
+    assert(buckets.size() == 10);
+    assert(doubleEquals(buckets[5].cpm.mean(), 600.0));
+    assert(doubleEquals(buckets[5].accuracy.mean(), 50.0));
+    assert(doubleEquals(buckets[5].medianInterval.mean(), 100.5));
+    
+    // 再計算しても系列は作り直される
+    calc.calculate(InputRecorder::EventView(events), 50, 50);
+    assert(calc.getTimeSeries().getBuckets().size() == 10);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+// かなID辞書のテスト
+void test_kana_dictionary() {
+    std::cout << "Test: Kana dictionary... ";
+    
+    KanaDictionary dict;
+    uint16_t shi = dict.intern("し");
+    uint16_t ka = dict.intern("か");
+    
+    assert(shi != ka);
+    assert(dict.intern("し") == shi);  // 同じかなは同じID
+    assert(dict.size() == 2);
+    assert(dict.name(ka) == "か");
+    
+    dict.clear();
+    assert(dict.size() == 0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
+void test_session_sketches() {
+    std::cout << "Test: Session quantile sketches... ";
+    
+    using InputRecorder::InputEvent;
+    
+    // 100msごとに50キー、押下時間は40ms
+    std::vector<InputEvent> events;
+    for (int i = 0; i < 50; ++i) {
+        events.emplace_back(EventType::KEY_DOWN, i * 100000ULL, 'A', 30, 'a');
+        events.emplace_back(EventType::KEY_UP, i * 100000ULL + 40000, 'A', 30);
+    }
+    
+    Calculator calc;
+    calc.startSession(0);
+    calc.recordKanaInput("し", "si", 0, 150000);
+    calc.recordKanaInput("し", "si", 200000, 450000);
+    calc.endSession(5000000);
+    calc.calculate(InputRecorder::EventView(events), 50, 0);
+    
+    const SessionSketches& sketches = calc.getSketches();
+    assert(sketches.interval.count() == 49.0);
+    assert(doubleEquals(sketches.interval.quantile(0.5), 100.0));
+    assert(sketches.dwell.count() == 50.0);
+    assert(doubleEquals(sketches.dwell.quantile(0.99), 40.0));
+    assert(sketches.kana.size() == 1);
+    assert(sketches.kana.at("し").count() == 2.0);
+    assert(doubleEquals(sketches.kana.at("し").min(), 150.0));
+    assert(doubleEquals(sketches.kana.at("し").max(), 250.0));
+    
+    // 再計算しても二重に数えない
+    calc.calculate(InputRecorder::EventView(events), 50, 0);
+    assert(calc.getSketches().interval.count() == 49.0);
+    
+    std::cout << "  PASS" << std::endl;
+}
+
 int main() {
     std::cout << "=== Statistics Calculator Unit Tests ===" << std::endl;
     std::cout << std::endl;
@@ -328,6 +684,7 @@ int main() {
     test_inter_key_interval();
     test_uneven_intervals();
     test_key_press_duration();
+    test_key_press_duration_overlapped();
     test_backspace_count();
     test_empty_data();
     test_reset();
@@ -336,6 +693,14 @@ int main() {
     test_kana_single_input();
     test_kana_multiple_keys();
     test_kana_averaging();
+    test_kana_dictionary();
+    test_digraph_transitions();
+    test_bounce_excluded();
+    test_rollover_overlap();
+    test_calculate_over_event_view();
+    test_metric_subset();
+    test_time_series();
+    test_session_sketches();
     
     std::cout << std::endl;
     std::cout << "All tests passed! ✓" << std::endl;
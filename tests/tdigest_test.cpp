@@ -0,0 +1,215 @@
+// tdigest_test.cpp
+// 分位点スケッチ（t-digest）のユニットテスト
+
+#include "../core/tdigest.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+using namespace Statistics;
+
+bool doubleEquals(double a, double b, double epsilon = 0.01) {
+    return std::abs(a - b) < epsilon;
+}
+
+// 再現可能な擬似乱数（0.0〜1.0）
+static double nextUniform(uint64_t& state) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<double>(state >> 11) / static_cast<double>(1ULL << 53);
+}
+
+// 対数正規分布に近い値（キー間隔らしい右裾の長い分布, ms）
+static double nextInterval(uint64_t& state) {
+    double u1 = std::max(nextUniform(state), 1e-12);
+    double u2 = nextUniform(state);
+    double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * 3.14159265358979 * u2);
+    return std::exp(5.0 + 0.4 * z);   // 中央値 約148ms
+}
+
+// 正確な分位点（ソート済み配列）
+static double exactQuantile(const std::vector<double>& sorted, double q) {
+    size_t index = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// テスト1: 空・1件
+void test_empty_and_single() {
+    std::cout << "Test: Empty and single value..." << std::endl;
+
+    TDigest digest;
+    assert(digest.empty());
+    assert(digest.count() == 0.0);
+    assert(digest.quantile(0.5) == 0.0);
+
+    digest.add(42.0);
+    assert(!digest.empty());
+    assert(digest.count() == 1.0);
+    assert(doubleEquals(digest.quantile(0.0), 42.0));
+    assert(doubleEquals(digest.quantile(0.99), 42.0));
+    assert(digest.min() == 42.0 && digest.max() == 42.0);
+
+    digest.clear();
+    assert(digest.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 一様な値の分位点
+void test_uniform_quantiles() {
+    std::cout << "Test: Uniform quantiles..." << std::endl;
+
+    TDigest digest;
+    for (int i = 1; i <= 10000; ++i) {
+        digest.add(static_cast<double>(i));
+    }
+
+    assert(digest.count() == 10000.0);
+    assert(digest.min() == 1.0 && digest.max() == 10000.0);
+    assert(std::abs(digest.quantile(0.5) - 5000.0) < 50.0);
+    assert(std::abs(digest.quantile(0.9) - 9000.0) < 50.0);
+    assert(std::abs(digest.quantile(0.99) - 9900.0) < 10.0);
+    assert(std::abs(digest.quantile(0.999) - 9990.0) < 3.0);
+    assert(digest.quantile(1.0) == 10000.0);
+
+    // quantile()は写しを圧縮するので、元のスケッチは書き換えない
+    TDigest small;
+    small.add(1.0);
+    small.add(3.0);
+    assert(doubleEquals(small.quantile(0.5), 2.0));
+    assert(!small.compressed());
+
+    // 圧縮後はデータ件数よりはるかに小さい
+    digest.compress();
+    assert(digest.compressed());
+    assert(digest.centroids().size() < 200);
+    assert(std::abs(digest.quantile(0.99) - 9900.0) < 10.0);
+
+    std::cout << "  Centroids: " << digest.centroids().size() << std::endl;
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 多数のスケッチを合算しても裾の精度を保つ
+void test_merge_many() {
+    std::cout << "Test: Merge many sketches..." << std::endl;
+
+    uint64_t state = 12345;
+    std::vector<double> all;
+    TDigest merged;
+    for (int session = 0; session < 1000; ++session) {
+        TDigest digest;
+        for (int i = 0; i < 300; ++i) {
+            double value = nextInterval(state);
+            digest.add(value);
+            all.push_back(value);
+        }
+        merged.merge(digest);
+    }
+    std::sort(all.begin(), all.end());
+
+    assert(merged.count() == static_cast<double>(all.size()));
+    assert(merged.min() == all.front() && merged.max() == all.back());
+
+    // 相対誤差（裾ほど厳しく）
+    const double qs[] = {0.5, 0.9, 0.99, 0.999};
+    const double tolerance[] = {0.02, 0.02, 0.02, 0.03};
+    for (int i = 0; i < 4; ++i) {
+        double exact = exactQuantile(all, qs[i]);
+        double approx = merged.quantile(qs[i]);
+        assert(std::abs(approx - exact) / exact < tolerance[i]);
+    }
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: セントロイドからの復元
+void test_from_centroids() {
+    std::cout << "Test: Restore from centroids..." << std::endl;
+
+    uint64_t state = 99;
+    TDigest digest;
+    for (int i = 0; i < 5000; ++i) {
+        digest.add(nextInterval(state));
+    }
+    digest.compress();
+
+    TDigest restored = TDigest::fromCentroids(digest.centroids(), digest.min(), digest.max());
+    assert(restored.count() == digest.count());
+    assert(restored.min() == digest.min() && restored.max() == digest.max());
+    assert(restored.centroids().size() == digest.centroids().size());
+    for (double q : {0.01, 0.5, 0.9, 0.99}) {
+        assert(doubleEquals(restored.quantile(q), digest.quantile(q), 1e-6));
+    }
+
+    // 重み0のセントロイドは無視
+    TDigest empty = TDigest::fromCentroids({{10.0, 0.0}}, 10.0, 10.0);
+    assert(empty.empty());
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト5: 合算の順序によらず件数・範囲が一致し、分位点も近い
+void test_merge_order() {
+    std::cout << "Test: Merge order..." << std::endl;
+
+    uint64_t state = 7;
+    std::vector<TDigest> parts(16);
+    for (auto& part : parts) {
+        for (int i = 0; i < 500; ++i) part.add(nextInterval(state));
+    }
+
+    TDigest forward;
+    for (const auto& part : parts) forward.merge(part);
+    TDigest backward;
+    for (auto it = parts.rbegin(); it != parts.rend(); ++it) backward.merge(*it);
+
+    assert(forward.count() == backward.count());
+    assert(forward.min() == backward.min() && forward.max() == backward.max());
+    double p99 = forward.quantile(0.99);
+    assert(std::abs(p99 - backward.quantile(0.99)) / p99 < 0.02);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト6: 圧縮済みのスケッチは複数スレッドから同時に読める
+void test_shared_reads() {
+    std::cout << "Test: Concurrent quantile reads..." << std::endl;
+
+    uint64_t state = 3;
+    TDigest digest;
+    for (int i = 0; i < 5000; ++i) digest.add(nextInterval(state));
+    digest.compress();
+    double expected = digest.quantile(0.99);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&digest, expected] {
+            for (int i = 0; i < 1000; ++i) {
+                assert(digest.quantile(0.99) == expected);
+            }
+        });
+    }
+    for (auto& reader : readers) reader.join();
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== TDigest Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_empty_and_single();
+    test_uniform_quantiles();
+    test_merge_many();
+    test_from_centroids();
+    test_merge_order();
+    test_shared_reads();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
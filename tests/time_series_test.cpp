@@ -0,0 +1,164 @@
+// time_series_test.cpp
+// 移動窓時系列のユニットテスト
+
+#include "../core/time_series.h"
+#include <iostream>
+#include <cassert>
+#include <cmath>
+
+using namespace Statistics;
+
+bool doubleEquals(double a, double b, double epsilon = 0.01) {
+    return std::abs(a - b) < epsilon;
+}
+
+// テスト1: 一定ペースの入力
+void test_steady_pace() {
+    std::cout << "Test: Steady pace..." << std::endl;
+
+    TimeSeriesConfig config;
+    config.windowUs = 10000000;  // 10秒
+    config.stepUs = 1000000;     // 1秒
+    TimeSeries series(config);
+
+    // 200msごとに60秒間（300キー/分 = 60WPM）、すべて正解
+    series.begin(0);
+    for (uint64_t t = 0; t < 60000000; t += 200000) {
+        series.addKeyDown(t, true);
+    }
+    series.finish(60000000);
+
+    const auto& buckets = series.getBuckets();
+    assert(buckets.size() == 60);
+    assert(series.getSamplesPerBucket() == 1);
+
+    // 窓が埋まった後は一定
+    const TimeSeriesBucket& late = buckets[30];
+    assert(doubleEquals(late.cpm.mean(), 300.0));
+    assert(doubleEquals(late.wpm.mean(), 60.0));
+    assert(doubleEquals(late.accuracy.mean(), 100.0));
+    assert(doubleEquals(late.medianInterval.mean(), 200.5));
+
+    // 開始直後も経過時間で割るので過小評価しない
+    assert(buckets[0].cpm.mean() >= 300.0);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト2: 速度変化と正確率
+void test_speed_change() {
+    std::cout << "Test: Speed change and accuracy..." << std::endl;
+
+    TimeSeriesConfig config;
+    config.windowUs = 5000000;   // 5秒
+    config.stepUs = 5000000;
+    TimeSeries series(config);
+
+    series.begin(0);
+    // 前半20秒: 100msごと、4回に1回ミス
+    int i = 0;
+    for (uint64_t t = 0; t < 20000000; t += 100000, ++i) {
+        series.addKeyDown(t, i % 4 != 0);
+    }
+    // 後半20秒: 400msごと、すべて正解
+    for (uint64_t t = 20000000; t < 40000000; t += 400000) {
+        series.addKeyDown(t, true);
+    }
+    series.finish(40000000);
+
+    const auto& buckets = series.getBuckets();
+    assert(buckets.size() == 8);
+    assert(doubleEquals(buckets[1].cpm.mean(), 600.0));
+    assert(doubleEquals(buckets[1].accuracy.mean(), 74.0, 1.0));  // 5.1〜10.0秒の50キー中13ミス
+    assert(doubleEquals(buckets[1].medianInterval.mean(), 100.5));
+    assert(doubleEquals(buckets[6].cpm.mean(), 144.0));  // 30.4〜34.8秒の12キー
+    assert(doubleEquals(buckets[6].accuracy.mean(), 100.0));
+    assert(doubleEquals(buckets[6].medianInterval.mean(), 400.5));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト3: 長時間セッションのダウンサンプリング
+void test_downsampling() {
+    std::cout << "Test: Downsampling bounds memory..." << std::endl;
+
+    TimeSeriesConfig config;
+    config.maxBuckets = 64;
+    TimeSeries series(config);
+
+    // 24時間、250msごと（1秒ステップで86400サンプル）
+    series.begin(0);
+    const uint64_t day = 24ULL * 3600 * 1000000;
+    for (uint64_t t = 0; t < day; t += 250000) {
+        series.addKeyDown(t, true);
+    }
+    series.finish(day);
+
+    const auto& buckets = series.getBuckets();
+    assert(buckets.size() <= 64);
+    assert(buckets.size() >= 32);
+
+    size_t samples = 0;
+    for (const auto& b : buckets) samples += b.samples;
+    assert(samples == 86400);
+
+    // 統合後も値の範囲は保たれる
+    assert(doubleEquals(buckets[buckets.size() / 2].cpm.min, 240.0));
+    assert(doubleEquals(buckets[buckets.size() / 2].cpm.max, 240.0));
+    assert(buckets.back().endTime == day);
+
+    std::cout << "  PASS" << std::endl;
+}
+
+// テスト4: 長い休止
+void test_idle_gap() {
+    std::cout << "Test: Idle gap..." << std::endl;
+
+    TimeSeries series;  // 10秒窓・1秒ステップ
+
+    series.begin(0);
+    series.addKeyDown(100000, true);
+    series.addKeyDown(300000, true);
+    // 1時間の休止
+    series.addKeyDown(3600000000ULL, true);
+    series.addKeyDown(3600200000ULL, false);
+    series.finish(3601000000ULL);
+
+    const auto& buckets = series.getBuckets();
+    // 休止中も0のサンプルを置くので、バケットの時間幅は揃ったまま
+    assert(buckets.size() <= 512);
+    size_t samples = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        samples += buckets[i].samples;
+        if (i + 1 < buckets.size()) {
+            assert(buckets[i].samples == series.getSamplesPerBucket());
+            assert(buckets[i + 1].startTime - buckets[i].startTime == series.getSamplesPerBucket() * 1000000ULL);
+        }
+    }
+    assert(samples == 3601);
+    assert(buckets[100].cpm.count > 0 && buckets[100].cpm.max == 0.0);
+    assert(buckets[100].accuracy.count == 0);
+
+    const TimeSeriesBucket& last = buckets.back();
+    assert(last.endTime == 3601000000ULL);
+    assert(doubleEquals(last.accuracy.mean(), 50.0));
+    // 休止をまたぐ間隔は上限のビンに入り、中央値には影響しない
+    assert(doubleEquals(last.medianInterval.mean(), 200.5));
+
+    std::cout << "  PASS" << std::endl;
+}
+
+int main() {
+    std::cout << "=== Time Series Unit Tests ===" << std::endl;
+    std::cout << std::endl;
+
+    test_steady_pace();
+    test_speed_change();
+    test_downsampling();
+    test_idle_gap();
+
+    std::cout << std::endl;
+    std::cout << "All tests passed! ✓" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+// ab_compare.cpp
+// キーボードA/Bのセッション群を比較するコマンドラインツール
+//
+// 使い方:
+//   ab_compare.exe <Aのディレクトリ> <Bのディレクトリ> [--resamples N] [--seed S] [--threads T] [--csv 出力先]
+//
+// 各ディレクトリの typing_events_*.csv を読み込み、セッションごとの
+// WPM・正答率・平均キー間隔をA/Bで比較する。
+
+#include "../core/ab_compare.h"
+#include "../core/csv_reader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ディレクトリ内の全セッションを並列に読み込んで指標を計算
+static std::vector<ABCompare::SessionMetrics> loadSessions(const std::string& directory, size_t threadCount) {
+    std::vector<std::string> paths = CSVReader::listEventCSV(directory);
+    std::vector<ABCompare::SessionMetrics> metrics(paths.size());
+    std::vector<char> loaded(paths.size(), 0);
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]() {
+        std::vector<InputRecorder::InputEvent> events;  // スレッドごとに再利用
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= paths.size()) break;
+
+            events.clear();
+            if (!CSVReader::readEventCSV(paths[i], events)) continue;
+            metrics[i] = ABCompare::measureSession(events);
+            loaded[i] = 1;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // 読み込めなかったファイルを除く（順序はファイル名順のまま）
+    std::vector<ABCompare::SessionMetrics> result;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (loaded[i]) result.push_back(metrics[i]);
+    }
+    return result;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: ab_compare <dirA> <dirB> [--resamples N] [--seed S] [--threads T] [--csv path]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> dirs;
+    std::string csvPath;
+    ABCompare::BootstrapOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--resamples") {
+            options.resamples = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--seed") {
+            options.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--threads") {
+            options.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--csv") {
+            csvPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            dirs.push_back(arg);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (dirs.size() != 2) {
+        printUsage();
+        return 1;
+    }
+
+    size_t threadCount = options.threads;
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<ABCompare::SessionMetrics> a = loadSessions(dirs[0], threadCount);
+    std::vector<ABCompare::SessionMetrics> b = loadSessions(dirs[1], threadCount);
+    std::cout << "A: " << a.size() << " sessions (" << dirs[0] << ")" << std::endl;
+    std::cout << "B: " << b.size() << " sessions (" << dirs[1] << ")" << std::endl;
+    if (a.empty() || b.empty()) {
+        std::cerr << "No sessions found." << std::endl;
+        return 1;
+    }
+
+    std::vector<ABCompare::MetricComparison> results = ABCompare::compare(a, b, options);
+
+    // 結果の表示
+    std::cout << std::endl << std::fixed << std::setprecision(3);
+    for (const auto& r : results) {
+        std::cout << "[" << r.name << "]" << std::endl;
+        std::cout << "  mean   A=" << r.meanA << "  B=" << r.meanB
+                  << "  diff(B-A)=" << r.meanDiff
+                  << "  " << static_cast<int>(options.confidence * 100) << "% CI [" << r.ci.low << ", " << r.ci.high << "]" << std::endl;
+        std::cout << "  median A=" << r.medianA << "  B=" << r.medianB << std::endl;
+        std::cout << "  Mann-Whitney U=" << r.test.u << "  z=" << r.test.z << "  p=" << r.test.pValue << std::endl;
+        std::cout << "  Cliff's delta=" << r.cliffsDelta << "  Cohen's d=" << r.cohensD << std::endl;
+    }
+
+    if (!csvPath.empty()) {
+        std::ofstream file(csvPath);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write " << csvPath << std::endl;
+            return 1;
+        }
+        file << "metric,count_a,count_b,mean_a,mean_b,median_a,median_b,mean_diff,ci_low,ci_high,u,z,p_value,cliffs_delta,cohens_d\n";
+        file << std::setprecision(6);
+        for (const auto& r : results) {
+            file << r.name << "," << r.countA << "," << r.countB << ","
+                 << r.meanA << "," << r.meanB << "," << r.medianA << "," << r.medianB << ","
+                 << r.meanDiff << "," << r.ci.low << "," << r.ci.high << ","
+                 << r.test.u << "," << r.test.z << "," << r.test.pValue << ","
+                 << r.cliffsDelta << "," << r.cohensD << "\n";
+        }
+    }
+
+    return 0;
+}
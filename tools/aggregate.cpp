@@ -0,0 +1,64 @@
+// aggregate.cpp
+// 出力ディレクトリ内の全セッションを集計してレポートを出力するコマンドラインツール
+//
+// 使い方:
+//   aggregate.exe [ディレクトリ（省略時 output）] [--threads T] [--out 出力先]
+//
+// typing_events_* / typing_summary_* / typing_kana_* をセッションごとにまとめて並列に読み込み、
+// キー別・かな別・セッション単位の集計を1つのCSVレポート（省略時 aggregate_report.csv）に出力する。
+
+#include "../core/session_aggregator.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+static void printUsage() {
+    std::cerr << "Usage: aggregate [dir] [--threads T] [--out path]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::string directory = "output";
+    std::string outPath = "aggregate_report.csv";
+    size_t threadCount = 0;
+    bool directoryGiven = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--threads") {
+            threadCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--out") {
+            outPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-' && !directoryGiven) {
+            directory = arg;
+            directoryGiven = true;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<Aggregator::SessionFiles> sessions = Aggregator::findSessions(directory);
+    if (sessions.empty()) {
+        std::cerr << "No sessions found in " << directory << std::endl;
+        return 1;
+    }
+
+    Aggregator::AggregateData data = Aggregator::aggregate(sessions, threadCount);
+    double elapsedSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Sessions: " << data.sessionCount << " (failed " << data.failedCount << ")" << std::endl;
+    std::cout << "Events:   " << data.eventCount << std::endl;
+    std::cout << "Elapsed:  " << std::fixed << std::setprecision(2) << elapsedSec << " s" << std::endl;
+
+    if (!Aggregator::writeReport(data, outPath)) {
+        std::cerr << "Failed to write " << outPath << std::endl;
+        return 1;
+    }
+    std::cout << "Report:   " << outPath << std::endl;
+
+    return 0;
+}
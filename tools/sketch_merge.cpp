@@ -0,0 +1,130 @@
+// sketch_merge.cpp
+// セッションごとの分位点スケッチを合算して全体のパーセンタイルを表示するコマンドラインツール
+//
+// 使い方:
+//   sketch_merge.exe <ディレクトリ>... [--threads T] [--csv 出力先]
+//
+// 各ディレクトリの typing_sketch_*.csv を読み込み、同じ名前のスケッチ
+// （interval_ms, dwell_ms, kana_ms:<かな>）を合算する。
+// --csv を指定すると合算結果を同じ形式で保存する（さらに合算できる）。
+
+#include "../core/csv_reader.h"
+#include "../core/csv_logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using SketchMap = std::map<std::string, Statistics::TDigest>;
+
+// ファイルをスレッドごとに読み込んで合算し、最後に1つにまとめる
+static SketchMap mergeFiles(const std::vector<std::string>& paths, size_t threadCount, size_t& loadedCount) {
+    std::vector<SketchMap> partials(threadCount);
+    std::vector<size_t> loaded(threadCount, 0);
+    std::atomic<size_t> next(0);
+
+    auto worker = [&](size_t t) {
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= paths.size()) break;
+            if (CSVReader::readSketchCSV(paths[i], partials[t])) {
+                loaded[t]++;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    SketchMap merged;
+    loadedCount = 0;
+    for (size_t t = 0; t < threadCount; ++t) {
+        for (const auto& pair : partials[t]) {
+            merged[pair.first].merge(pair.second);
+        }
+        loadedCount += loaded[t];
+    }
+    return merged;
+}
+
+static void printUsage() {
+    std::cerr << "Usage: sketch_merge <dir>... [--threads T] [--csv path]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> dirs;
+    std::string csvPath;
+    size_t threadCount = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 < argc && arg == "--threads") {
+            threadCount = std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && arg == "--csv") {
+            csvPath = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            dirs.push_back(arg);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (dirs.empty()) {
+        printUsage();
+        return 1;
+    }
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::string> paths;
+    for (const auto& dir : dirs) {
+        std::vector<std::string> found = CSVReader::listCSV(dir, "typing_sketch_");
+        paths.insert(paths.end(), found.begin(), found.end());
+    }
+    threadCount = std::max<size_t>(1, std::min(threadCount, paths.size()));
+
+    auto start = std::chrono::steady_clock::now();
+    size_t loadedCount = 0;
+    SketchMap merged = mergeFiles(paths, threadCount, loadedCount);
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Merged " << loadedCount << " sketch files in " << std::fixed << std::setprecision(1)
+              << elapsedMs << " ms" << std::endl;
+    if (merged.empty()) {
+        std::cerr << "No sketches found." << std::endl;
+        return 1;
+    }
+
+    for (auto& pair : merged) {
+        pair.second.compress();
+    }
+
+    // 結果の表示（ミリ秒）
+    std::cout << std::endl << std::setprecision(3);
+    std::cout << "sketch,count,min,p50,p90,p99,p999,max" << std::endl;
+    for (const auto& pair : merged) {
+        const Statistics::TDigest& d = pair.second;
+        std::cout << pair.first << "," << static_cast<uint64_t>(d.count()) << "," << d.min() << ","
+                  << d.quantile(0.5) << "," << d.quantile(0.9) << "," << d.quantile(0.99) << ","
+                  << d.quantile(0.999) << "," << d.max() << std::endl;
+    }
+
+    if (!csvPath.empty() && !CSVLogger::writeSketchFile(merged, csvPath)) {
+        std::cerr << "Failed to write " << csvPath << std::endl;
+        return 1;
+    }
+
+    return 0;
+}